@@ -1,8 +1,10 @@
 #pragma once
 #ifndef CORE_CONTAINERS_CIRCULAR_BUFFER_HPP
+#define CORE_CONTAINERS_CIRCULAR_BUFFER_HPP
 #include <type_traits>
 #include <cstddef>
 #include <array>
+#include <utility>
 
 template<typename T, size_t Capacity>
 struct circular_buffer
@@ -34,14 +36,15 @@ public:
     void push(T&& elem) noexcept
     {
         data[tail] = std::move(elem);
-        tail = ++tail % Capacity;
+        tail = (tail + 1u) % Capacity;
     }
 
-    T&& pop() noexcept
+    // Returns by value: the element is moved out of the buffer, so there's nothing left to refer to
+    T pop() noexcept
     {
         T result = std::move(data[head]);
-        head = ++head % Capacity;
-        return std::move(result);
+        head = (head + 1u) % Capacity;
+        return result;
     }
 
     T& operator[](size_t index) noexcept
@@ -0,0 +1,217 @@
+#pragma once
+#ifndef CORE_CONTAINERS_FLAT_HASH_MAP_HPP
+#define CORE_CONTAINERS_FLAT_HASH_MAP_HPP
+#include "flat_hash_table.hpp"
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace foundation
+{
+
+    namespace detail
+    {
+
+        /*
+            Elements are handed out as pair<const Key, T>, but a const key can only be copied out when the table
+            rehashes. Like Abseil's map_slot_type, slots overlay that with a pair<Key, T> so keys can be moved
+            instead, whenever the two are guaranteed the same layout (both standard layout).
+        */
+        template<typename Key, typename T>
+        union flat_hash_map_slot
+        {
+            flat_hash_map_slot() noexcept {}
+            ~flat_hash_map_slot() {}
+            std::pair<const Key, T> value;
+            std::pair<Key, T> mutableValue;
+        };
+
+        template<typename Key, typename T>
+        struct flat_hash_map_policy
+        {
+            using key_type = Key;
+            using value_type = std::pair<const Key, T>;
+            using mutable_value_type = std::pair<Key, T>;
+            using slot_type = flat_hash_map_slot<Key, T>;
+
+            constexpr static bool movableKeys = std::is_standard_layout_v<value_type> && std::is_standard_layout_v<mutable_value_type>;
+
+            static value_type& element(slot_type* slot) noexcept
+            {
+                return *std::launder(&slot->value);
+            }
+
+            static const value_type& element(const slot_type* slot) noexcept
+            {
+                return *std::launder(&slot->value);
+            }
+
+            static const Key& key(const value_type& value) noexcept
+            {
+                return value.first;
+            }
+
+            template<typename...Args>
+            static void construct(slot_type* slot, Args&&...args)
+            {
+                ::new (static_cast<void*>(&slot->value)) value_type(std::forward<Args>(args)...);
+            }
+
+            static void destroy(slot_type* slot) noexcept
+            {
+                element(slot).~value_type();
+            }
+
+            static void transfer(slot_type* dst, slot_type* src)
+            {
+                if constexpr (movableKeys)
+                {
+                    mutable_value_type& source = *std::launder(&src->mutableValue);
+                    ::new (static_cast<void*>(&dst->mutableValue)) mutable_value_type(std::move_if_noexcept(source));
+                }
+                else
+                {
+                    construct(dst, std::move_if_noexcept(element(src)));
+                }
+            }
+        };
+
+        // string keys get the transparent hasher/comparator, so find(std::string_view) just works
+        template<typename Key>
+        using default_key_equal = std::conditional_t<std::is_same_v<Key, std::string> || std::is_same_v<Key, std::string_view>,
+            std::equal_to<>, std::equal_to<Key>>;
+
+    }
+
+    /*
+        Drop-in replacement for std::unordered_map for lookup-heavy tables. See flat_hash_table.hpp for
+        the layout: the main difference in behavior vs unordered_map is that growing the table moves
+        the elements, so references/pointers to elements don't survive an insertion.
+    */
+    template<typename Key, typename T, typename Hash = fast_hash<Key>, typename Eq = detail::default_key_equal<Key>>
+    class flat_hash_map : public detail::flat_hash_table<detail::flat_hash_map_policy<Key, T>, Hash, Eq>
+    {
+        using base_t = detail::flat_hash_table<detail::flat_hash_map_policy<Key, T>, Hash, Eq>;
+    public:
+
+        using mapped_type = T;
+        using typename base_t::key_type;
+        using typename base_t::value_type;
+        using typename base_t::iterator;
+        using typename base_t::const_iterator;
+        using typename base_t::size_type;
+        template<typename K>
+        using key_arg = typename base_t::template key_arg<K>;
+
+        using base_t::base_t;
+
+        flat_hash_map() noexcept = default;
+
+        flat_hash_map(std::initializer_list<value_type> init) : base_t(init.size())
+        {
+            for (const value_type& value : init)
+            {
+                insert(value);
+            }
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return this->emplace_with_key(value.first, value);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return this->emplace_with_key(value.first, std::move(value));
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+            {
+                insert(*first);
+            }
+        }
+
+        template<typename...Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&...args)
+        {
+            return this->emplace_with_key(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename...Args>
+        std::pair<iterator, bool> try_emplace(key_type&& key, Args&&...args)
+        {
+            return this->emplace_with_key(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename K, typename V>
+        std::pair<iterator, bool> emplace(K&& key, V&& value)
+        {
+            return try_emplace(key_type(std::forward<K>(key)), std::forward<V>(value));
+        }
+
+        template<typename V>
+        std::pair<iterator, bool> insert_or_assign(const key_type& key, V&& value)
+        {
+            auto result = try_emplace(key, std::forward<V>(value));
+            if (!result.second)
+            {
+                result.first->second = std::forward<V>(value);
+            }
+            return result;
+        }
+
+        template<typename V>
+        std::pair<iterator, bool> insert_or_assign(key_type&& key, V&& value)
+        {
+            auto result = try_emplace(std::move(key), std::forward<V>(value));
+            if (!result.second)
+            {
+                result.first->second = std::forward<V>(value);
+            }
+            return result;
+        }
+
+        T& operator[](const key_type& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        T& operator[](key_type&& key)
+        {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        template<typename K = key_type>
+        T& at(const key_arg<K>& key)
+        {
+            auto iter = this->template find<K>(key);
+            if (iter == this->end())
+            {
+                throw std::out_of_range("flat_hash_map::at: key not found");
+            }
+            return iter->second;
+        }
+
+        template<typename K = key_type>
+        const T& at(const key_arg<K>& key) const
+        {
+            auto iter = this->template find<K>(key);
+            if (iter == this->end())
+            {
+                throw std::out_of_range("flat_hash_map::at: key not found");
+            }
+            return iter->second;
+        }
+
+    };
+
+}
+
+#endif //!CORE_CONTAINERS_FLAT_HASH_MAP_HPP
@@ -0,0 +1,101 @@
+#pragma once
+#ifndef CORE_CONTAINERS_FLAT_HASH_SET_HPP
+#define CORE_CONTAINERS_FLAT_HASH_SET_HPP
+#include "flat_hash_map.hpp"
+
+namespace foundation
+{
+
+    namespace detail
+    {
+
+        // Keys are stored mutable so a rehash can move them, and only handed out as const
+        template<typename Key>
+        struct flat_hash_set_policy
+        {
+            using key_type = Key;
+            using value_type = const Key;
+            using slot_type = Key;
+
+            static const Key& element(const Key* slot) noexcept
+            {
+                return *slot;
+            }
+
+            static const Key& key(const Key& value) noexcept
+            {
+                return value;
+            }
+
+            template<typename...Args>
+            static void construct(Key* slot, Args&&...args)
+            {
+                ::new (static_cast<void*>(slot)) Key(std::forward<Args>(args)...);
+            }
+
+            static void destroy(Key* slot) noexcept
+            {
+                slot->~Key();
+            }
+
+            static void transfer(Key* dst, Key* src)
+            {
+                construct(dst, std::move_if_noexcept(*src));
+            }
+        };
+
+    }
+
+    // Set counterpart of flat_hash_map: same table, same invalidation rules
+    template<typename Key, typename Hash = fast_hash<Key>, typename Eq = detail::default_key_equal<Key>>
+    class flat_hash_set : public detail::flat_hash_table<detail::flat_hash_set_policy<Key>, Hash, Eq>
+    {
+        using base_t = detail::flat_hash_table<detail::flat_hash_set_policy<Key>, Hash, Eq>;
+    public:
+
+        using typename base_t::key_type;
+        using typename base_t::iterator;
+        using typename base_t::const_iterator;
+
+        using base_t::base_t;
+
+        flat_hash_set() noexcept = default;
+
+        flat_hash_set(std::initializer_list<Key> init) : base_t(init.size())
+        {
+            for (const Key& key : init)
+            {
+                insert(key);
+            }
+        }
+
+        std::pair<iterator, bool> insert(const Key& key)
+        {
+            return this->emplace_with_key(key, key);
+        }
+
+        std::pair<iterator, bool> insert(Key&& key)
+        {
+            return this->emplace_with_key(key, std::move(key));
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+            {
+                insert(*first);
+            }
+        }
+
+        template<typename...Args>
+        std::pair<iterator, bool> emplace(Args&&...args)
+        {
+            return insert(Key(std::forward<Args>(args)...));
+        }
+
+    };
+
+}
+
+#endif //!CORE_CONTAINERS_FLAT_HASH_SET_HPP
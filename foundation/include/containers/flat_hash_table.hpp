@@ -0,0 +1,847 @@
+#pragma once
+#ifndef CORE_CONTAINERS_FLAT_HASH_TABLE_HPP
+#define CORE_CONTAINERS_FLAT_HASH_TABLE_HPP
+#include "utility/FastHash.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FOUNDATION_FLAT_HASH_SSE2 1
+#endif
+
+/*
+    Open-addressing table in the style of Abseil's SwissTable: a separate array of one control byte
+    per slot holds 7 bits of each element's hash, and lookups compare a whole group of control bytes
+    against those bits at once (16 at a time with SSE2, 8 at a time with a SWAR fallback). Only slots
+    whose control byte matches get their keys compared, so most probes never touch the slot array.
+
+    Used via flat_hash_map and flat_hash_set. Like those, references and iterators are invalidated
+    by any insertion that grows the table.
+*/
+namespace foundation::detail
+{
+
+    using ctrl_t = int8_t;
+
+    // Empty and deleted both have the high bit set, full slots store the 7-bit H2 hash (high bit clear)
+    constexpr ctrl_t ctrlEmpty = static_cast<ctrl_t>(-128);
+    constexpr ctrl_t ctrlDeleted = static_cast<ctrl_t>(-2);
+
+    constexpr bool is_full(ctrl_t c) noexcept
+    {
+        return c >= 0;
+    }
+
+    // Iterates set bits of a group match, yielding slot offsets within the group
+    template<uint32_t Shift>
+    struct group_bitmask
+    {
+        uint64_t mask;
+
+        explicit operator bool() const noexcept
+        {
+            return mask != 0u;
+        }
+
+        uint32_t lowest() const noexcept
+        {
+            return static_cast<uint32_t>(std::countr_zero(mask)) >> Shift;
+        }
+
+        group_bitmask& operator++() noexcept
+        {
+            mask &= mask - 1u;
+            return *this;
+        }
+
+        uint32_t operator*() const noexcept
+        {
+            return lowest();
+        }
+
+        group_bitmask begin() const noexcept
+        {
+            return *this;
+        }
+
+        group_bitmask end() const noexcept
+        {
+            return group_bitmask{ 0u };
+        }
+
+        bool operator!=(const group_bitmask& other) const noexcept
+        {
+            return mask != other.mask;
+        }
+    };
+
+#ifdef FOUNDATION_FLAT_HASH_SSE2
+
+    struct ctrl_group
+    {
+        constexpr static size_t width = 16u;
+        using bitmask = group_bitmask<0u>;
+
+        explicit ctrl_group(const ctrl_t* pos) noexcept : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+        bitmask match(uint8_t h2) const noexcept
+        {
+            const __m128i target = _mm_set1_epi8(static_cast<char>(h2));
+            return bitmask{ static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(target, ctrl))) };
+        }
+
+        bitmask match_empty() const noexcept
+        {
+            const __m128i target = _mm_set1_epi8(static_cast<char>(ctrlEmpty));
+            return bitmask{ static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(target, ctrl))) };
+        }
+
+        // Empty and deleted are the only negative control values, so the sign bits say it all
+        bitmask match_empty_or_deleted() const noexcept
+        {
+            return bitmask{ static_cast<uint32_t>(_mm_movemask_epi8(ctrl)) };
+        }
+
+        __m128i ctrl;
+    };
+
+#else
+
+    struct ctrl_group
+    {
+        constexpr static size_t width = 8u;
+        using bitmask = group_bitmask<3u>;
+        constexpr static uint64_t lsbs = 0x0101010101010101ull;
+        constexpr static uint64_t msbs = 0x8080808080808080ull;
+
+        explicit ctrl_group(const ctrl_t* pos) noexcept
+        {
+            std::memcpy(&ctrl, pos, sizeof(ctrl));
+        }
+
+        // May report false positives (never false negatives), which are weeded out by the key compare
+        bitmask match(uint8_t h2) const noexcept
+        {
+            const uint64_t x = ctrl ^ (lsbs * h2);
+            return bitmask{ (x - lsbs) & ~x & msbs };
+        }
+
+        bitmask match_empty() const noexcept
+        {
+            return bitmask{ (ctrl & ~(ctrl << 6u)) & msbs };
+        }
+
+        bitmask match_empty_or_deleted() const noexcept
+        {
+            return bitmask{ ctrl & msbs };
+        }
+
+        uint64_t ctrl;
+    };
+
+#endif
+
+    // Probes groups in a triangular sequence, which visits every group exactly once when the
+    // group count is a power of two
+    struct probe_sequence
+    {
+        probe_sequence(size_t hash, size_t mask_) noexcept : mask(mask_), offset(hash & mask_) {}
+
+        size_t offset_at(size_t i) const noexcept
+        {
+            return (offset + i) & mask;
+        }
+
+        void next() noexcept
+        {
+            index += ctrl_group::width;
+            offset = (offset + index) & mask;
+        }
+
+        size_t mask;
+        size_t offset;
+        size_t index{ 0u };
+    };
+
+    inline const ctrl_t* empty_ctrl_group() noexcept
+    {
+        alignas(16) static const ctrl_t emptyGroup[16] =
+        {
+            ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty,
+            ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty, ctrlEmpty
+        };
+        return emptyGroup;
+    }
+
+    template<typename Hash, typename Eq>
+    constexpr bool is_transparent_lookup_v = requires { typename Hash::is_transparent; typename Eq::is_transparent; };
+
+    // Lookup functions take key_arg<K>: with a transparent hash and comparator that's just K (deducible),
+    // otherwise it collapses to key_type so lookups behave exactly like unordered_map's
+    template<bool Transparent>
+    struct key_arg_selector
+    {
+        template<typename K, typename Key>
+        using type = K;
+    };
+
+    template<>
+    struct key_arg_selector<false>
+    {
+        template<typename K, typename Key>
+        using type = Key;
+    };
+
+    /*
+        Policy provides:
+            key_type, value_type (what iterators yield), slot_type (what's stored)
+            static value_type& element(slot_type*), and a const overload
+            static const key_type& key(const value_type&)
+            static void construct(slot_type*, Args&&...)
+            static void destroy(slot_type*)
+            static void transfer(slot_type* dst, slot_type* src): constructs dst from src while rehashing,
+                moving when that can't throw and copying otherwise. src is destroyed separately afterwards.
+    */
+    template<typename Policy, typename Hash, typename Eq>
+    class flat_hash_table
+    {
+    public:
+
+        using key_type = typename Policy::key_type;
+        using value_type = typename Policy::value_type;
+        using slot_type = typename Policy::slot_type;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using hasher = Hash;
+        using key_equal = Eq;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        template<typename K>
+        using key_arg = typename key_arg_selector<is_transparent_lookup_v<Hash, Eq>>::template type<K, key_type>;
+
+        template<bool IsConst>
+        class iterator_base
+        {
+            friend class flat_hash_table;
+            template<bool>
+            friend class iterator_base;
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename Policy::value_type;
+            using difference_type = ptrdiff_t;
+            using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+            using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+            iterator_base() noexcept = default;
+
+            // const_iterator from iterator
+            template<bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+            iterator_base(const iterator_base<OtherConst>& other) noexcept : ctrl(other.ctrl), slot(other.slot), ctrlEnd(other.ctrlEnd) {}
+
+            reference operator*() const noexcept
+            {
+                return Policy::element(slot);
+            }
+
+            pointer operator->() const noexcept
+            {
+                return &Policy::element(slot);
+            }
+
+            iterator_base& operator++() noexcept
+            {
+                ++ctrl;
+                ++slot;
+                skip_empty_slots();
+                return *this;
+            }
+
+            iterator_base operator++(int) noexcept
+            {
+                iterator_base result = *this;
+                ++(*this);
+                return result;
+            }
+
+            friend bool operator==(const iterator_base& a, const iterator_base& b) noexcept
+            {
+                return a.slot == b.slot;
+            }
+
+            friend bool operator!=(const iterator_base& a, const iterator_base& b) noexcept
+            {
+                return a.slot != b.slot;
+            }
+
+        private:
+
+            using slot_ptr_t = std::conditional_t<IsConst, const slot_type*, slot_type*>;
+
+            iterator_base(const ctrl_t* ctrl_, slot_ptr_t slot_, const ctrl_t* ctrl_end) noexcept : ctrl(ctrl_), slot(slot_), ctrlEnd(ctrl_end) {}
+
+            void skip_empty_slots() noexcept
+            {
+                while (ctrl != ctrlEnd && !is_full(*ctrl))
+                {
+                    ++ctrl;
+                    ++slot;
+                }
+            }
+
+            const ctrl_t* ctrl{ nullptr };
+            slot_ptr_t slot{ nullptr };
+            const ctrl_t* ctrlEnd{ nullptr };
+        };
+
+        using iterator = iterator_base<false>;
+        using const_iterator = iterator_base<true>;
+
+        flat_hash_table() noexcept = default;
+
+        explicit flat_hash_table(size_type bucket_count, const Hash& hash = Hash(), const Eq& eq = Eq()) : hashFn(hash), eqFn(eq)
+        {
+            reserve(bucket_count);
+        }
+
+        flat_hash_table(const flat_hash_table& other) : hashFn(other.hashFn), eqFn(other.eqFn)
+        {
+            reserve(other.size());
+            size_t pendingIdx = npos;
+            try
+            {
+                for (const value_type& value : other)
+                {
+                    const size_t hash = hashFn(Policy::key(value));
+                    pendingIdx = prepare_insert(hash);
+                    Policy::construct(slots + pendingIdx, value);
+                    pendingIdx = npos;
+                }
+            }
+            catch (...)
+            {
+                // Our destructor won't run if the constructor throws, so undo everything copied so far here
+                if (pendingIdx != npos)
+                {
+                    abandon_insert(pendingIdx);
+                }
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        flat_hash_table(flat_hash_table&& other) noexcept : hashFn(std::move(other.hashFn)), eqFn(std::move(other.eqFn))
+        {
+            steal(other);
+        }
+
+        flat_hash_table& operator=(const flat_hash_table& other)
+        {
+            if (this != &other)
+            {
+                flat_hash_table copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        flat_hash_table& operator=(flat_hash_table&& other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy_and_deallocate();
+                hashFn = std::move(other.hashFn);
+                eqFn = std::move(other.eqFn);
+                steal(other);
+            }
+            return *this;
+        }
+
+        ~flat_hash_table()
+        {
+            destroy_and_deallocate();
+        }
+
+        iterator begin() noexcept
+        {
+            iterator result(ctrl, slots, ctrl + capacityVal);
+            result.skip_empty_slots();
+            return result;
+        }
+
+        iterator end() noexcept
+        {
+            return iterator(ctrl + capacityVal, slots + capacityVal, ctrl + capacityVal);
+        }
+
+        const_iterator begin() const noexcept
+        {
+            const_iterator result(ctrl, slots, ctrl + capacityVal);
+            result.skip_empty_slots();
+            return result;
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator(ctrl + capacityVal, slots + capacityVal, ctrl + capacityVal);
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        bool empty() const noexcept
+        {
+            return sizeVal == 0u;
+        }
+
+        size_type size() const noexcept
+        {
+            return sizeVal;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return capacityVal;
+        }
+
+        float load_factor() const noexcept
+        {
+            return capacityVal != 0u ? float(sizeVal) / float(capacityVal) : 0.0f;
+        }
+
+        void clear() noexcept
+        {
+            if (capacityVal == 0u)
+            {
+                return;
+            }
+            destroy_slots();
+            reset_ctrl();
+            sizeVal = 0u;
+            growthLeft = max_load(capacityVal);
+        }
+
+        // Ensures count elements fit without another rehash
+        void reserve(size_type count)
+        {
+            if (count > sizeVal + growthLeft)
+            {
+                resize(capacity_for(count));
+            }
+        }
+
+        template<typename K = key_type>
+        iterator find(const key_arg<K>& key) noexcept
+        {
+            const size_t idx = find_index(key, hashFn(key));
+            return idx != npos ? iterator_at(idx) : end();
+        }
+
+        template<typename K = key_type>
+        const_iterator find(const key_arg<K>& key) const noexcept
+        {
+            const size_t idx = find_index(key, hashFn(key));
+            return idx != npos ? const_iterator_at(idx) : end();
+        }
+
+        template<typename K = key_type>
+        bool contains(const key_arg<K>& key) const noexcept
+        {
+            return find_index(key, hashFn(key)) != npos;
+        }
+
+        template<typename K = key_type>
+        size_type count(const key_arg<K>& key) const noexcept
+        {
+            return contains<K>(key) ? 1u : 0u;
+        }
+
+        iterator erase(const_iterator pos) noexcept
+        {
+            const size_t idx = static_cast<size_t>(pos.slot - slots);
+            erase_at(idx);
+            iterator result = iterator_at(idx);
+            result.skip_empty_slots();
+            return result;
+        }
+
+        iterator erase(iterator pos) noexcept
+        {
+            return erase(const_iterator(pos));
+        }
+
+        template<typename K = key_type>
+        size_type erase(const key_arg<K>& key) noexcept
+        {
+            const size_t idx = find_index(key, hashFn(key));
+            if (idx == npos)
+            {
+                return 0u;
+            }
+            erase_at(idx);
+            return 1u;
+        }
+
+        void swap(flat_hash_table& other) noexcept
+        {
+            using std::swap;
+            swap(ctrl, other.ctrl);
+            swap(slots, other.slots);
+            swap(capacityVal, other.capacityVal);
+            swap(sizeVal, other.sizeVal);
+            swap(growthLeft, other.growthLeft);
+            swap(hashFn, other.hashFn);
+            swap(eqFn, other.eqFn);
+        }
+
+        hasher hash_function() const
+        {
+            return hashFn;
+        }
+
+        key_equal key_eq() const
+        {
+            return eqFn;
+        }
+
+    protected:
+
+        constexpr static size_t npos = ~size_t(0u);
+
+        iterator iterator_at(size_t idx) noexcept
+        {
+            return iterator(ctrl + idx, slots + idx, ctrl + capacityVal);
+        }
+
+        const_iterator const_iterator_at(size_t idx) const noexcept
+        {
+            return const_iterator(ctrl + idx, slots + idx, ctrl + capacityVal);
+        }
+
+        // Finds key, or reserves a slot for it. Returns (index, true) if the slot still needs to be constructed.
+        // Caller MUST construct the slot (or call abandon_insert) before touching the table again.
+        template<typename K>
+        std::pair<size_t, bool> find_or_prepare_insert(const K& key)
+        {
+            const size_t hash = hashFn(key);
+            const size_t idx = find_index(key, hash);
+            if (idx != npos)
+            {
+                return { idx, false };
+            }
+            return { prepare_insert(hash), true };
+        }
+
+        // Rolls back a prepare_insert whose construction threw
+        void abandon_insert(size_t idx) noexcept
+        {
+            set_ctrl(idx, ctrlDeleted);
+            --sizeVal;
+        }
+
+        template<typename K, typename...Args>
+        std::pair<iterator, bool> emplace_with_key(const K& key, Args&&...args)
+        {
+            auto [idx, inserted] = find_or_prepare_insert(key);
+            if (inserted)
+            {
+                try
+                {
+                    Policy::construct(slots + idx, std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    abandon_insert(idx);
+                    throw;
+                }
+            }
+            return { iterator_at(idx), inserted };
+        }
+
+    private:
+
+        static size_t h1(size_t hash) noexcept
+        {
+            return hash >> 7u;
+        }
+
+        static uint8_t h2(size_t hash) noexcept
+        {
+            return static_cast<uint8_t>(hash & 0x7Fu);
+        }
+
+        // 7/8ths max load
+        static size_t max_load(size_t capacity) noexcept
+        {
+            return capacity - capacity / 8u;
+        }
+
+        static size_t capacity_for(size_t count) noexcept
+        {
+            size_t result = ctrl_group::width;
+            while (max_load(result) < count)
+            {
+                result *= 2u;
+            }
+            return result;
+        }
+
+        template<typename K>
+        size_t find_index(const K& key, size_t hash) const noexcept
+        {
+            if (capacityVal == 0u)
+            {
+                return npos;
+            }
+
+            probe_sequence seq(h1(hash), capacityVal - 1u);
+            const uint8_t hashBits = h2(hash);
+            while (true)
+            {
+                const ctrl_group group(ctrl + seq.offset);
+                for (uint32_t i : group.match(hashBits))
+                {
+                    const size_t idx = seq.offset_at(i);
+                    if (eqFn(Policy::key(Policy::element(slots + idx)), key))
+                    {
+                        return idx;
+                    }
+                }
+                if (group.match_empty())
+                {
+                    return npos;
+                }
+                seq.next();
+                assert(seq.index < capacityVal + ctrl_group::width && "full table in flat_hash_table::find_index!");
+            }
+        }
+
+        size_t find_first_non_full(size_t hash) const noexcept
+        {
+            probe_sequence seq(h1(hash), capacityVal - 1u);
+            while (true)
+            {
+                const ctrl_group group(ctrl + seq.offset);
+                if (auto mask = group.match_empty_or_deleted(); mask)
+                {
+                    return seq.offset_at(mask.lowest());
+                }
+                seq.next();
+            }
+        }
+
+        size_t prepare_insert(size_t hash)
+        {
+            size_t target = capacityVal != 0u ? find_first_non_full(hash) : npos;
+            if (target == npos || (growthLeft == 0u && ctrl[target] != ctrlDeleted))
+            {
+                rehash_and_grow();
+                target = find_first_non_full(hash);
+            }
+            ++sizeVal;
+            growthLeft -= (ctrl[target] == ctrlEmpty) ? 1u : 0u;
+            set_ctrl(target, h2(hash));
+            return target;
+        }
+
+        void rehash_and_grow()
+        {
+            if (capacityVal == 0u)
+            {
+                resize(ctrl_group::width);
+            }
+            else if (sizeVal * 32u <= capacityVal * 25u)
+            {
+                // Mostly tombstones: rehashing at the same size is enough to reclaim them
+                resize(capacityVal);
+            }
+            else
+            {
+                resize(capacityVal * 2u);
+            }
+        }
+
+        // The control array is followed by a clone of its first group, so a group load starting at
+        // any slot index never has to wrap around
+        void set_ctrl(size_t idx, ctrl_t value) noexcept
+        {
+            ctrl[idx] = value;
+            if (idx < ctrl_group::width)
+            {
+                ctrl[capacityVal + idx] = value;
+            }
+        }
+
+        void reset_ctrl() noexcept
+        {
+            std::memset(ctrl, static_cast<uint8_t>(ctrlEmpty), capacityVal + ctrl_group::width);
+        }
+
+        static size_t slots_offset(size_t capacity) noexcept
+        {
+            const size_t ctrlBytes = capacity + ctrl_group::width;
+            return (ctrlBytes + alignof(slot_type) - 1u) & ~(alignof(slot_type) - 1u);
+        }
+
+        constexpr static size_t allocation_alignment() noexcept
+        {
+            return alignof(slot_type) > 16u ? alignof(slot_type) : 16u;
+        }
+
+        static size_t allocation_size(size_t capacity) noexcept
+        {
+            return slots_offset(capacity) + capacity * sizeof(slot_type);
+        }
+
+        void resize(size_t new_capacity)
+        {
+            assert(new_capacity >= ctrl_group::width && (new_capacity & (new_capacity - 1u)) == 0u);
+            ctrl_t* const oldCtrl = ctrl;
+            slot_type* const oldSlots = slots;
+            const size_t oldCapacity = capacityVal;
+
+            std::byte* memory = static_cast<std::byte*>(::operator new(allocation_size(new_capacity), std::align_val_t{ allocation_alignment() }));
+            ctrl = reinterpret_cast<ctrl_t*>(memory);
+            slots = reinterpret_cast<slot_type*>(memory + slots_offset(new_capacity));
+            capacityVal = new_capacity;
+            reset_ctrl();
+
+            try
+            {
+                for (size_t i = 0u; i < oldCapacity; ++i)
+                {
+                    if (is_full(oldCtrl[i]))
+                    {
+                        const size_t hash = hashFn(Policy::key(Policy::element(oldSlots + i)));
+                        const size_t target = find_first_non_full(hash);
+                        Policy::transfer(slots + target, oldSlots + i);
+                        set_ctrl(target, h2(hash));
+                    }
+                }
+            }
+            catch (...)
+            {
+                // Transfers only copy when a move could throw, so the old elements are all still intact:
+                // drop what made it into the new table and go back to the old one
+                destroy_slots();
+                ::operator delete(memory, std::align_val_t{ allocation_alignment() });
+                ctrl = oldCtrl;
+                slots = oldSlots;
+                capacityVal = oldCapacity;
+                throw;
+            }
+
+            // Nothing in the old table goes away until every element has made it across
+            for (size_t i = 0u; i < oldCapacity; ++i)
+            {
+                if (is_full(oldCtrl[i]))
+                {
+                    Policy::destroy(oldSlots + i);
+                }
+            }
+
+            growthLeft = max_load(capacityVal) - sizeVal;
+
+            if (oldCapacity != 0u)
+            {
+                ::operator delete(oldCtrl, std::align_val_t{ allocation_alignment() });
+            }
+        }
+
+        void erase_at(size_t idx) noexcept
+        {
+            Policy::destroy(slots + idx);
+            --sizeVal;
+
+            // If no probe window containing idx can be full, nothing ever probed past this slot, so it
+            // can go straight back to empty instead of leaving a tombstone
+            const size_t before = (idx - ctrl_group::width) & (capacityVal - 1u);
+            const auto emptyAfter = ctrl_group(ctrl + idx).match_empty();
+            const auto emptyBefore = ctrl_group(ctrl + before).match_empty();
+            const bool wasNeverFull = emptyBefore && emptyAfter &&
+                (leading_empty_distance(emptyBefore) + emptyAfter.lowest()) < ctrl_group::width;
+
+            set_ctrl(idx, wasNeverFull ? ctrlEmpty : ctrlDeleted);
+            growthLeft += wasNeverFull ? 1u : 0u;
+        }
+
+        // Distance from the end of the group to its last empty slot
+        static uint32_t leading_empty_distance(typename ctrl_group::bitmask mask) noexcept
+        {
+            uint32_t last = 0u;
+            for (uint32_t i : mask)
+            {
+                last = i;
+            }
+            return static_cast<uint32_t>(ctrl_group::width - 1u) - last;
+        }
+
+        void destroy_slots() noexcept
+        {
+            if constexpr (!std::is_trivially_destructible_v<value_type>)
+            {
+                for (size_t i = 0u; i < capacityVal; ++i)
+                {
+                    if (is_full(ctrl[i]))
+                    {
+                        Policy::destroy(slots + i);
+                    }
+                }
+            }
+        }
+
+        void destroy_and_deallocate() noexcept
+        {
+            if (capacityVal != 0u)
+            {
+                destroy_slots();
+                ::operator delete(ctrl, std::align_val_t{ allocation_alignment() });
+            }
+            ctrl = const_cast<ctrl_t*>(empty_ctrl_group());
+            slots = nullptr;
+            capacityVal = 0u;
+            sizeVal = 0u;
+            growthLeft = 0u;
+        }
+
+        void steal(flat_hash_table& other) noexcept
+        {
+            ctrl = std::exchange(other.ctrl, const_cast<ctrl_t*>(empty_ctrl_group()));
+            slots = std::exchange(other.slots, nullptr);
+            capacityVal = std::exchange(other.capacityVal, 0u);
+            sizeVal = std::exchange(other.sizeVal, 0u);
+            growthLeft = std::exchange(other.growthLeft, 0u);
+        }
+
+        // Only ever read through while capacityVal is 0, never written
+        ctrl_t* ctrl{ const_cast<ctrl_t*>(empty_ctrl_group()) };
+        slot_type* slots{ nullptr };
+        size_t capacityVal{ 0u };
+        size_t sizeVal{ 0u };
+        size_t growthLeft{ 0u };
+        [[no_unique_address]] Hash hashFn{};
+        [[no_unique_address]] Eq eqFn{};
+
+    };
+
+}
+
+#endif //!CORE_CONTAINERS_FLAT_HASH_TABLE_HPP
@@ -0,0 +1,298 @@
+#pragma once
+#ifndef CORE_CONTAINERS_INDEXED_PRIORITY_QUEUE_HPP
+#define CORE_CONTAINERS_INDEXED_PRIORITY_QUEUE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/*
+    Binary max-heap that hands out a handle per pushed item, so items can be re-prioritized or
+    removed while still queued (std::priority_queue can't do either). Each heap node holds only the
+    priority, a push sequence number and a slot index; items live in a dense slot vector that also
+    tracks the node's position in the heap, so sifting never moves the items themselves and each
+    step is a plain indexed store.
+
+    A handle is [ generation : 32 ][ slot index : 32 ], and a slot's generation is bumped every time
+    it's freed, so handles to popped or erased items stay invalid after the slot is reused. Handles
+    are never 0. Items of equal priority pop in push order. Not thread safe, guard it with whatever
+    lock covers the owner.
+*/
+template<typename T, typename Priority = float>
+class indexedPriorityQueue
+{
+public:
+
+    using value_type = T;
+    using priority_type = Priority;
+    using handle_type = uint64_t;
+    using size_type = size_t;
+
+    handle_type push(T&& item, const Priority priority)
+    {
+        if (freeHead == noFreeSlot)
+        {
+            freeHead = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+
+        // Slot stays on the free list until the item and its heap node are both in place
+        const uint32_t index = freeHead;
+        slot_t& slot = slots[index];
+        slot.item.emplace(std::move(item));
+        try
+        {
+            heap.emplace_back(heap_node{ priority, nextSequence, index });
+        }
+        catch (...)
+        {
+            slot.item.reset();
+            throw;
+        }
+
+        ++nextSequence;
+        freeHead = slot.nextFree;
+        slot.handle = (static_cast<handle_type>(slot.generation) << 32u) | index;
+        slot.nextFree = noFreeSlot;
+        sift_up(heap.size() - 1u);
+        return slot.handle;
+    }
+
+    // Returns false if handle isn't queued (already popped, erased or never pushed)
+    bool update(const handle_type handle, const Priority priority)
+    {
+        const slot_t* slot = find_slot(handle);
+        if (slot == nullptr)
+        {
+            return false;
+        }
+
+        const size_t index = slot->heapIndex;
+        const Priority previous = heap[index].priority;
+        heap[index].priority = priority;
+        if (previous < priority)
+        {
+            sift_up(index);
+        }
+        else
+        {
+            sift_down(index);
+        }
+        return true;
+    }
+
+    bool erase(const handle_type handle)
+    {
+        slot_t* slot = find_slot(handle);
+        if (slot == nullptr)
+        {
+            return false;
+        }
+
+        const size_t index = slot->heapIndex;
+        release_slot(*slot);
+        remove_node(index);
+        return true;
+    }
+
+    // Pops the highest-priority item, oldest first among equals
+    std::optional<T> pop()
+    {
+        if (heap.empty())
+        {
+            return std::nullopt;
+        }
+
+        slot_t& slot = slots[heap.front().slot];
+        std::optional<T> result{ std::move(slot.item) };
+        release_slot(slot);
+        remove_node(0u);
+        return result;
+    }
+
+    // Highest-priority item, left in place. nullptr if empty.
+    [[nodiscard]] T* top() noexcept
+    {
+        return heap.empty() ? nullptr : &*slots[heap.front().slot].item;
+    }
+
+    [[nodiscard]] std::optional<Priority> top_priority() const noexcept
+    {
+        if (heap.empty())
+        {
+            return std::nullopt;
+        }
+        return heap.front().priority;
+    }
+
+    [[nodiscard]] T* find(const handle_type handle) noexcept
+    {
+        slot_t* slot = find_slot(handle);
+        return slot != nullptr ? &*slot->item : nullptr;
+    }
+
+    [[nodiscard]] std::optional<Priority> priority(const handle_type handle) const noexcept
+    {
+        const slot_t* slot = find_slot(handle);
+        if (slot == nullptr)
+        {
+            return std::nullopt;
+        }
+        return heap[slot->heapIndex].priority;
+    }
+
+    [[nodiscard]] bool contains(const handle_type handle) const noexcept
+    {
+        return find_slot(handle) != nullptr;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return heap.empty();
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return heap.size();
+    }
+
+    void clear() noexcept
+    {
+        heap.clear();
+        // Keeps the slots (and their generations), so handles from before the clear stay invalid
+        for (size_t i = 0u; i < slots.size(); ++i)
+        {
+            if (slots[i].handle != 0u)
+            {
+                release_slot(slots[i]);
+            }
+        }
+    }
+
+private:
+
+    static constexpr uint32_t noFreeSlot = ~0u;
+
+    struct heap_node
+    {
+        Priority priority;
+        uint64_t sequence;
+        uint32_t slot;
+    };
+
+    struct slot_t
+    {
+        std::optional<T> item;
+        size_t heapIndex{ 0u };
+        // Full handle while queued, 0 while free
+        handle_type handle{ 0u };
+        uint32_t generation{ 1u };
+        uint32_t nextFree{ noFreeSlot };
+    };
+
+    static bool before(const heap_node& a, const heap_node& b) noexcept
+    {
+        return (b.priority < a.priority) || (!(a.priority < b.priority) && a.sequence < b.sequence);
+    }
+
+    slot_t* find_slot(const handle_type handle) noexcept
+    {
+        const size_t index = static_cast<uint32_t>(handle);
+        if (index < slots.size() && slots[index].handle == handle)
+        {
+            return &slots[index];
+        }
+        return nullptr;
+    }
+
+    const slot_t* find_slot(const handle_type handle) const noexcept
+    {
+        return const_cast<indexedPriorityQueue*>(this)->find_slot(handle);
+    }
+
+    void release_slot(slot_t& slot) noexcept
+    {
+        const uint32_t index = static_cast<uint32_t>(slot.handle);
+        slot.item.reset();
+        slot.handle = 0u;
+        // Skips 0 on wrap, so no handle is ever 0
+        slot.generation = slot.generation == ~0u ? 1u : slot.generation + 1u;
+        slot.nextFree = freeHead;
+        freeHead = index;
+    }
+
+    void place(const size_t index, const heap_node node) noexcept
+    {
+        slots[node.slot].heapIndex = index;
+        heap[index] = node;
+    }
+
+    void remove_node(const size_t index)
+    {
+        const heap_node last = heap.back();
+        heap.pop_back();
+        if (index == heap.size())
+        {
+            return;
+        }
+
+        place(index, last);
+        if (index != 0u && before(heap[index], heap[(index - 1u) / 2u]))
+        {
+            sift_up(index);
+        }
+        else
+        {
+            sift_down(index);
+        }
+    }
+
+    void sift_up(size_t index)
+    {
+        const heap_node node = heap[index];
+        while (index != 0u)
+        {
+            const size_t parent = (index - 1u) / 2u;
+            if (!before(node, heap[parent]))
+            {
+                break;
+            }
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, node);
+    }
+
+    void sift_down(size_t index)
+    {
+        const heap_node node = heap[index];
+        const size_t count = heap.size();
+        while (true)
+        {
+            size_t child = index * 2u + 1u;
+            if (child >= count)
+            {
+                break;
+            }
+            if (child + 1u < count && before(heap[child + 1u], heap[child]))
+            {
+                ++child;
+            }
+            if (!before(heap[child], node))
+            {
+                break;
+            }
+            place(index, heap[child]);
+            index = child;
+        }
+        place(index, node);
+    }
+
+    std::vector<heap_node> heap;
+    std::vector<slot_t> slots;
+    uint32_t freeHead{ noFreeSlot };
+    uint64_t nextSequence{ 0u };
+};
+
+#endif //!CORE_CONTAINERS_INDEXED_PRIORITY_QUEUE_HPP
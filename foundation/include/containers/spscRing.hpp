@@ -0,0 +1,220 @@
+#pragma once
+#ifndef CORE_CONTAINERS_SPSC_RING_HPP
+#define CORE_CONTAINERS_SPSC_RING_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/*
+    Lock-free single-producer/single-consumer ring. Exactly one thread may push and exactly one
+    (other) thread may pop: intended for feeding a per-thread command stream into the render or
+    transfer thread, where mwsrQueue's CAS reactors are overkill.
+
+    Head and tail live on their own cache lines, and each side keeps a cached copy of the other
+    side's index so it only touches the shared line when it thinks it has run out of room/items.
+    Indices increase monotonically and are masked on access, so Capacity must be a power of two
+    and all Capacity slots are usable.
+*/
+template<typename T, size_t Capacity>
+class spscRing
+{
+public:
+
+    static_assert(Capacity >= 2u && (Capacity & (Capacity - 1u)) == 0u, "spscRing capacity must be a power of two!");
+    static_assert(std::is_default_constructible_v<T>, "Type stored in spscRing must be default-constructible!");
+    static_assert(std::is_move_assignable_v<T>, "Type stored in spscRing must be move-assignable!");
+
+    using value_type = T;
+    using size_type = size_t;
+
+    spscRing() noexcept(std::is_nothrow_default_constructible_v<T>) = default;
+    spscRing(const spscRing&) = delete;
+    spscRing& operator=(const spscRing&) = delete;
+
+    // Producer side
+
+    bool try_push(T&& item) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        const size_t tail = producer.tail.load(std::memory_order_relaxed);
+        if (!has_room(tail, 1u))
+        {
+            return false;
+        }
+        items[tail & mask] = std::move(item);
+        producer.tail.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) noexcept(std::is_nothrow_copy_assignable_v<T>)
+    {
+        const size_t tail = producer.tail.load(std::memory_order_relaxed);
+        if (!has_room(tail, 1u))
+        {
+            return false;
+        }
+        items[tail & mask] = item;
+        producer.tail.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    // Copies as many of items as currently fit, publishing them all at once. Returns count pushed.
+    size_t push_n(std::span<const T> source) noexcept(std::is_nothrow_copy_assignable_v<T>)
+    {
+        return push_bulk(source, [](const T* first, const T* last, T* dest) { std::copy(first, last, dest); });
+    }
+
+    // As above, but moves out of source. Elements beyond the returned count are left untouched.
+    size_t push_n_move(std::span<T> source) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        return push_bulk(source, [](T* first, T* last, T* dest) { std::move(first, last, dest); });
+    }
+
+    // Consumer side
+
+    std::optional<T> try_pop() noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        std::optional<T> result;
+        const size_t head = consumer.head.load(std::memory_order_relaxed);
+        if (available(head, 1u) == 0u)
+        {
+            return result;
+        }
+        result.emplace(std::move(items[head & mask]));
+        consumer.head.store(head + 1u, std::memory_order_release);
+        return result;
+    }
+
+    bool try_pop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        const size_t head = consumer.head.load(std::memory_order_relaxed);
+        if (available(head, 1u) == 0u)
+        {
+            return false;
+        }
+        out = std::move(items[head & mask]);
+        consumer.head.store(head + 1u, std::memory_order_release);
+        return true;
+    }
+
+    // Moves up to dest.size() items into dest, releasing their slots in one go. Returns count popped.
+    size_t pop_n(std::span<T> dest) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        const size_t head = consumer.head.load(std::memory_order_relaxed);
+        const size_t count = std::min(available(head, dest.size()), dest.size());
+        if (count == 0u)
+        {
+            return 0u;
+        }
+
+        const size_t first = head & mask;
+        const size_t firstSpan = std::min(count, Capacity - first);
+        std::move(items.begin() + first, items.begin() + first + firstSpan, dest.begin());
+        std::move(items.begin(), items.begin() + (count - firstSpan), dest.begin() + firstSpan);
+
+        consumer.head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Only exact when called from the producer or consumer thread with the other side idle
+    size_t size_approx() const noexcept
+    {
+        // Head first: tail never falls behind a head read before it, so this can't underflow. Tail can
+        // still run ahead by up to a whole ring between the two loads though, hence the clamp.
+        const size_t head = consumer.head.load(std::memory_order_acquire);
+        const size_t tail = producer.tail.load(std::memory_order_acquire);
+        return std::min(tail - head, Capacity);
+    }
+
+    bool empty() const noexcept
+    {
+        return size_approx() == 0u;
+    }
+
+    constexpr static size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+private:
+
+    constexpr static size_t mask = Capacity - 1u;
+    constexpr static size_t cacheLineSize = 64u;
+
+    // Called by producer: refreshes the cached head only when the cached value says we're full
+    bool has_room(size_t tail, size_t count) noexcept
+    {
+        if (tail - producer.cachedHead + count <= Capacity)
+        {
+            return true;
+        }
+        producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+        return tail - producer.cachedHead + count <= Capacity;
+    }
+
+    // As above, but for bulk pushes: refreshes whenever the cached head can't fit all of wanted
+    size_t free_slots(size_t tail, size_t wanted) noexcept
+    {
+        size_t result = Capacity - (tail - producer.cachedHead);
+        if (result < wanted)
+        {
+            producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+            result = Capacity - (tail - producer.cachedHead);
+        }
+        return result;
+    }
+
+    // Called by consumer: refreshes the cached tail only when the cached value has fewer than wanted items
+    size_t available(size_t head, size_t wanted) noexcept
+    {
+        size_t result = consumer.cachedTail - head;
+        if (result < wanted)
+        {
+            consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+            result = consumer.cachedTail - head;
+        }
+        return result;
+    }
+
+    template<typename SpanType, typename CopyFn>
+    size_t push_bulk(SpanType source, CopyFn&& copy_fn)
+    {
+        const size_t tail = producer.tail.load(std::memory_order_relaxed);
+        const size_t count = std::min(free_slots(tail, source.size()), source.size());
+        if (count == 0u)
+        {
+            return 0u;
+        }
+
+        const size_t first = tail & mask;
+        const size_t firstSpan = std::min(count, Capacity - first);
+        copy_fn(source.data(), source.data() + firstSpan, items.data() + first);
+        copy_fn(source.data() + firstSpan, source.data() + count, items.data());
+
+        producer.tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    struct alignas(cacheLineSize) producer_state_t
+    {
+        std::atomic<size_t> tail{ 0u };
+        size_t cachedHead{ 0u };
+    };
+
+    struct alignas(cacheLineSize) consumer_state_t
+    {
+        std::atomic<size_t> head{ 0u };
+        size_t cachedTail{ 0u };
+    };
+
+    producer_state_t producer;
+    consumer_state_t consumer;
+    alignas(cacheLineSize) std::array<T, Capacity> items{};
+
+};
+
+#endif //!CORE_CONTAINERS_SPSC_RING_HPP
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef FOUNDATION_ALLOCATION_SAMPLING_HPP
+#define FOUNDATION_ALLOCATION_SAMPLING_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+    Sampled allocation tracking for the global new/delete overrides in miMallocOverride.cpp. Roughly
+    one sample is taken per SetAllocationSampleInterval() bytes allocated through operator new, and
+    each sample captures the calling stack. Samples are aggregated per unique stack into a fixed-size
+    callsite table, along with an estimate of the total bytes allocated from that callsite.
+
+    Only allocations are tracked, not frees: this answers "who allocates the most", which is what
+    finds per-frame churn, not "what is currently live".
+
+    Requires the FOUNDATION_ALLOCATION_SAMPLING CMake option, which defines
+    FOUNDATION_ALLOCATION_SAMPLING_CONF. Without it the overrides are plain mimalloc and these
+    functions do nothing. With it, but with an interval of zero (the default), each operator new
+    pays one thread-local subtraction and compare.
+*/
+namespace foundation
+{
+
+    constexpr size_t MaxAllocationSampleFrames = 16u;
+    // Fixed so that recording a sample never allocates. Samples from new callsites beyond this are dropped.
+    constexpr size_t MaxAllocationSampleCallsites = 4096u;
+
+    struct allocation_callsite
+    {
+        std::array<void*, MaxAllocationSampleFrames> frames{};
+        uint32_t depth{ 0u };
+        uint64_t sampleCount{ 0u };
+        // Unbiased estimate of the bytes allocated from this callsite while sampling was on
+        uint64_t estimatedBytes{ 0u };
+    };
+
+    // Average bytes allocated between samples. Zero disables sampling. Returns false if sampling wasn't compiled in.
+    bool SetAllocationSampleInterval(size_t bytes) noexcept;
+    [[nodiscard]] size_t GetAllocationSampleInterval() noexcept;
+    // Callsites sorted by estimated bytes, largest first
+    [[nodiscard]] std::vector<allocation_callsite> GetAllocationCallsites();
+    // Writes the largest max_callsites callsites, with symbolized stacks where the platform allows. Returns false on failure.
+    bool DumpAllocationCallsites(const char* output_file, size_t max_callsites = 64u);
+    void ResetAllocationSamples() noexcept;
+    // Samples lost because the callsite table was full
+    [[nodiscard]] uint64_t GetDroppedAllocationSampleCount() noexcept;
+
+}
+
+#endif //!FOUNDATION_ALLOCATION_SAMPLING_HPP
@@ -20,8 +20,12 @@ struct Plugin_API {
     void (*LogicalUpdate)(void);
     // Called per frame, dt is frametime. use for time-dependent updates like physical systems and simulations
     void (*TimeDependentUpdate)(double dt);
+    // Engine API IDs this plugin's updates read from and write to, used to run non-conflicting plugin
+    // updates in parallel. Call with null id arrays to query counts first. Plugins leaving this null
+    // are assumed to touch everything, and so are never run concurrently with other plugins.
+    void (*UpdateDependencies)(uint32_t* num_reads, uint32_t* read_api_ids, uint32_t* num_writes, uint32_t* write_api_ids);
     // For potential future API expansion
-    void* ReservedFns[24];
+    void* ReservedFns[23];
 };
 
 #endif //!PLUGIN_MANAGER_CORE_API_DECLARATIONS_HPP
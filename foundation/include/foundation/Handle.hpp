@@ -4,6 +4,8 @@
 #include <type_traits>
 #include <cstdint>
 #include <exception>
+#include <limits>
+#include <cstddef>
 
 namespace foundation
 {
@@ -40,26 +42,29 @@ namespace foundation
 
     class Container;
 
+    template<typename T, memory_mode MemoryMode>
+    class object_pool;
+
     namespace detail
     {
 
         struct fast_mode_metadata
         {
-            void* datumPtr;
+            void* datumPtr{ nullptr };
         };
 
         struct minimal_safety_mode_metadata
         {
             uint64_t ID{ 0u };
-            void* datumPtr;
+            void* datumPtr{ nullptr };
         };
 
         struct full_safety_mode_metadata
         {
             uint64_t ID{ 0u };
-            void* datumPtr;
-            void* parentAlloc;
-            uint64_t padding; // round up to 256 explicitly
+            void* datumPtr{ nullptr };
+            void* parentAlloc{ nullptr };
+            uint64_t padding{ 0u }; // round up to 256 explicitly
         };
 
         constexpr uint64_t INVALID_HANDLE = std::numeric_limits<uint64_t>::max();
@@ -74,12 +79,14 @@ namespace foundation
             Invalid,
             MinSafetyPtrIdMismatch,
             FailureToRemapInvalidPointer,
-            PointerIdMismatchAndMissingRelocFn
+            PointerIdMismatchAndMissingRelocFn,
+            PoolCapacityExhausted,
+            PoolHandleNotOwned
         };
 
         fabric_exception(type exception_type) : std::exception(), exceptionType(exception_type) {}
 
-        const char* what() const
+        const char* what() const noexcept override
         {
             switch (exceptionType)
             {
@@ -89,6 +96,10 @@ namespace foundation
                 return "unable to map pointer ID to new memory location!";
             case type::PointerIdMismatchAndMissingRelocFn:
                 return "object_handle's stored ID and ID from pointer didn't match, and there was no relocation function for this type!";
+            case type::PoolCapacityExhausted:
+                return "object_pool has no free slots left: capacity is fixed at construction!";
+            case type::PoolHandleNotOwned:
+                return "object_handle passed to object_pool doesn't refer to a live object in that pool!";
             default:
                 return "Unhandled new exception type in fabric object_handle code!";
             };
@@ -103,27 +114,35 @@ namespace foundation
     public:
 
         using relocation_lookup_fn_t = void*(*)(uint64_t ID, void* allocator);
+        using metadata_type = std::conditional_t<MemoryMode == memory_mode::fast, detail::fast_mode_metadata,
+            std::conditional_t<MemoryMode == memory_mode::minimal_safety, detail::minimal_safety_mode_metadata,
+            detail::full_safety_mode_metadata>>;
+
+        static_assert(MemoryMode != memory_mode::invalid, "object_handle cannot be used with memory_mode::invalid!");
+
+        object_handle() noexcept = default;
 
-        static void SetRelocationFunction(relocation_lookup_fn_t fn);
+        static void SetRelocationFunction(relocation_lookup_fn_t fn) noexcept
+        {
+            relocationFn = fn;
+        }
 
         // Returns mutable pointer to object, and will throw exceptions as appropriate based on
         // safety mode.
-        T* get_mutable()
+        T* get_mutable() const
         {
-            using namespace fabric::detail;
+            using namespace foundation::detail;
             if constexpr (MemoryMode == memory_mode::fast)
             {
-                fast_mode_metadata* metadata = reinterpret_cast<fast_mode_metadata*>(datumPtr);
-                return reinterpret_cast<T*>(metadata->datumPtr);
+                return get_object_address(metadata.datumPtr);
             }
             else if constexpr (MemoryMode == memory_mode::minimal_safety)
             {
-                minimal_safety_mode_metadata* metadata = reinterpret_cast<minimal_safety_mode_metadata*>(datumPtr);
                 // even if this data is garbage or invalid, merely casting it to an ID should NOT crash
-                const uint64_t ptrID = get_datum_value(metadata->datumPtr);
-                if (ptrID == metadata->ID)
+                const uint64_t ptrID = get_datum_value(metadata.datumPtr);
+                if (ptrID == metadata.ID)
                 {
-                    return get_object_address(metadata->datumPtr);
+                    return get_object_address(metadata.datumPtr);
                 }
                 else
                 {
@@ -132,15 +151,16 @@ namespace foundation
             }
             else if constexpr (MemoryMode == memory_mode::full_safety)
             {
-                full_safety_mode_metadata* metadata = reinterpret_cast<full_safety_mode_metadata*>(datumPtr);
-                const uint64_t ptrID = get_datum_value(metadata->datumPtr);
-                if (ptrID == metadata->ID)
+                const uint64_t ptrID = get_datum_value(metadata.datumPtr);
+                if (ptrID == metadata.ID)
                 {
-                    return get_object_address(metadata->datumPtr);
+                    return get_object_address(metadata.datumPtr);
                 }
                 else if (relocationFn != nullptr)
                 {
-                    void* relocatedAddress = relocationFn(ptrID, metadata->parentAlloc);
+                    // our ID is the one the owning allocator knows us by: the value at our stale address
+                    // now belongs to whatever got moved (or allocated) into that slot since
+                    void* relocatedAddress = relocationFn(metadata.ID, metadata.parentAlloc);
                     if (relocatedAddress != nullptr)
                     {
                         resolve_address(relocatedAddress);
@@ -160,22 +180,28 @@ namespace foundation
 
         // In fast mode, the only difference in this function is that we'll check validity and return null if not valid. In safety modes, 
         // we return nullptr instead of throwing an exception in our failure paths
-        T* try_and_get_mutable()
+        T* try_and_get_mutable() const noexcept
         {
-            using namespace::fabric::detail;
+            using namespace foundation::detail;
             if constexpr (MemoryMode == memory_mode::fast)
             {
-                fast_mode_metadata* metadata = reinterpret_cast<fast_mode_metadata*>(datumPtr);
-                const uint64_t datumValue = get_datum_value(metadata->datumPtr);
-                return datumValue != INVALID_HANDLE ? get_object_address(metadata->datumPtr) : nullptr;
+                if (metadata.datumPtr == nullptr)
+                {
+                    return nullptr;
+                }
+                const uint64_t datumValue = get_datum_value(metadata.datumPtr);
+                return datumValue != INVALID_HANDLE ? get_object_address(metadata.datumPtr) : nullptr;
             }
             else if constexpr (MemoryMode == memory_mode::minimal_safety)
             {
-                minimal_safety_mode_metadata* metadata = reinterpret_cast<minimal_safety_mode_metadata*>(datumPtr);
-                const uint64_t ptrID = get_datum_value(metadata->datumPtr);
-                if (ptrID == metadata->ID)
+                if (metadata.datumPtr == nullptr)
+                {
+                    return nullptr;
+                }
+                const uint64_t ptrID = get_datum_value(metadata.datumPtr);
+                if (ptrID == metadata.ID)
                 {
-                    return get_object_address(metadata->datumPtr);
+                    return get_object_address(metadata.datumPtr);
                 }
                 else
                 {
@@ -184,16 +210,18 @@ namespace foundation
             }
             else if constexpr (MemoryMode == memory_mode::full_safety)
             {
-                full_safety_mode_metadata* metadata = reinterpret_cast<full_safety_mode_metadata*>(datumPtr);
-                const uint64_t ptrID = get_datum_value(metadata->datumPtr);
-                if (ptrID == metadata->ID)
+                if (metadata.datumPtr == nullptr)
+                {
+                    return nullptr;
+                }
+                const uint64_t ptrID = get_datum_value(metadata.datumPtr);
+                if (ptrID == metadata.ID)
                 {
-                    return get_object_address(metadata->datumPtr);
+                    return get_object_address(metadata.datumPtr);
                 }
                 else if (relocationFn != nullptr)
                 {
-                    // use the pointer ID since it's more likely to be what's in the lookup map
-                    void* relocatedAddress = relocationFn(ptrID, metadata->parentAlloc);
+                    void* relocatedAddress = relocationFn(metadata.ID, metadata.parentAlloc);
                     if (relocatedAddress != nullptr)
                     {
                         resolve_address(relocatedAddress);
@@ -216,50 +244,33 @@ namespace foundation
             return get_mutable();
         }
 
-        const T* try_and_get() const
+        const T* try_and_get() const noexcept
         {
             return try_and_get_mutable();
         }
 
         bool valid() const noexcept
         {
-            using namespace fabric::detail;
+            return try_and_get_mutable() != nullptr;
+        }
+
+        // Raw ID this handle was created with. Only meaningful in the safety modes, since fast mode doesn't track IDs.
+        uint64_t id() const noexcept
+        {
             if constexpr (MemoryMode == memory_mode::fast)
             {
-                const fast_mode_metadata* metadata = reinterpret_cast<fast_mode_metadata*>(datumPtr);
-                const uint64_t handleValue = get_datum_value(metadata->datumPtr);
-                return handleValue != INVALID_HANDLE;
-            }
-            else if constexpr (MemoryMode == memory_mode::minimal_safety)
-            {
-                const minimal_safety_mode_metadata* metadata = reinterpret_cast<minimal_safety_mode_metadata*>(datumPtr);
-                const uint64_t ptrID = *reinterpret_cast<const uint64_t*>(metadata->datumPtr);
-                return ptrID == metadata->ID;
+                return metadata.datumPtr != nullptr ? get_datum_value(metadata.datumPtr) : detail::INVALID_HANDLE;
             }
-            else if constexpr (MemoryMode == memory_mode::full_safety)
+            else
             {
-                const full_safety_mode_metadata* metadata = reinterpret_cast<full_safety_mode_metadata*>(datumPtr);
-                const uint64_t ptrID = *reinterpret_cast<const uint64_t*>(metadata->datumPtr);
-                if (ptrID == metadata->ID)
-                {
-                    return true;                    
-                }
-                else if (relocationFn != nullptr)
-                {
-                    void* relocatedAddress = relocationFn(ptrID, metadata->parentAlloc);
-                    // (comma just makes sure we resolve the address before returning true, as it's now valid for sure!)
-                    relocatedAddress != nullptr ? resolve_address(relocatedAddress), true : false;
-                }
-                else
-                {
-                    return false;
-                }
+                return metadata.ID;
             }
         }
 
     private:
+        friend class object_pool<T, MemoryMode>;
 
-        constexpr static uint64_t get_datum_value(void* datum) noexcept
+        static uint64_t get_datum_value(const void* datum) noexcept
         {
             return *reinterpret_cast<const uint64_t*>(datum);
         }
@@ -267,22 +278,23 @@ namespace foundation
         // Allocation models for these handles MUST use the format of (uint64_t, object) when allocating
         // memory for our objects. safety_mode is per handle type, but the data storage for these objects
         // needs to still store both the handle and the pointer. this way
-        constexpr static T* get_object_address(void* handleAddr) noexcept
+        static T* get_object_address(void* handleAddr) noexcept
         {
-            return reinterpret_cast<T*>(handleAddr + sizeof(uint64_t));
+            return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(handleAddr) + sizeof(uint64_t));
         }
 
-        void resolve_address(void* relocated_address)
+        void resolve_address(void* relocated_address) const noexcept
         {
-            metadata->ID = *reinterpret_cast<const uint64_t*>(relocatedAddress);
-            metadata->datumPtr = relocatedAddress;
+            metadata.ID = get_datum_value(relocated_address);
+            metadata.datumPtr = relocated_address;
         }
 
         // this will be unique per instantiation of this class, so each type has it's own function
-        static relocation_lookup_fn_t relocationFn{ nullptr };
-        // Depending on mode, this points to various types. Marked mutable so const functions can just
-        // call non-consts that might do relocation in full_safety mode
-        mutable void* datumPtr;
+        inline static relocation_lookup_fn_t relocationFn{ nullptr };
+        // Handles carry their metadata by value, so each copy can be checked (and re-resolved after a
+        // relocation) independently. Marked mutable so const functions can just call non-consts that
+        // might do relocation in full_safety mode
+        mutable metadata_type metadata{};
     };
 
 }
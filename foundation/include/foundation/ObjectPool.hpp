@@ -0,0 +1,367 @@
+#pragma once
+#ifndef FOUNDATION_FABRIC_OBJECT_POOL_HPP
+#define FOUNDATION_FABRIC_OBJECT_POOL_HPP
+#include "Handle.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace foundation
+{
+
+    /*
+        Typed pool that backs object_handle. Objects are stored densely in a single fixed-capacity
+        block, using the (uint64_t ID, object) layout object_handle expects, so iterating over all
+        live objects is a linear walk over contiguous memory.
+
+        Behavior per memory_mode:
+        - fast: IDs are only used to mark slots as live or dead. No generation checks, no compaction.
+        - minimal_safety: IDs are (generation << 32 | stable index), so handles to destroyed objects
+          are detected instead of silently aliasing whatever reuses the slot.
+        - full_safety: as above, plus Compact() which relocates live objects into holes left by
+          destroyed ones. Handles aren't touched: they notice the ID mismatch at their old address,
+          then ask the pool (through the registered relocation function) where their object went.
+
+        Capacity is fixed at construction, as growing the block would invalidate every handle
+        in fast and minimal_safety modes.
+    */
+    template<typename T, memory_mode MemoryMode>
+    class object_pool
+    {
+    public:
+
+        using value_type = T;
+        using handle_type = object_handle<T, MemoryMode>;
+        using size_type = size_t;
+
+        static_assert(MemoryMode != memory_mode::invalid, "object_pool cannot be used with memory_mode::invalid!");
+        static_assert(alignof(T) <= alignof(uint64_t), "object_handle requires objects to directly follow their 64-bit ID!");
+        static_assert(MemoryMode != memory_mode::full_safety || std::is_nothrow_move_constructible_v<T>,
+            "Objects in a full_safety pool get relocated by Compact(), so they must be nothrow move-constructible!");
+
+        explicit object_pool(size_type capacity) : slotCapacity(capacity), slots(std::make_unique<slot_t[]>(capacity))
+        {
+            assert(capacity < static_cast<size_type>(invalidIndex));
+            freeSlots.reserve(capacity);
+            if constexpr (MemoryMode != memory_mode::fast)
+            {
+                // Generations start at 1, so a default-constructed handle (ID 0) never matches a live object
+                generations.resize(capacity, 1u);
+                stableToSlot.resize(capacity, invalidIndex);
+                freeStableIndices.reserve(capacity);
+                for (size_type i = capacity; i > 0u; --i)
+                {
+                    freeStableIndices.emplace_back(static_cast<uint32_t>(i - 1u));
+                }
+            }
+            if constexpr (MemoryMode == memory_mode::full_safety)
+            {
+                handle_type::SetRelocationFunction(&object_pool::relocation_lookup);
+            }
+        }
+
+        ~object_pool()
+        {
+            clear();
+        }
+
+        // Handles store the address of the pool, so it can't go anywhere
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+        object_pool(object_pool&&) = delete;
+        object_pool& operator=(object_pool&&) = delete;
+
+        template<typename...Args>
+        [[nodiscard]] handle_type create(Args&&...args)
+        {
+            const uint32_t slotIdx = acquire_slot();
+            slot_t& slot = slots[slotIdx];
+
+            try
+            {
+                ::new (static_cast<void*>(slot.storage)) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                release_slot(slotIdx);
+                throw;
+            }
+
+            uint64_t objectID = static_cast<uint64_t>(slotIdx);
+            if constexpr (MemoryMode != memory_mode::fast)
+            {
+                const uint32_t stableIdx = freeStableIndices.back();
+                freeStableIndices.pop_back();
+                stableToSlot[stableIdx] = slotIdx;
+                objectID = make_id(generations[stableIdx], stableIdx);
+            }
+
+            slot.id = objectID;
+            ++liveCount;
+
+            handle_type result;
+            result.metadata.datumPtr = &slot;
+            if constexpr (MemoryMode != memory_mode::fast)
+            {
+                result.metadata.ID = objectID;
+            }
+            if constexpr (MemoryMode == memory_mode::full_safety)
+            {
+                result.metadata.parentAlloc = this;
+            }
+            return result;
+        }
+
+        // Throws fabric_exception if the handle doesn't refer to a live object in this pool
+        void destroy(const handle_type& handle)
+        {
+            const uint32_t slotIdx = find_slot(handle);
+            if (slotIdx == invalidIndex)
+            {
+                throw fabric_exception(fabric_exception::type::PoolHandleNotOwned);
+            }
+
+            slot_t& slot = slots[slotIdx];
+            if constexpr (MemoryMode != memory_mode::fast)
+            {
+                const uint32_t stableIdx = get_stable_index(slot.id);
+                // Bumping the generation is what invalidates any handles still floating around
+                ++generations[stableIdx];
+                stableToSlot[stableIdx] = invalidIndex;
+                freeStableIndices.emplace_back(stableIdx);
+            }
+
+            object_at(slotIdx)->~T();
+            --liveCount;
+            release_slot(slotIdx);
+        }
+
+        // Moves live objects from the back of the block into holes left by destroyed objects, until
+        // every live object sits in [0, size()). Only available in full_safety mode, as it's the only
+        // mode where handles can find their object again after it has been moved.
+        void Compact() noexcept
+        {
+            static_assert(MemoryMode == memory_mode::full_safety, "Compact() requires memory_mode::full_safety!");
+
+            std::sort(freeSlots.begin(), freeSlots.end());
+            trim_high_water();
+
+            for (const uint32_t hole : freeSlots)
+            {
+                if (hole >= highWater)
+                {
+                    break;
+                }
+
+                relocate(highWater - 1u, hole);
+                --highWater;
+                trim_high_water();
+            }
+
+            freeSlots.clear();
+            assert(highWater == liveCount);
+        }
+
+        // Invokes fn(T&) on every live object, in storage order
+        template<typename Fn>
+        void for_each(Fn&& fn)
+        {
+            for (uint32_t i = 0u; i < highWater; ++i)
+            {
+                if (slots[i].id != detail::INVALID_HANDLE)
+                {
+                    fn(*object_at(i));
+                }
+            }
+        }
+
+        template<typename Fn>
+        void for_each(Fn&& fn) const
+        {
+            for (uint32_t i = 0u; i < highWater; ++i)
+            {
+                if (slots[i].id != detail::INVALID_HANDLE)
+                {
+                    fn(static_cast<const T&>(*object_at(i)));
+                }
+            }
+        }
+
+        void clear() noexcept
+        {
+            for (uint32_t i = 0u; i < highWater; ++i)
+            {
+                if (slots[i].id != detail::INVALID_HANDLE)
+                {
+                    if constexpr (MemoryMode != memory_mode::fast)
+                    {
+                        const uint32_t stableIdx = get_stable_index(slots[i].id);
+                        ++generations[stableIdx];
+                        stableToSlot[stableIdx] = invalidIndex;
+                        freeStableIndices.emplace_back(stableIdx);
+                    }
+                    object_at(i)->~T();
+                    slots[i].id = detail::INVALID_HANDLE;
+                }
+            }
+            highWater = 0u;
+            liveCount = 0u;
+            freeSlots.clear();
+        }
+
+        size_type size() const noexcept
+        {
+            return liveCount;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return slotCapacity;
+        }
+
+        bool empty() const noexcept
+        {
+            return liveCount == 0u;
+        }
+
+        // Number of destroyed slots interleaved with live objects: what Compact() would get rid of
+        size_type hole_count() const noexcept
+        {
+            return highWater - liveCount;
+        }
+
+    private:
+
+        struct slot_t
+        {
+            uint64_t id{ detail::INVALID_HANDLE };
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+        static_assert(offsetof(slot_t, storage) == sizeof(uint64_t), "object must directly follow its ID in a slot!");
+
+        constexpr static uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+        constexpr static uint64_t make_id(uint32_t generation, uint32_t stable_index) noexcept
+        {
+            return (static_cast<uint64_t>(generation) << 32u) | static_cast<uint64_t>(stable_index);
+        }
+
+        constexpr static uint32_t get_stable_index(uint64_t id) noexcept
+        {
+            return static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        }
+
+        constexpr static uint32_t get_generation(uint64_t id) noexcept
+        {
+            return static_cast<uint32_t>(id >> 32u);
+        }
+
+        T* object_at(uint32_t slot_idx) const noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(slots[slot_idx].storage));
+        }
+
+        uint32_t acquire_slot()
+        {
+            if (!freeSlots.empty())
+            {
+                const uint32_t result = freeSlots.back();
+                freeSlots.pop_back();
+                return result;
+            }
+            else if (highWater < slotCapacity)
+            {
+                return highWater++;
+            }
+            else
+            {
+                throw fabric_exception(fabric_exception::type::PoolCapacityExhausted);
+            }
+        }
+
+        void release_slot(uint32_t slot_idx) noexcept
+        {
+            slots[slot_idx].id = detail::INVALID_HANDLE;
+            freeSlots.emplace_back(slot_idx);
+        }
+
+        // Drops dead slots off the end of the used range. Only called from Compact(), which clears
+        // freeSlots afterwards so nothing can hand out a slot at or above highWater
+        void trim_high_water() noexcept
+        {
+            while (highWater > 0u && slots[highWater - 1u].id == detail::INVALID_HANDLE)
+            {
+                --highWater;
+            }
+        }
+
+        uint32_t find_slot_by_id(uint64_t id) const noexcept
+        {
+            const uint32_t stableIdx = get_stable_index(id);
+            if (stableIdx >= slotCapacity || generations[stableIdx] != get_generation(id))
+            {
+                return invalidIndex;
+            }
+            return stableToSlot[stableIdx];
+        }
+
+        uint32_t find_slot(const handle_type& handle) const noexcept
+        {
+            if constexpr (MemoryMode == memory_mode::fast)
+            {
+                const slot_t* slotPtr = static_cast<const slot_t*>(handle.metadata.datumPtr);
+                const slot_t* first = slots.get();
+                if (slotPtr < first || slotPtr >= first + highWater || slotPtr->id == detail::INVALID_HANDLE)
+                {
+                    return invalidIndex;
+                }
+                return static_cast<uint32_t>(slotPtr - first);
+            }
+            else
+            {
+                return find_slot_by_id(handle.metadata.ID);
+            }
+        }
+
+        void relocate(uint32_t src_idx, uint32_t dst_idx) noexcept
+        {
+            slot_t& src = slots[src_idx];
+            slot_t& dst = slots[dst_idx];
+            assert(src.id != detail::INVALID_HANDLE && dst.id == detail::INVALID_HANDLE);
+
+            ::new (static_cast<void*>(dst.storage)) T(std::move(*object_at(src_idx)));
+            object_at(src_idx)->~T();
+
+            dst.id = src.id;
+            src.id = detail::INVALID_HANDLE;
+            stableToSlot[get_stable_index(dst.id)] = dst_idx;
+        }
+
+        static void* relocation_lookup(uint64_t id, void* allocator) noexcept
+        {
+            const object_pool* pool = static_cast<const object_pool*>(allocator);
+            const uint32_t slotIdx = pool->find_slot_by_id(id);
+            return slotIdx != invalidIndex ? static_cast<void*>(&pool->slots[slotIdx]) : nullptr;
+        }
+
+        const size_type slotCapacity;
+        std::unique_ptr<slot_t[]> slots;
+        // Slots at or above highWater have never been used (or were trimmed off by Compact)
+        uint32_t highWater{ 0u };
+        size_type liveCount{ 0u };
+        std::vector<uint32_t> freeSlots;
+        // Safety modes only: stable indices are what IDs are built from, so that objects can move
+        // between slots without invalidating their handle's ID
+        std::vector<uint32_t> generations;
+        std::vector<uint32_t> stableToSlot;
+        std::vector<uint32_t> freeStableIndices;
+
+    };
+
+}
+
+#endif //!FOUNDATION_FABRIC_OBJECT_POOL_HPP
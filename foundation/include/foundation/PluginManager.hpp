@@ -2,8 +2,18 @@
 #ifndef PLUGIN_MANAGER_CORE_HPP
 #define PLUGIN_MANAGER_CORE_HPP
 #include <memory>
+#include <cstdint>
+#include <vector>
 
 struct PluginManagerImpl;
+class PluginUpdateScheduler;
+
+struct PluginUpdateTiming
+{
+    uint32_t PluginID;
+    double LogicalUpdateMs;
+    double TimeDependentUpdateMs;
+};
 
 class PluginManager {
 protected:
@@ -21,8 +31,31 @@ public:
     void* RetrieveBaseAPI(uint32_t id);
     void GetLoadedPlugins(uint32_t* num_plugins, uint32_t* plugin_ids) const;
 
+    // Starts watching loaded plugins for rebuilt binaries. A plugin is reloaded once its file has
+    // seen no changes for coalesce_window_ms. Returns false if unsupported on this platform.
+    bool EnableHotReload(uint32_t coalesce_window_ms = 150u);
+    // Call once per frame at a point where no plugin code is on the stack: reloads plugins whose
+    // binaries changed, handing state across with Plugin_API::BeginReload/FinishReload. Plugins lacking
+    // either hook are Unload()ed and then Load()ed fresh instead
+    void ProcessPendingReloads();
+
+    // Run every loaded plugin's update. Plugins whose declared dependencies (Plugin_API::UpdateDependencies)
+    // don't conflict run concurrently, the rest run in the order they were loaded.
+    void LogicalUpdate();
+    void TimeDependentUpdate(double dt);
+    // Defaults to hardware_concurrency - 1, as the calling thread also runs plugin updates. 0 runs them all serially.
+    void SetUpdateWorkerCount(uint32_t count);
+    // Per-plugin duration of the most recent LogicalUpdate and TimeDependentUpdate
+    void GetPluginUpdateTimings(uint32_t* num_timings, PluginUpdateTiming* timings) const;
+
 private:
+    void refreshUpdateScheduler();
+
     std::unique_ptr<PluginManagerImpl> impl;
+    std::unique_ptr<PluginUpdateScheduler> updateScheduler;
+    // PluginIDs in load order, which is the order conflicting updates run in
+    std::vector<uint32_t> registrationOrder;
+    bool updateSchedulerDirty{ true };
 };
 
 #endif // !PLUGIN_MANAGER_CORE_HPP
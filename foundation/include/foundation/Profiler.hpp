@@ -0,0 +1,124 @@
+#pragma once
+#ifndef FOUNDATION_PROFILER_HPP
+#define FOUNDATION_PROFILER_HPP
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/*
+    Lightweight CPU profiler. Zones are recorded as single complete events into a per-thread
+    single-producer ring, so recording a zone is two clock reads and one ring push: no locks, no
+    allocation. CollectProfilerEvents() drains every thread's ring into a shared store (call it once
+    a frame or so, so rings don't fill up and drop events: RenderingContext::Update() does), and WriteProfilerChromeTrace() writes
+    that store out as Chrome trace event JSON, viewable in chrome://tracing or Perfetto.
+
+    Each thread's ring is set up when it registers (RegisterProfilerThread(), or naming the thread),
+    which is the only point that allocates. Threads that record without registering claim one of the
+    spare rings set aside with ReserveProfilerThreadBuffers(), and drop their events if none are left.
+    When a thread exits, its ring is drained by the next collection and then kept as a spare or freed.
+
+    Names passed to zones and counters are stored as pointers, so they must outlive the profiler
+    data: string literals, in practice. Use the zone argument for anything dynamic (like IDs).
+
+    The FOUNDATION_PROFILE_* macros compile to nothing unless the FOUNDATION_PROFILER_ENABLED CMake
+    option is set, which defines FOUNDATION_PROFILER_ENABLED_CONF. When compiled in, recording can
+    also be toggled at runtime with SetProfilerEnabled().
+*/
+namespace foundation
+{
+
+    enum class profiler_event_type : uint32_t
+    {
+        Zone = 0,
+        Counter = 1
+    };
+
+    struct profiler_event
+    {
+        const char* name;
+        uint64_t timestampNs;
+        // Zone duration in nanoseconds, or counter value (stored as the bits of a double)
+        uint64_t payload;
+        uint32_t argument;
+        profiler_event_type type;
+    };
+
+    // Events each thread can buffer between calls to CollectProfilerEvents()
+    constexpr size_t ProfilerThreadRingCapacity = 8192u;
+    // The shared store keeps this many of the most recent events, so collecting every frame stays bounded
+    constexpr size_t ProfilerMaxCollectedEvents = 1u << 20u;
+
+    void SetProfilerEnabled(bool enabled) noexcept;
+    [[nodiscard]] bool IsProfilerEnabled() noexcept;
+    // Sets up the calling thread's ring ahead of its first event
+    void RegisterProfilerThread();
+    // Registers the calling thread too. Shows up as the track name in exported traces. Copied, so any string is fine here.
+    void SetProfilerThreadName(const char* name);
+    // Keeps count spare rings around for threads that record without registering first
+    void ReserveProfilerThreadBuffers(size_t count);
+
+    void RecordProfilerZone(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t argument) noexcept;
+    void RecordProfilerCounter(const char* name, double value) noexcept;
+
+    // Moves events from every thread's ring into the shared store
+    void CollectProfilerEvents();
+    void ClearProfilerEvents();
+    // Collects, then writes everything in the shared store as Chrome trace JSON. Returns false if the file couldn't be opened.
+    bool WriteProfilerChromeTrace(const char* output_file);
+    // Events lost because a thread's ring was full, or it had no ring at all
+    [[nodiscard]] uint64_t GetProfilerDroppedEventCount() noexcept;
+
+    namespace detail
+    {
+        extern std::atomic<bool> profilerEnabled;
+
+        inline uint64_t profiler_now_ns() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
+    struct profiler_zone
+    {
+        profiler_zone(const char* _name, uint32_t _argument = 0u) noexcept : name(_name), argument(_argument),
+            startNs(detail::profilerEnabled.load(std::memory_order_relaxed) ? detail::profiler_now_ns() : 0u)
+        {
+        }
+
+        ~profiler_zone()
+        {
+            if (startNs != 0u)
+            {
+                RecordProfilerZone(name, startNs, detail::profiler_now_ns(), argument);
+            }
+        }
+
+        profiler_zone(const profiler_zone&) = delete;
+        profiler_zone& operator=(const profiler_zone&) = delete;
+
+    private:
+        const char* name;
+        uint32_t argument;
+        uint64_t startNs;
+    };
+
+}
+
+#define FOUNDATION_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FOUNDATION_PROFILE_CONCAT(a, b) FOUNDATION_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef FOUNDATION_PROFILER_ENABLED_CONF
+#define FOUNDATION_PROFILE_ZONE(name) foundation::profiler_zone FOUNDATION_PROFILE_CONCAT(profilerZone, __LINE__)(name)
+#define FOUNDATION_PROFILE_ZONE_ARG(name, argument) foundation::profiler_zone FOUNDATION_PROFILE_CONCAT(profilerZone, __LINE__)(name, argument)
+#define FOUNDATION_PROFILE_COUNTER(name, value) foundation::RecordProfilerCounter(name, static_cast<double>(value))
+#define FOUNDATION_PROFILE_THREAD_NAME(name) foundation::SetProfilerThreadName(name)
+#else
+#define FOUNDATION_PROFILE_ZONE(name) ((void)0)
+#define FOUNDATION_PROFILE_ZONE_ARG(name, argument) ((void)0)
+#define FOUNDATION_PROFILE_COUNTER(name, value) ((void)0)
+#define FOUNDATION_PROFILE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif //!FOUNDATION_PROFILER_HPP
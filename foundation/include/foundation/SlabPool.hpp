@@ -0,0 +1,149 @@
+#pragma once
+#ifndef FOUNDATION_SLAB_POOL_HPP
+#define FOUNDATION_SLAB_POOL_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace foundation
+{
+
+    /*
+        Pool of fixed-size blocks, for objects created and destroyed at high rates from many threads.
+
+        Each thread keeps two magazines (small stacks of free blocks) per pool, so almost every
+        allocate/deallocate is a push or pop on thread-local memory. Only when both are exhausted (or
+        full) does a thread swap a magazine with the global depot, which is a pair of lock-free stacks
+        of full and empty magazines. Blocks freed on another thread than they were allocated on just
+        flow back through that thread's magazines.
+
+        Memory is carved out in slabs and only returned when the pool is destroyed. Magazines are never
+        freed either, and are addressed by index, so the depot stacks can use an index + tag head to
+        avoid ABA without 128-bit CAS.
+    */
+    class slab_pool
+    {
+    public:
+
+        static constexpr uint32_t MagazineCapacity = 32u;
+
+        struct stats_t
+        {
+            size_t blockSize{ 0u };
+            size_t slabCount{ 0u };
+            size_t bytesReserved{ 0u };
+            size_t magazineCount{ 0u };
+        };
+
+        explicit slab_pool(size_t block_size, size_t block_alignment = alignof(std::max_align_t), size_t blocks_per_slab = 256u);
+        ~slab_pool();
+        slab_pool(const slab_pool&) = delete;
+        slab_pool& operator=(const slab_pool&) = delete;
+
+        [[nodiscard]] void* allocate();
+        void deallocate(void* ptr) noexcept;
+
+        size_t block_size() const noexcept;
+        stats_t stats() const noexcept;
+
+        struct magazine_t;
+        struct thread_cache_t;
+
+    private:
+
+        friend struct thread_cache_t;
+
+        magazine_t* getMagazine(uint32_t idx) const noexcept;
+        uint32_t createMagazine();
+        void pushMagazine(std::atomic<uint64_t>& stack, uint32_t idx) noexcept;
+        uint32_t popMagazine(std::atomic<uint64_t>& stack) noexcept;
+        uint32_t allocateSlab();
+        thread_cache_t* localCache() noexcept;
+        void flushCache(thread_cache_t& cache) noexcept;
+
+        const size_t blockSize;
+        const size_t blockAlignment;
+        const size_t blocksPerSlab;
+        const uint64_t poolID;
+
+        // Depot stacks: (tag << 32) | (magazine index + 1), 0 when empty
+        alignas(64) std::atomic<uint64_t> fullMagazines{ 0u };
+        alignas(64) std::atomic<uint64_t> emptyMagazines{ 0u };
+
+        static constexpr uint32_t MagazinesPerSegment = 64u;
+        static constexpr uint32_t MaxMagazineSegments = 1024u;
+        alignas(64) std::atomic<uint32_t> magazineCount{ 0u };
+        std::atomic<magazine_t*> magazineSegments[MaxMagazineSegments]{};
+
+        struct slab_header_t;
+        std::atomic<slab_header_t*> slabs{ nullptr };
+        std::atomic<size_t> slabCount{ 0u };
+    };
+
+    // Shared pools for small fixed sizes, used by slab_allocator. Returns nullptr for sizes too
+    // large for any size class, in which case callers should use the general-purpose allocator.
+    [[nodiscard]] slab_pool* GetSlabPoolForSize(size_t size, size_t alignment) noexcept;
+
+    /*
+        Stateless STL allocator over the shared size-class slab pools. Single-object allocations that
+        fit a size class come from a slab pool, anything else falls through to operator new. Meant for
+        std::allocate_shared: it rebinds to the combined control block + object type, so both come
+        from a single pool block.
+    */
+    template<typename T>
+    struct slab_allocator
+    {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = slab_allocator<U>;
+        };
+
+        slab_allocator() noexcept = default;
+        template<typename U>
+        slab_allocator(const slab_allocator<U>&) noexcept {}
+
+        [[nodiscard]] T* allocate(size_t n)
+        {
+            if (n == 1u)
+            {
+                if (slab_pool* pool = GetSlabPoolForSize(sizeof(T), alignof(T)))
+                {
+                    return static_cast<T*>(pool->allocate());
+                }
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept
+        {
+            if (n == 1u)
+            {
+                if (slab_pool* pool = GetSlabPoolForSize(sizeof(T), alignof(T)))
+                {
+                    pool->deallocate(ptr);
+                    return;
+                }
+            }
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        }
+
+        template<typename U>
+        bool operator==(const slab_allocator<U>&) const noexcept
+        {
+            return true;
+        }
+
+        template<typename U>
+        bool operator!=(const slab_allocator<U>&) const noexcept
+        {
+            return false;
+        }
+    };
+
+}
+
+#endif //!FOUNDATION_SLAB_POOL_HPP
@@ -0,0 +1,125 @@
+#pragma once
+#ifndef FOUNDATION_MATH_BOUNDS_KERNELS_HPP
+#define FOUNDATION_MATH_BOUNDS_KERNELS_HPP
+#include <cstddef>
+#include <cstdint>
+
+/*
+    Batched culling and bounds kernels over structure-of-arrays data: each component (minX, minY, ...)
+    is its own array, so one SIMD register holds the same component of 4 or 8 boxes and every plane
+    test is straight-line math with no shuffles.
+
+    The best implementation for the running CPU is picked on first use (AVX2 if available, else SSE
+    on x86-64 or NEON on arm64). Every implementation does the exact same float operations in the
+    same order as the scalar reference, so results are bit-identical across levels: the scalar table
+    can be fetched with GetBoundsKernelTable(simd_level::Scalar) to verify against.
+
+    Matrices are 16 floats, column-major (glm's layout): m[12], m[13], m[14] is the translation.
+    Frustum planes are (n, d) with n pointing inwards: a point p is inside when dot(n, p) + d >= 0.
+*/
+namespace foundation
+{
+
+    enum class simd_level : uint32_t
+    {
+        Scalar = 0,
+        SSE = 1,
+        AVX2 = 2,
+        NEON = 3,
+        // Whatever's fastest on this CPU
+        Best = 0xFFFFFFFF
+    };
+
+    struct frustum_planes
+    {
+        float nx[6];
+        float ny[6];
+        float nz[6];
+        float d[6];
+    };
+
+    struct aabb_soa_view
+    {
+        const float* minX{ nullptr };
+        const float* minY{ nullptr };
+        const float* minZ{ nullptr };
+        const float* maxX{ nullptr };
+        const float* maxY{ nullptr };
+        const float* maxZ{ nullptr };
+        size_t count{ 0u };
+    };
+
+    struct aabb_soa_output
+    {
+        float* minX{ nullptr };
+        float* minY{ nullptr };
+        float* minZ{ nullptr };
+        float* maxX{ nullptr };
+        float* maxY{ nullptr };
+        float* maxZ{ nullptr };
+    };
+
+    struct sphere_soa_view
+    {
+        const float* x{ nullptr };
+        const float* y{ nullptr };
+        const float* z{ nullptr };
+        const float* radius{ nullptr };
+        size_t count{ 0u };
+    };
+
+    struct point_soa_view
+    {
+        const float* x{ nullptr };
+        const float* y{ nullptr };
+        const float* z{ nullptr };
+        size_t count{ 0u };
+    };
+
+    struct point_soa_output
+    {
+        float* x{ nullptr };
+        float* y{ nullptr };
+        float* z{ nullptr };
+    };
+
+    // Single merged box. Default is "empty": merging anything into it gives that thing back.
+    struct aabb_bounds
+    {
+        float min[3]{ 3.402823466e+38f, 3.402823466e+38f, 3.402823466e+38f };
+        float max[3]{ -3.402823466e+38f, -3.402823466e+38f, -3.402823466e+38f };
+    };
+
+    struct bounds_kernel_table
+    {
+        simd_level level;
+        // Writes 1 to visible[i] if box i is at least partially inside, 0 otherwise. Returns the number visible.
+        size_t(*cullAABBs)(const frustum_planes& planes, const aabb_soa_view& boxes, uint8_t* visible);
+        size_t(*cullSpheres)(const frustum_planes& planes, const sphere_soa_view& spheres, uint8_t* visible);
+        // Transforms by the affine part of the matrix (w = 1, no perspective divide). Output may alias input.
+        void(*transformPoints)(const float* matrix, const point_soa_view& points, const point_soa_output& result);
+        // Tightest box around each transformed box (Arvo's method). Output may alias input.
+        void(*transformAABBs)(const float* matrix, const aabb_soa_view& boxes, const aabb_soa_output& result);
+        // result[i] = union of a[i] and b[i]. Counts must match. Output may alias either input.
+        void(*mergeAABBs)(const aabb_soa_view& a, const aabb_soa_view& b, const aabb_soa_output& result);
+        aabb_bounds(*reduceAABBs)(const aabb_soa_view& boxes);
+    };
+
+    // Levels the CPU can't run fall back to the best one it can
+    [[nodiscard]] const bounds_kernel_table& GetBoundsKernelTable(simd_level level = simd_level::Best) noexcept;
+    [[nodiscard]] simd_level GetBestSimdLevel() noexcept;
+    [[nodiscard]] const char* GetSimdLevelName(simd_level level) noexcept;
+
+    // Extracts normalized planes from a column-major view-projection matrix (Gribb/Hartmann), for [0, 1] clip space depth
+    [[nodiscard]] frustum_planes FrustumPlanesFromMatrix(const float* view_projection) noexcept;
+
+    size_t CullAABBs(const frustum_planes& planes, const aabb_soa_view& boxes, uint8_t* visible);
+    size_t CullSpheres(const frustum_planes& planes, const sphere_soa_view& spheres, uint8_t* visible);
+    void TransformPoints(const float* matrix, const point_soa_view& points, const point_soa_output& result);
+    void TransformAABBs(const float* matrix, const aabb_soa_view& boxes, const aabb_soa_output& result);
+    void MergeAABBs(const aabb_soa_view& a, const aabb_soa_view& b, const aabb_soa_output& result);
+    [[nodiscard]] aabb_bounds ReduceAABBs(const aabb_soa_view& boxes);
+
+}
+
+#endif //!FOUNDATION_MATH_BOUNDS_KERNELS_HPP
@@ -1,14 +1,103 @@
 #pragma once
 #ifndef MEMORY_ALLOCATION_REACTOR_HPP
 #define MEMORY_ALLOCATION_REACTOR_HPP
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
 namespace reactors
 {
 
+    // Each subsystem gets its own set of mimalloc heaps (one per thread that allocates from it, since
+    // mimalloc heaps are owned by the thread that made them), so memory use can be attributed to it
+    enum class AllocationSubsystem : uint32_t
+    {
+        Resource = 0,
+        Content = 1,
+        Terrain = 2,
+        Render = 3,
+        Count
+    };
+
+    struct AllocationSubsystemStats
+    {
+        const char* name{ nullptr };
+        size_t bytesInUse{ 0u };
+        size_t peakBytesInUse{ 0u };
+        size_t totalAllocations{ 0u };
+        size_t totalFrees{ 0u };
+    };
+
+    struct FrameArenaStats
+    {
+        size_t bytesUsedThisFrame{ 0u };
+        size_t bytesReserved{ 0u };
+        size_t blockCount{ 0u };
+    };
 
     bool InitializeAllocationSubsystems();
     void ResetAllocationSubsystems();
 
+    [[nodiscard]] void* SubsystemAllocate(AllocationSubsystem subsystem, size_t size, size_t alignment = alignof(std::max_align_t));
+    // Memory can be freed from any thread, not just the one that allocated it
+    void SubsystemFree(AllocationSubsystem subsystem, void* ptr) noexcept;
+    [[nodiscard]] AllocationSubsystemStats GetAllocationSubsystemStats(AllocationSubsystem subsystem) noexcept;
+    [[nodiscard]] const char* GetAllocationSubsystemName(AllocationSubsystem subsystem) noexcept;
+
+    // Allocates from the calling thread's frame arena. Memory is valid until the next AdvanceFrame(),
+    // and is never freed individually. Destructors are NOT run: only use for trivially destructible data.
+    [[nodiscard]] void* FrameAllocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    // Marks a frame boundary. Each thread's arena notices the new frame index on its next allocation
+    // and rewinds to the start of its first block, so this is O(1) regardless of thread count.
+    // RenderingContext::Update() calls this every frame: applications driving frames some other way must call it themselves.
+    void AdvanceFrame() noexcept;
+    [[nodiscard]] uint64_t GetCurrentFrameIndex() noexcept;
+    // Stats for the calling thread's frame arena
+    [[nodiscard]] FrameArenaStats GetFrameArenaStats() noexcept;
+
+    // STL-compatible allocator routing container storage into a subsystem heap
+    template<typename T, AllocationSubsystem Subsystem>
+    struct subsystem_allocator
+    {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = subsystem_allocator<U, Subsystem>;
+        };
+
+        subsystem_allocator() noexcept = default;
+        template<typename U>
+        subsystem_allocator(const subsystem_allocator<U, Subsystem>&) noexcept {}
+
+        [[nodiscard]] T* allocate(size_t n)
+        {
+            void* result = SubsystemAllocate(Subsystem, n * sizeof(T), alignof(T));
+            if (result == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(result);
+        }
+
+        void deallocate(T* ptr, size_t) noexcept
+        {
+            SubsystemFree(Subsystem, ptr);
+        }
+
+        template<typename U>
+        bool operator==(const subsystem_allocator<U, Subsystem>&) const noexcept
+        {
+            return true;
+        }
+
+        template<typename U>
+        bool operator!=(const subsystem_allocator<U, Subsystem>&) const noexcept
+        {
+            return false;
+        }
+    };
 
 }
 
@@ -0,0 +1,95 @@
+#pragma once
+#ifndef FOUNDATION_THREADING_HYBRID_WAITER_HPP
+#define FOUNDATION_THREADING_HYBRID_WAITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace foundation
+{
+    /**
+     * Tuning for a HybridWaiter. Each worker loop has different latency needs, so each call site
+     * is expected to fill one of these in rather than rely on the defaults.
+     */
+    struct HybridWaiterConfig
+    {
+        // Upper bound on the pause/yield spin phase. The spin actually used adapts to recent wait times.
+        std::chrono::microseconds maxSpinDuration{ 50 };
+        // Bounds of the blocking phase, which backs off between these when no work shows up
+        std::chrono::microseconds minSleepDuration{ 100 };
+        std::chrono::microseconds maxSleepDuration{ 10000 };
+        float backoffMultiplier{ 2.0f };
+    };
+
+    /**
+     * Waits for work in three phases: spinning on a pause instruction, then yielding, then blocking
+     * with microsecond timeouts (futex on Linux, WaitOnAddress on Windows, which rounds up to whole
+     * milliseconds). Producers call notify() after publishing work, which ends any phase immediately,
+     * so the timeout only bounds how late a missed wakeup can be.
+     *
+     * Keeps a running average of how long notified waits took: when work usually arrives within the
+     * spin window we spin for about that long, and when it doesn't we skip most of the spinning.
+     *
+     * Use prepareWait() before checking for work, and pass the token to wait(), so a notify() landing
+     * between the check and the wait isn't lost.
+     */
+    class HybridWaiter
+    {
+    public:
+
+        explicit HybridWaiter(const HybridWaiterConfig& config = HybridWaiterConfig{}) noexcept;
+        ~HybridWaiter() noexcept = default;
+
+        HybridWaiter(const HybridWaiter&) = delete;
+        HybridWaiter& operator=(const HybridWaiter&) = delete;
+
+        /**
+         * Returns a token representing the current notification count.
+         */
+        uint32_t prepareWait() const noexcept;
+
+        /**
+         * Waits until notify() is called after token was taken, or the current sleep duration elapses.
+         * Must only be called from one thread at a time.
+         *
+         * @return true if woken by notify(), false on timeout
+         */
+        bool wait(uint32_t token) noexcept;
+
+        /**
+         * Wakes the waiting thread, if any. Safe to call from any thread.
+         */
+        void notify() noexcept;
+
+        /**
+         * Resets the blocking timeout to the minimum. Call this when work has been done.
+         */
+        void reset() noexcept;
+
+        /**
+         * Increases the blocking timeout. Call this when no work was done.
+         */
+        void backoff() noexcept;
+
+        std::chrono::microseconds getCurrentDuration() const noexcept;
+        std::chrono::microseconds getAverageWaitDuration() const noexcept;
+
+    private:
+
+        std::chrono::nanoseconds spinBudget() const noexcept;
+        void recordWait(std::chrono::nanoseconds duration) noexcept;
+
+        HybridWaiterConfig config;
+        std::chrono::microseconds currentSleepDuration;
+        // Exponentially weighted average of recent wait durations, in nanoseconds
+        int64_t averageWaitNs;
+
+        // Producers bump this and wake the waiter if it's blocked
+        alignas(64) std::atomic<uint32_t> notifyEpoch{ 0u };
+        std::atomic<uint32_t> sleepingWaiters{ 0u };
+    };
+
+} // namespace foundation
+
+#endif // FOUNDATION_THREADING_HYBRID_WAITER_HPP
@@ -1,6 +1,7 @@
 #pragma once
 #ifndef FOUNDATION_THREADING_CRITICAL_SECTION_HPP
 #define FOUNDATION_THREADING_CRITICAL_SECTION_HPP
+#include <cstddef>
 
 struct critical_section
 {
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef FOUNDATION_THREADING_EPOCH_RECLAMATION_HPP
+#define FOUNDATION_THREADING_EPOCH_RECLAMATION_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+    Safe memory reclamation for lock-free structures: nodes unlinked by one thread can't be freed while
+    other threads might still be reading them, so they're retire()'d instead and freed later.
+
+    The default scheme is epoch based. Readers enter a critical region (epoch_guard) around any access to
+    shared nodes, which is a single store in the common case. A retired node is freed once the global
+    epoch has advanced twice past the epoch it was retired in, which can only happen after every reader
+    that could have seen it has left its critical region. Freeing happens in batches, amortizing the scan
+    of all registered threads.
+
+    A reader that holds one node for a long time (or blocks while holding it) would stop the epoch from
+    advancing, and with it all reclamation. Those readers should use a hazard_pointer instead of an
+    epoch_guard: a hazard pointer protects exactly one node, and never holds up the epoch. Retired nodes
+    are only freed once they are both epoch-safe and not protected by any hazard pointer.
+
+    Threads register themselves on first use, and unregister when they exit. Explicit registration is
+    only needed to control when the per-thread record gets set up or torn down.
+*/
+namespace foundation
+{
+
+    using retire_deleter_fn = void(*)(void* ptr);
+
+    // Number of hazard pointers a single thread can hold at once
+    constexpr size_t MaxHazardPointersPerThread = 4u;
+    // Each thread attempts to reclaim once it has this many retired nodes pending
+    constexpr size_t ReclamationBatchSize = 64u;
+
+    void RegisterReclamationThread();
+    // Pending retired nodes are handed off to be freed by another thread later
+    void UnregisterReclamationThread();
+
+    // Node must already be unreachable for new readers. deleter is called once it's safe to free.
+    void Retire(void* ptr, retire_deleter_fn deleter);
+
+    template<typename T>
+    void Retire(T* ptr)
+    {
+        Retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // Attempts to advance the global epoch and free everything the calling thread has retired that is
+    // now safe to free. Called automatically from Retire() every ReclamationBatchSize nodes.
+    void ReclaimRetired();
+    // Keeps reclaiming until everything the calling thread has retired, along with anything left behind
+    // by exited threads, has been freed. Nodes are still only freed once every thread has moved past the
+    // epoch they were retired in and no hazard pointer protects them, so this blocks for as long as any
+    // reader stays in an epoch_guard. Nodes pending on other live threads are left to those threads.
+    // Must not be called from inside an epoch_guard, or while this thread holds a hazard pointer to a
+    // retired node.
+    void DrainRetired();
+
+    [[nodiscard]] uint64_t GetGlobalEpoch() noexcept;
+    // Retired but not yet freed by the calling thread
+    [[nodiscard]] size_t GetPendingRetiredCount() noexcept;
+
+    // Marks the calling thread as reading shared nodes. Guards can be nested.
+    struct epoch_guard
+    {
+        epoch_guard() noexcept;
+        ~epoch_guard();
+        epoch_guard(const epoch_guard&) = delete;
+        epoch_guard& operator=(const epoch_guard&) = delete;
+    };
+
+    namespace detail
+    {
+        std::atomic<void*>* AcquireHazardSlot();
+        void ReleaseHazardSlot(std::atomic<void*>* slot) noexcept;
+    }
+
+    // Protects a single node from reclamation, for long-lived references. Holds one of the calling
+    // thread's MaxHazardPointersPerThread slots until destroyed.
+    template<typename T>
+    class hazard_pointer
+    {
+    public:
+
+        hazard_pointer() : slot(detail::AcquireHazardSlot()) {}
+
+        ~hazard_pointer()
+        {
+            detail::ReleaseHazardSlot(slot);
+        }
+
+        hazard_pointer(const hazard_pointer&) = delete;
+        hazard_pointer& operator=(const hazard_pointer&) = delete;
+
+        // Loads src and protects the result. Once this returns the node stays valid until reset(),
+        // another protect(), or destruction, even if it gets retired in the meantime.
+        T* protect(const std::atomic<T*>& src) noexcept
+        {
+            T* ptr = src.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                slot->store(ptr, std::memory_order_seq_cst);
+                // Re-check after publishing: if src still holds ptr, it can't have been retired before
+                // the hazard became visible, so the reclaiming thread is guaranteed to see it
+                T* current = src.load(std::memory_order_seq_cst);
+                if (current == ptr)
+                {
+                    return ptr;
+                }
+                ptr = current;
+            }
+        }
+
+        void reset() noexcept
+        {
+            slot->store(nullptr, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<void*>* slot;
+    };
+
+}
+
+#endif //!FOUNDATION_THREADING_EPOCH_RECLAMATION_HPP
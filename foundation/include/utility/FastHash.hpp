@@ -0,0 +1,196 @@
+#pragma once
+#ifndef DIAMOND_DOGS_FAST_HASH_HPP
+#define DIAMOND_DOGS_FAST_HASH_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <functional>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+    Small-key oriented bytes hash, following the construction of wyhash (https://github.com/wangyi-fudan/wyhash,
+    public domain). Unlike MurmurHash.hpp this lives entirely in the header, since it's intended for hash table
+    lookups on short strings where the call overhead would be a measurable chunk of the cost.
+*/
+namespace foundation
+{
+
+    namespace detail
+    {
+
+        constexpr uint64_t fastHashSecret[4] =
+        {
+            0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+        };
+
+        inline void fast_hash_mum(uint64_t& a, uint64_t& b) noexcept
+        {
+#if defined(_MSC_VER) && defined(_M_X64)
+            a = _umul128(a, b, &b);
+#elif defined(__SIZEOF_INT128__)
+            const __uint128_t r = static_cast<__uint128_t>(a) * b;
+            a = static_cast<uint64_t>(r);
+            b = static_cast<uint64_t>(r >> 64u);
+#else
+            const uint64_t ha = a >> 32u, hb = b >> 32u, la = uint32_t(a), lb = uint32_t(b);
+            const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32u);
+            uint64_t lo = t + (rm1 << 32u);
+            const uint64_t c = (t < rl) + (lo < t);
+            const uint64_t hi = rh + (rm0 >> 32u) + (rm1 >> 32u) + c;
+            a = lo;
+            b = hi;
+#endif
+        }
+
+        inline uint64_t fast_hash_mix(uint64_t a, uint64_t b) noexcept
+        {
+            fast_hash_mum(a, b);
+            return a ^ b;
+        }
+
+        inline uint64_t fast_hash_read8(const uint8_t* p) noexcept
+        {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t fast_hash_read4(const uint8_t* p) noexcept
+        {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t fast_hash_read3(const uint8_t* p, size_t k) noexcept
+        {
+            return (uint64_t(p[0]) << 16u) | (uint64_t(p[k >> 1u]) << 8u) | p[k - 1u];
+        }
+
+    }
+
+    [[nodiscard]] inline uint64_t FastHash(const void* key, size_t len, uint64_t seed = 0u) noexcept
+    {
+        using namespace detail;
+        const uint8_t* p = static_cast<const uint8_t*>(key);
+        seed ^= fast_hash_mix(seed ^ fastHashSecret[0], fastHashSecret[1]);
+        uint64_t a;
+        uint64_t b;
+
+        if (len <= 16u)
+        {
+            if (len >= 4u)
+            {
+                a = (fast_hash_read4(p) << 32u) | fast_hash_read4(p + ((len >> 3u) << 2u));
+                b = (fast_hash_read4(p + len - 4u) << 32u) | fast_hash_read4(p + len - 4u - ((len >> 3u) << 2u));
+            }
+            else if (len > 0u)
+            {
+                a = fast_hash_read3(p, len);
+                b = 0u;
+            }
+            else
+            {
+                a = 0u;
+                b = 0u;
+            }
+        }
+        else
+        {
+            size_t i = len;
+            if (i > 48u)
+            {
+                uint64_t see1 = seed;
+                uint64_t see2 = seed;
+                do
+                {
+                    seed = fast_hash_mix(fast_hash_read8(p) ^ fastHashSecret[1], fast_hash_read8(p + 8u) ^ seed);
+                    see1 = fast_hash_mix(fast_hash_read8(p + 16u) ^ fastHashSecret[2], fast_hash_read8(p + 24u) ^ see1);
+                    see2 = fast_hash_mix(fast_hash_read8(p + 32u) ^ fastHashSecret[3], fast_hash_read8(p + 40u) ^ see2);
+                    p += 48u;
+                    i -= 48u;
+                }
+                while (i > 48u);
+                seed ^= see1 ^ see2;
+            }
+
+            while (i > 16u)
+            {
+                seed = fast_hash_mix(fast_hash_read8(p) ^ fastHashSecret[1], fast_hash_read8(p + 8u) ^ seed);
+                i -= 16u;
+                p += 16u;
+            }
+
+            a = fast_hash_read8(p + i - 16u);
+            b = fast_hash_read8(p + i - 8u);
+        }
+
+        a ^= fastHashSecret[1];
+        b ^= seed;
+        fast_hash_mum(a, b);
+        return fast_hash_mix(a ^ fastHashSecret[0] ^ len, b ^ fastHashSecret[1]);
+    }
+
+    // Mixes an already-integral value, so that identity std::hash results spread across all 64 bits
+    [[nodiscard]] inline uint64_t FastHashMix(uint64_t value) noexcept
+    {
+        return detail::fast_hash_mix(value ^ detail::fastHashSecret[0], detail::fastHashSecret[1]);
+    }
+
+    // Transparent string hasher: std::string, std::string_view and const char* all hash identically,
+    // so string-keyed tables can be probed with a string_view without building a temporary string
+    struct string_hash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view str) const noexcept
+        {
+            return static_cast<size_t>(FastHash(str.data(), str.size()));
+        }
+
+        size_t operator()(const std::string& str) const noexcept
+        {
+            return static_cast<size_t>(FastHash(str.data(), str.size()));
+        }
+
+        size_t operator()(const char* str) const noexcept
+        {
+            return static_cast<size_t>(FastHash(str, std::strlen(str)));
+        }
+    };
+
+    // Default hasher for foundation's hash containers
+    template<typename T>
+    struct fast_hash
+    {
+        size_t operator()(const T& value) const noexcept
+        {
+            if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+            {
+                return static_cast<size_t>(FastHashMix(static_cast<uint64_t>(value)));
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+                return static_cast<size_t>(FastHashMix(reinterpret_cast<uintptr_t>(value)));
+            }
+            else
+            {
+                return static_cast<size_t>(FastHashMix(static_cast<uint64_t>(std::hash<T>{}(value))));
+            }
+        }
+    };
+
+    template<>
+    struct fast_hash<std::string> : string_hash {};
+
+    template<>
+    struct fast_hash<std::string_view> : string_hash {};
+
+}
+
+#endif //!DIAMOND_DOGS_FAST_HASH_HPP
@@ -2,36 +2,65 @@
 #ifndef DIAMOND_DOGS_MULTICAST_DELEGATE_HPP
 #define DIAMOND_DOGS_MULTICAST_DELEGATE_HPP
 #include "delegate.hpp"
-#include <vector>
-#include <functional>
-#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
+/*
+    Invocation elements are stored by value in one contiguous, immutable snapshot. Broadcasting is a
+    linear walk over that block instead of chasing a unique_ptr per subscriber.
+
+    Subscribing/unsubscribing builds a new snapshot and publishes it with a CAS, so it can happen
+    from any thread while other threads are broadcasting, without locks. Replaced snapshots are
+    retired, and only freed once nothing is reading them: broadcasts and writers copying the current
+    snapshot both bump activeReaders, and a writer only frees the retired chain it grabbed after
+    seeing that count at zero.
+
+    Snapshots of up to inlineSnapshotCapacity subscribers live in small buffers inside the delegate
+    itself, so the common case of a handful of subscribers never touches the heap. There are two of
+    them, as a change needs a free buffer while the current snapshot still occupies the other. When
+    neither is free (the old one is still retired, waiting for readers) the snapshot goes on the heap.
+*/
 template<typename Result, typename...Args>
 class multicast_delegate_t<Result(Args...)> final : private base_delegate_t<Result(Args...)>
 {
+    using invocation_element_t = typename base_delegate_t<Result(Args...)>::invocation_element_t;
 public:
 
-    multicast_delegate_t() {}
-    ~multicast_delegate_t() {}
+    multicast_delegate_t() noexcept = default;
+
+    ~multicast_delegate_t()
+    {
+        free_snapshot(current.load(std::memory_order_acquire));
+        free_retired_chain(retired.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    constexpr static size_t inlineSnapshotCapacity = 4u;
+
+    multicast_delegate_t(const multicast_delegate_t&) = delete;
+    multicast_delegate_t& operator=(const multicast_delegate_t&) = delete;
 
     bool empty() const noexcept
     {
-        return invocationVector.empty();
+        return current.load(std::memory_order_acquire) == nullptr;
     }
 
     bool operator==(void* ptr) const noexcept
     {
-        return (ptr == nullptr) && invocationVector.empty();
+        return (ptr == nullptr) && empty();
     }
 
     bool operator!=(void* ptr) const noexcept
     {
-        return (ptr != nullptr) || (!invocationVector.empty());
+        return (ptr != nullptr) || (!empty());
     }
 
     size_t size() const noexcept
     {
-        return invocationVector.size();
+        read_guard guard(*this);
+        const snapshot_t* snapshot = guard.snapshot;
+        return snapshot != nullptr ? snapshot->count : 0u;
     }
 
     multicast_delegate_t& operator+=(const delegate_t<Result(Args...)>& fn)
@@ -40,32 +69,294 @@ public:
         {
             return *this;
         }
-        invocationVector.emplace_back(std::make_unique<list_value_t>(fn.invocation.object, fn.invocation.stub));
+
+        snapshot_t* expected = nullptr;
+        {
+            // Held until the CAS: another writer could otherwise retire and free expected while we copy it
+            read_guard guard(*this);
+            expected = guard.snapshot;
+            snapshot_t* desired = nullptr;
+            do
+            {
+                free_snapshot(desired);
+                const size_t oldCount = expected != nullptr ? expected->count : 0u;
+                desired = allocate_snapshot(oldCount + 1u);
+                for (size_t i = 0u; i < oldCount; ++i)
+                {
+                    desired->elements()[i] = expected->elements()[i];
+                }
+                desired->elements()[oldCount] = fn.invocation;
+            }
+            while (!current.compare_exchange_weak(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire));
+        }
+
+        // Only after dropping the guard, or we'd always see ourselves as an active reader and never free anything
+        retire(expected);
+        return *this;
     }
 
-    void operator()(Args...args) const noexcept
+    // Removes the first subscription matching fn, if there is one
+    multicast_delegate_t& operator-=(const delegate_t<Result(Args...)>& fn)
     {
-        for (const auto& item : invocationVector)
+        snapshot_t* expected = nullptr;
         {
-            (*(item->stub))(item->object, args...);
+            // As in operator+=, expected must stay pinned until the CAS
+            read_guard guard(*this);
+            expected = guard.snapshot;
+            snapshot_t* desired = nullptr;
+            do
+            {
+                free_snapshot(desired);
+                desired = nullptr;
+                if (expected == nullptr)
+                {
+                    return *this;
+                }
+
+                size_t foundIdx = expected->count;
+                for (size_t i = 0u; i < expected->count; ++i)
+                {
+                    if (expected->elements()[i] == fn.invocation)
+                    {
+                        foundIdx = i;
+                        break;
+                    }
+                }
+
+                if (foundIdx == expected->count)
+                {
+                    return *this;
+                }
+
+                if (expected->count > 1u)
+                {
+                    desired = allocate_snapshot(expected->count - 1u);
+                    size_t dst = 0u;
+                    for (size_t i = 0u; i < expected->count; ++i)
+                    {
+                        if (i != foundIdx)
+                        {
+                            desired->elements()[dst++] = expected->elements()[i];
+                        }
+                    }
+                }
+            }
+            while (!current.compare_exchange_weak(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire));
+        }
+
+        retire(expected);
+        return *this;
+    }
+
+    void clear()
+    {
+        retire(current.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+    void operator()(Args...args) const
+    {
+        read_guard guard(*this);
+        const snapshot_t* snapshot = guard.snapshot;
+        if (snapshot == nullptr)
+        {
+            return;
+        }
+
+        const invocation_element_t* items = snapshot->elements();
+        for (size_t i = 0u; i < snapshot->count; ++i)
+        {
+            (*(items[i].stub))(items[i].object, args...);
         }
     }
 
     void operator()(Args...args, delegate_t<void(size_t,Result*)> handler) const
     {
-        size_t idx{ 0u };
-        for (const auto& item : invocationVector)
+        read_guard guard(*this);
+        const snapshot_t* snapshot = guard.snapshot;
+        if (snapshot == nullptr)
+        {
+            return;
+        }
+
+        const invocation_element_t* items = snapshot->elements();
+        for (size_t i = 0u; i < snapshot->count; ++i)
         {
-            Result value = (*(item->stub))(item->object, args...);
-            handler(idx, &value);
-            ++idx;
+            Result value = (*(items[i].stub))(items[i].object, args...);
+            handler(i, &value);
         }
     }
 
 private:
 
-    using list_value_t = std::unique_ptr<typename base_delegate_t<Result(Args...)>::invocation_element_t>;
-    std::vector<list_value_t> invocationVector;
+    constexpr static uint32_t numInlineSnapshots = 2u;
+    constexpr static uint32_t heapSnapshot = numInlineSnapshots;
+
+    // Header followed directly by count invocation elements, in a single allocation or inline buffer
+    struct snapshot_t
+    {
+        snapshot_t* nextRetired{ nullptr };
+        size_t count{ 0u };
+        // Index of the inline buffer holding this snapshot, or heapSnapshot
+        uint32_t inlineIndex{ heapSnapshot };
+
+        invocation_element_t* elements() noexcept
+        {
+            return reinterpret_cast<invocation_element_t*>(this + 1);
+        }
+
+        const invocation_element_t* elements() const noexcept
+        {
+            return reinterpret_cast<const invocation_element_t*>(this + 1);
+        }
+    };
+
+    static_assert(alignof(invocation_element_t) <= alignof(snapshot_t), "elements must be able to directly follow snapshot header!");
+    static_assert(sizeof(snapshot_t) % alignof(invocation_element_t) == 0u, "elements must be able to directly follow snapshot header!");
+
+    struct inline_snapshot_buffer_t
+    {
+        alignas(snapshot_t) std::byte storage[sizeof(snapshot_t) + sizeof(invocation_element_t) * inlineSnapshotCapacity];
+    };
+
+    struct read_guard
+    {
+        read_guard(const multicast_delegate_t& _parent) noexcept : parent(_parent)
+        {
+            parent.activeReaders.fetch_add(1u, std::memory_order_seq_cst);
+            snapshot = parent.current.load(std::memory_order_seq_cst);
+        }
+
+        ~read_guard()
+        {
+            parent.activeReaders.fetch_sub(1u, std::memory_order_seq_cst);
+        }
+
+        read_guard(const read_guard&) = delete;
+        read_guard& operator=(const read_guard&) = delete;
+
+        const multicast_delegate_t& parent;
+        snapshot_t* snapshot{ nullptr };
+    };
+
+    // Claims a free inline buffer for small snapshots, falling back to the heap if both are taken
+    snapshot_t* allocate_snapshot(size_t count)
+    {
+        void* memory = nullptr;
+        uint32_t inlineIndex = heapSnapshot;
+        if (count <= inlineSnapshotCapacity)
+        {
+            uint32_t inUse = inlineBuffersInUse.load(std::memory_order_relaxed);
+            for (uint32_t i = 0u; i < numInlineSnapshots && memory == nullptr; ++i)
+            {
+                const uint32_t bit = 1u << i;
+                while ((inUse & bit) == 0u)
+                {
+                    if (inlineBuffersInUse.compare_exchange_weak(inUse, inUse | bit, std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        memory = inlineBuffers[i].storage;
+                        inlineIndex = i;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (memory == nullptr)
+        {
+            memory = ::operator new(sizeof(snapshot_t) + sizeof(invocation_element_t) * count);
+        }
+
+        snapshot_t* result = ::new (memory) snapshot_t{ nullptr, count, inlineIndex };
+        invocation_element_t* items = result->elements();
+        for (size_t i = 0u; i < count; ++i)
+        {
+            ::new (static_cast<void*>(items + i)) invocation_element_t();
+        }
+        return result;
+    }
+
+    void free_snapshot(snapshot_t* snapshot) noexcept
+    {
+        if (snapshot == nullptr)
+        {
+            return;
+        }
+
+        if (snapshot->inlineIndex != heapSnapshot)
+        {
+            inlineBuffersInUse.fetch_and(~(1u << snapshot->inlineIndex), std::memory_order_release);
+        }
+        else
+        {
+            ::operator delete(snapshot);
+        }
+    }
+
+    void free_retired_chain(snapshot_t* head) noexcept
+    {
+        while (head != nullptr)
+        {
+            snapshot_t* next = head->nextRetired;
+            free_snapshot(head);
+            head = next;
+        }
+    }
+
+    void push_retired(snapshot_t* first, snapshot_t* last) noexcept
+    {
+        snapshot_t* head = retired.load(std::memory_order_relaxed);
+        do
+        {
+            last->nextRetired = head;
+        }
+        while (!retired.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void retire(snapshot_t* snapshot) noexcept
+    {
+        if (snapshot != nullptr)
+        {
+            snapshot->nextRetired = nullptr;
+            push_retired(snapshot, snapshot);
+        }
+
+        // Cheap early-out: while broadcasts are running there's no point grabbing the chain, it just
+        // keeps growing until some later change lands in a quiet moment (or the destructor runs)
+        if (activeReaders.load(std::memory_order_seq_cst) != 0u)
+        {
+            return;
+        }
+
+        // Grab the chain first, then check for readers again: anything in the chain was unpublished
+        // before we took it, so a reader still using it must have registered before now
+        snapshot_t* chain = retired.exchange(nullptr, std::memory_order_seq_cst);
+        if (chain == nullptr)
+        {
+            return;
+        }
+
+        if (activeReaders.load(std::memory_order_seq_cst) == 0u)
+        {
+            free_retired_chain(chain);
+        }
+        else
+        {
+            // Lost the race with a new broadcast: hand the chain back for a later change to free
+            snapshot_t* last = chain;
+            while (last->nextRetired != nullptr)
+            {
+                last = last->nextRetired;
+            }
+            push_retired(chain, last);
+        }
+    }
+
+    std::atomic<snapshot_t*> current{ nullptr };
+    std::atomic<snapshot_t*> retired{ nullptr };
+    mutable std::atomic<uint32_t> activeReaders{ 0u };
+    // Bit i set while inlineBuffers[i] holds a current, retired or under-construction snapshot
+    std::atomic<uint32_t> inlineBuffersInUse{ 0u };
+    inline_snapshot_buffer_t inlineBuffers[numInlineSnapshots];
 
 };
 
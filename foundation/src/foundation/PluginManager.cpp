@@ -1,8 +1,15 @@
 #include "foundation/PluginManager.hpp"
 #include "foundation/CoreAPIs.hpp"
 #include "PluginManagerImpl.hpp"
+#include "PluginUpdateScheduler.hpp"
+#include <algorithm>
+#include <thread>
 
-PluginManager::PluginManager() : impl(std::make_unique<PluginManagerImpl>()) {}
+PluginManager::PluginManager() : impl(std::make_unique<PluginManagerImpl>()), updateScheduler(std::make_unique<PluginUpdateScheduler>())
+{
+    const uint32_t hardware_threads = std::thread::hardware_concurrency();
+    updateScheduler->SetWorkerCount(hardware_threads > 1u ? hardware_threads - 1u : 0u);
+}
 
 PluginManager::~PluginManager() {}
 
@@ -15,11 +22,13 @@ PluginManager& PluginManager::GetPluginManager()
 void PluginManager::LoadPlugin(const char * fname)
 {
     impl->LoadPlugin(fname);
+    updateSchedulerDirty = true;
 }
 
 void PluginManager::UnloadPlugin(const char * fname)
 {
     impl->UnloadPlugin(fname);
+    updateSchedulerDirty = true;
 }
 
 void* PluginManager::RetrieveAPI(uint32_t id)
@@ -36,3 +45,76 @@ void PluginManager::GetLoadedPlugins(uint32_t * num_plugins, uint32_t * plugin_i
 {
     impl->LoadedPlugins(num_plugins, plugin_ids);
 }
+
+bool PluginManager::EnableHotReload(uint32_t coalesce_window_ms)
+{
+    return impl->EnableHotReload(coalesce_window_ms);
+}
+
+void PluginManager::ProcessPendingReloads()
+{
+    if (impl->ProcessPendingReloads() != 0u)
+    {
+        // Reloaded plugins have new API pointers, and might have changed their dependencies
+        updateSchedulerDirty = true;
+    }
+}
+
+void PluginManager::LogicalUpdate()
+{
+    refreshUpdateScheduler();
+    updateScheduler->Run(PluginUpdateScheduler::update_kind::Logical, 0.0);
+}
+
+void PluginManager::TimeDependentUpdate(double dt)
+{
+    refreshUpdateScheduler();
+    updateScheduler->Run(PluginUpdateScheduler::update_kind::TimeDependent, dt);
+}
+
+void PluginManager::SetUpdateWorkerCount(uint32_t count)
+{
+    updateScheduler->SetWorkerCount(count);
+}
+
+void PluginManager::GetPluginUpdateTimings(uint32_t* num_timings, PluginUpdateTiming* timings) const
+{
+    updateScheduler->GetTimings(num_timings, timings);
+}
+
+void PluginManager::refreshUpdateScheduler()
+{
+    if (!updateSchedulerDirty)
+    {
+        return;
+    }
+
+    uint32_t num_plugins = 0u;
+    impl->LoadedPlugins(&num_plugins, nullptr);
+    std::vector<uint32_t> loaded_ids(num_plugins);
+    impl->LoadedPlugins(&num_plugins, loaded_ids.data());
+
+    // Drop unloaded plugins, then append new ones: the impl's maps don't keep load order for us
+    registrationOrder.erase(std::remove_if(registrationOrder.begin(), registrationOrder.end(), [&loaded_ids](uint32_t id)
+    {
+        return std::find(loaded_ids.cbegin(), loaded_ids.cend(), id) == loaded_ids.cend();
+    }), registrationOrder.end());
+
+    for (uint32_t id : loaded_ids)
+    {
+        if (std::find(registrationOrder.cbegin(), registrationOrder.cend(), id) == registrationOrder.cend())
+        {
+            registrationOrder.emplace_back(id);
+        }
+    }
+
+    std::vector<Plugin_API*> plugins_in_order;
+    plugins_in_order.reserve(registrationOrder.size());
+    for (uint32_t id : registrationOrder)
+    {
+        plugins_in_order.emplace_back(impl->GetCoreAPI(id));
+    }
+
+    updateScheduler->SetPlugins(plugins_in_order);
+    updateSchedulerDirty = false;
+}
@@ -0,0 +1,277 @@
+#include "PluginUpdateScheduler.hpp"
+#include "foundation/Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+
+    bool intersects(const std::vector<uint32_t>& sorted_a, const std::vector<uint32_t>& sorted_b) noexcept
+    {
+        auto a = sorted_a.cbegin();
+        auto b = sorted_b.cbegin();
+        while (a != sorted_a.cend() && b != sorted_b.cend())
+        {
+            if (*a < *b)
+            {
+                ++a;
+            }
+            else if (*b < *a)
+            {
+                ++b;
+            }
+            else
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+PluginUpdateScheduler::~PluginUpdateScheduler()
+{
+    stopWorkers();
+}
+
+void PluginUpdateScheduler::SetPlugins(const std::vector<Plugin_API*>& plugins_in_order)
+{
+    nodes.clear();
+    roots.clear();
+    nodes.resize(plugins_in_order.size());
+
+    for (size_t i = 0u; i < plugins_in_order.size(); ++i)
+    {
+        node_t& node = nodes[i];
+        node.api = plugins_in_order[i];
+        node.pluginID = node.api->PluginID();
+
+        if (node.api->UpdateDependencies == nullptr)
+        {
+            node.touchesEverything = true;
+            continue;
+        }
+
+        uint32_t num_reads = 0u;
+        uint32_t num_writes = 0u;
+        node.api->UpdateDependencies(&num_reads, nullptr, &num_writes, nullptr);
+        node.reads.resize(num_reads);
+        node.writes.resize(num_writes);
+        node.api->UpdateDependencies(&num_reads, node.reads.data(), &num_writes, node.writes.data());
+        // Updates mutate a plugin's own state, which is what other plugins read through its API
+        node.writes.emplace_back(node.pluginID);
+
+        std::sort(node.reads.begin(), node.reads.end());
+        node.reads.erase(std::unique(node.reads.begin(), node.reads.end()), node.reads.end());
+        std::sort(node.writes.begin(), node.writes.end());
+        node.writes.erase(std::unique(node.writes.begin(), node.writes.end()), node.writes.end());
+    }
+
+    // Edges always point from earlier to later registration, so the graph can't have cycles
+    std::vector<uint32_t> depth(nodes.size(), 1u);
+    criticalPathLength = nodes.empty() ? 0u : 1u;
+    for (uint32_t later = 0u; later < static_cast<uint32_t>(nodes.size()); ++later)
+    {
+        for (uint32_t earlier = 0u; earlier < later; ++earlier)
+        {
+            if (conflicts(nodes[earlier], nodes[later]))
+            {
+                nodes[earlier].successors.emplace_back(later);
+                ++nodes[later].predecessorCount;
+                depth[later] = std::max(depth[later], depth[earlier] + 1u);
+            }
+        }
+
+        if (nodes[later].predecessorCount == 0u)
+        {
+            roots.emplace_back(later);
+        }
+        criticalPathLength = std::max(criticalPathLength, depth[later]);
+    }
+}
+
+void PluginUpdateScheduler::SetWorkerCount(uint32_t count)
+{
+    if (count == workerCount)
+    {
+        return;
+    }
+    stopWorkers();
+    workerCount = count;
+}
+
+void PluginUpdateScheduler::Run(update_kind kind, double dt)
+{
+    if (nodes.empty())
+    {
+        return;
+    }
+
+    // Nothing to overlap: skip the hand-off to workers entirely
+    if (workerCount == 0u || criticalPathLength == static_cast<uint32_t>(nodes.size()))
+    {
+        currentKind = kind;
+        currentDt = dt;
+        for (uint32_t i = 0u; i < static_cast<uint32_t>(nodes.size()); ++i)
+        {
+            execute(i);
+        }
+        return;
+    }
+
+    if (workers.empty())
+    {
+        startWorkers();
+    }
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    currentKind = kind;
+    currentDt = dt;
+    completedNodes = 0u;
+    for (node_t& node : nodes)
+    {
+        node.remainingPredecessors = node.predecessorCount;
+    }
+    readyNodes.assign(roots.cbegin(), roots.cend());
+    stateChanged.notify_all();
+
+    // Calling thread works through the graph too, instead of just sleeping until it's done
+    while (completedNodes != nodes.size())
+    {
+        if (!readyNodes.empty())
+        {
+            const uint32_t node_idx = readyNodes.front();
+            readyNodes.pop_front();
+            lock.unlock();
+            execute(node_idx);
+            lock.lock();
+            completeNode(node_idx);
+        }
+        else
+        {
+            stateChanged.wait(lock);
+        }
+    }
+}
+
+void PluginUpdateScheduler::GetTimings(uint32_t* num_timings, PluginUpdateTiming* timings) const
+{
+    *num_timings = static_cast<uint32_t>(nodes.size());
+    if (timings != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        for (size_t i = 0u; i < nodes.size(); ++i)
+        {
+            timings[i].PluginID = nodes[i].pluginID;
+            timings[i].LogicalUpdateMs = static_cast<double>(nodes[i].logicalUpdateNs) * 1.0e-6;
+            timings[i].TimeDependentUpdateMs = static_cast<double>(nodes[i].timeDependentUpdateNs) * 1.0e-6;
+        }
+    }
+}
+
+uint32_t PluginUpdateScheduler::CriticalPathLength() const noexcept
+{
+    return criticalPathLength;
+}
+
+bool PluginUpdateScheduler::conflicts(const node_t& first, const node_t& second) noexcept
+{
+    if (first.touchesEverything || second.touchesEverything)
+    {
+        return true;
+    }
+    // Reads alone never conflict with each other
+    return intersects(first.writes, second.writes) || intersects(first.writes, second.reads) ||
+        intersects(first.reads, second.writes);
+}
+
+void PluginUpdateScheduler::execute(uint32_t node_idx)
+{
+    node_t& node = nodes[node_idx];
+    const auto start = std::chrono::steady_clock::now();
+
+    if (currentKind == update_kind::Logical)
+    {
+        if (node.api->LogicalUpdate != nullptr)
+        {
+            FOUNDATION_PROFILE_ZONE_ARG("Plugin::LogicalUpdate", node.pluginID);
+            node.api->LogicalUpdate();
+        }
+    }
+    else if (node.api->TimeDependentUpdate != nullptr)
+    {
+        FOUNDATION_PROFILE_ZONE_ARG("Plugin::TimeDependentUpdate", node.pluginID);
+        node.api->TimeDependentUpdate(currentDt);
+    }
+
+    const uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    // Only this thread touches the node until completeNode() publishes it under the lock
+    if (currentKind == update_kind::Logical)
+    {
+        node.logicalUpdateNs = elapsed;
+    }
+    else
+    {
+        node.timeDependentUpdateNs = elapsed;
+    }
+}
+
+void PluginUpdateScheduler::completeNode(uint32_t node_idx)
+{
+    for (uint32_t successor : nodes[node_idx].successors)
+    {
+        if (--nodes[successor].remainingPredecessors == 0u)
+        {
+            readyNodes.emplace_back(successor);
+        }
+    }
+    ++completedNodes;
+    stateChanged.notify_all();
+}
+
+void PluginUpdateScheduler::startWorkers()
+{
+    stopping = false;
+    workers.reserve(workerCount);
+    for (uint32_t i = 0u; i < workerCount; ++i)
+    {
+        workers.emplace_back(&PluginUpdateScheduler::workerLoop, this);
+    }
+}
+
+void PluginUpdateScheduler::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    stateChanged.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void PluginUpdateScheduler::workerLoop()
+{
+    FOUNDATION_PROFILE_THREAD_NAME("Plugin Update Worker");
+    std::unique_lock<std::mutex> lock(stateMutex);
+    for (;;)
+    {
+        stateChanged.wait(lock, [this]() { return stopping || !readyNodes.empty(); });
+        if (stopping)
+        {
+            return;
+        }
+
+        const uint32_t node_idx = readyNodes.front();
+        readyNodes.pop_front();
+        lock.unlock();
+        execute(node_idx);
+        lock.lock();
+        completeNode(node_idx);
+    }
+}
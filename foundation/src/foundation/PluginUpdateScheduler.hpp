@@ -0,0 +1,83 @@
+#pragma once
+#ifndef PLUGIN_UPDATE_SCHEDULER_HPP
+#define PLUGIN_UPDATE_SCHEDULER_HPP
+#include "foundation/CoreAPIs.hpp"
+#include "foundation/PluginManager.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Runs plugin updates as a DAG: plugin B depends on an earlier-registered plugin A when one of them
+    writes an engine API the other reads or writes. Plugins with no conflicts between them run
+    concurrently on a small pool of worker threads (plus the calling thread), and conflicting ones
+    keep their registration order, so results match the old serial loop.
+*/
+class PluginUpdateScheduler
+{
+public:
+
+    enum class update_kind : uint8_t
+    {
+        Logical,
+        TimeDependent
+    };
+
+    PluginUpdateScheduler() = default;
+    ~PluginUpdateScheduler();
+    PluginUpdateScheduler(const PluginUpdateScheduler&) = delete;
+    PluginUpdateScheduler& operator=(const PluginUpdateScheduler&) = delete;
+
+    // Plugins in registration order. Queries each plugin's dependencies and rebuilds the graph.
+    void SetPlugins(const std::vector<Plugin_API*>& plugins_in_order);
+    // 0 runs everything on the calling thread
+    void SetWorkerCount(uint32_t count);
+    void Run(update_kind kind, double dt);
+    // Timings are from the most recent run of each update kind
+    void GetTimings(uint32_t* num_timings, PluginUpdateTiming* timings) const;
+    // Longest chain of dependent plugins: 1 means every plugin could run concurrently
+    uint32_t CriticalPathLength() const noexcept;
+
+private:
+
+    struct node_t
+    {
+        Plugin_API* api{ nullptr };
+        uint32_t pluginID{ 0u };
+        bool touchesEverything{ false };
+        std::vector<uint32_t> reads;
+        std::vector<uint32_t> writes;
+        std::vector<uint32_t> successors;
+        uint32_t predecessorCount{ 0u };
+        uint32_t remainingPredecessors{ 0u };
+        uint64_t logicalUpdateNs{ 0u };
+        uint64_t timeDependentUpdateNs{ 0u };
+    };
+
+    static bool conflicts(const node_t& first, const node_t& second) noexcept;
+    void execute(uint32_t node_idx);
+    // Expects lock to be held
+    void completeNode(uint32_t node_idx);
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+
+    std::vector<node_t> nodes;
+    std::vector<uint32_t> roots;
+    uint32_t criticalPathLength{ 0u };
+
+    uint32_t workerCount{ 0u };
+    std::vector<std::thread> workers;
+    mutable std::mutex stateMutex;
+    std::condition_variable stateChanged;
+    std::deque<uint32_t> readyNodes;
+    size_t completedNodes{ 0u };
+    bool stopping{ false };
+    update_kind currentKind{ update_kind::Logical };
+    double currentDt{ 0.0 };
+};
+
+#endif //!PLUGIN_UPDATE_SCHEDULER_HPP
@@ -0,0 +1,412 @@
+#include "foundation/Profiler.hpp"
+#include "containers/spscRing.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace foundation
+{
+
+    namespace detail
+    {
+        std::atomic<bool> profilerEnabled{ true };
+    }
+
+    namespace
+    {
+
+        struct thread_buffer
+        {
+            spscRing<profiler_event, ProfilerThreadRingCapacity> ring;
+            uint32_t threadID{ 0u };
+            std::atomic<uint64_t> droppedEvents{ 0u };
+            // Set by the owning thread as it exits, after its last push: once drained, nothing writes to this buffer again
+            std::atomic<bool> released{ false };
+        };
+
+        struct collected_event
+        {
+            profiler_event event;
+            uint32_t threadID;
+        };
+
+        struct profiler_state
+        {
+            // Guards the buffer lists, thread names and collected store. The recording path only ever
+            // try_locks it, to claim a spare buffer.
+            std::mutex mutex;
+            // Capacity is kept at activeBuffers.size() + spareBuffers.size(), so claiming a spare never allocates
+            std::vector<thread_buffer*> activeBuffers;
+            std::vector<thread_buffer*> spareBuffers;
+            size_t spareTarget{ 0u };
+            uint32_t nextThreadID{ 1u };
+            // Kept apart from the buffers, so names of exited threads still make it into traces
+            std::vector<std::pair<uint32_t, std::string>> threadNames;
+            std::deque<collected_event> collectedEvents;
+            // Events from threads without a buffer, and from buffers already freed
+            std::atomic<uint64_t> droppedEvents{ 0u };
+            // Bumped whenever spares are added, so threads that found none know when to look again
+            std::atomic<uint32_t> spareGeneration{ 0u };
+            // Only one thread may consume a given ring at a time
+            std::mutex collectMutex;
+        };
+
+        profiler_state& state() noexcept
+        {
+            // Never destroyed, so zones on threads exiting during static destruction are still safe
+            static profiler_state* instance = new profiler_state();
+            return *instance;
+        }
+
+        // Constructed during static initialization, rather than by whichever zone happens to come first
+        [[maybe_unused]] profiler_state& initialState = state();
+
+        // Expects state().mutex to be held
+        void make_active(profiler_state& profiler, thread_buffer* buffer) noexcept
+        {
+            buffer->threadID = profiler.nextThreadID++;
+            profiler.activeBuffers.emplace_back(buffer);
+        }
+
+        struct local_buffer_handle
+        {
+            ~local_buffer_handle()
+            {
+                if (buffer != nullptr)
+                {
+                    buffer->released.store(true, std::memory_order_release);
+                    buffer = nullptr;
+                }
+                exited = true;
+            }
+
+            thread_buffer* buffer{ nullptr };
+            // Spare generation last seen empty, so we don't retry the lock on every event
+            uint32_t failedGeneration{ UINT32_MAX };
+            // Zones recorded from other thread_local destructors after ours must not claim a new buffer
+            bool exited{ false };
+        };
+
+        thread_local local_buffer_handle localHandle;
+
+        thread_buffer* claim_spare_buffer() noexcept
+        {
+            profiler_state& profiler = state();
+            const uint32_t generation = profiler.spareGeneration.load(std::memory_order_acquire);
+            if (localHandle.exited || generation == localHandle.failedGeneration)
+            {
+                return nullptr;
+            }
+
+            std::unique_lock<std::mutex> lock(profiler.mutex, std::try_to_lock);
+            if (!lock.owns_lock())
+            {
+                // Just try again on the next event
+                return nullptr;
+            }
+            if (profiler.spareBuffers.empty())
+            {
+                localHandle.failedGeneration = generation;
+                return nullptr;
+            }
+
+            thread_buffer* buffer = profiler.spareBuffers.back();
+            profiler.spareBuffers.pop_back();
+            make_active(profiler, buffer);
+            localHandle.buffer = buffer;
+            return buffer;
+        }
+
+        void push_event(const profiler_event& event) noexcept
+        {
+            thread_buffer* buffer = localHandle.buffer != nullptr ? localHandle.buffer : claim_spare_buffer();
+            if (buffer == nullptr)
+            {
+                state().droppedEvents.fetch_add(1u, std::memory_order_relaxed);
+            }
+            else if (!buffer->ring.try_push(event))
+            {
+                buffer->droppedEvents.fetch_add(1u, std::memory_order_relaxed);
+            }
+        }
+
+        void write_json_string(std::ofstream& output, const char* str)
+        {
+            output << '"';
+            for (const char* c = str; *c != '\0'; ++c)
+            {
+                switch (*c)
+                {
+                case '"':
+                    output << "\\\"";
+                    break;
+                case '\\':
+                    output << "\\\\";
+                    break;
+                case '\n':
+                    output << "\\n";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(*c) >= 0x20u)
+                    {
+                        output << *c;
+                    }
+                    break;
+                }
+            }
+            output << '"';
+        }
+
+    }
+
+    void SetProfilerEnabled(bool enabled) noexcept
+    {
+        detail::profilerEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool IsProfilerEnabled() noexcept
+    {
+        return detail::profilerEnabled.load(std::memory_order_relaxed);
+    }
+
+    void RegisterProfilerThread()
+    {
+        if (localHandle.buffer != nullptr || localHandle.exited)
+        {
+            return;
+        }
+
+        profiler_state& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        thread_buffer* buffer = nullptr;
+        if (!profiler.spareBuffers.empty())
+        {
+            buffer = profiler.spareBuffers.back();
+            profiler.spareBuffers.pop_back();
+        }
+        else
+        {
+            profiler.activeBuffers.reserve(profiler.activeBuffers.size() + profiler.spareBuffers.size() + 1u);
+            buffer = new thread_buffer();
+        }
+        make_active(profiler, buffer);
+        localHandle.buffer = buffer;
+    }
+
+    void SetProfilerThreadName(const char* name)
+    {
+        RegisterProfilerThread();
+        if (localHandle.buffer == nullptr)
+        {
+            return;
+        }
+
+        const uint32_t threadID = localHandle.buffer->threadID;
+        profiler_state& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        auto iter = std::find_if(profiler.threadNames.begin(), profiler.threadNames.end(), [threadID](const auto& entry)
+        {
+            return entry.first == threadID;
+        });
+        if (iter != profiler.threadNames.end())
+        {
+            iter->second = name;
+        }
+        else
+        {
+            profiler.threadNames.emplace_back(threadID, name);
+        }
+    }
+
+    void ReserveProfilerThreadBuffers(size_t count)
+    {
+        profiler_state& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        profiler.spareTarget = count;
+        profiler.activeBuffers.reserve(profiler.activeBuffers.size() + std::max(count, profiler.spareBuffers.size()));
+        profiler.spareBuffers.reserve(count);
+        while (profiler.spareBuffers.size() < count)
+        {
+            profiler.spareBuffers.emplace_back(new thread_buffer());
+        }
+        while (profiler.spareBuffers.size() > count)
+        {
+            delete profiler.spareBuffers.back();
+            profiler.spareBuffers.pop_back();
+        }
+        profiler.spareGeneration.fetch_add(1u, std::memory_order_release);
+    }
+
+    void RecordProfilerZone(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t argument) noexcept
+    {
+        push_event(profiler_event{ name, start_ns, end_ns - start_ns, argument, profiler_event_type::Zone });
+    }
+
+    void RecordProfilerCounter(const char* name, double value) noexcept
+    {
+        if (!detail::profilerEnabled.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        uint64_t bits = 0u;
+        std::memcpy(&bits, &value, sizeof(double));
+        push_event(profiler_event{ name, detail::profiler_now_ns(), bits, 0u, profiler_event_type::Counter });
+    }
+
+    void CollectProfilerEvents()
+    {
+        profiler_state& profiler = state();
+        std::lock_guard<std::mutex> collectLock(profiler.collectMutex);
+
+        std::vector<thread_buffer*> buffers;
+        {
+            std::lock_guard<std::mutex> lock(profiler.mutex);
+            buffers = profiler.activeBuffers;
+        }
+
+        std::array<profiler_event, 512u> scratch;
+        std::vector<collected_event> drained;
+        std::vector<thread_buffer*> releasedBuffers;
+        for (thread_buffer* buffer : buffers)
+        {
+            // Checked before draining: everything the thread pushed before releasing is then in the ring
+            const bool released = buffer->released.load(std::memory_order_acquire);
+            size_t count = 0u;
+            while ((count = buffer->ring.pop_n(std::span<profiler_event>(scratch))) != 0u)
+            {
+                for (size_t i = 0u; i < count; ++i)
+                {
+                    drained.emplace_back(collected_event{ scratch[i], buffer->threadID });
+                }
+            }
+            if (released)
+            {
+                releasedBuffers.emplace_back(buffer);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        profiler.collectedEvents.insert(profiler.collectedEvents.end(), drained.cbegin(), drained.cend());
+        while (profiler.collectedEvents.size() > ProfilerMaxCollectedEvents)
+        {
+            profiler.collectedEvents.pop_front();
+        }
+
+        // Buffers of exited threads are empty now: keep enough as spares, and free the rest
+        bool addedSpares = false;
+        for (thread_buffer* buffer : releasedBuffers)
+        {
+            profiler.activeBuffers.erase(std::find(profiler.activeBuffers.begin(), profiler.activeBuffers.end(), buffer));
+            profiler.droppedEvents.fetch_add(buffer->droppedEvents.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            if (profiler.spareBuffers.size() < profiler.spareTarget)
+            {
+                buffer->droppedEvents.store(0u, std::memory_order_relaxed);
+                buffer->released.store(false, std::memory_order_relaxed);
+                profiler.spareBuffers.emplace_back(buffer);
+                addedSpares = true;
+            }
+            else
+            {
+                delete buffer;
+            }
+        }
+        if (addedSpares)
+        {
+            profiler.spareGeneration.fetch_add(1u, std::memory_order_release);
+        }
+    }
+
+    void ClearProfilerEvents()
+    {
+        profiler_state& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        profiler.collectedEvents.clear();
+        profiler.collectedEvents.shrink_to_fit();
+    }
+
+    bool WriteProfilerChromeTrace(const char* output_file)
+    {
+        CollectProfilerEvents();
+
+        std::ofstream output(output_file, std::ios::out | std::ios::trunc);
+        if (!output.is_open())
+        {
+            return false;
+        }
+
+        profiler_state& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+
+        // Chrome trace timestamps are microseconds: rebase onto the first event to keep them short
+        uint64_t baseNs = UINT64_MAX;
+        for (const collected_event& entry : profiler.collectedEvents)
+        {
+            baseNs = std::min(baseNs, entry.event.timestampNs);
+        }
+
+        output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]()
+        {
+            if (!first)
+            {
+                output << ",\n";
+            }
+            first = false;
+        };
+
+        for (const auto& [threadID, threadName] : profiler.threadNames)
+        {
+            separator();
+            output << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << threadID << ",\"args\":{\"name\":";
+            write_json_string(output, threadName.c_str());
+            output << "}}";
+        }
+
+        output.precision(15);
+        for (const collected_event& entry : profiler.collectedEvents)
+        {
+            const profiler_event& event = entry.event;
+            const double timestampUs = static_cast<double>(event.timestampNs - baseNs) * 1.0e-3;
+            separator();
+            if (event.type == profiler_event_type::Zone)
+            {
+                output << "{\"ph\":\"X\",\"name\":";
+                write_json_string(output, event.name);
+                output << ",\"pid\":1,\"tid\":" << entry.threadID << ",\"ts\":" << timestampUs <<
+                    ",\"dur\":" << static_cast<double>(event.payload) * 1.0e-3 << ",\"args\":{\"arg\":" << event.argument << "}}";
+            }
+            else
+            {
+                double value = 0.0;
+                std::memcpy(&value, &event.payload, sizeof(double));
+                output << "{\"ph\":\"C\",\"name\":";
+                write_json_string(output, event.name);
+                output << ",\"pid\":1,\"tid\":" << entry.threadID << ",\"ts\":" << timestampUs << ",\"args\":{\"value\":" << value << "}}";
+            }
+        }
+
+        output << "\n]}\n";
+        return output.good();
+    }
+
+    uint64_t GetProfilerDroppedEventCount() noexcept
+    {
+        profiler_state& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        uint64_t total = profiler.droppedEvents.load(std::memory_order_relaxed);
+        for (const thread_buffer* buffer : profiler.activeBuffers)
+        {
+            total += buffer->droppedEvents.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+}
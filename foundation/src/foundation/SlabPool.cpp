@@ -0,0 +1,446 @@
+#include "foundation/SlabPool.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace foundation
+{
+
+    namespace
+    {
+        constexpr uint32_t invalidMagazine = UINT32_MAX;
+        // Distinct pools a single thread keeps magazines for at once, before evicting the oldest
+        constexpr size_t maxCachedPools = 16u;
+
+        std::atomic<uint64_t> nextPoolID{ 1u };
+
+        // Pools that are still alive, so a thread exiting after a pool was destroyed doesn't touch it
+        struct pool_registry
+        {
+            std::mutex mutex;
+            std::vector<std::pair<uint64_t, slab_pool*>> pools;
+        };
+
+        pool_registry& registry() noexcept
+        {
+            // Never destroyed, since thread caches may be flushed during static destruction
+            static pool_registry* instance = new pool_registry();
+            return *instance;
+        }
+
+        bool is_registered(const pool_registry& reg, uint64_t id, const slab_pool* pool) noexcept
+        {
+            return std::find(reg.pools.cbegin(), reg.pools.cend(), std::make_pair(id, const_cast<slab_pool*>(pool))) != reg.pools.cend();
+        }
+    }
+
+    struct slab_pool::magazine_t
+    {
+        // Link for the depot stacks, as (index + 1) of the next magazine
+        std::atomic<uint32_t> next{ 0u };
+        uint32_t count{ 0u };
+        void* blocks[MagazineCapacity];
+    };
+
+    struct slab_pool::thread_cache_t
+    {
+        uint64_t poolID{ 0u };
+        slab_pool* pool{ nullptr };
+        uint32_t loaded{ invalidMagazine };
+        uint32_t previous{ invalidMagazine };
+
+        void flush() noexcept
+        {
+            pool->flushCache(*this);
+        }
+    };
+
+    struct slab_pool::slab_header_t
+    {
+        slab_header_t* next{ nullptr };
+        size_t bytes{ 0u };
+        size_t alignment{ 0u };
+    };
+
+    namespace
+    {
+        struct cache_table
+        {
+            ~cache_table()
+            {
+                // Hand any blocks we're holding back to their pools' depots, for other threads to use
+                pool_registry& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                for (slab_pool::thread_cache_t& cache : entries)
+                {
+                    if (cache.poolID != 0u && is_registered(reg, cache.poolID, cache.pool))
+                    {
+                        cache.flush();
+                    }
+                }
+            }
+
+            slab_pool::thread_cache_t entries[maxCachedPools];
+            uint32_t lastUsed{ 0u };
+            uint32_t nextEviction{ 0u };
+        };
+
+        thread_local cache_table localCaches;
+    }
+
+    slab_pool::slab_pool(size_t block_size, size_t block_alignment, size_t blocks_per_slab) :
+        // Every block must be able to hold at least a pointer, and keep the next block aligned
+        blockSize((std::max(block_size, sizeof(void*)) + block_alignment - 1u) & ~(block_alignment - 1u)),
+        blockAlignment(block_alignment),
+        // Slabs are split straight into full magazines
+        blocksPerSlab(((std::max<size_t>(blocks_per_slab, 1u) + MagazineCapacity - 1u) / MagazineCapacity) * MagazineCapacity),
+        poolID(nextPoolID.fetch_add(1u, std::memory_order_relaxed))
+    {
+        assert((block_alignment & (block_alignment - 1u)) == 0u && "slab_pool block alignment must be a power of two!");
+        pool_registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.pools.emplace_back(poolID, this);
+    }
+
+    slab_pool::~slab_pool()
+    {
+        {
+            pool_registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.pools.erase(std::remove(reg.pools.begin(), reg.pools.end(), std::make_pair(poolID, this)), reg.pools.end());
+        }
+
+        slab_header_t* slab = slabs.load(std::memory_order_acquire);
+        while (slab != nullptr)
+        {
+            slab_header_t* next = slab->next;
+            const size_t alignment = slab->alignment;
+            slab->~slab_header_t();
+            ::operator delete(static_cast<void*>(slab), std::align_val_t(alignment));
+            slab = next;
+        }
+
+        for (std::atomic<magazine_t*>& segment : magazineSegments)
+        {
+            delete[] segment.load(std::memory_order_acquire);
+        }
+    }
+
+    void* slab_pool::allocate()
+    {
+        thread_cache_t* cache = localCache();
+
+        if (cache->loaded != invalidMagazine)
+        {
+            magazine_t* loaded = getMagazine(cache->loaded);
+            if (loaded->count != 0u)
+            {
+                return loaded->blocks[--loaded->count];
+            }
+        }
+
+        if (cache->previous != invalidMagazine && getMagazine(cache->previous)->count != 0u)
+        {
+            std::swap(cache->loaded, cache->previous);
+            magazine_t* loaded = getMagazine(cache->loaded);
+            return loaded->blocks[--loaded->count];
+        }
+
+        // Both empty: keep one empty magazine around for frees, and swap the other for a full one
+        if (cache->previous != invalidMagazine)
+        {
+            pushMagazine(emptyMagazines, cache->previous);
+        }
+        cache->previous = cache->loaded;
+
+        uint32_t full = popMagazine(fullMagazines);
+        if (full == invalidMagazine)
+        {
+            full = allocateSlab();
+        }
+        cache->loaded = full;
+
+        magazine_t* loaded = getMagazine(cache->loaded);
+        return loaded->blocks[--loaded->count];
+    }
+
+    void slab_pool::deallocate(void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        thread_cache_t* cache = localCache();
+
+        if (cache->loaded != invalidMagazine)
+        {
+            magazine_t* loaded = getMagazine(cache->loaded);
+            if (loaded->count != MagazineCapacity)
+            {
+                loaded->blocks[loaded->count++] = ptr;
+                return;
+            }
+        }
+
+        if (cache->previous != invalidMagazine && getMagazine(cache->previous)->count != MagazineCapacity)
+        {
+            std::swap(cache->loaded, cache->previous);
+            magazine_t* loaded = getMagazine(cache->loaded);
+            loaded->blocks[loaded->count++] = ptr;
+            return;
+        }
+
+        // Both full: keep one full magazine for allocations, and swap the other for an empty one
+        if (cache->previous != invalidMagazine)
+        {
+            pushMagazine(fullMagazines, cache->previous);
+        }
+        cache->previous = cache->loaded;
+
+        uint32_t empty = popMagazine(emptyMagazines);
+        if (empty == invalidMagazine)
+        {
+            empty = createMagazine();
+        }
+        cache->loaded = empty;
+
+        magazine_t* loaded = getMagazine(cache->loaded);
+        loaded->blocks[loaded->count++] = ptr;
+    }
+
+    size_t slab_pool::block_size() const noexcept
+    {
+        return blockSize;
+    }
+
+    slab_pool::stats_t slab_pool::stats() const noexcept
+    {
+        stats_t result;
+        result.blockSize = blockSize;
+        result.slabCount = slabCount.load(std::memory_order_relaxed);
+        result.bytesReserved = result.slabCount * blockSize * blocksPerSlab;
+        result.magazineCount = magazineCount.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    slab_pool::magazine_t* slab_pool::getMagazine(uint32_t idx) const noexcept
+    {
+        magazine_t* segment = magazineSegments[idx / MagazinesPerSegment].load(std::memory_order_acquire);
+        return segment + (idx % MagazinesPerSegment);
+    }
+
+    uint32_t slab_pool::createMagazine()
+    {
+        const uint32_t idx = magazineCount.fetch_add(1u, std::memory_order_relaxed);
+        const uint32_t segment_idx = idx / MagazinesPerSegment;
+        if (segment_idx >= MaxMagazineSegments)
+        {
+            throw std::bad_alloc();
+        }
+
+        std::atomic<magazine_t*>& segment = magazineSegments[segment_idx];
+        if (segment.load(std::memory_order_acquire) == nullptr)
+        {
+            magazine_t* new_segment = new magazine_t[MagazinesPerSegment];
+            magazine_t* expected = nullptr;
+            if (!segment.compare_exchange_strong(expected, new_segment, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                // Another thread got its segment in first
+                delete[] new_segment;
+            }
+        }
+
+        return idx;
+    }
+
+    void slab_pool::pushMagazine(std::atomic<uint64_t>& stack, uint32_t idx) noexcept
+    {
+        magazine_t* magazine = getMagazine(idx);
+        uint64_t head = stack.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do
+        {
+            magazine->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            desired = (((head >> 32u) + 1u) << 32u) | static_cast<uint64_t>(idx + 1u);
+        }
+        while (!stack.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    uint32_t slab_pool::popMagazine(std::atomic<uint64_t>& stack) noexcept
+    {
+        uint64_t head = stack.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const uint32_t top = static_cast<uint32_t>(head);
+            if (top == 0u)
+            {
+                return invalidMagazine;
+            }
+
+            // May be stale if top got popped and pushed again meanwhile, but then the tag changed too
+            const uint32_t next = getMagazine(top - 1u)->next.load(std::memory_order_relaxed);
+            const uint64_t desired = (((head >> 32u) + 1u) << 32u) | static_cast<uint64_t>(next);
+            if (stack.compare_exchange_weak(head, desired, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return top - 1u;
+            }
+        }
+    }
+
+    uint32_t slab_pool::allocateSlab()
+    {
+        const size_t alignment = std::max(blockAlignment, alignof(slab_header_t));
+        const size_t header_size = (sizeof(slab_header_t) + blockAlignment - 1u) & ~(blockAlignment - 1u);
+        const size_t total_size = header_size + blockSize * blocksPerSlab;
+
+        void* memory = ::operator new(total_size, std::align_val_t(alignment));
+        slab_header_t* header = ::new (memory) slab_header_t{ nullptr, total_size, alignment };
+        slab_header_t* head = slabs.load(std::memory_order_relaxed);
+        do
+        {
+            header->next = head;
+        }
+        while (!slabs.compare_exchange_weak(head, header, std::memory_order_release, std::memory_order_relaxed));
+        slabCount.fetch_add(1u, std::memory_order_relaxed);
+
+        std::byte* blocks = static_cast<std::byte*>(memory) + header_size;
+        uint32_t result = invalidMagazine;
+        for (size_t first = 0u; first < blocksPerSlab; first += MagazineCapacity)
+        {
+            uint32_t idx = popMagazine(emptyMagazines);
+            if (idx == invalidMagazine)
+            {
+                idx = createMagazine();
+            }
+
+            magazine_t* magazine = getMagazine(idx);
+            for (uint32_t i = 0u; i < MagazineCapacity; ++i)
+            {
+                magazine->blocks[i] = blocks + (first + i) * blockSize;
+            }
+            magazine->count = MagazineCapacity;
+
+            // Caller gets the first one, rest go to the depot
+            if (result == invalidMagazine)
+            {
+                result = idx;
+            }
+            else
+            {
+                pushMagazine(fullMagazines, idx);
+            }
+        }
+
+        return result;
+    }
+
+    slab_pool::thread_cache_t* slab_pool::localCache() noexcept
+    {
+        cache_table& table = localCaches;
+        if (table.entries[table.lastUsed].poolID == poolID)
+        {
+            return &table.entries[table.lastUsed];
+        }
+
+        for (uint32_t i = 0u; i < maxCachedPools; ++i)
+        {
+            if (table.entries[i].poolID == poolID)
+            {
+                table.lastUsed = i;
+                return &table.entries[i];
+            }
+        }
+
+        // Not cached yet: take a free entry, or evict one round-robin
+        uint32_t slot = maxCachedPools;
+        for (uint32_t i = 0u; i < maxCachedPools; ++i)
+        {
+            if (table.entries[i].poolID == 0u)
+            {
+                slot = i;
+                break;
+            }
+        }
+
+        if (slot == maxCachedPools)
+        {
+            slot = table.nextEviction;
+            table.nextEviction = (table.nextEviction + 1u) % maxCachedPools;
+            thread_cache_t& evicted = table.entries[slot];
+            pool_registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (is_registered(reg, evicted.poolID, evicted.pool))
+            {
+                evicted.flush();
+            }
+        }
+
+        table.entries[slot] = thread_cache_t{ poolID, this, invalidMagazine, invalidMagazine };
+        table.lastUsed = slot;
+        return &table.entries[slot];
+    }
+
+    void slab_pool::flushCache(thread_cache_t& cache) noexcept
+    {
+        for (uint32_t idx : { cache.loaded, cache.previous })
+        {
+            if (idx != invalidMagazine)
+            {
+                pushMagazine(getMagazine(idx)->count != 0u ? fullMagazines : emptyMagazines, idx);
+            }
+        }
+        cache = thread_cache_t{};
+    }
+
+    namespace
+    {
+        constexpr size_t sizeClassGranularity = 16u;
+        constexpr size_t maxSizeClassBytes = 512u;
+        constexpr std::array<size_t, 13u> sizeClasses{ 16u, 32u, 48u, 64u, 80u, 96u, 128u, 160u, 192u, 256u, 320u, 384u, 512u };
+
+        // Maps (size + 15) / 16 to an index into sizeClasses
+        constexpr std::array<uint8_t, maxSizeClassBytes / sizeClassGranularity + 1u> sizeClassLookup = []()
+        {
+            std::array<uint8_t, maxSizeClassBytes / sizeClassGranularity + 1u> lookup{};
+            size_t size_class = 0u;
+            for (size_t i = 0u; i < lookup.size(); ++i)
+            {
+                while (sizeClasses[size_class] < i * sizeClassGranularity)
+                {
+                    ++size_class;
+                }
+                lookup[i] = static_cast<uint8_t>(size_class);
+            }
+            return lookup;
+        }();
+
+        slab_pool** size_class_pools()
+        {
+            // Never destroyed: shared_ptrs with static storage duration may release into these during exit
+            static slab_pool** pools = []()
+            {
+                slab_pool** result = new slab_pool*[sizeClasses.size()];
+                for (size_t i = 0u; i < sizeClasses.size(); ++i)
+                {
+                    result[i] = new slab_pool(sizeClasses[i], alignof(std::max_align_t));
+                }
+                return result;
+            }();
+            return pools;
+        }
+    }
+
+    slab_pool* GetSlabPoolForSize(size_t size, size_t alignment) noexcept
+    {
+        if (size > maxSizeClassBytes || alignment > alignof(std::max_align_t))
+        {
+            return nullptr;
+        }
+        return size_class_pools()[sizeClassLookup[(size + sizeClassGranularity - 1u) / sizeClassGranularity]];
+    }
+
+}
@@ -1,39 +1,93 @@
 #include "PluginManagerImpl.hpp"
 #include <dlfcn.h>
+#include <unistd.h>
 #include <iostream>
 #ifdef __APPLE_CC__
 #include <boost/filesystem.hpp>
 #else
 #include <experimental/filesystem>
 #endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include <stdexcept>
+#include <system_error>
 #include <vector>
 
+#ifdef __APPLE_CC__
+namespace fs = boost::filesystem;
+#else
+namespace fs = std::experimental::filesystem;
+#endif
+
 static void* GetEngineApiFnPtr(uint32_t id) {
     auto& instance = PluginManager::GetPluginManager();
     return instance.RetrieveAPI(id);
 }
 
+static std::string MakeShadowPath(const std::string& absolute_path, uint32_t generation) {
+    const fs::path original(absolute_path);
+    fs::path shadow_dir = fs::temp_directory_path() / "diamond_dogs_plugins";
+    // pid keeps several running copies of the engine from stomping on each other's shadows
+    const std::string shadow_name = original.stem().string() + "." + std::to_string(getpid()) + "." +
+        std::to_string(generation) + original.extension().string();
+    return (shadow_dir / shadow_name).string();
+}
+
+static void RemoveShadowFile(const std::string& shadow_path) {
+    std::error_code ec;
+    fs::remove(fs::path(shadow_path), ec);
+}
+
 PluginManagerImpl::PluginManagerImpl() {}
 
-void PluginManagerImpl::LoadPlugin(const char * fname) {
-#ifdef __APPLE_CC__
-    namespace fs = boost::filesystem;
-#else
-    namespace fs = std::experimental::filesystem;
+PluginManagerImpl::~PluginManagerImpl() {
+#ifdef __linux__
+    if (inotifyFd != -1) {
+        close(inotifyFd);
+    }
 #endif
+    // Still mapped by any plugins that were never unloaded, but unlinking a mapped file is fine
+    for (const auto& entry : shadowFiles) {
+        RemoveShadowFile(entry.second);
+    }
+}
+
+plugin_handle PluginManagerImpl::openShadowCopy(const std::string& absolute_path, std::string& shadow_path) {
+    shadow_path = MakeShadowPath(absolute_path, shadowGeneration++);
+
+    std::error_code ec;
+    fs::create_directories(fs::path(shadow_path).parent_path(), ec);
+    if (!fs::copy_file(fs::path(absolute_path), fs::path(shadow_path), fs::copy_options::overwrite_existing, ec)) {
+        std::cerr << "Couldn't create shadow copy of plugin " << absolute_path << ": " << ec.message() << "\n";
+        return nullptr;
+    }
+
+    plugin_handle handle = dlopen(shadow_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        std::cerr << "dlopen failed for plugin " << absolute_path << ": " << dlerror() << "\n";
+        RemoveShadowFile(shadow_path);
+    }
+    return handle;
+}
+
+void PluginManagerImpl::LoadPlugin(const char * fname) {
     fs::path plugin_path(fname);
     if (!fs::exists(plugin_path)) {
         std::cerr << "Given path to plugin does not exist: " << plugin_path.string() << "\n";
+        return;
     }
 
     const std::string absolute_path = fs::absolute(plugin_path).string();
-    plugin_handle new_handle = dlopen(absolute_path.c_str(), RTLD_LOCAL);
+    std::string shadow_path;
+    plugin_handle new_handle = openShadowCopy(absolute_path, shadow_path);
 
     if (!new_handle) {
         throw std::runtime_error("Failed to load plugin!");
     }
     else {
         plugins.emplace(absolute_path, new_handle);
+        shadowFiles.emplace(absolute_path, shadow_path);
         void* get_api_fn = dlsym(new_handle, "GetPluginAPI");
         if (!get_api_fn) {
             std::cerr << "Couldn't find function address in plugin.";
@@ -50,16 +104,14 @@ void PluginManagerImpl::LoadPlugin(const char * fname) {
         apiPointers.emplace(id, unique_api);
 
         api->Load(GetEngineApiFnPtr);
-       
+
+        if (inotifyFd != -1) {
+            watchPluginDirectory(absolute_path);
+        }
     }
 }
 
 void PluginManagerImpl::UnloadPlugin(const char * fname) {
-#ifdef __APPLE_CC__
-    namespace fs= boost::filesystem;
-#else
-    namespace fs = std::experimental::filesystem;
-#endif
     const std::string plugin_path = fs::absolute(fs::path(fname)).string();
 
     auto iter = plugins.find(plugin_path);
@@ -69,9 +121,17 @@ void PluginManagerImpl::UnloadPlugin(const char * fname) {
         api->Unload();
         coreApiPointers.erase(id);
         apiPointers.erase(id);
-        pluginFilesToIDMap.erase(fname);
+        pluginFilesToIDMap.erase(plugin_path);
         dlclose(iter->second);
         plugins.erase(plugin_path);
+        pendingReloads.erase(plugin_path);
+        unwatchPluginDirectory(plugin_path);
+
+        auto shadow_iter = shadowFiles.find(plugin_path);
+        if (shadow_iter != std::end(shadowFiles)) {
+            RemoveShadowFile(shadow_iter->second);
+            shadowFiles.erase(shadow_iter);
+        }
     }
 }
 
@@ -105,3 +165,182 @@ Plugin_API* PluginManagerImpl::GetCoreAPI(uint32_t api_id) {
         return iter->second;
     }
 }
+
+bool PluginManagerImpl::EnableHotReload(uint32_t coalesce_window_ms) {
+    coalesceWindow = std::chrono::milliseconds(coalesce_window_ms);
+#ifdef __linux__
+    if (inotifyFd != -1) {
+        return true;
+    }
+
+    // Non-blocking, so draining events at the frame safe point never stalls the frame
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd == -1) {
+        std::cerr << "Failed to initialize inotify, plugin hot reloading disabled.\n";
+        return false;
+    }
+
+    for (const auto& entry : plugins) {
+        watchPluginDirectory(entry.first);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PluginManagerImpl::watchPluginDirectory(const std::string& absolute_path) {
+#ifdef __linux__
+    const std::string directory = fs::path(absolute_path).parent_path().string();
+    // Only events for finished writes and files moved/linked into place: compilers and linkers
+    // either write in-place and close, or write a temporary and rename it over the original
+    const int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd == -1) {
+        std::cerr << "Couldn't watch plugin directory " << directory << " for changes.\n";
+        return;
+    }
+    // inotify hands back the same descriptor for a directory that's already watched
+    pluginWatches[absolute_path] = wd;
+#endif
+}
+
+void PluginManagerImpl::unwatchPluginDirectory(const std::string& absolute_path) {
+#ifdef __linux__
+    auto iter = pluginWatches.find(absolute_path);
+    if (iter == std::end(pluginWatches)) {
+        return;
+    }
+
+    const int wd = iter->second;
+    pluginWatches.erase(iter);
+    for (const auto& entry : pluginWatches) {
+        if (entry.second == wd) {
+            return;
+        }
+    }
+    inotify_rm_watch(inotifyFd, wd);
+#endif
+}
+
+uint32_t PluginManagerImpl::ProcessPendingReloads() {
+#ifdef __linux__
+    if (inotifyFd == -1) {
+        return 0u;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point now = clock::now();
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: queue is drained
+            break;
+        }
+
+        for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(ptr)->len) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Lost events, so we can't tell what changed: conservatively reload everything
+                for (const auto& entry : plugins) {
+                    pendingReloads[entry.first] = now;
+                }
+                continue;
+            }
+
+            if (event->len == 0) {
+                continue;
+            }
+
+            const std::string changed_name(event->name);
+            for (const auto& entry : pluginWatches) {
+                if (entry.second == event->wd && fs::path(entry.first).filename().string() == changed_name) {
+                    // Restarts the window on every event, so a burst of writes yields one reload
+                    pendingReloads[entry.first] = now;
+                }
+            }
+        }
+    }
+
+    std::vector<std::string> ready_plugins;
+    for (auto iter = pendingReloads.begin(); iter != pendingReloads.end();) {
+        if (now - iter->second >= coalesceWindow) {
+            ready_plugins.emplace_back(iter->first);
+            iter = pendingReloads.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+
+    uint32_t num_reloaded = 0u;
+    for (const auto& path : ready_plugins) {
+        if (reloadPlugin(path)) {
+            ++num_reloaded;
+        }
+    }
+    return num_reloaded;
+#else
+    return 0u;
+#endif
+}
+
+bool PluginManagerImpl::reloadPlugin(const std::string& absolute_path) {
+    auto iter = plugins.find(absolute_path);
+    if (iter == std::end(plugins)) {
+        return false;
+    }
+
+    const uint32_t id = pluginFilesToIDMap.at(absolute_path);
+    Plugin_API* old_api = coreApiPointers.at(id);
+
+    // Load the new version next to the old one first: if anything about it is wrong, we just keep running the old one
+    std::string shadow_path;
+    plugin_handle new_handle = openShadowCopy(absolute_path, shadow_path);
+    if (!new_handle) {
+        std::cerr << "Reload of " << absolute_path << " failed, keeping previously loaded version.\n";
+        return false;
+    }
+
+    void* get_api_fn = dlsym(new_handle, "GetPluginAPI");
+    Plugin_API* new_api = get_api_fn ? reinterpret_cast<Plugin_API*>(reinterpret_cast<GetEngineAPI_Fn>(get_api_fn)(0)) : nullptr;
+    if (!new_api || new_api->PluginID() != id) {
+        std::cerr << "Reloaded plugin " << absolute_path << " doesn't expose a matching Plugin_API, keeping previously loaded version.\n";
+        dlclose(new_handle);
+        RemoveShadowFile(shadow_path);
+        return false;
+    }
+
+    // State only gets handed across when both sides implement the hooks: otherwise BeginReload's data
+    // would leak, or the old module would be dlclose'd without ever being told to Unload
+    const bool hand_off_state = old_api->BeginReload && new_api->FinishReload;
+    void* state_data = nullptr;
+    if (hand_off_state) {
+        state_data = old_api->BeginReload(GetEngineApiFnPtr);
+    }
+    else {
+        old_api->Unload();
+    }
+
+    coreApiPointers[id] = new_api;
+    apiPointers[id] = reinterpret_cast<GetEngineAPI_Fn>(get_api_fn)(id);
+
+    if (hand_off_state) {
+        new_api->FinishReload(GetEngineApiFnPtr, state_data);
+    }
+    else {
+        new_api->Load(GetEngineApiFnPtr);
+    }
+
+    dlclose(iter->second);
+    iter->second = new_handle;
+
+    auto shadow_iter = shadowFiles.find(absolute_path);
+    if (shadow_iter != std::end(shadowFiles)) {
+        RemoveShadowFile(shadow_iter->second);
+        shadow_iter->second = shadow_path;
+    }
+
+    return true;
+}
@@ -3,6 +3,7 @@
 #define PLUGIN_MANAGER_UNIX_IMPL_HPP
 #include "PluginManager.hpp"
 #include "CoreAPIs.hpp"
+#include <chrono>
 #include <string>
 #include <unordered_map>
 
@@ -10,17 +11,40 @@ using plugin_handle = void*;
 
 struct PluginManagerImpl {
     PluginManagerImpl();
+    ~PluginManagerImpl();
     void LoadPlugin(const char* fname);
     void UnloadPlugin(const char* fname);
     void* GetEngineAPI(uint32_t api_id);
     void LoadedPlugins(uint32_t * num_plugins, uint32_t * plugin_ids) const;
     Plugin_API* GetCoreAPI(uint32_t api_id);
+    bool EnableHotReload(uint32_t coalesce_window_ms);
+    // Returns number of plugins reloaded
+    uint32_t ProcessPendingReloads();
     std::unordered_map<std::string, plugin_handle> plugins;
     std::unordered_map<std::string, uint32_t> pluginFilesToIDMap;
     // Each plugin should expose a Plugin_API*
     std::unordered_map<uint32_t, Plugin_API*> coreApiPointers;
     // The unique plugin APIs loaded are stored here
     std::unordered_map<uint32_t, void*> apiPointers; 
+    // We dlopen a private copy of each plugin, so a build writing the original never touches the mapped file
+    std::unordered_map<std::string, std::string> shadowFiles;
+    uint32_t shadowGeneration{ 0u };
+
+private:
+    plugin_handle openShadowCopy(const std::string& absolute_path, std::string& shadow_path);
+    void watchPluginDirectory(const std::string& absolute_path);
+    void unwatchPluginDirectory(const std::string& absolute_path);
+    bool reloadPlugin(const std::string& absolute_path);
+
+    // inotify watch state: -1 until EnableHotReload succeeds
+    int inotifyFd{ -1 };
+    // Watch descriptor of the directory each plugin lives in: watching the directory instead of
+    // the file means we still see rebuilds that replace the binary with a new inode
+    std::unordered_map<std::string, int> pluginWatches;
+    // Time of the last change event per plugin path. Rebuilds touch a file several times in
+    // a row, so we only reload once a path has been quiet for the whole coalesce window
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> pendingReloads;
+    std::chrono::milliseconds coalesceWindow{ 150 };
 };
 
 #endif //!PLUGIN_MANAGER_UNIX_IMPL_HPP
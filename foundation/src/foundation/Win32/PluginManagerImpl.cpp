@@ -178,3 +178,14 @@ Plugin_API* PluginManagerImpl::GetCoreAPI(uint32_t api_id)
         return iter->second;
     }
 }
+
+bool PluginManagerImpl::EnableHotReload(uint32_t coalesce_window_ms)
+{
+    // No directory watcher on Win32 yet (would be ReadDirectoryChangesW), and loaded DLLs are locked by the OS anyways
+    return false;
+}
+
+uint32_t PluginManagerImpl::ProcessPendingReloads()
+{
+    return 0u;
+}
@@ -16,6 +16,9 @@ struct PluginManagerImpl {
     void* GetEngineAPI(uint32_t api_id);
     void LoadedPlugins(uint32_t * num_plugins, uint32_t * plugin_ids) const;
     Plugin_API* GetCoreAPI(uint32_t api_id);
+    bool EnableHotReload(uint32_t coalesce_window_ms);
+    // Returns number of plugins reloaded
+    uint32_t ProcessPendingReloads();
     std::unordered_map<std::wstring, plugin_handle> plugins;
     std::unordered_map<std::wstring, uint32_t> pluginFilesToIDMap;
     // Each plugin should expose a Plugin_API*
@@ -0,0 +1,415 @@
+#include "BoundsKernelsImpl.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FOUNDATION_BOUNDS_KERNELS_X64
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FOUNDATION_BOUNDS_KERNELS_ARM64
+#include <arm_neon.h>
+#endif
+
+namespace foundation::detail
+{
+
+    // The scalar reference. SIMD kernels mirror these expressions operation for operation, parenthesized
+    // the same way, so they round identically. (This file and the AVX2 one build with FP contraction off,
+    // so the compiler can't fuse any of these into FMAs on one side only.)
+
+    size_t cullAABBsScalarRange(const frustum_planes& planes, const aabb_soa_view& boxes, uint8_t* visible, size_t begin)
+    {
+        size_t visibleCount = 0u;
+        for (size_t i = begin; i < boxes.count; ++i)
+        {
+            const float centerX = (boxes.minX[i] + boxes.maxX[i]) * 0.5f;
+            const float centerY = (boxes.minY[i] + boxes.maxY[i]) * 0.5f;
+            const float centerZ = (boxes.minZ[i] + boxes.maxZ[i]) * 0.5f;
+            const float extentX = (boxes.maxX[i] - boxes.minX[i]) * 0.5f;
+            const float extentY = (boxes.maxY[i] - boxes.minY[i]) * 0.5f;
+            const float extentZ = (boxes.maxZ[i] - boxes.minZ[i]) * 0.5f;
+
+            bool outside = false;
+            for (size_t p = 0u; p < 6u; ++p)
+            {
+                const float distance = ((planes.nx[p] * centerX + planes.ny[p] * centerY) + planes.nz[p] * centerZ) + planes.d[p];
+                const float radius = (std::fabs(planes.nx[p]) * extentX + std::fabs(planes.ny[p]) * extentY) + std::fabs(planes.nz[p]) * extentZ;
+                outside |= (distance + radius) < 0.0f;
+            }
+
+            visible[i] = outside ? 0u : 1u;
+            visibleCount += outside ? 0u : 1u;
+        }
+        return visibleCount;
+    }
+
+    size_t cullSpheresScalarRange(const frustum_planes& planes, const sphere_soa_view& spheres, uint8_t* visible, size_t begin)
+    {
+        size_t visibleCount = 0u;
+        for (size_t i = begin; i < spheres.count; ++i)
+        {
+            const float negativeRadius = -spheres.radius[i];
+            bool outside = false;
+            for (size_t p = 0u; p < 6u; ++p)
+            {
+                const float distance = ((planes.nx[p] * spheres.x[i] + planes.ny[p] * spheres.y[i]) + planes.nz[p] * spheres.z[i]) + planes.d[p];
+                outside |= distance < negativeRadius;
+            }
+
+            visible[i] = outside ? 0u : 1u;
+            visibleCount += outside ? 0u : 1u;
+        }
+        return visibleCount;
+    }
+
+    void transformPointsScalarRange(const float* m, const point_soa_view& points, const point_soa_output& result, size_t begin)
+    {
+        for (size_t i = begin; i < points.count; ++i)
+        {
+            const float x = points.x[i];
+            const float y = points.y[i];
+            const float z = points.z[i];
+            result.x[i] = ((m[0] * x + m[4] * y) + m[8] * z) + m[12];
+            result.y[i] = ((m[1] * x + m[5] * y) + m[9] * z) + m[13];
+            result.z[i] = ((m[2] * x + m[6] * y) + m[10] * z) + m[14];
+        }
+    }
+
+    void transformAABBsScalarRange(const float* m, const aabb_soa_view& boxes, const aabb_soa_output& result, size_t begin)
+    {
+        for (size_t i = begin; i < boxes.count; ++i)
+        {
+            const float centerX = (boxes.minX[i] + boxes.maxX[i]) * 0.5f;
+            const float centerY = (boxes.minY[i] + boxes.maxY[i]) * 0.5f;
+            const float centerZ = (boxes.minZ[i] + boxes.maxZ[i]) * 0.5f;
+            const float extentX = (boxes.maxX[i] - boxes.minX[i]) * 0.5f;
+            const float extentY = (boxes.maxY[i] - boxes.minY[i]) * 0.5f;
+            const float extentZ = (boxes.maxZ[i] - boxes.minZ[i]) * 0.5f;
+
+            float newMin[3];
+            float newMax[3];
+            for (size_t row = 0u; row < 3u; ++row)
+            {
+                const float center = ((m[row] * centerX + m[4u + row] * centerY) + m[8u + row] * centerZ) + m[12u + row];
+                const float extent = (std::fabs(m[row]) * extentX + std::fabs(m[4u + row]) * extentY) + std::fabs(m[8u + row]) * extentZ;
+                newMin[row] = center - extent;
+                newMax[row] = center + extent;
+            }
+
+            result.minX[i] = newMin[0];
+            result.minY[i] = newMin[1];
+            result.minZ[i] = newMin[2];
+            result.maxX[i] = newMax[0];
+            result.maxY[i] = newMax[1];
+            result.maxZ[i] = newMax[2];
+        }
+    }
+
+    void mergeAABBsScalarRange(const aabb_soa_view& a, const aabb_soa_view& b, const aabb_soa_output& result, size_t begin)
+    {
+        // Written out rather than std::min/max, to match the SIMD min/max operand order exactly
+        for (size_t i = begin; i < a.count; ++i)
+        {
+            const float minX = a.minX[i] < b.minX[i] ? a.minX[i] : b.minX[i];
+            const float minY = a.minY[i] < b.minY[i] ? a.minY[i] : b.minY[i];
+            const float minZ = a.minZ[i] < b.minZ[i] ? a.minZ[i] : b.minZ[i];
+            const float maxX = b.maxX[i] < a.maxX[i] ? a.maxX[i] : b.maxX[i];
+            const float maxY = b.maxY[i] < a.maxY[i] ? a.maxY[i] : b.maxY[i];
+            const float maxZ = b.maxZ[i] < a.maxZ[i] ? a.maxZ[i] : b.maxZ[i];
+            result.minX[i] = minX;
+            result.minY[i] = minY;
+            result.minZ[i] = minZ;
+            result.maxX[i] = maxX;
+            result.maxY[i] = maxY;
+            result.maxZ[i] = maxZ;
+        }
+    }
+
+    void reduceAABBsScalarRange(const aabb_soa_view& boxes, aabb_bounds& bounds, size_t begin)
+    {
+        for (size_t i = begin; i < boxes.count; ++i)
+        {
+            bounds.min[0] = boxes.minX[i] < bounds.min[0] ? boxes.minX[i] : bounds.min[0];
+            bounds.min[1] = boxes.minY[i] < bounds.min[1] ? boxes.minY[i] : bounds.min[1];
+            bounds.min[2] = boxes.minZ[i] < bounds.min[2] ? boxes.minZ[i] : bounds.min[2];
+            bounds.max[0] = bounds.max[0] < boxes.maxX[i] ? boxes.maxX[i] : bounds.max[0];
+            bounds.max[1] = bounds.max[1] < boxes.maxY[i] ? boxes.maxY[i] : bounds.max[1];
+            bounds.max[2] = bounds.max[2] < boxes.maxZ[i] ? boxes.maxZ[i] : bounds.max[2];
+        }
+    }
+
+}
+
+namespace
+{
+    using namespace foundation;
+
+    size_t cullAABBsScalar(const frustum_planes& planes, const aabb_soa_view& boxes, uint8_t* visible)
+    {
+        return detail::cullAABBsScalarRange(planes, boxes, visible, 0u);
+    }
+
+    size_t cullSpheresScalar(const frustum_planes& planes, const sphere_soa_view& spheres, uint8_t* visible)
+    {
+        return detail::cullSpheresScalarRange(planes, spheres, visible, 0u);
+    }
+
+    void transformPointsScalar(const float* matrix, const point_soa_view& points, const point_soa_output& result)
+    {
+        detail::transformPointsScalarRange(matrix, points, result, 0u);
+    }
+
+    void transformAABBsScalar(const float* matrix, const aabb_soa_view& boxes, const aabb_soa_output& result)
+    {
+        detail::transformAABBsScalarRange(matrix, boxes, result, 0u);
+    }
+
+    void mergeAABBsScalar(const aabb_soa_view& a, const aabb_soa_view& b, const aabb_soa_output& result)
+    {
+        detail::mergeAABBsScalarRange(a, b, result, 0u);
+    }
+
+    aabb_bounds reduceAABBsScalar(const aabb_soa_view& boxes)
+    {
+        aabb_bounds bounds;
+        detail::reduceAABBsScalarRange(boxes, bounds, 0u);
+        return bounds;
+    }
+
+    constexpr bounds_kernel_table scalarBoundsKernels
+    {
+        simd_level::Scalar,
+        &cullAABBsScalar,
+        &cullSpheresScalar,
+        &transformPointsScalar,
+        &transformAABBsScalar,
+        &mergeAABBsScalar,
+        &reduceAABBsScalar
+    };
+
+#if defined(FOUNDATION_BOUNDS_KERNELS_X64)
+
+    // SSE2 is the x86-64 baseline, so this level never needs checking for
+    struct simd_ops
+    {
+        using vec = __m128;
+        using mask = __m128;
+        static constexpr size_t Width = 4u;
+
+        static vec load(const float* ptr) noexcept { return _mm_loadu_ps(ptr); }
+        static void store(float* ptr, vec v) noexcept { _mm_storeu_ps(ptr, v); }
+        static vec set1(float value) noexcept { return _mm_set1_ps(value); }
+        static vec add(vec a, vec b) noexcept { return _mm_add_ps(a, b); }
+        static vec sub(vec a, vec b) noexcept { return _mm_sub_ps(a, b); }
+        static vec mul(vec a, vec b) noexcept { return _mm_mul_ps(a, b); }
+        static vec abs(vec a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        static vec negate(vec a) noexcept { return _mm_xor_ps(_mm_set1_ps(-0.0f), a); }
+        static mask less(vec a, vec b) noexcept { return _mm_cmplt_ps(a, b); }
+        static mask orMask(mask a, mask b) noexcept { return _mm_or_ps(a, b); }
+        static uint32_t laneBits(mask m) noexcept { return static_cast<uint32_t>(_mm_movemask_ps(m)); }
+        static vec select(mask m, vec a, vec b) noexcept { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    };
+
+#include "BoundsKernelsSimd.inl"
+
+    constexpr bounds_kernel_table sseBoundsKernels = makeBoundsKernelTable<simd_ops>(simd_level::SSE);
+
+    bool cpuSupportsAVX2() noexcept
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6u) == 0x6u;
+        const bool hasAVX = (info[2] & (1 << 28)) != 0;
+        __cpuidex(info, 7, 0);
+        const bool hasAVX2 = (info[1] & (1 << 5)) != 0;
+        return osSavesYmm && hasAVX && hasAVX2;
+#else
+        // Also checks the OS saves YMM state
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#elif defined(FOUNDATION_BOUNDS_KERNELS_ARM64)
+
+    // NEON is part of the arm64 baseline, so this level never needs checking for either
+    struct simd_ops
+    {
+        using vec = float32x4_t;
+        using mask = uint32x4_t;
+        static constexpr size_t Width = 4u;
+
+        static vec load(const float* ptr) noexcept { return vld1q_f32(ptr); }
+        static void store(float* ptr, vec v) noexcept { vst1q_f32(ptr, v); }
+        static vec set1(float value) noexcept { return vdupq_n_f32(value); }
+        static vec add(vec a, vec b) noexcept { return vaddq_f32(a, b); }
+        static vec sub(vec a, vec b) noexcept { return vsubq_f32(a, b); }
+        static vec mul(vec a, vec b) noexcept { return vmulq_f32(a, b); }
+        static vec abs(vec a) noexcept { return vabsq_f32(a); }
+        static vec negate(vec a) noexcept { return vnegq_f32(a); }
+        static mask less(vec a, vec b) noexcept { return vcltq_f32(a, b); }
+        static mask orMask(mask a, mask b) noexcept { return vorrq_u32(a, b); }
+        static vec select(mask m, vec a, vec b) noexcept { return vbslq_f32(m, a, b); }
+
+        static uint32_t laneBits(mask m) noexcept
+        {
+            const uint32x4_t laneWeights = { 1u, 2u, 4u, 8u };
+            return vaddvq_u32(vandq_u32(m, laneWeights));
+        }
+    };
+
+#include "BoundsKernelsSimd.inl"
+
+    constexpr bounds_kernel_table neonBoundsKernels = makeBoundsKernelTable<simd_ops>(simd_level::NEON);
+
+#endif
+
+    simd_level detectBestSimdLevel() noexcept
+    {
+#if defined(FOUNDATION_BOUNDS_KERNELS_X64)
+        return cpuSupportsAVX2() ? simd_level::AVX2 : simd_level::SSE;
+#elif defined(FOUNDATION_BOUNDS_KERNELS_ARM64)
+        return simd_level::NEON;
+#else
+        return simd_level::Scalar;
+#endif
+    }
+
+    const bounds_kernel_table& tableForSupportedLevel(simd_level level) noexcept
+    {
+        switch (level)
+        {
+#if defined(FOUNDATION_BOUNDS_KERNELS_X64)
+        case simd_level::AVX2:
+            return detail::avx2BoundsKernels;
+        case simd_level::SSE:
+            return sseBoundsKernels;
+#elif defined(FOUNDATION_BOUNDS_KERNELS_ARM64)
+        case simd_level::NEON:
+            return neonBoundsKernels;
+#endif
+        default:
+            return scalarBoundsKernels;
+        }
+    }
+
+    const bounds_kernel_table& bestTable() noexcept
+    {
+        static const bounds_kernel_table& table = tableForSupportedLevel(detectBestSimdLevel());
+        return table;
+    }
+
+}
+
+namespace foundation
+{
+
+    const bounds_kernel_table& GetBoundsKernelTable(simd_level level) noexcept
+    {
+        if (level == simd_level::Scalar)
+        {
+            return scalarBoundsKernels;
+        }
+#if defined(FOUNDATION_BOUNDS_KERNELS_X64)
+        else if (level == simd_level::SSE)
+        {
+            return sseBoundsKernels;
+        }
+#endif
+        return bestTable();
+    }
+
+    simd_level GetBestSimdLevel() noexcept
+    {
+        return bestTable().level;
+    }
+
+    const char* GetSimdLevelName(simd_level level) noexcept
+    {
+        switch (level)
+        {
+        case simd_level::Scalar:
+            return "Scalar";
+        case simd_level::SSE:
+            return "SSE";
+        case simd_level::AVX2:
+            return "AVX2";
+        case simd_level::NEON:
+            return "NEON";
+        case simd_level::Best:
+            return GetSimdLevelName(GetBestSimdLevel());
+        default:
+            return "Unknown";
+        }
+    }
+
+    frustum_planes FrustumPlanesFromMatrix(const float* m) noexcept
+    {
+        // Rows of the column-major matrix
+        const float rows[4][4] =
+        {
+            { m[0], m[4], m[8], m[12] },
+            { m[1], m[5], m[9], m[13] },
+            { m[2], m[6], m[10], m[14] },
+            { m[3], m[7], m[11], m[15] }
+        };
+
+        // Left, right, bottom, top, near, far
+        const float planeSigns[6] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+        const size_t planeRows[6] = { 0u, 0u, 1u, 1u, 2u, 2u };
+
+        frustum_planes result;
+        for (size_t p = 0u; p < 6u; ++p)
+        {
+            float plane[4];
+            for (size_t c = 0u; c < 4u; ++c)
+            {
+                // Near plane is just row 2 with [0, 1] depth, rather than row 3 + row 2
+                const float base = (p == 4u) ? 0.0f : rows[3][c];
+                plane[c] = base + planeSigns[p] * rows[planeRows[p]][c];
+            }
+
+            const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            const float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+            result.nx[p] = plane[0] * invLength;
+            result.ny[p] = plane[1] * invLength;
+            result.nz[p] = plane[2] * invLength;
+            result.d[p] = plane[3] * invLength;
+        }
+
+        return result;
+    }
+
+    size_t CullAABBs(const frustum_planes& planes, const aabb_soa_view& boxes, uint8_t* visible)
+    {
+        return bestTable().cullAABBs(planes, boxes, visible);
+    }
+
+    size_t CullSpheres(const frustum_planes& planes, const sphere_soa_view& spheres, uint8_t* visible)
+    {
+        return bestTable().cullSpheres(planes, spheres, visible);
+    }
+
+    void TransformPoints(const float* matrix, const point_soa_view& points, const point_soa_output& result)
+    {
+        bestTable().transformPoints(matrix, points, result);
+    }
+
+    void TransformAABBs(const float* matrix, const aabb_soa_view& boxes, const aabb_soa_output& result)
+    {
+        bestTable().transformAABBs(matrix, boxes, result);
+    }
+
+    void MergeAABBs(const aabb_soa_view& a, const aabb_soa_view& b, const aabb_soa_output& result)
+    {
+        bestTable().mergeAABBs(a, b, result);
+    }
+
+    aabb_bounds ReduceAABBs(const aabb_soa_view& boxes)
+    {
+        return bestTable().reduceAABBs(boxes);
+    }
+
+}
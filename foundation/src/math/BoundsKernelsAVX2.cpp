@@ -0,0 +1,41 @@
+// Built with -mavx2 on GCC/Clang: only reached after BoundsKernels.cpp has checked the CPU supports it.
+// Keep includes here to just intrinsics and our own declarations (see BoundsKernelsImpl.hpp for why).
+#include "BoundsKernelsImpl.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+namespace
+{
+    using namespace foundation;
+
+    struct simd_ops
+    {
+        using vec = __m256;
+        using mask = __m256;
+        static constexpr size_t Width = 8u;
+
+        static vec load(const float* ptr) noexcept { return _mm256_loadu_ps(ptr); }
+        static void store(float* ptr, vec v) noexcept { _mm256_storeu_ps(ptr, v); }
+        static vec set1(float value) noexcept { return _mm256_set1_ps(value); }
+        static vec add(vec a, vec b) noexcept { return _mm256_add_ps(a, b); }
+        static vec sub(vec a, vec b) noexcept { return _mm256_sub_ps(a, b); }
+        static vec mul(vec a, vec b) noexcept { return _mm256_mul_ps(a, b); }
+        static vec abs(vec a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static vec negate(vec a) noexcept { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), a); }
+        static mask less(vec a, vec b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static mask orMask(mask a, mask b) noexcept { return _mm256_or_ps(a, b); }
+        static uint32_t laneBits(mask m) noexcept { return static_cast<uint32_t>(_mm256_movemask_ps(m)); }
+        static vec select(mask m, vec a, vec b) noexcept { return _mm256_blendv_ps(b, a, m); }
+    };
+
+#include "BoundsKernelsSimd.inl"
+
+}
+
+namespace foundation::detail
+{
+    const bounds_kernel_table avx2BoundsKernels = makeBoundsKernelTable<simd_ops>(simd_level::AVX2);
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef FOUNDATION_MATH_BOUNDS_KERNELS_IMPL_HPP
+#define FOUNDATION_MATH_BOUNDS_KERNELS_IMPL_HPP
+#include "math/BoundsKernels.hpp"
+
+/*
+    Shared between the kernel translation units. Deliberately nothing inline in here: the AVX2 file is
+    compiled with -mavx2, and any inline function it instantiated could get picked by the linker for
+    the scalar paths too, then fault on CPUs without AVX2. SIMD kernels hand their tails (count % width)
+    to the out-of-line scalar range functions instead.
+*/
+namespace foundation::detail
+{
+
+    size_t cullAABBsScalarRange(const frustum_planes& planes, const aabb_soa_view& boxes, uint8_t* visible, size_t begin);
+    size_t cullSpheresScalarRange(const frustum_planes& planes, const sphere_soa_view& spheres, uint8_t* visible, size_t begin);
+    void transformPointsScalarRange(const float* matrix, const point_soa_view& points, const point_soa_output& result, size_t begin);
+    void transformAABBsScalarRange(const float* matrix, const aabb_soa_view& boxes, const aabb_soa_output& result, size_t begin);
+    void mergeAABBsScalarRange(const aabb_soa_view& a, const aabb_soa_view& b, const aabb_soa_output& result, size_t begin);
+    void reduceAABBsScalarRange(const aabb_soa_view& boxes, aabb_bounds& bounds, size_t begin);
+
+#if defined(__x86_64__) || defined(_M_X64)
+    extern const bounds_kernel_table avx2BoundsKernels;
+#endif
+
+}
+
+#endif //!FOUNDATION_MATH_BOUNDS_KERNELS_IMPL_HPP
@@ -0,0 +1,265 @@
+// Generic SIMD bodies for the bounds kernels. Included inside an anonymous namespace by each kernel
+// translation unit, after it defines a simd_ops struct for its instruction set, so every instantiation
+// stays internal to the TU (and its target flags) that made it.
+//
+// simd_ops provides: Width, vec, mask, load, store (both unaligned), set1, add, sub, mul, abs, negate,
+// less, orMask, laneBits (lane i set -> bit i) and select (mask ? a : b).
+
+template<typename simd_ops>
+size_t cullAABBsSimd(const frustum_planes& planes, const aabb_soa_view& boxes, uint8_t* visible)
+{
+    using vec = typename simd_ops::vec;
+    using mask = typename simd_ops::mask;
+    constexpr size_t Width = simd_ops::Width;
+
+    const vec half = simd_ops::set1(0.5f);
+    const vec zero = simd_ops::set1(0.0f);
+    size_t visibleCount = 0u;
+    size_t i = 0u;
+    for (; i + Width <= boxes.count; i += Width)
+    {
+        const vec minX = simd_ops::load(boxes.minX + i);
+        const vec minY = simd_ops::load(boxes.minY + i);
+        const vec minZ = simd_ops::load(boxes.minZ + i);
+        const vec maxX = simd_ops::load(boxes.maxX + i);
+        const vec maxY = simd_ops::load(boxes.maxY + i);
+        const vec maxZ = simd_ops::load(boxes.maxZ + i);
+        const vec centerX = simd_ops::mul(simd_ops::add(minX, maxX), half);
+        const vec centerY = simd_ops::mul(simd_ops::add(minY, maxY), half);
+        const vec centerZ = simd_ops::mul(simd_ops::add(minZ, maxZ), half);
+        const vec extentX = simd_ops::mul(simd_ops::sub(maxX, minX), half);
+        const vec extentY = simd_ops::mul(simd_ops::sub(maxY, minY), half);
+        const vec extentZ = simd_ops::mul(simd_ops::sub(maxZ, minZ), half);
+
+        mask outside = simd_ops::less(zero, zero);
+        for (size_t p = 0u; p < 6u; ++p)
+        {
+            const vec nx = simd_ops::set1(planes.nx[p]);
+            const vec ny = simd_ops::set1(planes.ny[p]);
+            const vec nz = simd_ops::set1(planes.nz[p]);
+            const vec distance = simd_ops::add(simd_ops::add(simd_ops::add(simd_ops::mul(nx, centerX), simd_ops::mul(ny, centerY)),
+                simd_ops::mul(nz, centerZ)), simd_ops::set1(planes.d[p]));
+            const vec radius = simd_ops::add(simd_ops::add(simd_ops::mul(simd_ops::abs(nx), extentX), simd_ops::mul(simd_ops::abs(ny), extentY)),
+                simd_ops::mul(simd_ops::abs(nz), extentZ));
+            outside = simd_ops::orMask(outside, simd_ops::less(simd_ops::add(distance, radius), zero));
+        }
+
+        const uint32_t outsideBits = simd_ops::laneBits(outside);
+        for (size_t lane = 0u; lane < Width; ++lane)
+        {
+            const uint8_t isVisible = ((outsideBits >> lane) & 1u) == 0u ? 1u : 0u;
+            visible[i + lane] = isVisible;
+            visibleCount += isVisible;
+        }
+    }
+
+    return visibleCount + detail::cullAABBsScalarRange(planes, boxes, visible, i);
+}
+
+template<typename simd_ops>
+size_t cullSpheresSimd(const frustum_planes& planes, const sphere_soa_view& spheres, uint8_t* visible)
+{
+    using vec = typename simd_ops::vec;
+    using mask = typename simd_ops::mask;
+    constexpr size_t Width = simd_ops::Width;
+
+    const vec zero = simd_ops::set1(0.0f);
+    size_t visibleCount = 0u;
+    size_t i = 0u;
+    for (; i + Width <= spheres.count; i += Width)
+    {
+        const vec x = simd_ops::load(spheres.x + i);
+        const vec y = simd_ops::load(spheres.y + i);
+        const vec z = simd_ops::load(spheres.z + i);
+        const vec negativeRadius = simd_ops::negate(simd_ops::load(spheres.radius + i));
+
+        mask outside = simd_ops::less(zero, zero);
+        for (size_t p = 0u; p < 6u; ++p)
+        {
+            const vec distance = simd_ops::add(simd_ops::add(simd_ops::add(simd_ops::mul(simd_ops::set1(planes.nx[p]), x),
+                simd_ops::mul(simd_ops::set1(planes.ny[p]), y)), simd_ops::mul(simd_ops::set1(planes.nz[p]), z)), simd_ops::set1(planes.d[p]));
+            outside = simd_ops::orMask(outside, simd_ops::less(distance, negativeRadius));
+        }
+
+        const uint32_t outsideBits = simd_ops::laneBits(outside);
+        for (size_t lane = 0u; lane < Width; ++lane)
+        {
+            const uint8_t isVisible = ((outsideBits >> lane) & 1u) == 0u ? 1u : 0u;
+            visible[i + lane] = isVisible;
+            visibleCount += isVisible;
+        }
+    }
+
+    return visibleCount + detail::cullSpheresScalarRange(planes, spheres, visible, i);
+}
+
+template<typename simd_ops>
+void transformPointsSimd(const float* m, const point_soa_view& points, const point_soa_output& result)
+{
+    using vec = typename simd_ops::vec;
+    constexpr size_t Width = simd_ops::Width;
+
+    size_t i = 0u;
+    for (; i + Width <= points.count; i += Width)
+    {
+        const vec x = simd_ops::load(points.x + i);
+        const vec y = simd_ops::load(points.y + i);
+        const vec z = simd_ops::load(points.z + i);
+        vec transformed[3];
+        for (size_t row = 0u; row < 3u; ++row)
+        {
+            transformed[row] = simd_ops::add(simd_ops::add(simd_ops::add(simd_ops::mul(simd_ops::set1(m[row]), x),
+                simd_ops::mul(simd_ops::set1(m[4u + row]), y)), simd_ops::mul(simd_ops::set1(m[8u + row]), z)), simd_ops::set1(m[12u + row]));
+        }
+        simd_ops::store(result.x + i, transformed[0]);
+        simd_ops::store(result.y + i, transformed[1]);
+        simd_ops::store(result.z + i, transformed[2]);
+    }
+
+    detail::transformPointsScalarRange(m, points, result, i);
+}
+
+template<typename simd_ops>
+void transformAABBsSimd(const float* m, const aabb_soa_view& boxes, const aabb_soa_output& result)
+{
+    using vec = typename simd_ops::vec;
+    constexpr size_t Width = simd_ops::Width;
+
+    const vec half = simd_ops::set1(0.5f);
+    size_t i = 0u;
+    for (; i + Width <= boxes.count; i += Width)
+    {
+        const vec minX = simd_ops::load(boxes.minX + i);
+        const vec minY = simd_ops::load(boxes.minY + i);
+        const vec minZ = simd_ops::load(boxes.minZ + i);
+        const vec maxX = simd_ops::load(boxes.maxX + i);
+        const vec maxY = simd_ops::load(boxes.maxY + i);
+        const vec maxZ = simd_ops::load(boxes.maxZ + i);
+        const vec centerX = simd_ops::mul(simd_ops::add(minX, maxX), half);
+        const vec centerY = simd_ops::mul(simd_ops::add(minY, maxY), half);
+        const vec centerZ = simd_ops::mul(simd_ops::add(minZ, maxZ), half);
+        const vec extentX = simd_ops::mul(simd_ops::sub(maxX, minX), half);
+        const vec extentY = simd_ops::mul(simd_ops::sub(maxY, minY), half);
+        const vec extentZ = simd_ops::mul(simd_ops::sub(maxZ, minZ), half);
+
+        vec newMin[3];
+        vec newMax[3];
+        for (size_t row = 0u; row < 3u; ++row)
+        {
+            const vec m0 = simd_ops::set1(m[row]);
+            const vec m1 = simd_ops::set1(m[4u + row]);
+            const vec m2 = simd_ops::set1(m[8u + row]);
+            const vec center = simd_ops::add(simd_ops::add(simd_ops::add(simd_ops::mul(m0, centerX), simd_ops::mul(m1, centerY)),
+                simd_ops::mul(m2, centerZ)), simd_ops::set1(m[12u + row]));
+            const vec extent = simd_ops::add(simd_ops::add(simd_ops::mul(simd_ops::abs(m0), extentX), simd_ops::mul(simd_ops::abs(m1), extentY)),
+                simd_ops::mul(simd_ops::abs(m2), extentZ));
+            newMin[row] = simd_ops::sub(center, extent);
+            newMax[row] = simd_ops::add(center, extent);
+        }
+
+        simd_ops::store(result.minX + i, newMin[0]);
+        simd_ops::store(result.minY + i, newMin[1]);
+        simd_ops::store(result.minZ + i, newMin[2]);
+        simd_ops::store(result.maxX + i, newMax[0]);
+        simd_ops::store(result.maxY + i, newMax[1]);
+        simd_ops::store(result.maxZ + i, newMax[2]);
+    }
+
+    detail::transformAABBsScalarRange(m, boxes, result, i);
+}
+
+// Same semantics as the scalar (a < b ? a : b), including which operand wins for NaNs and signed zeros
+template<typename simd_ops>
+typename simd_ops::vec minSimd(typename simd_ops::vec a, typename simd_ops::vec b)
+{
+    return simd_ops::select(simd_ops::less(a, b), a, b);
+}
+
+template<typename simd_ops>
+typename simd_ops::vec maxSimd(typename simd_ops::vec a, typename simd_ops::vec b)
+{
+    return simd_ops::select(simd_ops::less(b, a), a, b);
+}
+
+template<typename simd_ops>
+void mergeAABBsSimd(const aabb_soa_view& a, const aabb_soa_view& b, const aabb_soa_output& result)
+{
+    constexpr size_t Width = simd_ops::Width;
+
+    size_t i = 0u;
+    for (; i + Width <= a.count; i += Width)
+    {
+        const auto minX = minSimd<simd_ops>(simd_ops::load(a.minX + i), simd_ops::load(b.minX + i));
+        const auto minY = minSimd<simd_ops>(simd_ops::load(a.minY + i), simd_ops::load(b.minY + i));
+        const auto minZ = minSimd<simd_ops>(simd_ops::load(a.minZ + i), simd_ops::load(b.minZ + i));
+        const auto maxX = maxSimd<simd_ops>(simd_ops::load(a.maxX + i), simd_ops::load(b.maxX + i));
+        const auto maxY = maxSimd<simd_ops>(simd_ops::load(a.maxY + i), simd_ops::load(b.maxY + i));
+        const auto maxZ = maxSimd<simd_ops>(simd_ops::load(a.maxZ + i), simd_ops::load(b.maxZ + i));
+        simd_ops::store(result.minX + i, minX);
+        simd_ops::store(result.minY + i, minY);
+        simd_ops::store(result.minZ + i, minZ);
+        simd_ops::store(result.maxX + i, maxX);
+        simd_ops::store(result.maxY + i, maxY);
+        simd_ops::store(result.maxZ + i, maxZ);
+    }
+
+    detail::mergeAABBsScalarRange(a, b, result, i);
+}
+
+template<typename simd_ops>
+aabb_bounds reduceAABBsSimd(const aabb_soa_view& boxes)
+{
+    using vec = typename simd_ops::vec;
+    constexpr size_t Width = simd_ops::Width;
+
+    aabb_bounds bounds;
+    vec accumulators[6] =
+    {
+        simd_ops::set1(bounds.min[0]), simd_ops::set1(bounds.min[1]), simd_ops::set1(bounds.min[2]),
+        simd_ops::set1(bounds.max[0]), simd_ops::set1(bounds.max[1]), simd_ops::set1(bounds.max[2])
+    };
+
+    size_t i = 0u;
+    for (; i + Width <= boxes.count; i += Width)
+    {
+        accumulators[0] = minSimd<simd_ops>(simd_ops::load(boxes.minX + i), accumulators[0]);
+        accumulators[1] = minSimd<simd_ops>(simd_ops::load(boxes.minY + i), accumulators[1]);
+        accumulators[2] = minSimd<simd_ops>(simd_ops::load(boxes.minZ + i), accumulators[2]);
+        accumulators[3] = maxSimd<simd_ops>(simd_ops::load(boxes.maxX + i), accumulators[3]);
+        accumulators[4] = maxSimd<simd_ops>(simd_ops::load(boxes.maxY + i), accumulators[4]);
+        accumulators[5] = maxSimd<simd_ops>(simd_ops::load(boxes.maxZ + i), accumulators[5]);
+    }
+
+    float lanes[Width];
+    for (size_t axis = 0u; axis < 3u; ++axis)
+    {
+        simd_ops::store(lanes, accumulators[axis]);
+        for (size_t lane = 0u; lane < Width; ++lane)
+        {
+            bounds.min[axis] = lanes[lane] < bounds.min[axis] ? lanes[lane] : bounds.min[axis];
+        }
+        simd_ops::store(lanes, accumulators[3u + axis]);
+        for (size_t lane = 0u; lane < Width; ++lane)
+        {
+            bounds.max[axis] = lanes[lane] > bounds.max[axis] ? lanes[lane] : bounds.max[axis];
+        }
+    }
+
+    detail::reduceAABBsScalarRange(boxes, bounds, i);
+    return bounds;
+}
+
+template<typename simd_ops>
+constexpr bounds_kernel_table makeBoundsKernelTable(simd_level level) noexcept
+{
+    return bounds_kernel_table
+    {
+        level,
+        &cullAABBsSimd<simd_ops>,
+        &cullSpheresSimd<simd_ops>,
+        &transformPointsSimd<simd_ops>,
+        &transformAABBsSimd<simd_ops>,
+        &mergeAABBsSimd<simd_ops>,
+        &reduceAABBsSimd<simd_ops>
+    };
+}
@@ -1,2 +1,376 @@
 // Including this file should override new/delete operators to use mimalloc project-wide
+#include "foundation/AllocationSampling.hpp"
+
+#ifndef FOUNDATION_ALLOCATION_SAMPLING_CONF
+
 #include "mimalloc-new-delete.h"
+
+namespace foundation
+{
+
+    bool SetAllocationSampleInterval(size_t) noexcept
+    {
+        return false;
+    }
+
+    size_t GetAllocationSampleInterval() noexcept
+    {
+        return 0u;
+    }
+
+    std::vector<allocation_callsite> GetAllocationCallsites()
+    {
+        return {};
+    }
+
+    bool DumpAllocationCallsites(const char*, size_t)
+    {
+        return false;
+    }
+
+    void ResetAllocationSamples() noexcept
+    {
+    }
+
+    uint64_t GetDroppedAllocationSampleCount() noexcept
+    {
+        return 0u;
+    }
+
+}
+
+#else
+
+#include <mimalloc.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <execinfo.h>
+#endif
+
+/*
+    Same overrides mimalloc-new-delete.h provides, with a sampling hook in front of each operator new.
+
+    Sampling follows the tcmalloc/heapprofd scheme: each thread counts down a randomly drawn number of
+    bytes (exponentially distributed, mean = interval) and the allocation that crosses zero is sampled.
+    The common path is just that subtraction. Drawing the distances randomly, rather than sampling
+    every Nth byte, keeps allocations with periodic sizes from being systematically hit or missed.
+*/
+namespace
+{
+
+    using foundation::allocation_callsite;
+    using foundation::MaxAllocationSampleCallsites;
+    using foundation::MaxAllocationSampleFrames;
+
+    // Countdowns never exceed this, so a thread notices a changed interval within this many bytes.
+    // Capping is free statistically: the exponential is memoryless, so redrawing is equivalent to continuing.
+    constexpr int64_t RecheckIntervalBytes = int64_t(16) * 1024 * 1024;
+    // sampleSlowPath() + operator new itself
+    constexpr int SkippedFrames = 2;
+
+    std::atomic<size_t> sampleInterval{ 0u };
+    std::atomic<uint64_t> droppedSamples{ 0u };
+
+    std::mutex callsiteMutex;
+    // Static so recording a sample never allocates (and never recurses back into operator new)
+    allocation_callsite callsites[MaxAllocationSampleCallsites];
+    uint64_t callsiteHashes[MaxAllocationSampleCallsites];
+
+    // Zero, so each thread's first allocation takes the slow path and draws its real countdown
+    thread_local int64_t bytesUntilSample{ 0 };
+    thread_local bool countdownIsSample{ false };
+    thread_local bool inSampler{ false };
+    thread_local uint64_t rngState{ 0u };
+
+    struct sampler_reentry_guard
+    {
+        sampler_reentry_guard() noexcept : wasInSampler(inSampler)
+        {
+            inSampler = true;
+        }
+
+        ~sampler_reentry_guard()
+        {
+            inSampler = wasInSampler;
+        }
+
+        const bool wasInSampler;
+    };
+
+    double nextUniform() noexcept
+    {
+        if (rngState == 0u)
+        {
+            rngState = reinterpret_cast<uintptr_t>(&rngState) ^ 0x9E3779B97F4A7C15ull;
+        }
+        // xorshift64*
+        rngState ^= rngState >> 12;
+        rngState ^= rngState << 25;
+        rngState ^= rngState >> 27;
+        const uint64_t bits = rngState * 0x2545F4914F6CDD1Dull;
+        // (0, 1]: never zero, so the log below is finite
+        return (static_cast<double>(bits >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+    }
+
+    void drawCountdown(size_t interval) noexcept
+    {
+        if (interval == 0u)
+        {
+            bytesUntilSample = RecheckIntervalBytes;
+            countdownIsSample = false;
+            return;
+        }
+
+        const double distance = -std::log(nextUniform()) * static_cast<double>(interval);
+        if (distance >= static_cast<double>(RecheckIntervalBytes))
+        {
+            bytesUntilSample = RecheckIntervalBytes;
+            countdownIsSample = false;
+        }
+        else
+        {
+            bytesUntilSample = static_cast<int64_t>(distance);
+            countdownIsSample = true;
+        }
+    }
+
+    uint64_t hashFrames(void* const* frames, uint32_t depth) noexcept
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (uint32_t i = 0u; i < depth; ++i)
+        {
+            hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(frames[i]));
+            hash *= 1099511628211ull;
+        }
+        return hash != 0u ? hash : 1u;
+    }
+
+    void recordSample(void* const* frames, uint32_t depth, size_t size, size_t interval) noexcept
+    {
+        const uint64_t hash = hashFrames(frames, depth);
+
+        // Probability this allocation got sampled was 1 - e^(-size/interval), so it stands in for size / that many bytes
+        const double sampleProbability = -std::expm1(-static_cast<double>(size) / static_cast<double>(interval));
+        const uint64_t estimatedBytes = static_cast<uint64_t>(static_cast<double>(size) / sampleProbability);
+
+        std::lock_guard<std::mutex> lock(callsiteMutex);
+        size_t slot = static_cast<size_t>(hash) & (MaxAllocationSampleCallsites - 1u);
+        for (size_t probe = 0u; probe < MaxAllocationSampleCallsites; ++probe)
+        {
+            allocation_callsite& callsite = callsites[slot];
+            if (callsiteHashes[slot] == 0u)
+            {
+                callsiteHashes[slot] = hash;
+                std::copy(frames, frames + depth, callsite.frames.begin());
+                callsite.depth = depth;
+                callsite.sampleCount = 1u;
+                callsite.estimatedBytes = estimatedBytes;
+                return;
+            }
+            else if (callsiteHashes[slot] == hash && callsite.depth == depth && std::equal(frames, frames + depth, callsite.frames.cbegin()))
+            {
+                ++callsite.sampleCount;
+                callsite.estimatedBytes += estimatedBytes;
+                return;
+            }
+            slot = (slot + 1u) & (MaxAllocationSampleCallsites - 1u);
+        }
+
+        droppedSamples.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    static_assert((MaxAllocationSampleCallsites & (MaxAllocationSampleCallsites - 1u)) == 0u, "Callsite table size must be a power of two!");
+
+    void sampleSlowPath(size_t size) noexcept
+    {
+        if (inSampler)
+        {
+            // Allocation from inside the sampler (backtrace() loading its unwinder, or the reporting functions)
+            bytesUntilSample = RecheckIntervalBytes;
+            countdownIsSample = false;
+            return;
+        }
+
+        sampler_reentry_guard guard;
+        const size_t interval = sampleInterval.load(std::memory_order_relaxed);
+        if (countdownIsSample && interval != 0u)
+        {
+            // Captured here rather than in recordSample(), so SkippedFrames is just this function and operator new.
+            // Unoptimized builds don't inline sampleAllocation() either, so there the top frame is that instead of the caller.
+            void* stack[MaxAllocationSampleFrames + SkippedFrames];
+#ifdef _WIN32
+            const int captured = static_cast<int>(CaptureStackBackTrace(0, static_cast<DWORD>(std::size(stack)), stack, nullptr));
+#else
+            const int captured = backtrace(stack, static_cast<int>(std::size(stack)));
+#endif
+            if (captured > SkippedFrames)
+            {
+                recordSample(stack + SkippedFrames, static_cast<uint32_t>(captured - SkippedFrames), size, interval);
+            }
+        }
+        drawCountdown(interval);
+    }
+
+    inline void sampleAllocation(size_t size) noexcept
+    {
+        bytesUntilSample -= static_cast<int64_t>(size);
+        if (bytesUntilSample < 0) [[unlikely]]
+        {
+            sampleSlowPath(size);
+        }
+    }
+
+}
+
+void operator delete(void* p) noexcept { mi_free(p); }
+void operator delete[](void* p) noexcept { mi_free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { mi_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { mi_free(p); }
+
+void* operator new(std::size_t n) noexcept(false) { sampleAllocation(n); return mi_new(n); }
+void* operator new[](std::size_t n) noexcept(false) { sampleAllocation(n); return mi_new(n); }
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { sampleAllocation(n); return mi_new_nothrow(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { sampleAllocation(n); return mi_new_nothrow(n); }
+
+void operator delete(void* p, std::size_t n) noexcept { mi_free_size(p, n); }
+void operator delete[](void* p, std::size_t n) noexcept { mi_free_size(p, n); }
+
+void operator delete(void* p, std::align_val_t al) noexcept { mi_free_aligned(p, static_cast<size_t>(al)); }
+void operator delete[](void* p, std::align_val_t al) noexcept { mi_free_aligned(p, static_cast<size_t>(al)); }
+void operator delete(void* p, std::size_t n, std::align_val_t al) noexcept { mi_free_size_aligned(p, n, static_cast<size_t>(al)); }
+void operator delete[](void* p, std::size_t n, std::align_val_t al) noexcept { mi_free_size_aligned(p, n, static_cast<size_t>(al)); }
+void operator delete(void* p, std::align_val_t al, const std::nothrow_t&) noexcept { mi_free_aligned(p, static_cast<size_t>(al)); }
+void operator delete[](void* p, std::align_val_t al, const std::nothrow_t&) noexcept { mi_free_aligned(p, static_cast<size_t>(al)); }
+
+void* operator new(std::size_t n, std::align_val_t al) noexcept(false) { sampleAllocation(n); return mi_new_aligned(n, static_cast<size_t>(al)); }
+void* operator new[](std::size_t n, std::align_val_t al) noexcept(false) { sampleAllocation(n); return mi_new_aligned(n, static_cast<size_t>(al)); }
+void* operator new(std::size_t n, std::align_val_t al, const std::nothrow_t&) noexcept { sampleAllocation(n); return mi_new_aligned_nothrow(n, static_cast<size_t>(al)); }
+void* operator new[](std::size_t n, std::align_val_t al, const std::nothrow_t&) noexcept { sampleAllocation(n); return mi_new_aligned_nothrow(n, static_cast<size_t>(al)); }
+
+namespace foundation
+{
+
+    bool SetAllocationSampleInterval(size_t bytes) noexcept
+    {
+        sampleInterval.store(bytes, std::memory_order_relaxed);
+        // Pick the new interval up on this thread right away, other threads within RecheckIntervalBytes
+        bytesUntilSample = 0;
+        countdownIsSample = false;
+        return true;
+    }
+
+    size_t GetAllocationSampleInterval() noexcept
+    {
+        return sampleInterval.load(std::memory_order_relaxed);
+    }
+
+    std::vector<allocation_callsite> GetAllocationCallsites()
+    {
+        // Allocations made here mustn't try to take callsiteMutex again
+        sampler_reentry_guard guard;
+        std::vector<allocation_callsite> result;
+        result.reserve(MaxAllocationSampleCallsites);
+        {
+            std::lock_guard<std::mutex> lock(callsiteMutex);
+            for (size_t i = 0u; i < MaxAllocationSampleCallsites; ++i)
+            {
+                if (callsiteHashes[i] != 0u)
+                {
+                    result.emplace_back(callsites[i]);
+                }
+            }
+        }
+
+        std::sort(result.begin(), result.end(), [](const allocation_callsite& a, const allocation_callsite& b)
+        {
+            return a.estimatedBytes > b.estimatedBytes;
+        });
+        return result;
+    }
+
+    bool DumpAllocationCallsites(const char* output_file, size_t max_callsites)
+    {
+        sampler_reentry_guard guard;
+        const std::vector<allocation_callsite> sorted = GetAllocationCallsites();
+
+        FILE* output = std::fopen(output_file, "w");
+        if (output == nullptr)
+        {
+            return false;
+        }
+
+        uint64_t totalBytes = 0u;
+        for (const allocation_callsite& callsite : sorted)
+        {
+            totalBytes += callsite.estimatedBytes;
+        }
+
+        std::fprintf(output, "Allocation callsites: %zu, sample interval: %zu bytes, estimated total: %llu bytes, dropped samples: %llu\n\n",
+            sorted.size(), GetAllocationSampleInterval(), static_cast<unsigned long long>(totalBytes),
+            static_cast<unsigned long long>(GetDroppedAllocationSampleCount()));
+
+        const size_t count = std::min(max_callsites, sorted.size());
+        for (size_t i = 0u; i < count; ++i)
+        {
+            const allocation_callsite& callsite = sorted[i];
+            const double percentage = totalBytes != 0u ? 100.0 * static_cast<double>(callsite.estimatedBytes) / static_cast<double>(totalBytes) : 0.0;
+            std::fprintf(output, "#%zu: ~%llu bytes (%.2f%%), %llu samples\n", i, static_cast<unsigned long long>(callsite.estimatedBytes),
+                percentage, static_cast<unsigned long long>(callsite.sampleCount));
+#ifdef _WIN32
+            for (uint32_t frame = 0u; frame < callsite.depth; ++frame)
+            {
+                std::fprintf(output, "    %p\n", callsite.frames[frame]);
+            }
+#else
+            // backtrace_symbols() uses malloc, not operator new, so it doesn't feed back into the sampler
+            char** symbols = backtrace_symbols(callsite.frames.data(), static_cast<int>(callsite.depth));
+            for (uint32_t frame = 0u; frame < callsite.depth; ++frame)
+            {
+                if (symbols != nullptr)
+                {
+                    std::fprintf(output, "    %s\n", symbols[frame]);
+                }
+                else
+                {
+                    std::fprintf(output, "    %p\n", callsite.frames[frame]);
+                }
+            }
+            std::free(symbols);
+#endif
+            std::fputc('\n', output);
+        }
+
+        const bool success = std::ferror(output) == 0;
+        std::fclose(output);
+        return success;
+    }
+
+    void ResetAllocationSamples() noexcept
+    {
+        std::lock_guard<std::mutex> lock(callsiteMutex);
+        std::fill(std::begin(callsiteHashes), std::end(callsiteHashes), uint64_t(0u));
+        droppedSamples.store(0u, std::memory_order_relaxed);
+    }
+
+    uint64_t GetDroppedAllocationSampleCount() noexcept
+    {
+        return droppedSamples.load(std::memory_order_relaxed);
+    }
+
+}
+
+#endif
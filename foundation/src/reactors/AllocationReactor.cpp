@@ -1,6 +1,294 @@
 #include "reactors/AllocationReactor.hpp"
+#include "mimalloc.h"
+#include <array>
+#include <atomic>
+#include <cassert>
 
 namespace reactors
 {
 
+    namespace
+    {
+
+        constexpr size_t subsystemCount = static_cast<size_t>(AllocationSubsystem::Count);
+        constexpr size_t frameArenaBlockSize = 256u * 1024u;
+
+        constexpr std::array<const char*, subsystemCount> subsystemNames
+        {
+            "Resource",
+            "Content",
+            "Terrain",
+            "Render"
+        };
+
+        // Padded to a cache line each, as different subsystems are hammered from different threads
+        struct alignas(64) SubsystemCounters
+        {
+            std::atomic<size_t> bytesInUse{ 0u };
+            std::atomic<size_t> peakBytesInUse{ 0u };
+            std::atomic<size_t> totalAllocations{ 0u };
+            std::atomic<size_t> totalFrees{ 0u };
+        };
+
+        std::array<SubsystemCounters, subsystemCount> subsystemCounters;
+        std::atomic<bool> subsystemsInitialized{ false };
+        std::atomic<uint64_t> currentFrameIndex{ 0u };
+
+        // mimalloc heaps can only be allocated from by the thread that created them, so each thread
+        // gets its own heap per subsystem (created on first use). Blocks still alive when the thread
+        // exits get migrated to the default heap by mi_heap_delete, so they can still be freed later.
+        struct ThreadSubsystemHeaps
+        {
+            std::array<mi_heap_t*, subsystemCount> heaps{};
+
+            ~ThreadSubsystemHeaps()
+            {
+                for (mi_heap_t*& heap : heaps)
+                {
+                    if (heap != nullptr)
+                    {
+                        mi_heap_delete(heap);
+                        heap = nullptr;
+                    }
+                }
+            }
+
+            mi_heap_t* get(AllocationSubsystem subsystem)
+            {
+                mi_heap_t*& heap = heaps[static_cast<size_t>(subsystem)];
+                if (heap == nullptr)
+                {
+                    heap = mi_heap_new();
+                }
+                return heap;
+            }
+        };
+
+        struct FrameArenaBlock
+        {
+            FrameArenaBlock* next{ nullptr };
+            size_t capacity{ 0u };
+
+            std::byte* data() noexcept
+            {
+                return reinterpret_cast<std::byte*>(this + 1);
+            }
+        };
+
+        // Chain of blocks that is only ever rewound, never shrunk: after the first few frames the
+        // arena has grown to the high-water mark of a frame and stops touching the heap entirely
+        struct FrameArena
+        {
+            FrameArenaBlock* first{ nullptr };
+            FrameArenaBlock* current{ nullptr };
+            size_t offset{ 0u };
+            uint64_t frameIndex{ 0u };
+            size_t bytesUsedThisFrame{ 0u };
+            size_t bytesReserved{ 0u };
+            size_t blockCount{ 0u };
+
+            FrameArena() = default;
+            FrameArena(const FrameArena&) = delete;
+            FrameArena& operator=(const FrameArena&) = delete;
+
+            ~FrameArena()
+            {
+                FrameArenaBlock* block = first;
+                while (block != nullptr)
+                {
+                    FrameArenaBlock* next = block->next;
+                    mi_free(block);
+                    block = next;
+                }
+            }
+
+            void rewind(uint64_t frame_index) noexcept
+            {
+                current = first;
+                offset = 0u;
+                bytesUsedThisFrame = 0u;
+                frameIndex = frame_index;
+            }
+
+            void* tryAllocateFromCurrent(size_t size, size_t alignment) noexcept
+            {
+                if (current == nullptr)
+                {
+                    return nullptr;
+                }
+                const uintptr_t base = reinterpret_cast<uintptr_t>(current->data());
+                const uintptr_t aligned = (base + offset + (alignment - 1u)) & ~(uintptr_t(alignment) - 1u);
+                const size_t newOffset = (aligned - base) + size;
+                if (newOffset > current->capacity)
+                {
+                    return nullptr;
+                }
+                bytesUsedThisFrame += newOffset - offset;
+                offset = newOffset;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            void* allocate(size_t size, size_t alignment)
+            {
+                const uint64_t globalFrame = currentFrameIndex.load(std::memory_order_relaxed);
+                if (frameIndex != globalFrame)
+                {
+                    rewind(globalFrame);
+                }
+
+                if (void* result = tryAllocateFromCurrent(size, alignment); result != nullptr)
+                {
+                    return result;
+                }
+
+                // Reuse the next block in the chain if it's big enough, otherwise splice in a new one
+                const size_t requiredCapacity = size + alignment;
+                FrameArenaBlock* next = current != nullptr ? current->next : first;
+                if (next == nullptr || next->capacity < requiredCapacity)
+                {
+                    const size_t capacity = requiredCapacity > frameArenaBlockSize ? requiredCapacity : frameArenaBlockSize;
+                    void* memory = mi_malloc_aligned(sizeof(FrameArenaBlock) + capacity, alignof(std::max_align_t));
+                    if (memory == nullptr)
+                    {
+                        return nullptr;
+                    }
+                    FrameArenaBlock* block = ::new (memory) FrameArenaBlock{ next, capacity };
+                    if (current != nullptr)
+                    {
+                        current->next = block;
+                    }
+                    else
+                    {
+                        first = block;
+                    }
+                    next = block;
+                    bytesReserved += capacity;
+                    ++blockCount;
+                }
+
+                current = next;
+                offset = 0u;
+                return tryAllocateFromCurrent(size, alignment);
+            }
+        };
+
+        thread_local ThreadSubsystemHeaps threadSubsystemHeaps;
+        thread_local FrameArena threadFrameArena;
+
+        SubsystemCounters& getCounters(AllocationSubsystem subsystem) noexcept
+        {
+            assert(subsystem < AllocationSubsystem::Count);
+            return subsystemCounters[static_cast<size_t>(subsystem)];
+        }
+
+        void updatePeak(SubsystemCounters& counters, size_t bytes_in_use) noexcept
+        {
+            size_t peak = counters.peakBytesInUse.load(std::memory_order_relaxed);
+            while (bytes_in_use > peak && !counters.peakBytesInUse.compare_exchange_weak(peak, bytes_in_use, std::memory_order_relaxed)) {}
+        }
+
+    }
+
+    bool InitializeAllocationSubsystems()
+    {
+        bool expected = false;
+        if (!subsystemsInitialized.compare_exchange_strong(expected, true))
+        {
+            // already initialized
+            return false;
+        }
+
+        for (SubsystemCounters& counters : subsystemCounters)
+        {
+            counters.peakBytesInUse.store(counters.bytesInUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            counters.totalAllocations.store(0u, std::memory_order_relaxed);
+            counters.totalFrees.store(0u, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    void ResetAllocationSubsystems()
+    {
+        // bytesInUse is left alone: anything still allocated will be freed (and subtracted) later
+        for (SubsystemCounters& counters : subsystemCounters)
+        {
+            counters.peakBytesInUse.store(counters.bytesInUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            counters.totalAllocations.store(0u, std::memory_order_relaxed);
+            counters.totalFrees.store(0u, std::memory_order_relaxed);
+        }
+        // Rewinds every frame arena, then hands any memory mimalloc has cached back to the OS
+        AdvanceFrame();
+        mi_collect(true);
+        subsystemsInitialized.store(false);
+    }
+
+    void* SubsystemAllocate(AllocationSubsystem subsystem, size_t size, size_t alignment)
+    {
+        assert(subsystemsInitialized.load(std::memory_order_relaxed));
+        void* result = mi_heap_malloc_aligned(threadSubsystemHeaps.get(subsystem), size, alignment);
+        if (result != nullptr)
+        {
+            SubsystemCounters& counters = getCounters(subsystem);
+            const size_t usableSize = mi_usable_size(result);
+            const size_t inUse = counters.bytesInUse.fetch_add(usableSize, std::memory_order_relaxed) + usableSize;
+            counters.totalAllocations.fetch_add(1u, std::memory_order_relaxed);
+            updatePeak(counters, inUse);
+        }
+        return result;
+    }
+
+    void SubsystemFree(AllocationSubsystem subsystem, void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        SubsystemCounters& counters = getCounters(subsystem);
+        counters.bytesInUse.fetch_sub(mi_usable_size(ptr), std::memory_order_relaxed);
+        counters.totalFrees.fetch_add(1u, std::memory_order_relaxed);
+        mi_free(ptr);
+    }
+
+    AllocationSubsystemStats GetAllocationSubsystemStats(AllocationSubsystem subsystem) noexcept
+    {
+        const SubsystemCounters& counters = getCounters(subsystem);
+        return AllocationSubsystemStats
+        {
+            GetAllocationSubsystemName(subsystem),
+            counters.bytesInUse.load(std::memory_order_relaxed),
+            counters.peakBytesInUse.load(std::memory_order_relaxed),
+            counters.totalAllocations.load(std::memory_order_relaxed),
+            counters.totalFrees.load(std::memory_order_relaxed)
+        };
+    }
+
+    const char* GetAllocationSubsystemName(AllocationSubsystem subsystem) noexcept
+    {
+        return subsystem < AllocationSubsystem::Count ? subsystemNames[static_cast<size_t>(subsystem)] : "Invalid";
+    }
+
+    void* FrameAllocate(size_t size, size_t alignment)
+    {
+        assert(alignment != 0u && (alignment & (alignment - 1u)) == 0u);
+        return threadFrameArena.allocate(size, alignment);
+    }
+
+    void AdvanceFrame() noexcept
+    {
+        currentFrameIndex.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    uint64_t GetCurrentFrameIndex() noexcept
+    {
+        return currentFrameIndex.load(std::memory_order_relaxed);
+    }
+
+    FrameArenaStats GetFrameArenaStats() noexcept
+    {
+        const FrameArena& arena = threadFrameArena;
+        const bool stale = arena.frameIndex != currentFrameIndex.load(std::memory_order_relaxed);
+        return FrameArenaStats{ stale ? 0u : arena.bytesUsedThisFrame, arena.bytesReserved, arena.blockCount };
+    }
+
 }
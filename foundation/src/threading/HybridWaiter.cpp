@@ -0,0 +1,191 @@
+#include "threading/HybridWaiter.hpp"
+#include <algorithm>
+#include <thread>
+#ifdef __linux__
+#include "futex_linux.hpp"
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#undef WIN32_LEAN_AND_MEAN
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace foundation
+{
+
+    namespace
+    {
+
+        using clock = std::chrono::steady_clock;
+
+        // Re-reading the clock every pause would dwarf the pause itself
+        constexpr uint32_t pausesPerClockCheck = 16u;
+        // A handful of yields lets another thread on this core (possibly the producer) run before we block
+        constexpr uint32_t yieldCount = 4u;
+        // Waits shorter than this are treated as "work was basically already there"
+        constexpr std::chrono::nanoseconds minSpinDuration{ 1000 };
+
+        inline void spin_pause() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER)
+            _mm_pause();
+#else
+            __builtin_ia32_pause();
+#endif
+#elif defined(__aarch64__) || defined(__arm__)
+            asm volatile("yield" ::: "memory");
+#endif
+        }
+
+    }
+
+    HybridWaiter::HybridWaiter(const HybridWaiterConfig& _config) noexcept :
+        config(_config),
+        currentSleepDuration(_config.minSleepDuration),
+        averageWaitNs(std::chrono::duration_cast<std::chrono::nanoseconds>(_config.maxSpinDuration).count() / 2)
+    {
+    }
+
+    uint32_t HybridWaiter::prepareWait() const noexcept
+    {
+        return notifyEpoch.load(std::memory_order_acquire);
+    }
+
+    bool HybridWaiter::wait(uint32_t token) noexcept
+    {
+        const clock::time_point start = clock::now();
+        const clock::time_point spinDeadline = start + spinBudget();
+
+        // Spin phase
+        for (uint32_t i = 0u; ; ++i)
+        {
+            if (notifyEpoch.load(std::memory_order_acquire) != token)
+            {
+                recordWait(clock::now() - start);
+                return true;
+            }
+            if ((i % pausesPerClockCheck) == 0u && clock::now() >= spinDeadline)
+            {
+                break;
+            }
+            spin_pause();
+        }
+
+        // Yield phase
+        for (uint32_t i = 0u; i < yieldCount; ++i)
+        {
+            std::this_thread::yield();
+            if (notifyEpoch.load(std::memory_order_acquire) != token)
+            {
+                recordWait(clock::now() - start);
+                return true;
+            }
+        }
+
+        // Blocking phase. Registering as a sleeper before re-checking the epoch pairs with notify()
+        // bumping the epoch before checking for sleepers: one of the two always sees the other.
+        const clock::time_point deadline = start + currentSleepDuration;
+        sleepingWaiters.fetch_add(1u, std::memory_order_seq_cst);
+        bool notified = false;
+        for (;;)
+        {
+            if (notifyEpoch.load(std::memory_order_seq_cst) != token)
+            {
+                notified = true;
+                break;
+            }
+
+            const clock::time_point now = clock::now();
+            if (now >= deadline)
+            {
+                break;
+            }
+
+            const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+#ifdef __linux__
+            timespec timeout;
+            timeout.tv_sec = static_cast<time_t>(remaining.count() / 1000000000);
+            timeout.tv_nsec = static_cast<long>(remaining.count() % 1000000000);
+            detail::futex_wait(&notifyEpoch, token, &timeout);
+#elif defined(_WIN32)
+            // Millisecond timeouts only: round up, as an early timeout would just come straight back here
+            uint32_t expected = token;
+            const DWORD timeoutMs = static_cast<DWORD>((remaining.count() + 999999) / 1000000);
+            WaitOnAddress(&notifyEpoch, &expected, sizeof(expected), timeoutMs);
+#else
+            // No address-wait with a timeout in the standard library, or anything native we use here yet: sleep in short slices instead
+            std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(remaining, std::chrono::microseconds(100)));
+#endif
+        }
+        sleepingWaiters.fetch_sub(1u, std::memory_order_relaxed);
+
+        // A timeout only says no work showed up within currentSleepDuration: counting it would drag the
+        // average towards the sleep length and stop us spinning for work that does arrive quickly
+        if (notified)
+        {
+            recordWait(clock::now() - start);
+        }
+        return notified;
+    }
+
+    void HybridWaiter::notify() noexcept
+    {
+        notifyEpoch.fetch_add(1u, std::memory_order_seq_cst);
+        // Uncontended case (waiter busy or spinning) stays free of syscalls
+        if (sleepingWaiters.load(std::memory_order_seq_cst) != 0u)
+        {
+#ifdef __linux__
+            detail::futex_wake_all(&notifyEpoch);
+#elif defined(_WIN32)
+            WakeByAddressAll(&notifyEpoch);
+#endif
+        }
+    }
+
+    void HybridWaiter::reset() noexcept
+    {
+        currentSleepDuration = config.minSleepDuration;
+    }
+
+    void HybridWaiter::backoff() noexcept
+    {
+        const auto scaled = std::chrono::microseconds(static_cast<int64_t>(currentSleepDuration.count() * config.backoffMultiplier));
+        currentSleepDuration = std::clamp(scaled, config.minSleepDuration, config.maxSleepDuration);
+    }
+
+    std::chrono::microseconds HybridWaiter::getCurrentDuration() const noexcept
+    {
+        return currentSleepDuration;
+    }
+
+    std::chrono::microseconds HybridWaiter::getAverageWaitDuration() const noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(averageWaitNs));
+    }
+
+    std::chrono::nanoseconds HybridWaiter::spinBudget() const noexcept
+    {
+        const std::chrono::nanoseconds maxSpin = config.maxSpinDuration;
+        const std::chrono::nanoseconds average(averageWaitNs);
+        if (average > maxSpin)
+        {
+            // Work usually takes longer to show up than we're willing to spin: go to sleep nearly right away
+            return std::min(minSpinDuration, maxSpin);
+        }
+        // Spin a bit past the typical wait, so slightly-late work still gets caught
+        return std::clamp(average * 2, minSpinDuration, maxSpin);
+    }
+
+    void HybridWaiter::recordWait(std::chrono::nanoseconds duration) noexcept
+    {
+        // Weighted 1/8 towards the newest sample
+        averageWaitNs += (duration.count() - averageWaitNs) / 8;
+    }
+
+} // namespace foundation
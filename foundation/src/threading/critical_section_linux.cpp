@@ -0,0 +1,187 @@
+#include "threading/critical_section.hpp"
+#include "futex_linux.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Futex-backed equivalent of a Win32 CRITICAL_SECTION: recursive, with a configurable spin count.
+    Lock word is 0 (unlocked), 1 (locked) or 2 (locked, and someone may be sleeping on it), as in
+    Drepper's "Futexes Are Tricky". Uncontended lock/unlock are a single CAS/exchange each.
+
+    Spinning is adaptive (like glibc's PTHREAD_MUTEX_ADAPTIVE_NP): we track a running average of how
+    long it took to get the lock by spinning, and only spin for about twice that before sleeping, so
+    sections that are held for a long time stop burning cycles on spinning that never pays off.
+*/
+namespace
+{
+
+    // Same defaults as the win32 version gets from InitializeCriticalSection(Ex)
+#ifdef NDEBUG
+    constexpr uint32_t defaultSpinCount = 40000u;
+#else
+    constexpr uint32_t defaultSpinCount = 0u;
+#endif
+
+    struct critical_section_state
+    {
+        std::atomic<uint32_t> lockWord{ 0u };
+        std::atomic<uintptr_t> owner{ 0u };
+        uint32_t recursionCount{ 0u };
+        std::atomic<uint32_t> spinCount{ defaultSpinCount };
+        std::atomic<uint32_t> adaptiveSpins{ 0u };
+    };
+
+    uintptr_t current_thread_id() noexcept
+    {
+        // Address of a thread_local is unique per live thread and never 0
+        thread_local char threadIdentity{ 0 };
+        return reinterpret_cast<uintptr_t>(&threadIdentity);
+    }
+
+    critical_section_state* get_state(void* ptr) noexcept
+    {
+        return static_cast<critical_section_state*>(ptr);
+    }
+
+    void lock_contended(critical_section_state* state) noexcept
+    {
+        using namespace foundation::detail;
+
+        const uint32_t maxSpins = state->spinCount.load(std::memory_order_relaxed);
+        const uint32_t adaptive = state->adaptiveSpins.load(std::memory_order_relaxed);
+        const uint32_t spinLimit = std::min(maxSpins, adaptive * 2u + 10u);
+
+        for (uint32_t spins = 0u; spins < spinLimit; ++spins)
+        {
+            uint32_t expected = 0u;
+            if (state->lockWord.load(std::memory_order_relaxed) == 0u &&
+                state->lockWord.compare_exchange_weak(expected, 1u, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                // Move the average an eighth of the way towards this sample
+                const int32_t delta = (static_cast<int32_t>(spins) - static_cast<int32_t>(adaptive)) / 8;
+                state->adaptiveSpins.store(static_cast<uint32_t>(static_cast<int32_t>(adaptive) + delta), std::memory_order_relaxed);
+                return;
+            }
+            cpu_relax();
+        }
+
+        // Spinning didn't pay off this time: decay the average so we spin less next time
+        state->adaptiveSpins.store(adaptive - adaptive / 8u, std::memory_order_relaxed);
+
+        // Mark as contended, and sleep until the exchange hands us an unlocked word
+        while (state->lockWord.exchange(2u, std::memory_order_acquire) != 0u)
+        {
+            futex_wait(&state->lockWord, 2u);
+        }
+    }
+
+}
+
+critical_section::critical_section()
+{
+    criticalSectionObject = new critical_section_state();
+}
+
+critical_section::~critical_section()
+{
+    if (criticalSectionObject != nullptr)
+    {
+        delete get_state(criticalSectionObject);
+    }
+}
+
+critical_section::critical_section(critical_section&& other) noexcept : criticalSectionObject(other.criticalSectionObject)
+{
+    other.criticalSectionObject = nullptr;
+}
+
+critical_section& critical_section::operator=(critical_section&& other) noexcept
+{
+    criticalSectionObject = other.criticalSectionObject;
+    other.criticalSectionObject = nullptr;
+    return *this;
+}
+
+void critical_section::lock()
+{
+    critical_section_state* state = get_state(criticalSectionObject);
+    const uintptr_t self = current_thread_id();
+    if (state->owner.load(std::memory_order_relaxed) == self)
+    {
+        ++state->recursionCount;
+        return;
+    }
+
+    uint32_t expected = 0u;
+    if (!state->lockWord.compare_exchange_strong(expected, 1u, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        lock_contended(state);
+    }
+
+    state->owner.store(self, std::memory_order_relaxed);
+    state->recursionCount = 1u;
+}
+
+bool critical_section::try_lock()
+{
+    critical_section_state* state = get_state(criticalSectionObject);
+    const uintptr_t self = current_thread_id();
+    if (state->owner.load(std::memory_order_relaxed) == self)
+    {
+        ++state->recursionCount;
+        return true;
+    }
+
+    uint32_t expected = 0u;
+    if (state->lockWord.compare_exchange_strong(expected, 1u, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        state->owner.store(self, std::memory_order_relaxed);
+        state->recursionCount = 1u;
+        return true;
+    }
+
+    return false;
+}
+
+void critical_section::unlock()
+{
+    critical_section_state* state = get_state(criticalSectionObject);
+    assert(state->owner.load(std::memory_order_relaxed) == current_thread_id());
+    if (--state->recursionCount != 0u)
+    {
+        return;
+    }
+
+    state->owner.store(0u, std::memory_order_relaxed);
+    if (state->lockWord.exchange(0u, std::memory_order_release) == 2u)
+    {
+        foundation::detail::futex_wake(&state->lockWord, 1);
+    }
+}
+
+size_t critical_section::spin_count() const noexcept
+{
+    return static_cast<size_t>(get_state(criticalSectionObject)->spinCount.load(std::memory_order_relaxed));
+}
+
+void critical_section::set_spin_count(const size_t new_spin_count) noexcept
+{
+    get_state(criticalSectionObject)->spinCount.store(static_cast<uint32_t>(new_spin_count), std::memory_order_relaxed);
+}
+
+critical_section::raii_scoped_lock critical_section::get_lock() noexcept
+{
+    return raii_scoped_lock(*this);
+}
+
+critical_section::raii_scoped_lock::raii_scoped_lock(critical_section& _section) noexcept : section(_section)
+{
+    section.lock();
+}
+
+critical_section::raii_scoped_lock::~raii_scoped_lock()
+{
+    section.unlock();
+}
@@ -0,0 +1,342 @@
+#include "threading/epoch_reclamation.hpp"
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace foundation
+{
+
+    namespace
+    {
+
+        // Set in a thread's local epoch while it is inside an epoch_guard
+        constexpr uint64_t activeBit = 1ull << 63ull;
+
+        struct retired_node
+        {
+            void* ptr;
+            retire_deleter_fn deleter;
+            uint64_t epoch;
+        };
+
+        // One per registered thread. Records are recycled when threads exit, but never freed, so
+        // scanning the record list never has to worry about records disappearing under it
+        struct alignas(64) thread_record
+        {
+            std::atomic<uint64_t> localEpoch{ 0u };
+            std::atomic<void*> hazards[MaxHazardPointersPerThread]{};
+            std::atomic<bool> inUse{ false };
+            thread_record* next{ nullptr };
+
+            // Only touched by the owning thread
+            uint32_t guardDepth{ 0u };
+            uint32_t hazardMask{ 0u };
+            bool reclaiming{ false };
+            size_t reclaimThreshold{ ReclamationBatchSize };
+            std::vector<retired_node> retired;
+        };
+
+        // Retired nodes left behind by exited threads, adopted by the next thread that reclaims
+        struct orphan_batch
+        {
+            std::vector<retired_node> nodes;
+            orphan_batch* next{ nullptr };
+        };
+
+        struct reclamation_domain
+        {
+            // Starts at 2 so "retired epoch + 2" never wraps on our first epochs
+            alignas(64) std::atomic<uint64_t> globalEpoch{ 2u };
+            alignas(64) std::atomic<thread_record*> records{ nullptr };
+            alignas(64) std::atomic<orphan_batch*> orphans{ nullptr };
+        };
+
+        reclamation_domain& domain() noexcept
+        {
+            // Intentionally never destroyed: thread_local handles can outlive static destruction order
+            static reclamation_domain* instance = new reclamation_domain();
+            return *instance;
+        }
+
+        thread_record* acquire_record()
+        {
+            reclamation_domain& d = domain();
+            for (thread_record* record = d.records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+            {
+                bool expected = false;
+                if (!record->inUse.load(std::memory_order_relaxed) &&
+                    record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return record;
+                }
+            }
+
+            thread_record* record = new thread_record();
+            record->inUse.store(true, std::memory_order_relaxed);
+            thread_record* head = d.records.load(std::memory_order_relaxed);
+            do
+            {
+                record->next = head;
+            }
+            while (!d.records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+            return record;
+        }
+
+        void push_orphans(std::vector<retired_node>&& nodes)
+        {
+            reclamation_domain& d = domain();
+            orphan_batch* batch = new orphan_batch{ std::move(nodes), nullptr };
+            orphan_batch* head = d.orphans.load(std::memory_order_relaxed);
+            do
+            {
+                batch->next = head;
+            }
+            while (!d.orphans.compare_exchange_weak(head, batch, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        void adopt_orphans(thread_record* record)
+        {
+            // Taking the whole list at once means no ABA to worry about
+            orphan_batch* batch = domain().orphans.exchange(nullptr, std::memory_order_acquire);
+            while (batch != nullptr)
+            {
+                record->retired.insert(record->retired.end(), batch->nodes.cbegin(), batch->nodes.cend());
+                orphan_batch* next = batch->next;
+                delete batch;
+                batch = next;
+            }
+        }
+
+        bool try_advance_epoch() noexcept
+        {
+            reclamation_domain& d = domain();
+            uint64_t epoch = d.globalEpoch.load(std::memory_order_seq_cst);
+            for (thread_record* record = d.records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+            {
+                const uint64_t local = record->localEpoch.load(std::memory_order_seq_cst);
+                if ((local & activeBit) && (local & ~activeBit) != epoch)
+                {
+                    // Someone is still reading in an older epoch
+                    return false;
+                }
+            }
+            return d.globalEpoch.compare_exchange_strong(epoch, epoch + 1u, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        void reclaim_local(thread_record* record)
+        {
+            if (record->reclaiming)
+            {
+                // A deleter retired more nodes: they'll be picked up by a later pass
+                return;
+            }
+            record->reclaiming = true;
+
+            adopt_orphans(record);
+            try_advance_epoch();
+
+            reclamation_domain& d = domain();
+            const uint64_t epoch = d.globalEpoch.load(std::memory_order_seq_cst);
+
+            std::vector<void*> hazards;
+            for (thread_record* other = d.records.load(std::memory_order_acquire); other != nullptr; other = other->next)
+            {
+                for (const std::atomic<void*>& hazard : other->hazards)
+                {
+                    void* ptr = hazard.load(std::memory_order_seq_cst);
+                    if (ptr != nullptr)
+                    {
+                        hazards.emplace_back(ptr);
+                    }
+                }
+            }
+            std::sort(hazards.begin(), hazards.end());
+
+            // Deleters may retire more nodes, so don't iterate the record's list directly
+            std::vector<retired_node> pending;
+            pending.swap(record->retired);
+            std::vector<retired_node> kept;
+            for (const retired_node& node : pending)
+            {
+                if (node.epoch + 2u <= epoch && !std::binary_search(hazards.cbegin(), hazards.cend(), node.ptr))
+                {
+                    node.deleter(node.ptr);
+                }
+                else
+                {
+                    kept.emplace_back(node);
+                }
+            }
+            record->retired.insert(record->retired.end(), kept.cbegin(), kept.cend());
+            // If nothing could be freed (e.g. a stalled reader), don't retry on every single Retire()
+            record->reclaimThreshold = record->retired.size() + ReclamationBatchSize;
+
+            record->reclaiming = false;
+        }
+
+        void release_record(thread_record* record)
+        {
+            assert(record->guardDepth == 0u && "thread exiting from inside an epoch_guard!");
+            reclaim_local(record);
+            if (!record->retired.empty())
+            {
+                push_orphans(std::move(record->retired));
+                record->retired = std::vector<retired_node>();
+            }
+
+            for (std::atomic<void*>& hazard : record->hazards)
+            {
+                hazard.store(nullptr, std::memory_order_release);
+            }
+            record->hazardMask = 0u;
+            record->localEpoch.store(0u, std::memory_order_release);
+            record->reclaimThreshold = ReclamationBatchSize;
+            record->inUse.store(false, std::memory_order_release);
+        }
+
+        struct thread_handle
+        {
+            ~thread_handle()
+            {
+                if (record != nullptr)
+                {
+                    release_record(record);
+                }
+            }
+
+            thread_record* record{ nullptr };
+        };
+
+        thread_local thread_handle localHandle;
+
+        thread_record* local_record()
+        {
+            if (localHandle.record == nullptr)
+            {
+                localHandle.record = acquire_record();
+            }
+            return localHandle.record;
+        }
+
+    }
+
+    void RegisterReclamationThread()
+    {
+        local_record();
+    }
+
+    void UnregisterReclamationThread()
+    {
+        if (localHandle.record != nullptr)
+        {
+            release_record(localHandle.record);
+            localHandle.record = nullptr;
+        }
+    }
+
+    void Retire(void* ptr, retire_deleter_fn deleter)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        thread_record* record = local_record();
+        record->retired.emplace_back(retired_node{ ptr, deleter, domain().globalEpoch.load(std::memory_order_seq_cst) });
+        if (record->retired.size() >= record->reclaimThreshold)
+        {
+            reclaim_local(record);
+        }
+    }
+
+    void ReclaimRetired()
+    {
+        reclaim_local(local_record());
+    }
+
+    void DrainRetired()
+    {
+        thread_record* record = local_record();
+        assert(record->guardDepth == 0u && "DrainRetired() can never finish inside an epoch_guard!");
+        for (;;)
+        {
+            reclaim_local(record);
+            if (record->retired.empty() && domain().orphans.load(std::memory_order_acquire) == nullptr)
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t GetGlobalEpoch() noexcept
+    {
+        return domain().globalEpoch.load(std::memory_order_acquire);
+    }
+
+    size_t GetPendingRetiredCount() noexcept
+    {
+        return localHandle.record != nullptr ? localHandle.record->retired.size() : 0u;
+    }
+
+    epoch_guard::epoch_guard() noexcept
+    {
+        thread_record* record = local_record();
+        if (record->guardDepth++ == 0u)
+        {
+            const std::atomic<uint64_t>& global = domain().globalEpoch;
+            uint64_t epoch = global.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                record->localEpoch.store(epoch | activeBit, std::memory_order_seq_cst);
+                // Publishing a stale epoch would be safe, but would needlessly hold up the next advance
+                const uint64_t current = global.load(std::memory_order_seq_cst);
+                if (current == epoch)
+                {
+                    break;
+                }
+                epoch = current;
+            }
+        }
+    }
+
+    epoch_guard::~epoch_guard()
+    {
+        thread_record* record = localHandle.record;
+        if (--record->guardDepth == 0u)
+        {
+            record->localEpoch.store(0u, std::memory_order_release);
+        }
+    }
+
+    namespace detail
+    {
+
+        std::atomic<void*>* AcquireHazardSlot()
+        {
+            thread_record* record = local_record();
+            for (uint32_t i = 0u; i < MaxHazardPointersPerThread; ++i)
+            {
+                const uint32_t bit = 1u << i;
+                if ((record->hazardMask & bit) == 0u)
+                {
+                    record->hazardMask |= bit;
+                    return &record->hazards[i];
+                }
+            }
+            throw std::runtime_error("Exceeded MaxHazardPointersPerThread on this thread!");
+        }
+
+        void ReleaseHazardSlot(std::atomic<void*>* slot) noexcept
+        {
+            thread_record* record = localHandle.record;
+            slot->store(nullptr, std::memory_order_release);
+            const uint32_t idx = static_cast<uint32_t>(slot - &record->hazards[0]);
+            record->hazardMask &= ~(1u << idx);
+        }
+
+    }
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef FOUNDATION_THREADING_FUTEX_LINUX_HPP
+#define FOUNDATION_THREADING_FUTEX_LINUX_HPP
+#include <atomic>
+#include <cstdint>
+#include <climits>
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace foundation::detail
+{
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex words must be plain 32-bit integers!");
+
+    // Blocks while *word == expected. Spurious wakeups are possible, callers must re-check their condition.
+    inline void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, const timespec* relative_timeout = nullptr) noexcept
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected, relative_timeout, nullptr, 0);
+    }
+
+    // Returns number of waiters woken
+    inline int futex_wake(std::atomic<uint32_t>* word, int count) noexcept
+    {
+        const long result = syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        return result > 0 ? static_cast<int>(result) : 0;
+    }
+
+    inline int futex_wake_all(std::atomic<uint32_t>* word) noexcept
+    {
+        return futex_wake(word, INT_MAX);
+    }
+
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+}
+
+#endif //!FOUNDATION_THREADING_FUTEX_LINUX_HPP
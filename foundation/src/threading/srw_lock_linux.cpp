@@ -0,0 +1,351 @@
+#include "threading/srw_lock.hpp"
+#include "futex_linux.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Futex-backed reader/writer lock, standing in for SRWLOCK. Like SRWLOCK it is not recursive, and
+    it prefers writers: once a writer is waiting, new readers queue up behind it rather than starving it.
+
+    Everything lives in one 32-bit state word:
+        bits 0-29: reader count, or readerMask when write locked
+        bit 30: readers are sleeping on the state word
+        bit 31: writers are sleeping on writerNotify
+    Uncontended lock/unlock in either mode is a single CAS or fetch_sub. Writers sleep on a separate
+    sequence counter so waking one writer doesn't stampede every waiting reader too.
+
+    Spinning before sleeping adapts per lock, as critical_section's does: each lock keeps a running average
+    of how many spins it took for the lock to free up, and only spins for about twice that, so locks held
+    for a long time stop burning cycles on spins that end in a futex wait anyway.
+*/
+namespace
+{
+
+    constexpr uint32_t readLocked = 1u;
+    constexpr uint32_t readerMask = (1u << 30u) - 1u;
+    constexpr uint32_t writeLocked = readerMask;
+    constexpr uint32_t maxReaders = readerMask - 1u;
+    constexpr uint32_t readersWaiting = 1u << 30u;
+    constexpr uint32_t writersWaiting = 1u << 31u;
+
+    // SRW critical sections are expected to be brief, so even the longest spin stays short
+    constexpr uint32_t maxSpinLimit = 2000u;
+    // Starts out spinning 100 times, the limit this used to have fixed
+    constexpr uint32_t initialAdaptiveSpins = 45u;
+
+    struct srw_lock_state
+    {
+        std::atomic<uint32_t> state{ 0u };
+        std::atomic<uint32_t> writerNotify{ 0u };
+        std::atomic<uint32_t> adaptiveSpins{ initialAdaptiveSpins };
+    };
+
+    srw_lock_state* get_state(void* ptr) noexcept
+    {
+        return static_cast<srw_lock_state*>(ptr);
+    }
+
+    constexpr bool is_unlocked(uint32_t state) noexcept
+    {
+        return (state & readerMask) == 0u;
+    }
+
+    constexpr bool is_write_locked(uint32_t state) noexcept
+    {
+        return (state & readerMask) == writeLocked;
+    }
+
+    constexpr bool has_readers_waiting(uint32_t state) noexcept
+    {
+        return (state & readersWaiting) != 0u;
+    }
+
+    constexpr bool has_writers_waiting(uint32_t state) noexcept
+    {
+        return (state & writersWaiting) != 0u;
+    }
+
+    constexpr bool is_read_lockable(uint32_t state) noexcept
+    {
+        // Waiting readers also block new ones: they only wait when a writer is waiting or active
+        return (state & readerMask) < maxReaders && !has_readers_waiting(state) && !has_writers_waiting(state);
+    }
+
+    template<typename Predicate>
+    uint32_t spin_until(srw_lock_state* lock, Predicate&& pred) noexcept
+    {
+        const uint32_t adaptive = lock->adaptiveSpins.load(std::memory_order_relaxed);
+        const uint32_t spinLimit = std::min(maxSpinLimit, adaptive * 2u + 10u);
+        for (uint32_t spins = 0u; ; ++spins)
+        {
+            const uint32_t state = lock->state.load(std::memory_order_relaxed);
+            if (pred(state))
+            {
+                // Not having to spin at all says nothing about how long spinning takes to pay off
+                if (spins != 0u)
+                {
+                    // Move the average an eighth of the way towards this sample
+                    const int32_t delta = (static_cast<int32_t>(spins) - static_cast<int32_t>(adaptive)) / 8;
+                    lock->adaptiveSpins.store(static_cast<uint32_t>(static_cast<int32_t>(adaptive) + delta), std::memory_order_relaxed);
+                }
+                return state;
+            }
+            if (spins == spinLimit)
+            {
+                // Spinning didn't pay off this time, and we're likely headed for a futex wait: spin less next time
+                lock->adaptiveSpins.store(adaptive - adaptive / 8u, std::memory_order_relaxed);
+                return state;
+            }
+            foundation::detail::cpu_relax();
+        }
+    }
+
+    uint32_t spin_read(srw_lock_state* lock) noexcept
+    {
+        return spin_until(lock, [](uint32_t state)
+        {
+            return !is_write_locked(state) || has_readers_waiting(state) || has_writers_waiting(state);
+        });
+    }
+
+    uint32_t spin_write(srw_lock_state* lock) noexcept
+    {
+        return spin_until(lock, [](uint32_t state)
+        {
+            return is_unlocked(state) || has_writers_waiting(state);
+        });
+    }
+
+    void lock_shared_contended(srw_lock_state* lock) noexcept
+    {
+        uint32_t state = spin_read(lock);
+        for (;;)
+        {
+            if (is_read_lockable(state))
+            {
+                if (lock->state.compare_exchange_weak(state, state + readLocked, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return;
+                }
+                continue;
+            }
+
+            assert((state & readerMask) != maxReaders && "srw_lock reader count overflow!");
+
+            if (!has_readers_waiting(state))
+            {
+                if (!lock->state.compare_exchange_weak(state, state | readersWaiting, std::memory_order_relaxed, std::memory_order_relaxed))
+                {
+                    continue;
+                }
+            }
+
+            foundation::detail::futex_wait(&lock->state, state | readersWaiting);
+            state = spin_read(lock);
+        }
+    }
+
+    // Returns true if a writer was actually woken up
+    bool wake_writer(srw_lock_state* lock) noexcept
+    {
+        lock->writerNotify.fetch_add(1u, std::memory_order_release);
+        return foundation::detail::futex_wake(&lock->writerNotify, 1) != 0;
+    }
+
+    void wake_writer_or_readers(srw_lock_state* lock, uint32_t state) noexcept
+    {
+        assert(is_unlocked(state));
+
+        // Only writers waiting: wake one of them
+        if (state == writersWaiting)
+        {
+            if (lock->state.compare_exchange_strong(state, 0u, std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+                wake_writer(lock);
+                return;
+            }
+        }
+
+        // Both waiting: writers go first. Only if no writer was actually asleep do readers get woken.
+        if (state == (readersWaiting | writersWaiting))
+        {
+            if (!lock->state.compare_exchange_strong(state, readersWaiting, std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+                // Someone else changed the state: whoever did that is now responsible for waking
+                return;
+            }
+            if (wake_writer(lock))
+            {
+                return;
+            }
+            state = readersWaiting;
+        }
+
+        if (state == readersWaiting)
+        {
+            if (lock->state.compare_exchange_strong(state, 0u, std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+                foundation::detail::futex_wake_all(&lock->state);
+            }
+        }
+    }
+
+    void lock_exclusive_contended(srw_lock_state* lock) noexcept
+    {
+        uint32_t state = spin_write(lock);
+        // Once we've slept, we have to assume other writers are too, and keep the flag set on acquire
+        uint32_t otherWritersWaiting = 0u;
+
+        for (;;)
+        {
+            if (is_unlocked(state))
+            {
+                if (lock->state.compare_exchange_weak(state, state | writeLocked | otherWritersWaiting, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return;
+                }
+                continue;
+            }
+
+            if (!has_writers_waiting(state))
+            {
+                if (!lock->state.compare_exchange_weak(state, state | writersWaiting, std::memory_order_relaxed, std::memory_order_relaxed))
+                {
+                    continue;
+                }
+            }
+
+            otherWritersWaiting = writersWaiting;
+
+            // Read the sequence before re-checking, so an unlock between the check and the wait bumps it
+            const uint32_t sequence = lock->writerNotify.load(std::memory_order_acquire);
+            state = lock->state.load(std::memory_order_relaxed);
+            if (is_unlocked(state) || !has_writers_waiting(state))
+            {
+                continue;
+            }
+
+            foundation::detail::futex_wait(&lock->writerNotify, sequence);
+            state = spin_write(lock);
+        }
+    }
+
+}
+
+srw_lock::srw_lock()
+{
+    srwLockPtr = new srw_lock_state();
+}
+
+srw_lock::~srw_lock()
+{
+    if (srwLockPtr != nullptr)
+    {
+        delete get_state(srwLockPtr);
+    }
+}
+
+srw_lock::srw_lock(srw_lock&& other) noexcept : srwLockPtr(other.srwLockPtr)
+{
+    other.srwLockPtr = nullptr;
+}
+
+srw_lock& srw_lock::operator=(srw_lock&& other) noexcept
+{
+    srwLockPtr = other.srwLockPtr;
+    other.srwLockPtr = nullptr;
+    return *this;
+}
+
+void srw_lock::lock_exclusive()
+{
+    srw_lock_state* lock = get_state(srwLockPtr);
+    uint32_t expected = 0u;
+    if (!lock->state.compare_exchange_strong(expected, writeLocked, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        lock_exclusive_contended(lock);
+    }
+}
+
+void srw_lock::lock_shared()
+{
+    srw_lock_state* lock = get_state(srwLockPtr);
+    uint32_t state = lock->state.load(std::memory_order_relaxed);
+    if (!is_read_lockable(state) ||
+        !lock->state.compare_exchange_weak(state, state + readLocked, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        lock_shared_contended(lock);
+    }
+}
+
+bool srw_lock::try_lock_exclusive()
+{
+    srw_lock_state* lock = get_state(srwLockPtr);
+    uint32_t state = lock->state.load(std::memory_order_relaxed);
+    while (is_unlocked(state))
+    {
+        if (lock->state.compare_exchange_weak(state, state | writeLocked, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool srw_lock::try_lock_shared()
+{
+    srw_lock_state* lock = get_state(srwLockPtr);
+    uint32_t state = lock->state.load(std::memory_order_relaxed);
+    while (is_read_lockable(state))
+    {
+        if (lock->state.compare_exchange_weak(state, state + readLocked, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void srw_lock::unlock_exclusive()
+{
+    srw_lock_state* lock = get_state(srwLockPtr);
+    const uint32_t state = lock->state.fetch_sub(writeLocked, std::memory_order_release) - writeLocked;
+    assert(is_unlocked(state));
+    if (has_readers_waiting(state) || has_writers_waiting(state))
+    {
+        wake_writer_or_readers(lock, state);
+    }
+}
+
+void srw_lock::unlock_shared()
+{
+    srw_lock_state* lock = get_state(srwLockPtr);
+    const uint32_t state = lock->state.fetch_sub(readLocked, std::memory_order_release) - readLocked;
+    // Readers only ever wait behind a writer, so readersWaiting without writersWaiting can't happen here
+    if (is_unlocked(state) && has_writers_waiting(state))
+    {
+        wake_writer_or_readers(lock, state);
+    }
+}
+
+srw_lock::scoped_write_lock::scoped_write_lock(srw_lock& _lock) noexcept : lock(_lock)
+{
+    lock.lock_exclusive();
+}
+
+srw_lock::scoped_write_lock::~scoped_write_lock()
+{
+    lock.unlock_exclusive();
+}
+
+srw_lock::scoped_read_lock::scoped_read_lock(srw_lock& _lock) noexcept : lock(_lock)
+{
+    lock.lock_shared();
+}
+
+srw_lock::scoped_read_lock::~scoped_read_lock()
+{
+    lock.unlock_shared();
+}
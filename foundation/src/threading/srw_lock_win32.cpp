@@ -9,8 +9,8 @@
 
 srw_lock::srw_lock()
 {
-    auto pSrw = static_cast<PSRWLOCK>(srwLockPtr);
-    pSrw = new SRWLOCK();
+    auto pSrw = new SRWLOCK();
+    srwLockPtr = pSrw;
     memset(pSrw, 0, sizeof(SRWLOCK));
     InitializeSRWLock(pSrw);
 }
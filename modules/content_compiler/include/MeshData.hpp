@@ -2,15 +2,9 @@
 #ifndef ASSET_PIPELINE_MESH_DATA_HPP
 #define ASSET_PIPELINE_MESH_DATA_HPP
 #include <cstdint>
+#include <limits>
 #include <string>
 
-struct ccDataHandle
-{
-    uint32_t typeHash;
-    uint32_t containerIdx;
-    uint64_t dataHash;
-};
-
 using ccDataHandle = uint64_t;
 
 namespace detail
@@ -63,7 +57,9 @@ struct ObjectModelData
     uint32_t vertexAttributeCount{ 0u };
     const VertexMetadataEntry* vertexAttribMetadata{ nullptr };
     uint32_t indexDataSize{ 0u };
-    const uint32_t* indexData{ nullptr };
+    // VkIndexType of indexData: 16-bit (0) whenever every index fits, otherwise 32-bit (1)
+    uint32_t indexType{ 1u };
+    const void* indexData{ nullptr };
     uint32_t numMaterials{ 0u };
     const MaterialRange* materialRanges{ nullptr };
     uint32_t numPrimGroups{ 0u };
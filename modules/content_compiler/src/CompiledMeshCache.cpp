@@ -0,0 +1,215 @@
+#include "CompiledMeshCache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+
+    size_t alignBlobOffset(const size_t offset)
+    {
+        return (offset + compiledMeshBlobAlignment - 1u) & ~(compiledMeshBlobAlignment - 1u);
+    }
+
+    bool blobInBounds(const compiled_mesh_blob_t& blob, const size_t fileSize, const size_t elementSize)
+    {
+        return blob.offset <= fileSize && blob.size <= fileSize - blob.offset && (blob.size % elementSize) == 0u &&
+            (blob.offset % compiledMeshBlobAlignment) == 0u;
+    }
+
+    // Blobs are aligned in the file, but the mapping itself isn't guaranteed to be, so everything goes through memcpy
+    template<typename T>
+    std::vector<T> readBlob(std::span<const std::byte> fileData, const compiled_mesh_blob_t& blob)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Blobs are copied out bytewise");
+        std::vector<T> result(blob.size / sizeof(T));
+        if (!result.empty())
+        {
+            std::memcpy(result.data(), fileData.data() + blob.offset, blob.size);
+        }
+        return result;
+    }
+
+    struct blob_writer_t
+    {
+        template<typename T>
+        compiled_mesh_blob_t add(const T* data, const size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Blobs are copied in bytewise");
+            compiled_mesh_blob_t blob{ alignBlobOffset(bytes.size()), sizeof(T) * count };
+            bytes.resize(blob.offset + blob.size);
+            if (count != 0u)
+            {
+                std::memcpy(bytes.data() + blob.offset, data, blob.size);
+            }
+            return blob;
+        }
+
+        std::vector<std::byte> bytes;
+    };
+
+}
+
+bool ReadCompiledMesh(std::span<const std::byte> fileData, const uint64_t sourceHash, const uint64_t recipeHash, ObjectModelDataImpl& data)
+{
+    compiled_mesh_header_t header;
+    if (fileData.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, fileData.data(), sizeof(header));
+
+    const size_t fileSize = fileData.size();
+    if (header.magic != compiledMeshMagic || header.version != compiledMeshVersion || header.fileSize != fileSize ||
+        header.sourceHash != sourceHash || header.recipeHash != recipeHash || header.vertexStride == 0u ||
+        (header.vertexStride % sizeof(float)) != 0u)
+    {
+        return false;
+    }
+
+    if (!blobInBounds(header.vertexData, fileSize, header.vertexStride) ||
+        !blobInBounds(header.indices, fileSize, sizeof(uint32_t)) ||
+        !blobInBounds(header.vertexMetadata, fileSize, sizeof(VertexMetadataEntry)) ||
+        !blobInBounds(header.materialRanges, fileSize, sizeof(compiled_mesh_range_t)) ||
+        !blobInBounds(header.primitiveGroups, fileSize, sizeof(compiled_mesh_group_t)) ||
+        !blobInBounds(header.names, fileSize, 1u))
+    {
+        return false;
+    }
+
+    const char* names = reinterpret_cast<const char*>(fileData.data() + header.names.offset);
+    auto nameInBounds = [&](const uint32_t offset, const uint32_t length)
+    {
+        return offset <= header.names.size && length <= header.names.size - offset;
+    };
+
+    const std::vector<compiled_mesh_range_t> ranges = readBlob<compiled_mesh_range_t>(fileData, header.materialRanges);
+    const std::vector<compiled_mesh_group_t> groups = readBlob<compiled_mesh_group_t>(fileData, header.primitiveGroups);
+    std::vector<uint32_t> indices = readBlob<uint32_t>(fileData, header.indices);
+    const size_t numVertices = header.vertexData.size / header.vertexStride;
+
+    for (const uint32_t index : indices)
+    {
+        if (index >= numVertices)
+        {
+            return false;
+        }
+    }
+
+    std::vector<MaterialRange> materialRanges;
+    materialRanges.reserve(ranges.size());
+    for (const compiled_mesh_range_t& range : ranges)
+    {
+        if (!nameInBounds(range.nameOffset, range.nameLength) || range.startIndex > indices.size() || range.indexCount > indices.size() - range.startIndex)
+        {
+            return false;
+        }
+        materialRanges.emplace_back(MaterialRange{ std::string(names + range.nameOffset, range.nameLength), range.startIndex, range.indexCount });
+    }
+
+    std::vector<PrimitiveGroup> primitiveGroups;
+    primitiveGroups.reserve(groups.size());
+    for (const compiled_mesh_group_t& group : groups)
+    {
+        if (!nameInBounds(group.nameOffset, group.nameLength) || group.startMaterial > ranges.size() || group.materialCount > ranges.size() - group.startMaterial)
+        {
+            return false;
+        }
+        PrimitiveGroup& result = primitiveGroups.emplace_back(PrimitiveGroup{ std::string(names + group.nameOffset, group.nameLength), group.startMaterial, group.materialCount });
+        std::copy(group.min, group.min + 3, result.min);
+        std::copy(group.max, group.max + 3, result.max);
+    }
+
+    // Every attribute has at least one float, and has to start on one, inside the vertex
+    std::vector<VertexMetadataEntry> vertexMetadata = readBlob<VertexMetadataEntry>(fileData, header.vertexMetadata);
+    for (const VertexMetadataEntry& entry : vertexMetadata)
+    {
+        if ((entry.offset % sizeof(float)) != 0u || entry.offset >= header.vertexStride)
+        {
+            return false;
+        }
+    }
+
+    data.vertexStride = static_cast<size_t>(header.vertexStride);
+    data.vertexData = readBlob<float>(fileData, header.vertexData);
+    data.vertexMetadata = std::move(vertexMetadata);
+    data.indices = std::move(indices);
+    data.indices16.clear();
+    data.materialRanges = std::move(materialRanges);
+    data.primitiveGroups = std::move(primitiveGroups);
+    std::copy(header.min, header.min + 3, data.min);
+    std::copy(header.max, header.max + 3, data.max);
+    return true;
+}
+
+bool WriteCompiledMesh(const std::filesystem::path& path, const ObjectModelDataImpl& data, const uint64_t sourceHash, const uint64_t recipeHash)
+{
+    compiled_mesh_header_t header;
+    header.sourceHash = sourceHash;
+    header.recipeHash = recipeHash;
+    header.vertexStride = data.vertexStride;
+    std::copy(data.min, data.min + 3, header.min);
+    std::copy(data.max, data.max + 3, header.max);
+
+    std::string names;
+    std::vector<compiled_mesh_range_t> ranges;
+    ranges.reserve(data.materialRanges.size());
+    for (const MaterialRange& range : data.materialRanges)
+    {
+        ranges.emplace_back(compiled_mesh_range_t{ static_cast<uint32_t>(names.size()), static_cast<uint32_t>(range.MaterialName.size()), range.startIndex, range.indexCount });
+        names += range.MaterialName;
+    }
+
+    std::vector<compiled_mesh_group_t> groups;
+    groups.reserve(data.primitiveGroups.size());
+    for (const PrimitiveGroup& group : data.primitiveGroups)
+    {
+        compiled_mesh_group_t& result = groups.emplace_back(compiled_mesh_group_t{ static_cast<uint32_t>(names.size()), static_cast<uint32_t>(group.primitiveName.size()), group.startMaterial, group.materialCount });
+        std::copy(group.min, group.min + 3, result.min);
+        std::copy(group.max, group.max + 3, result.max);
+        names += group.primitiveName;
+    }
+
+    blob_writer_t writer;
+    writer.bytes.resize(sizeof(header));
+    header.vertexData = writer.add(data.vertexData.data(), data.vertexData.size());
+    header.indices = writer.add(data.indices.data(), data.indices.size());
+    header.vertexMetadata = writer.add(data.vertexMetadata.data(), data.vertexMetadata.size());
+    header.materialRanges = writer.add(ranges.data(), ranges.size());
+    header.primitiveGroups = writer.add(groups.data(), groups.size());
+    header.names = writer.add(names.data(), names.size());
+    header.fileSize = writer.bytes.size();
+    std::memcpy(writer.bytes.data(), &header, sizeof(header));
+
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream output(tempPath, std::ios::binary | std::ios::trunc);
+        if (!output)
+        {
+            return false;
+        }
+        output.write(reinterpret_cast<const char*>(writer.bytes.data()), static_cast<std::streamsize>(writer.bytes.size()));
+        if (!output)
+        {
+            output.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
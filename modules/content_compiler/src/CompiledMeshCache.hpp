@@ -0,0 +1,79 @@
+#pragma once
+#ifndef CONTENT_COMPILER_COMPILED_MESH_CACHE_HPP
+#define CONTENT_COMPILER_COMPILED_MESH_CACHE_HPP
+#include "ModelDataImpl.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+/*
+    Binary container for an ObjectModelDataImpl, so meshes only have to be parsed and processed the first time
+    they're compiled. Layout, all native-endian:
+
+        compiled_mesh_header_t
+        vertex data             (floats, aligned to compiledMeshBlobAlignment)
+        indices                 (uint32_t, aligned)
+        vertex metadata         (VertexMetadataEntry as-is, aligned)
+        material ranges         (compiled_mesh_range_t, aligned)
+        primitive groups        (compiled_mesh_group_t, aligned)
+        names                   (not null terminated: ranges and groups store offset + length into this)
+
+    The header records the hash of the source file and of the recipe (import options) it was compiled with, and
+    ReadCompiledMesh() rejects the file if either doesn't match, as well as on any version, size or bounds mismatch.
+    Rejected files should just be compiled from source again and overwritten.
+*/
+
+constexpr uint32_t compiledMeshMagic = 0x48534d43; // "CMSH"
+// Bump whenever the layout below changes
+constexpr uint32_t compiledMeshVersion = 1u;
+constexpr size_t compiledMeshBlobAlignment = 64u;
+
+struct compiled_mesh_blob_t
+{
+    uint64_t offset{ 0u };
+    uint64_t size{ 0u };
+};
+
+struct compiled_mesh_header_t
+{
+    uint32_t magic{ compiledMeshMagic };
+    uint32_t version{ compiledMeshVersion };
+    uint64_t fileSize{ 0u };
+    uint64_t sourceHash{ 0u };
+    uint64_t recipeHash{ 0u };
+    uint64_t vertexStride{ 0u };
+    float min[3]{ 0.0f, 0.0f, 0.0f };
+    float max[3]{ 0.0f, 0.0f, 0.0f };
+    compiled_mesh_blob_t vertexData;
+    compiled_mesh_blob_t indices;
+    compiled_mesh_blob_t vertexMetadata;
+    compiled_mesh_blob_t materialRanges;
+    compiled_mesh_blob_t primitiveGroups;
+    compiled_mesh_blob_t names;
+};
+
+struct compiled_mesh_range_t
+{
+    uint32_t nameOffset{ 0u };
+    uint32_t nameLength{ 0u };
+    uint32_t startIndex{ 0u };
+    uint32_t indexCount{ 0u };
+};
+
+struct compiled_mesh_group_t
+{
+    uint32_t nameOffset{ 0u };
+    uint32_t nameLength{ 0u };
+    uint32_t startMaterial{ 0u };
+    uint32_t materialCount{ 0u };
+    float min[3]{ 0.0f, 0.0f, 0.0f };
+    float max[3]{ 0.0f, 0.0f, 0.0f };
+};
+
+// fileData is the whole (mapped) file. Returns false, leaving data untouched, if it isn't a valid container for these hashes.
+bool ReadCompiledMesh(std::span<const std::byte> fileData, const uint64_t sourceHash, const uint64_t recipeHash, ObjectModelDataImpl& data);
+// Writes to a temporary file next to path, then renames it over path, so readers never see a partial file. Returns false on failure.
+bool WriteCompiledMesh(const std::filesystem::path& path, const ObjectModelDataImpl& data, const uint64_t sourceHash, const uint64_t recipeHash);
+
+#endif //!CONTENT_COMPILER_COMPILED_MESH_CACHE_HPP
@@ -2,24 +2,12 @@
 #ifndef CONTENT_COMPILER_INTERNAL_TYPES_HPP
 #define CONTENT_COMPILER_INTERNAL_TYPES_HPP
 #include "MeshData.hpp"
+#include "ModelDataImpl.hpp"
 #include "mango/image/image.hpp"
 #include <cstdint>
 #include <vector>
 #include <string>
 
-struct ObjectModelDataImpl
-{
-    size_t vertexStride{ 0u };
-    std::vector<float> vertexData;
-    std::vector<VertexMetadataEntry> vertexMetadata;
-    std::vector<uint32_t> indices;
-    std::vector<MaterialRange> materialRanges;
-    std::vector<PrimitiveGroup> primitiveGroups;
-    float min[3];
-    float max[3];
-    explicit operator ObjectModelData() const;
-};
-
 // Representation of data as it's first loaded from disk
 struct StoredTextureDataImpl
 {
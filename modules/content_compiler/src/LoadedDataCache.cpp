@@ -1,7 +1,8 @@
 #include "LoadedDataCache.hpp"
+#include <algorithm>
+#include <limits>
 #include <variant>
 #include <unordered_map>
-#include "mango/core/hash.hpp"
 
 ObjectModelDataImpl::operator ObjectModelData() const
 {
@@ -11,12 +12,24 @@ ObjectModelDataImpl::operator ObjectModelData() const
     result.vertexData = vertexData.data();
     result.vertexAttributeCount = static_cast<uint32_t>(vertexMetadata.size());
     result.vertexAttribMetadata = vertexMetadata.data();
-    result.indexDataSize = static_cast<uint32_t>(sizeof(uint32_t) * indices.size());
-    result.indexData = indices.data();
+    if (!indices16.empty())
+    {
+        result.indexDataSize = static_cast<uint32_t>(sizeof(uint16_t) * indices16.size());
+        result.indexType = 0u;
+        result.indexData = indices16.data();
+    }
+    else
+    {
+        result.indexDataSize = static_cast<uint32_t>(sizeof(uint32_t) * indices.size());
+        result.indexType = 1u;
+        result.indexData = indices.data();
+    }
     result.numMaterials = static_cast<uint32_t>(materialRanges.size());
     result.materialRanges = materialRanges.data();
     result.numPrimGroups = static_cast<uint32_t>(primitiveGroups.size());
     result.primitiveGroups = primitiveGroups.data();
+    std::copy(min, min + 3, result.minPosition);
+    std::copy(max, max + 3, result.maxPosition);
     return result;
 }
 
@@ -37,5 +50,27 @@ ObjectModelDataImpl* TryAndGetModelData(const ccDataHandle handle)
 
 void AddObjectModelData(const ccDataHandle handle, ObjectModelDataImpl data)
 {
-    objectModelDatum.emplace(handle, data);
+    auto [iter, inserted] = objectModelDatum.emplace(handle, std::move(data));
+    if (inserted)
+    {
+        NarrowIndices(iter->second);
+    }
+}
+
+void NarrowIndices(ObjectModelDataImpl& data)
+{
+    // 0xffff is left alone, as it's the primitive restart index
+    const size_t numVertices = data.vertexStride != 0u ? (data.vertexData.size() * sizeof(float)) / data.vertexStride : 0u;
+    if (numVertices == 0u || numVertices >= std::numeric_limits<uint16_t>::max())
+    {
+        data.indices16.clear();
+        data.indices16.shrink_to_fit();
+        return;
+    }
+
+    data.indices16.resize(data.indices.size());
+    std::transform(data.indices.begin(), data.indices.end(), data.indices16.begin(), [](const uint32_t index)
+    {
+        return static_cast<uint16_t>(index);
+    });
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 #ifndef CONTENT_COMPILER_LOADED_DATA_CACHE_HPP
 #define CONTENT_COMPILER_LOADED_DATA_CACHE_HPP
 #include "MeshData.hpp"
-#include "InternalTypes.hpp"
+#include "ModelDataImpl.hpp"
 #include <vector>
 #include <string>
 
@@ -15,6 +15,9 @@
 */
 
 ObjectModelDataImpl* TryAndGetModelData(const ccDataHandle handle);
+// Narrows the indices as the data is added: anything changing them afterwards has to call NarrowIndices() again
 void AddObjectModelData(const ccDataHandle handle, ObjectModelDataImpl data);
+// Refreshes data.indices16 from data.indices, or clears it if there are too many vertices for 16-bit indices
+void NarrowIndices(ObjectModelDataImpl& data);
 
 #endif //!CONTENT_COMPILER_LOADED_DATA_CACHE_HPP
@@ -3,7 +3,286 @@
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
+#include "containers/flat_hash_map.hpp"
+#pragma warning(push, 0)
+#include "easylogging++.h"
+#pragma warning(pop)
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <string_view>
+
+namespace
+{
+
+    struct index_range_t
+    {
+        size_t start{ 0u };
+        size_t count{ 0u };
+    };
+
+    // Material ranges are separate draws, so passes that reorder triangles have to stay within them. Only a mesh
+    // without any ranges is treated as one range: ones too small to hold a triangle just have nothing to reorder.
+    std::vector<index_range_t> getTriangleRanges(const ObjectModelDataImpl& data)
+    {
+        std::vector<index_range_t> ranges;
+        if (data.materialRanges.empty())
+        {
+            ranges.emplace_back(index_range_t{ 0u, data.indices.size() - (data.indices.size() % 3u) });
+            return ranges;
+        }
+
+        ranges.reserve(data.materialRanges.size());
+        for (const MaterialRange& range : data.materialRanges)
+        {
+            if (range.indexCount >= 3u)
+            {
+                ranges.emplace_back(index_range_t{ range.startIndex, range.indexCount - (range.indexCount % 3u) });
+            }
+        }
+
+        return ranges;
+    }
+
+    size_t getVertexCount(const ObjectModelDataImpl& data)
+    {
+        return data.vertexStride != 0u ? (data.vertexData.size() * sizeof(float)) / data.vertexStride : 0u;
+    }
+
+    /*
+        FIFO cache simulation (hits don't refresh an entry, as on most hardware). A vertex is cached if it was
+        last transformed no more than cacheSize transforms ago, so the cache is just a timestamp per vertex,
+        and flush() invalidates everything at once by jumping the clock forwards.
+    */
+    struct fifo_cache_t
+    {
+        fifo_cache_t(const size_t numVertices, const uint32_t _cacheSize) :
+            timestamps(numVertices, 0u), cacheSize(_cacheSize), timestamp(_cacheSize + 1u)
+        {}
+
+        // Returns how many of the triangle's vertices had to be transformed
+        uint32_t access(const uint32_t* triangle) noexcept
+        {
+            uint32_t misses = 0u;
+            for (size_t i = 0; i < 3; ++i)
+            {
+                if (timestamp - timestamps[triangle[i]] > cacheSize)
+                {
+                    timestamps[triangle[i]] = timestamp++;
+                    ++misses;
+                }
+            }
+            return misses;
+        }
+
+        void flush() noexcept
+        {
+            timestamp += cacheSize + 1u;
+        }
+
+        std::vector<uint32_t> timestamps;
+        uint32_t cacheSize;
+        uint32_t timestamp;
+    };
+
+    void logCacheStatistics(const char* pass, const VertexCacheStatistics& before, const VertexCacheStatistics& after)
+    {
+        LOG(INFO) << pass << ": ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr <<
+            ", vertices transformed " << before.verticesTransformed << " -> " << after.verticesTransformed;
+    }
+
+    // Tunables from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    constexpr size_t forsythCacheSize = 32u;
+    constexpr float forsythCacheDecayPower = 1.5f;
+    constexpr float forsythLastTriangleScore = 0.75f;
+    constexpr float forsythValenceBoostScale = 2.0f;
+    constexpr float forsythValenceBoostPower = 0.5f;
+    constexpr size_t forsythMaxTabulatedValence = 64u;
+
+    struct forsyth_score_tables_t
+    {
+        forsyth_score_tables_t()
+        {
+            for (size_t i = 0; i < forsythCacheSize; ++i)
+            {
+                // The three vertices of the triangle just drawn get a fixed score, so the next triangle doesn't
+                // always end up reusing the same edge (which makes for long thin strips)
+                cache[i] = i < 3u ? forsythLastTriangleScore : std::pow(1.0f - float(i - 3u) / float(forsythCacheSize - 3u), forsythCacheDecayPower);
+            }
+            valence[0] = 0.0f;
+            for (size_t i = 1; i < forsythMaxTabulatedValence; ++i)
+            {
+                valence[i] = forsythValenceBoostScale * std::pow(float(i), -forsythValenceBoostPower);
+            }
+        }
+
+        float score(const int32_t cachePosition, const uint32_t liveTriangles) const noexcept
+        {
+            if (liveTriangles == 0u)
+            {
+                // No triangles left to draw, so being in the cache doesn't help anything
+                return -1.0f;
+            }
+            const float cacheScore = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+            const float valenceScore = liveTriangles < forsythMaxTabulatedValence ? valence[liveTriangles] :
+                forsythValenceBoostScale * std::pow(float(liveTriangles), -forsythValenceBoostPower);
+            return cacheScore + valenceScore;
+        }
+
+        std::array<float, forsythCacheSize> cache;
+        std::array<float, forsythMaxTabulatedValence> valence;
+    };
+
+    // Reorders the triangles of one range in place. globalToLocal has to be all ~0u, and is left that way.
+    void optimizeRangeVertexCache(uint32_t* indices, const size_t numIndices, std::vector<uint32_t>& globalToLocal)
+    {
+        static const forsyth_score_tables_t scoreTables;
+        constexpr uint32_t invalidIndex = ~0u;
+        const size_t numTriangles = numIndices / 3u;
+
+        // Compact the range's vertices, so everything below is sized by the range and not the mesh
+        std::vector<uint32_t> localToGlobal;
+        std::vector<uint32_t> localIndices(numIndices);
+        for (size_t i = 0; i < numIndices; ++i)
+        {
+            uint32_t& local = globalToLocal[indices[i]];
+            if (local == invalidIndex)
+            {
+                local = static_cast<uint32_t>(localToGlobal.size());
+                localToGlobal.emplace_back(indices[i]);
+            }
+            localIndices[i] = local;
+        }
+        const size_t numVertices = localToGlobal.size();
+
+        // Triangles using each vertex, as one array with per-vertex offsets. Drawn triangles are swapped out to
+        // the end of their vertex's list, so the first liveTriangles entries are always the ones left to draw.
+        std::vector<uint32_t> liveTriangles(numVertices, 0u);
+        for (const uint32_t index : localIndices)
+        {
+            ++liveTriangles[index];
+        }
+        std::vector<uint32_t> adjacencyOffsets(numVertices + 1u, 0u);
+        std::partial_sum(liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1u);
+        std::vector<uint32_t> adjacency(numIndices);
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1u);
+            for (size_t i = 0; i < numIndices; ++i)
+            {
+                adjacency[fill[localIndices[i]]++] = static_cast<uint32_t>(i / 3u);
+            }
+        }
+
+        std::vector<int32_t> cachePositions(numVertices, -1);
+        std::vector<float> vertexScores(numVertices);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            vertexScores[i] = scoreTables.score(-1, liveTriangles[i]);
+        }
+
+        std::vector<uint8_t> emitted(numTriangles, 0u);
+        uint32_t bestTriangle = 0u;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < numTriangles; ++i)
+        {
+            const uint32_t* tri = &localIndices[i * 3u];
+            const float score = vertexScores[tri[0]] + vertexScores[tri[1]] + vertexScores[tri[2]];
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestTriangle = static_cast<uint32_t>(i);
+            }
+        }
+
+        // Three extra slots hold what the last triangle pushed out, as their scores need updating too
+        std::array<uint32_t, forsythCacheSize + 3u> cache;
+        std::array<uint32_t, forsythCacheSize + 3u> newCache;
+        size_t cacheCount = 0u;
+        size_t inputCursor = 0u;
+
+        for (size_t outputTriangle = 0u; outputTriangle < numTriangles; ++outputTriangle)
+        {
+            if (bestTriangle == invalidIndex)
+            {
+                // Nothing in the cache has any triangles left: carry on in input order
+                while (emitted[inputCursor])
+                {
+                    ++inputCursor;
+                }
+                bestTriangle = static_cast<uint32_t>(inputCursor);
+            }
+
+            const uint32_t* tri = &localIndices[bestTriangle * 3u];
+            std::copy(tri, tri + 3u, indices + outputTriangle * 3u);
+            emitted[bestTriangle] = 1u;
+
+            size_t newCacheCount = 0u;
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const uint32_t vertex = tri[i];
+                uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+                uint32_t* end = begin + liveTriangles[vertex];
+                std::iter_swap(std::find(begin, end, bestTriangle), end - 1);
+                --liveTriangles[vertex];
+                // degenerate triangles repeat a vertex, which should still only take one cache slot
+                if (std::find(newCache.begin(), newCache.begin() + newCacheCount, vertex) == newCache.begin() + newCacheCount)
+                {
+                    newCache[newCacheCount++] = vertex;
+                }
+            }
+
+            for (size_t i = 0; i < cacheCount; ++i)
+            {
+                const uint32_t vertex = cache[i];
+                if (vertex != tri[0] && vertex != tri[1] && vertex != tri[2])
+                {
+                    newCache[newCacheCount++] = vertex;
+                }
+            }
+
+            for (size_t i = 0; i < newCacheCount; ++i)
+            {
+                const uint32_t vertex = newCache[i];
+                cachePositions[vertex] = i < forsythCacheSize ? static_cast<int32_t>(i) : -1;
+                vertexScores[vertex] = scoreTables.score(cachePositions[vertex], liveTriangles[vertex]);
+            }
+
+            // Only triangles touching the cache changed score, so the next pick is the best of those
+            bestTriangle = invalidIndex;
+            bestScore = -1.0f;
+            for (size_t i = 0; i < newCacheCount; ++i)
+            {
+                const uint32_t vertex = newCache[i];
+                const uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+                const uint32_t* end = begin + liveTriangles[vertex];
+                for (const uint32_t* iter = begin; iter != end; ++iter)
+                {
+                    const uint32_t* adjacentTri = &localIndices[*iter * 3u];
+                    const float score = vertexScores[adjacentTri[0]] + vertexScores[adjacentTri[1]] + vertexScores[adjacentTri[2]];
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = *iter;
+                    }
+                }
+            }
+
+            cacheCount = std::min(newCacheCount, forsythCacheSize);
+            std::copy(newCache.begin(), newCache.begin() + cacheCount, cache.begin());
+        }
+
+        for (size_t i = 0; i < numIndices; ++i)
+        {
+            indices[i] = localToGlobal[indices[i]];
+        }
+        for (const uint32_t vertex : localToGlobal)
+        {
+            globalToLocal[vertex] = invalidIndex;
+        }
+    }
+
+}
 
 void CalculateTangents(const ccDataHandle handle)
 {
@@ -126,4 +405,276 @@ void SortMeshMaterialRanges(const ccDataHandle handle)
     mergedRanges.shrink_to_fit();
     modelData->indices.swap(indicesReordered);
     modelData->materialRanges.swap(mergedRanges);
+    NarrowIndices(*modelData);
+}
+
+
+void RemoveDuplicatedVertices(const ccDataHandle handle)
+{
+    ObjectModelDataImpl* data = TryAndGetModelData(handle);
+    if (!data || data->vertexStride == 0u)
+    {
+        return;
+    }
+
+    const size_t floatsPerVert = data->vertexStride / sizeof(float);
+    const size_t numVerts = data->vertexData.size() / floatsPerVert;
+
+    // Vertices are compared bit for bit (so -0.0f and 0.0f stay distinct), keyed on views of their bytes
+    foundation::flat_hash_map<std::string_view, uint32_t> uniqueVertices;
+    uniqueVertices.reserve(numVerts);
+    std::vector<uint32_t> remap(numVerts);
+    std::vector<float> uniqueVertexData;
+    uniqueVertexData.reserve(data->vertexData.size());
+
+    for (size_t i = 0; i < numVerts; ++i)
+    {
+        const float* vertex = &data->vertexData[i * floatsPerVert];
+        const std::string_view vertexBytes(reinterpret_cast<const char*>(vertex), data->vertexStride);
+        const uint32_t nextIndex = static_cast<uint32_t>(uniqueVertexData.size() / floatsPerVert);
+        auto [iter, inserted] = uniqueVertices.try_emplace(vertexBytes, nextIndex);
+        if (inserted)
+        {
+            uniqueVertexData.insert(uniqueVertexData.end(), vertex, vertex + floatsPerVert);
+        }
+        remap[i] = iter->second;
+    }
+
+    if (uniqueVertexData.size() == data->vertexData.size())
+    {
+        return;
+    }
+
+    for (uint32_t& index : data->indices)
+    {
+        index = remap[index];
+    }
+
+    uniqueVertexData.shrink_to_fit();
+    data->vertexData.swap(uniqueVertexData);
+    NarrowIndices(*data);
+}
+
+VertexCacheStatistics AnalyzeVertexCache(const ccDataHandle handle, const uint32_t cacheSize)
+{
+    ObjectModelDataImpl* data = TryAndGetModelData(handle);
+    if (!data || data->indices.size() < 3u)
+    {
+        return VertexCacheStatistics();
+    }
+
+    const size_t numVerts = getVertexCount(*data);
+    const size_t numTriangles = data->indices.size() / 3u;
+    fifo_cache_t cache(numVerts, cacheSize);
+    std::vector<uint8_t> referenced(numVerts, 0u);
+    size_t numReferenced = 0u;
+
+    VertexCacheStatistics result;
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        const uint32_t* tri = &data->indices[i * 3u];
+        result.verticesTransformed += cache.access(tri);
+        for (size_t j = 0; j < 3; ++j)
+        {
+            numReferenced += referenced[tri[j]] == 0u;
+            referenced[tri[j]] = 1u;
+        }
+    }
+
+    result.acmr = float(result.verticesTransformed) / float(numTriangles);
+    result.atvr = float(result.verticesTransformed) / float(numReferenced);
+    return result;
+}
+
+void OptimizeVertexCache(const ccDataHandle handle)
+{
+    ObjectModelDataImpl* data = TryAndGetModelData(handle);
+    if (!data || data->indices.size() < 3u)
+    {
+        return;
+    }
+
+    const VertexCacheStatistics before = AnalyzeVertexCache(handle);
+
+    std::vector<uint32_t> globalToLocal(getVertexCount(*data), ~0u);
+    for (const index_range_t& range : getTriangleRanges(*data))
+    {
+        optimizeRangeVertexCache(data->indices.data() + range.start, range.count, globalToLocal);
+    }
+
+    NarrowIndices(*data);
+    logCacheStatistics("OptimizeVertexCache", before, AnalyzeVertexCache(handle));
+}
+
+void OptimizeOverdraw(const ccDataHandle handle, const float threshold)
+{
+    ObjectModelDataImpl* data = TryAndGetModelData(handle);
+    if (!data || data->indices.size() < 3u)
+    {
+        return;
+    }
+
+    constexpr uint32_t cacheSize = 16u;
+    const VertexCacheStatistics before = AnalyzeVertexCache(handle, cacheSize);
+
+    const size_t floatsPerVert = data->vertexStride / sizeof(float);
+    size_t positionOffset = 0u;
+    for (const VertexMetadataEntry& entry : data->vertexMetadata)
+    {
+        if (entry.location == 0u)
+        {
+            positionOffset = entry.offset / sizeof(float);
+        }
+    }
+
+    auto getPosition = [&](const uint32_t vertex)
+    {
+        return glm::make_vec3(&data->vertexData[vertex * floatsPerVert + positionOffset]);
+    };
+
+    fifo_cache_t cache(getVertexCount(*data), cacheSize);
+    std::vector<uint32_t> reordered;
+
+    for (const index_range_t& range : getTriangleRanges(*data))
+    {
+        uint32_t* indices = data->indices.data() + range.start;
+        const size_t numTriangles = range.count / 3u;
+
+        // Hard boundaries: wherever a triangle misses on all three vertices, the cache-ordered sequence
+        // is starting over anyway, so reordering there costs nothing
+        std::vector<size_t> hardClusters{ 0u };
+        cache.flush();
+        cache.access(indices);
+        for (size_t i = 1; i < numTriangles; ++i)
+        {
+            if (cache.access(&indices[i * 3u]) == 3u)
+            {
+                hardClusters.emplace_back(i);
+            }
+        }
+        hardClusters.emplace_back(numTriangles);
+
+        // Soft boundaries: split a hard cluster wherever its ACMR so far is already within threshold of what
+        // the whole cluster gets, since from there on restarting the cache doesn't hurt much
+        std::vector<size_t> clusters;
+        for (size_t c = 0; c + 1u < hardClusters.size(); ++c)
+        {
+            const size_t clusterStart = hardClusters[c];
+            const size_t clusterEnd = hardClusters[c + 1u];
+
+            cache.flush();
+            uint32_t clusterMisses = 0u;
+            for (size_t i = clusterStart; i < clusterEnd; ++i)
+            {
+                clusterMisses += cache.access(&indices[i * 3u]);
+            }
+            const float clusterThreshold = threshold * float(clusterMisses) / float(clusterEnd - clusterStart);
+
+            cache.flush();
+            size_t subclusterStart = clusterStart;
+            uint32_t subclusterMisses = 0u;
+            clusters.emplace_back(clusterStart);
+            for (size_t i = clusterStart; i < clusterEnd; ++i)
+            {
+                subclusterMisses += cache.access(&indices[i * 3u]);
+                if (i + 1u < clusterEnd && float(subclusterMisses) / float(i + 1u - subclusterStart) <= clusterThreshold)
+                {
+                    clusters.emplace_back(i + 1u);
+                    subclusterStart = i + 1u;
+                    subclusterMisses = 0u;
+                    cache.flush();
+                }
+            }
+        }
+        clusters.emplace_back(numTriangles);
+
+        // Clusters facing away from the middle of the range are on its outside, so drawing them first
+        // lets depth testing reject more of what's drawn after
+        const size_t numClusters = clusters.size() - 1u;
+        std::vector<glm::vec3> clusterCentroids(numClusters, glm::vec3(0.0f));
+        std::vector<glm::vec3> clusterNormals(numClusters, glm::vec3(0.0f));
+        glm::vec3 rangeCentroid(0.0f);
+        float rangeArea = 0.0f;
+        for (size_t c = 0; c < numClusters; ++c)
+        {
+            float clusterArea = 0.0f;
+            for (size_t i = clusters[c]; i < clusters[c + 1u]; ++i)
+            {
+                const glm::vec3 p0 = getPosition(indices[i * 3u + 0u]);
+                const glm::vec3 p1 = getPosition(indices[i * 3u + 1u]);
+                const glm::vec3 p2 = getPosition(indices[i * 3u + 2u]);
+                // cross product's length is twice the area, which is fine as a weight
+                const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                const float area = glm::length(normal);
+                clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+                clusterNormals[c] += normal;
+                clusterArea += area;
+            }
+            rangeCentroid += clusterCentroids[c];
+            rangeArea += clusterArea;
+            clusterCentroids[c] = clusterArea > 0.0f ? clusterCentroids[c] / clusterArea : getPosition(indices[clusters[c] * 3u]);
+        }
+        rangeCentroid = rangeArea > 0.0f ? rangeCentroid / rangeArea : glm::vec3(0.0f);
+
+        std::vector<float> sortKeys(numClusters);
+        for (size_t c = 0; c < numClusters; ++c)
+        {
+            const float normalLength = glm::length(clusterNormals[c]);
+            sortKeys[c] = normalLength > 0.0f ? glm::dot(clusterCentroids[c] - rangeCentroid, clusterNormals[c] / normalLength) : 0.0f;
+        }
+
+        std::vector<uint32_t> clusterOrder(numClusters);
+        std::iota(clusterOrder.begin(), clusterOrder.end(), 0u);
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](const uint32_t c0, const uint32_t c1)
+        {
+            return sortKeys[c0] > sortKeys[c1];
+        });
+
+        reordered.clear();
+        reordered.reserve(range.count);
+        for (const uint32_t c : clusterOrder)
+        {
+            reordered.insert(reordered.end(), indices + clusters[c] * 3u, indices + clusters[c + 1u] * 3u);
+        }
+        std::copy(reordered.begin(), reordered.end(), indices);
+    }
+
+    NarrowIndices(*data);
+    logCacheStatistics("OptimizeOverdraw", before, AnalyzeVertexCache(handle, cacheSize));
+}
+
+void OptimizeVertexFetch(const ccDataHandle handle)
+{
+    ObjectModelDataImpl* data = TryAndGetModelData(handle);
+    if (!data || data->vertexStride == 0u)
+    {
+        return;
+    }
+
+    const VertexCacheStatistics before = AnalyzeVertexCache(handle);
+    const size_t floatsPerVert = data->vertexStride / sizeof(float);
+    const size_t numVerts = getVertexCount(*data);
+
+    constexpr uint32_t unusedVertex = ~0u;
+    std::vector<uint32_t> remap(numVerts, unusedVertex);
+    std::vector<float> reorderedVertexData;
+    reorderedVertexData.reserve(data->vertexData.size());
+
+    for (uint32_t& index : data->indices)
+    {
+        if (remap[index] == unusedVertex)
+        {
+            remap[index] = static_cast<uint32_t>(reorderedVertexData.size() / floatsPerVert);
+            const float* vertex = &data->vertexData[index * floatsPerVert];
+            reorderedVertexData.insert(reorderedVertexData.end(), vertex, vertex + floatsPerVert);
+        }
+        index = remap[index];
+    }
+
+    reorderedVertexData.shrink_to_fit();
+    data->vertexData.swap(reorderedVertexData);
+    NarrowIndices(*data);
+
+    logCacheStatistics("OptimizeVertexFetch", before, AnalyzeVertexCache(handle));
+    LOG(INFO) << "OptimizeVertexFetch: vertices " << numVerts << " -> " << getVertexCount(*data);
 }
@@ -0,0 +1,27 @@
+#pragma once
+#ifndef CONTENT_COMPILER_MODEL_DATA_IMPL_HPP
+#define CONTENT_COMPILER_MODEL_DATA_IMPL_HPP
+#include "MeshData.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Kept out of InternalTypes.hpp so mesh code, and its tests, don't need mango's image headers
+struct ObjectModelDataImpl
+{
+    size_t vertexStride{ 0u };
+    std::vector<float> vertexData;
+    std::vector<VertexMetadataEntry> vertexMetadata;
+    std::vector<uint32_t> indices;
+    // Copy of indices handed out instead of them when every index fits. Kept in step with indices by everything
+    // that changes them, so pointers handed out stay valid until the mesh itself changes: see NarrowIndices()
+    std::vector<uint16_t> indices16;
+    std::vector<MaterialRange> materialRanges;
+    std::vector<PrimitiveGroup> primitiveGroups;
+    // Bounds of every position used by a vertex, set by ObjFileData::RetrieveData()
+    float min[3]{ 3e38f, 3e38f, 3e38f };
+    float max[3]{-3e38f,-3e38f,-3e38f };
+    explicit operator ObjectModelData() const;
+};
+
+#endif //!CONTENT_COMPILER_MODEL_DATA_IMPL_HPP
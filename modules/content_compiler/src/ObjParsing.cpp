@@ -0,0 +1,545 @@
+#include "ObjParsing.hpp"
+#include "svUtil.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "utility/FastHash.hpp"
+#include <algorithm>
+#include <charconv>
+#include <execution>
+#include <numeric>
+#include <thread>
+#include <vulkan/vulkan_core.h>
+
+namespace
+{
+    // Only the keyword and the three tokens after it are ever used, so lines are split into these instead of a vector
+    constexpr size_t maxLineTokens = 4u;
+    using line_tokens_t = std::array<std::string_view, maxLineTokens>;
+
+    template<size_t numVecElements>
+    auto extract_vector(const line_tokens_t& tokens, const size_t numTokens)->std::array<float, numVecElements>;
+}
+
+namespace ObjLoader
+{
+
+    // Face corners with the same attribute indices are the same vertex, so this is what the importer dedupes on
+    struct OBJvertexHash
+    {
+        size_t operator()(const OBJvertex& vertex) const noexcept
+        {
+            static_assert(sizeof(OBJvertex) == 3u * sizeof(int32_t), "OBJvertex is hashed as raw bytes, so can't have padding");
+            return static_cast<size_t>(foundation::FastHash(&vertex, sizeof(OBJvertex)));
+        }
+    };
+
+    // A "usemtl" or "g" line. Opening a range depends on the ranges before it, so chunks just record these in order
+    struct OBJRangeStart
+    {
+        bool isGroup{ false };
+        std::string name;
+        // Face count at the point the range started, local to the chunk until merged
+        uint32_t faceIndex{ 0u };
+    };
+
+    /*
+        Everything parsed out of one chunk of the file, with face vertices and faces indexing into the chunk's
+        own arrays. Negative (relative) attribute indices can only be resolved once the attribute counts of
+        all the chunks before this one are known: they're resolved against the chunk, and the vertices
+        they belong to listed so mergeChunks() can add the rest.
+    */
+    struct OBJChunk
+    {
+        std::vector<vec3> positions;
+        std::vector<vec3> normals;
+        std::vector<vec2> uvs;
+        std::vector<OBJvertex> OBJverts;
+        std::vector<OBJface> OBJfaces;
+        std::vector<OBJRangeStart> rangeStarts;
+        std::vector<uint32_t> relativePositionVerts;
+        std::vector<uint32_t> relativeUvVerts;
+        std::vector<uint32_t> relativeNormalVerts;
+        size_t emptyFaces{ 0u };
+    };
+
+    ObjFileData::ObjFileData()
+    {
+        parsed.groups.reserve(2048);
+        parsed.OBJMtlRanges.reserve(2048);
+        parsed.groups.emplace_back(OBJgroup{ std::string(""), 0u, 0u, 0u, 0u });
+        parsed.OBJMtlRanges.emplace_back(OBJMtlRange{ std::string(""), 0u, 0u });
+    }
+
+    const OBJparsedData& ObjFileData::Parsed() const noexcept
+    {
+        return parsed;
+    }
+
+    size_t ObjFileData::EmptyFaceCount() const noexcept
+    {
+        return emptyFaces;
+    }
+
+    ObjectModelDataImpl ObjFileData::RetrieveData(const bool loadNormals, const bool loadTangents)
+    {
+        ObjectModelDataImpl results;
+        // transfers data into results in the compatible format for rendering
+        transferData(results, loadNormals, loadTangents);
+        // converts material and primitive groups into what we care about when rendering#pra
+        prepareMaterialsAndGroups(results);
+        releaseData();
+        return results;
+    }
+
+    void ObjFileData::ParseText(std::string_view modelMemoryView, const bool loadNormals, const size_t chunkSize)
+    {
+        const size_t modelMemorySize = modelMemoryView.size();
+
+        // Split into chunks at line boundaries: every chunk but the last ends just after a newline
+        const size_t maxChunks = std::max<size_t>(std::thread::hardware_concurrency(), 1u) * 4u;
+        const size_t numChunks = chunkSize == 0u ?
+            std::clamp<size_t>(modelMemorySize / defaultChunkSize, 1u, maxChunks) :
+            std::max<size_t>(modelMemorySize / chunkSize, 1u);
+        const size_t targetChunkSize = modelMemorySize / numChunks;
+        std::vector<std::string_view> chunkViews;
+        chunkViews.reserve(numChunks);
+
+        size_t chunkBegin = 0u;
+        while (chunkBegin < modelMemorySize)
+        {
+            size_t chunkEnd = modelMemorySize;
+            if (chunkViews.size() + 1u < numChunks)
+            {
+                const size_t newline = modelMemoryView.find('\n', chunkBegin + targetChunkSize);
+                chunkEnd = newline == std::string_view::npos ? modelMemorySize : newline + 1u;
+            }
+            chunkViews.emplace_back(modelMemoryView.substr(chunkBegin, chunkEnd - chunkBegin));
+            chunkBegin = chunkEnd;
+        }
+
+        std::vector<OBJChunk> chunks(chunkViews.size());
+        if (chunks.size() == 1u)
+        {
+            parseChunk(chunkViews[0], loadNormals, chunks[0]);
+        }
+        else
+        {
+            std::vector<size_t> chunkIndices(chunks.size());
+            std::iota(chunkIndices.begin(), chunkIndices.end(), size_t(0u));
+            std::for_each(std::execution::par, chunkIndices.begin(), chunkIndices.end(), [&](const size_t i)
+            {
+                parseChunk(chunkViews[i], loadNormals, chunks[i]);
+            });
+        }
+
+        mergeChunks(chunks);
+    }
+
+    void ObjFileData::parseChunk(std::string_view chunkView, bool loadNormals, OBJChunk& chunk)
+    {
+        using namespace svutil;
+
+        while (!chunkView.empty())
+        {
+            const size_t newline = chunkView.find('\n');
+            std::string_view line = chunkView.substr(0, newline);
+            chunkView.remove_prefix(newline == std::string_view::npos ? chunkView.size() : newline + 1u);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            line_tokens_t tokens;
+            const size_t numTokens = separate_first_tokens(line, ' ', tokens.data(), tokens.size());
+            if (numTokens == 0u)
+            {
+                continue;
+            }
+
+            if (tokens[0] == "f")
+            {
+                OBJface face{};
+                face.startVertexIdx = static_cast<uint32_t>(chunk.OBJverts.size());
+
+                for (size_t i = 1; i < numTokens; ++i)
+                {
+                    OBJvertex vertex;
+                    std::array<std::string_view, 3> indexTokens;
+                    const size_t numIndexTokens = separate_first_tokens(tokens[i], '/', indexTokens.data(), indexTokens.size());
+                    if (numIndexTokens > 0)
+                    {
+                        std::from_chars(indexTokens[0].data(), indexTokens[0].data() + indexTokens[0].size(), vertex.posIdx);
+                    }
+                    if (numIndexTokens > 1)
+                    {
+                        std::from_chars(indexTokens[1].data(), indexTokens[1].data() + indexTokens[1].size(), vertex.uvIdx);
+                    }
+                    if (numIndexTokens > 2 && loadNormals)
+                    {
+                        std::from_chars(indexTokens[2].data(), indexTokens[2].data() + indexTokens[2].size(), vertex.normalIdx);
+                    }
+
+                    const uint32_t vertexIdx = static_cast<uint32_t>(chunk.OBJverts.size());
+                    if (vertex.posIdx < 0)
+                    {
+                        vertex.posIdx += static_cast<int32_t>(chunk.positions.size()) + 1;
+                        chunk.relativePositionVerts.emplace_back(vertexIdx);
+                    }
+                    if (vertex.uvIdx < 0)
+                    {
+                        vertex.uvIdx += static_cast<int32_t>(chunk.uvs.size()) + 1;
+                        chunk.relativeUvVerts.emplace_back(vertexIdx);
+                    }
+                    if (vertex.normalIdx < 0)
+                    {
+                        vertex.normalIdx += static_cast<int32_t>(chunk.normals.size()) + 1;
+                        chunk.relativeNormalVerts.emplace_back(vertexIdx);
+                    }
+
+                    chunk.OBJverts.emplace_back(vertex);
+                }
+
+                face.endVertexIdx = static_cast<uint32_t>(chunk.OBJverts.size());
+                if (face.endVertexIdx == face.startVertexIdx)
+                {
+                    ++chunk.emptyFaces;
+                }
+
+                chunk.OBJfaces.emplace_back(face);
+            }
+            // vertex position
+            else if (tokens[0] == "v")
+            {
+                chunk.positions.emplace_back(extract_vector<3>(tokens, numTokens));
+            }
+            // vertex UV
+            else if (tokens[0] == "vt")
+            {
+                chunk.uvs.emplace_back(extract_vector<2>(tokens, numTokens));
+            }
+            // vertex normal
+            else if (tokens[0] == "vn" && loadNormals)
+            {
+                chunk.normals.emplace_back(extract_vector<3>(tokens, numTokens));
+            }
+            else if (tokens[0] == "usemtl" || tokens[0] == "g")
+            {
+                chunk.rangeStarts.emplace_back(OBJRangeStart{ tokens[0] == "g", to_lowercase(tokens[1]), static_cast<uint32_t>(chunk.OBJfaces.size()) });
+            }
+
+        }
+    }
+
+    void ObjFileData::mergeChunks(std::vector<OBJChunk>& chunks)
+    {
+        struct chunk_offsets_t
+        {
+            size_t positions{ 0u };
+            size_t normals{ 0u };
+            size_t uvs{ 0u };
+            size_t verts{ 0u };
+            size_t faces{ 0u };
+        };
+
+        // Exclusive prefix sums: where each chunk's data lands in the merged arrays
+        std::vector<chunk_offsets_t> offsets(chunks.size() + 1u);
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            offsets[i + 1u].positions = offsets[i].positions + chunks[i].positions.size();
+            offsets[i + 1u].normals = offsets[i].normals + chunks[i].normals.size();
+            offsets[i + 1u].uvs = offsets[i].uvs + chunks[i].uvs.size();
+            offsets[i + 1u].verts = offsets[i].verts + chunks[i].OBJverts.size();
+            offsets[i + 1u].faces = offsets[i].faces + chunks[i].OBJfaces.size();
+        }
+
+        const chunk_offsets_t& totals = offsets.back();
+        parsed.positions.resize(totals.positions);
+        parsed.normals.resize(totals.normals);
+        parsed.uvs.resize(totals.uvs);
+        parsed.OBJverts.resize(totals.verts);
+        parsed.OBJfaces.resize(totals.faces);
+
+        auto mergeChunk = [&](const size_t i)
+        {
+            OBJChunk& chunk = chunks[i];
+            const chunk_offsets_t& offset = offsets[i];
+
+            std::copy(chunk.positions.begin(), chunk.positions.end(), parsed.positions.begin() + offset.positions);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), parsed.normals.begin() + offset.normals);
+            std::copy(chunk.uvs.begin(), chunk.uvs.end(), parsed.uvs.begin() + offset.uvs);
+
+            for (const uint32_t vertexIdx : chunk.relativePositionVerts)
+            {
+                chunk.OBJverts[vertexIdx].posIdx += static_cast<int32_t>(offset.positions);
+            }
+            for (const uint32_t vertexIdx : chunk.relativeUvVerts)
+            {
+                chunk.OBJverts[vertexIdx].uvIdx += static_cast<int32_t>(offset.uvs);
+            }
+            for (const uint32_t vertexIdx : chunk.relativeNormalVerts)
+            {
+                chunk.OBJverts[vertexIdx].normalIdx += static_cast<int32_t>(offset.normals);
+            }
+            std::copy(chunk.OBJverts.begin(), chunk.OBJverts.end(), parsed.OBJverts.begin() + offset.verts);
+
+            std::transform(chunk.OBJfaces.begin(), chunk.OBJfaces.end(), parsed.OBJfaces.begin() + offset.faces, [&](const OBJface& face)
+            {
+                return OBJface{ face.startVertexIdx + static_cast<uint32_t>(offset.verts), face.endVertexIdx + static_cast<uint32_t>(offset.verts), 0u };
+            });
+
+            chunk.positions = {};
+            chunk.normals = {};
+            chunk.uvs = {};
+            chunk.OBJverts = {};
+            chunk.OBJfaces = {};
+        };
+
+        if (chunks.size() == 1u)
+        {
+            mergeChunk(0u);
+        }
+        else
+        {
+            std::vector<size_t> chunkIndices(chunks.size());
+            std::iota(chunkIndices.begin(), chunkIndices.end(), size_t(0u));
+            std::for_each(std::execution::par, chunkIndices.begin(), chunkIndices.end(), mergeChunk);
+        }
+
+        // Each range depends on the one before, so these are replayed in file order
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            emptyFaces += chunks[i].emptyFaces;
+            for (const OBJRangeStart& rangeStart : chunks[i].rangeStarts)
+            {
+                const uint32_t faceIndex = rangeStart.faceIndex + static_cast<uint32_t>(offsets[i].faces);
+                if (rangeStart.isGroup)
+                {
+                    beginGroup(rangeStart.name, faceIndex);
+                }
+                else
+                {
+                    beginMaterialRange(rangeStart.name, faceIndex);
+                }
+            }
+        }
+
+        parsed.OBJMtlRanges.back().endFaceIndex = static_cast<uint32_t>(parsed.OBJfaces.size());
+    }
+
+    void ObjFileData::beginMaterialRange(std::string_view name, const uint32_t faceIndex)
+    {
+        OBJMtlRange* currMtlRange = &parsed.OBJMtlRanges.back();
+        currMtlRange->endFaceIndex = faceIndex;
+
+        if (currMtlRange->endFaceIndex > currMtlRange->startFaceIndex)
+        {
+            parsed.OBJMtlRanges.push_back(OBJMtlRange());
+            currMtlRange = &parsed.OBJMtlRanges.back();
+        }
+
+        currMtlRange->mtlName = name;
+        currMtlRange->startFaceIndex = faceIndex;
+    }
+
+    void ObjFileData::beginGroup(std::string_view name, const uint32_t faceIndex)
+    {
+        // Pretty much the exact same process, just a little more to account for materials too
+        OBJgroup* currGroup = &parsed.groups.back();
+        currGroup->endFaceIndex = faceIndex;
+        currGroup->endMtlIndex = static_cast<uint32_t>(parsed.OBJMtlRanges.size());
+
+        if (currGroup->endFaceIndex > currGroup->startFaceIndex&& currGroup->endMtlIndex > currGroup->startMtlIndex)
+        {
+            parsed.groups.push_back(OBJgroup());
+            currGroup = &parsed.groups.back();
+        }
+
+        currGroup->groupName = name;
+        currGroup->startFaceIndex = faceIndex;
+        currGroup->startMtlIndex = static_cast<uint32_t>(parsed.OBJMtlRanges.size());
+    }
+
+    void ObjFileData::transferData(ObjectModelDataImpl& results, bool loadNormals, bool loadTangents)
+    { 
+        // Every face corner is an OBJvertex, but most of them repeat: only the first corner with a given
+        // position/normal/uv index tuple becomes a vertex, and the rest are remapped onto it
+        const size_t numCorners = parsed.OBJverts.size();
+        std::vector<uint32_t> cornerToVertex(numCorners);
+        std::vector<uint32_t> uniqueCorners;
+        uniqueCorners.reserve(numCorners / 4u);
+
+        {
+            foundation::flat_hash_map<OBJvertex, uint32_t, OBJvertexHash> uniqueVertices;
+            uniqueVertices.reserve(numCorners / 4u);
+            for (size_t i = 0; i < numCorners; ++i)
+            {
+                auto [iter, inserted] = uniqueVertices.try_emplace(parsed.OBJverts[i], static_cast<uint32_t>(uniqueCorners.size()));
+                if (inserted)
+                {
+                    uniqueCorners.emplace_back(static_cast<uint32_t>(i));
+                }
+                cornerToVertex[i] = iter->second;
+            }
+        }
+
+        const size_t vertexStrideInFloats = 3u + (parsed.uvs.empty() ? 0u : 2u) + (loadNormals ? 3u : 0u) + (loadTangents ? 3u : 0u);
+        results.vertexStride = sizeof(float) * vertexStrideInFloats;
+        results.vertexData.resize(uniqueCorners.size() * vertexStrideInFloats, 0.0f);
+
+        const size_t normalsOffset = loadNormals ? 3u : 0u;
+        const size_t tangentsOffset = loadTangents ? 3u + normalsOffset : normalsOffset;
+        // even if we're not loading them from an obj, we need to account for them now by leaving 3 empty floats
+        // in between the normals and UVs
+        const size_t uvsOffset = tangentsOffset + 3u;
+
+        // Quickly build the metadata entries
+        results.vertexMetadata.emplace_back(VertexMetadataEntry{ 0, (uint32_t)VK_FORMAT_R32G32B32_SFLOAT, 0u });
+        uint32_t uvsLocation = 1;
+        if (loadNormals)
+        {
+            results.vertexMetadata.emplace_back(VertexMetadataEntry{ 1, (uint32_t)VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(normalsOffset * sizeof(float)) });
+            ++uvsLocation;
+        }
+        if (loadTangents)
+        {
+            results.vertexMetadata.emplace_back(VertexMetadataEntry{ 2, (uint32_t)VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(tangentsOffset * sizeof(float)) });
+            ++uvsLocation;
+        }
+        results.vertexMetadata.emplace_back(VertexMetadataEntry{ uvsLocation, (uint32_t)VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(uvsOffset * sizeof(float)) });
+
+        const size_t numVerts = uniqueCorners.size();
+        auto& vertexDataRef = results.vertexData;
+        for (size_t i = 0; i < numVerts; ++i)
+        {
+            const OBJvertex& currentVertex = parsed.OBJverts[uniqueCorners[i]];
+            const size_t j = i * vertexStrideInFloats;
+
+            // I use std::copy in here mostly in the hope it might optimize to something nice
+            if (currentVertex.posIdx > 0)
+            {
+                auto& position = parsed.positions[currentVertex.posIdx - 1];
+                std::copy(position.data(), position.data() + 3u, vertexDataRef.begin() + j);
+                for (size_t k = 0; k < 3u; ++k)
+                {
+                    results.min[k] = std::min(results.min[k], position[k]);
+                    results.max[k] = std::max(results.max[k], position[k]);
+                }
+            }
+
+            if (currentVertex.normalIdx > 0)
+            {
+                auto& normal = parsed.normals[currentVertex.normalIdx - 1];
+                std::copy(normal.data(), normal.data() + 3u, vertexDataRef.begin() + j + normalsOffset);
+            }
+
+            if (currentVertex.uvIdx > 0)
+            {
+                auto& uv = parsed.uvs[currentVertex.uvIdx - 1];
+                std::copy(uv.data(), uv.data() + 2u, vertexDataRef.begin() + j + uvsOffset);
+            }
+
+        }
+
+        const size_t numFaces = parsed.OBJfaces.size();
+        auto& indexDataRef = results.indices;
+        indexDataRef.reserve(numFaces * 3u);
+
+        for (size_t i = 0; i < numFaces; ++i)
+        {
+            OBJface& face = parsed.OBJfaces[i];
+
+            face.indexStart = static_cast<uint32_t>(indexDataRef.size());
+            const uint32_t baseIndex = cornerToVertex[face.startVertexIdx];
+
+            for (uint32_t cornerIndex = face.startVertexIdx + 2; cornerIndex < face.endVertexIdx; ++cornerIndex)
+            {
+                indexDataRef.emplace_back(baseIndex);
+                indexDataRef.emplace_back(cornerToVertex[cornerIndex - 1u]);
+                indexDataRef.emplace_back(cornerToVertex[cornerIndex]);
+            }
+        }
+
+        // suggested by original implementer of this method
+        parsed.OBJfaces.emplace_back(OBJface{ 0, 0, static_cast<uint32_t>(results.indices.size()) });
+
+    }
+
+    void ObjFileData::prepareMaterialsAndGroups(ObjectModelDataImpl& results)
+    {
+        // This is literally two sets of transformations, which ends up being quite apt with usage of std::transform
+        // We're just changing that "space" the indices are referred to in so that it'll match the new storage layout
+       
+        auto transformMaterialRange = [&](OBJMtlRange& range)->MaterialRange
+        {
+            uint32_t startIndex = parsed.OBJfaces[range.startFaceIndex].indexStart;
+            uint32_t endIndex = parsed.OBJfaces[range.endFaceIndex].indexStart;
+            return MaterialRange{ range.mtlName, startIndex, endIndex - startIndex };
+        };
+
+        // otherwise we use back_inserter, which is just as inefficient as repeated push_backs
+        results.materialRanges.resize(parsed.OBJMtlRanges.size());
+        std::transform(parsed.OBJMtlRanges.begin(), parsed.OBJMtlRanges.end(), results.materialRanges.begin(), transformMaterialRange);
+
+        auto transformPrimitiveGroup = [&](OBJgroup& objGroup)->PrimitiveGroup
+        {
+            uint32_t startIndex = parsed.OBJfaces[objGroup.startFaceIndex].indexStart;
+            uint32_t endIndex = parsed.OBJfaces[objGroup.endFaceIndex].indexStart;
+            return PrimitiveGroup{ objGroup.groupName, objGroup.startMtlIndex, objGroup.endMtlIndex - objGroup.startMtlIndex };
+        };
+
+        results.primitiveGroups.resize(parsed.groups.size());
+        std::transform(parsed.groups.begin(), parsed.groups.end(), results.primitiveGroups.begin(), transformPrimitiveGroup);
+
+    }
+
+    void ObjFileData::releaseData()
+    {
+        parsed.positions.clear();
+        parsed.positions.shrink_to_fit();
+        parsed.normals.clear();
+        parsed.normals.shrink_to_fit();
+        parsed.uvs.clear();
+        parsed.uvs.shrink_to_fit();
+        parsed.groups.clear();
+        parsed.groups.shrink_to_fit();
+        parsed.OBJverts.clear();
+        parsed.OBJverts.shrink_to_fit();
+        parsed.OBJfaces.clear();
+        parsed.OBJfaces.shrink_to_fit();
+        parsed.OBJMtlRanges.clear();
+        parsed.OBJMtlRanges.shrink_to_fit();
+    }
+
+}
+
+namespace
+{
+    template<size_t numVecElements>
+    auto extract_vector(const line_tokens_t& tokens, const size_t numTokens) -> std::array<float, numVecElements>
+    {
+        std::array<float, numVecElements> result;
+        for (size_t i = 0; i < numVecElements; ++i)
+        {
+            result[i] = 0.0f;
+            // We offset by 1, because the token at zero is the specifier for this line/row
+            if (i + 1 < numTokens)
+            {
+                const std::string_view& currToken = tokens[i + 1];
+                std::from_chars(currToken.data(), currToken.data() + currToken.size(), result[i]);
+            }
+        }
+        if constexpr (numVecElements == 2)
+        {
+            if (result[1] > 1.0f)
+            {
+                result[1] -= 1.0f;
+            }
+            if (result[0] > 1.0f)
+            {
+                result[0] -= 1.0f;
+            }
+            // extracting UVs: need to flip Y of uv
+            result[1] = 1.0f - result[1];
+        }
+        return result;
+    }
+}
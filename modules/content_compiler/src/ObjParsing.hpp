@@ -0,0 +1,107 @@
+#pragma once
+#ifndef CONTENT_COMPILER_OBJ_PARSING_HPP
+#define CONTENT_COMPILER_OBJ_PARSING_HPP
+#include "ModelDataImpl.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    Parsing of .obj text into ObjectModelDataImpl. Kept apart from ObjModel.cpp, which handles the files, caches
+    and logging around it, so the parser itself only needs foundation and can be built on its own by tests.
+*/
+namespace ObjLoader
+{
+    using vec3 = std::array<float, 3>;
+    using vec2 = std::array<float, 2>;
+
+    struct OBJgroup
+    {
+        std::string groupName;
+        uint32_t startFaceIndex{ 0u };
+        uint32_t endFaceIndex{ 0u };
+        uint32_t startMtlIndex{ 0u };
+        uint32_t endMtlIndex{ 0u };
+    };
+
+    struct OBJvertex
+    {
+        int32_t posIdx{ 0 };
+        int32_t normalIdx{ 0 };
+        int32_t uvIdx{ 0 };
+        bool operator==(const OBJvertex& other) const noexcept = default;
+    };
+
+    struct OBJface
+    {
+        uint32_t startVertexIdx{ 0 };
+        uint32_t endVertexIdx{ 0 };
+        uint32_t indexStart{ 0 };
+    };
+
+    struct OBJMtlRange
+    {
+        std::string mtlName;
+        // These indices are into the indices CONTAINER, not like the start literal index and the monotically increasing end index
+        uint32_t startFaceIndex;
+        uint32_t endFaceIndex;
+    };
+
+    // Everything read out of the file, in file order, before it's turned into vertices and indices
+    struct OBJparsedData
+    {
+        std::vector<vec3> positions;
+        std::vector<vec3> normals;
+        std::vector<vec2> uvs;
+        std::vector<OBJgroup> groups;
+        std::vector<OBJvertex> OBJverts;
+        std::vector<OBJface> OBJfaces;
+        std::vector<OBJMtlRange> OBJMtlRanges;
+    };
+
+    struct OBJChunk;
+
+    /*
+        Contains the data from the object file, but not the actual file itself. We effectively release that as soon as we can.
+    */
+    class ObjFileData
+    {
+    public:
+
+        ObjFileData();
+
+        ObjFileData(const ObjFileData&) = delete;
+        ObjFileData& operator=(const ObjFileData&) = delete;
+
+        // The text is split into chunks of about chunkSize bytes, parsed in parallel. 0 picks the size from the
+        // size of the text, and anything at least as long as the text parses it as a single chunk.
+        void ParseText(std::string_view text, const bool loadNormals, const size_t chunkSize = 0u);
+        const OBJparsedData& Parsed() const noexcept;
+        // Faces with no vertices at all: they're kept, but the file is probably broken
+        size_t EmptyFaceCount() const noexcept;
+        ObjectModelDataImpl RetrieveData(const bool loadNormals, const bool loadTangents);
+
+    private:
+
+        static void parseChunk(std::string_view chunkView, bool loadNormals, OBJChunk& chunk);
+        void mergeChunks(std::vector<OBJChunk>& chunks);
+        void beginMaterialRange(std::string_view name, const uint32_t faceIndex);
+        void beginGroup(std::string_view name, const uint32_t faceIndex);
+        void transferData(ObjectModelDataImpl& context, bool loadNormals, bool loadTangents);
+        void prepareMaterialsAndGroups(ObjectModelDataImpl& context);
+        void releaseData();
+
+        // All of this data is for the file-based representation of the mesh, so I'm putting it in here
+        OBJparsedData parsed;
+        size_t emptyFaces{ 0u };
+
+        // Unless told otherwise, files are split into roughly this much text per chunk, and no more than hardware_concurrency * 4 chunks
+        constexpr static size_t defaultChunkSize = 4u * 1024u * 1024u;
+    };
+
+}
+
+#endif //!CONTENT_COMPILER_OBJ_PARSING_HPP
@@ -65,4 +65,28 @@ namespace svutil
         // We assume tokens here are split by spaces
         return results;
     }
+
+    size_t separate_first_tokens(std::string_view view, const char delimiter, std::string_view* tokens, const size_t max_tokens)
+    {
+        size_t count = 0u;
+        while (!view.empty() && count < max_tokens)
+        {
+            size_t distanceToDelimiter = view.find_first_of(delimiter);
+            if (distanceToDelimiter != std::string::npos && distanceToDelimiter > 0)
+            {
+                tokens[count++] = view.substr(0, distanceToDelimiter);
+                view.remove_prefix(distanceToDelimiter + 1);
+            }
+            else if (distanceToDelimiter == 0)
+            {
+                view.remove_prefix(1);
+            }
+            else
+            {
+                tokens[count++] = view;
+                break;
+            }
+        }
+        return count;
+    }
 }
\ No newline at end of file
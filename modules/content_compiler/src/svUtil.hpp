@@ -10,6 +10,8 @@ namespace svutil
     std::string to_lowercase(std::string_view& view);
     auto get_line(std::string_view& view)->std::string_view;
     std::vector<std::string_view> separate_tokens_in_view(std::string_view view, const char delimiter);
+    // Same splitting as separate_tokens_in_view, but stops after max_tokens and doesn't allocate. Returns how many were written.
+    size_t separate_first_tokens(std::string_view view, const char delimiter, std::string_view* tokens, const size_t max_tokens);
 
 }
 
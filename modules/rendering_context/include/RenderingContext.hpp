@@ -102,7 +102,11 @@ public:
     static void SetShouldResize(const bool val);
     static bool ShouldResizeExchange(const bool val);
 
+    // With the profiler compiled in, an optional "ProfilerTraceFile" entry in the config names where
+    // Destroy() writes a Chrome trace of the most recent profiler events
     void Construct(const char* cfg_file_path);
+    // Once per frame: polls the window, recreates the swapchain if needed, advances the frame arenas
+    // (reactors::AdvanceFrame) and collects profiler events
     void Update();
     void Destroy();
 
@@ -158,6 +162,7 @@ private:
     uint32_t syncMode{ uint32_t(0u) };
     std::string syncModeStr;
     std::string shaderCacheDir;
+    std::string profilerTraceFile;
     PFN_vkSetDebugUtilsObjectNameEXT SetObjectNameFn{ nullptr };
     VkDebugUtilsMessengerEXT DebugUtilsMessenger{ VK_NULL_HANDLE };
     std::unique_ptr<::QueriedDeviceFeatures> queriedDeviceFeatures;
@@ -7,6 +7,8 @@
 #include "SurfaceKHR.hpp"
 #include "VkDebugUtils.hpp"
 #include "vkAssert.hpp"
+#include "reactors/AllocationReactor.hpp"
+#include "foundation/Profiler.hpp"
 #include <thread>
 #include <sstream>
 #include <chrono>
@@ -138,6 +140,20 @@ void RenderingContext::Construct(const char* file_path)
 
     nlohmann::json json_file;
     input_file >> json_file;
+
+    // Returns false if the application already set these up itself, which is fine
+    reactors::InitializeAllocationSubsystems();
+
+#ifdef FOUNDATION_PROFILER_ENABLED_CONF
+    FOUNDATION_PROFILE_THREAD_NAME("Main Thread");
+    // Rings for threads that record zones without naming themselves first (std::async tasks and the like)
+    foundation::ReserveProfilerThreadBuffers(4u);
+    auto trace_iter = json_file.find("ProfilerTraceFile");
+    if (trace_iter != json_file.end())
+    {
+        profilerTraceFile = trace_iter->get<std::string>();
+    }
+#endif
     
     vpr::VprExtensionPack extensionPack;
 
@@ -250,6 +266,13 @@ void RenderingContext::Construct(const char* file_path)
 
 void RenderingContext::Update()
 {
+    // Update() is the once-per-frame call every application makes, so it's our frame boundary:
+    // everything FrameAllocate()'d last frame is released here
+    reactors::AdvanceFrame();
+#ifdef FOUNDATION_PROFILER_ENABLED_CONF
+    // Drain every thread's profiler ring once a frame too, so they never fill up and drop events
+    foundation::CollectProfilerEvents();
+#endif
     window->Update();
     if (ShouldResizeExchange(false))
     {
@@ -259,6 +282,12 @@ void RenderingContext::Update()
 
 void RenderingContext::Destroy()
 {
+#ifdef FOUNDATION_PROFILER_ENABLED_CONF
+    if (!profilerTraceFile.empty() && !foundation::WriteProfilerChromeTrace(profilerTraceFile.c_str()))
+    {
+        std::cerr << "Couldn't write profiler trace to " << profilerTraceFile << "\n";
+    }
+#endif
     swapchain.reset();
     windowSurface.reset();
     if constexpr (RENDERING_CONTEXT_VALIDATION_ENABLED)
@@ -271,6 +300,7 @@ void RenderingContext::Destroy()
     window.reset();
     queriedDeviceFeatures.reset();
     enabledDeviceFeatures.reset();
+    reactors::ResetAllocationSubsystems();
 }
 
 vpr::Instance * RenderingContext::Instance() noexcept
@@ -47,6 +47,38 @@ public:
         resource_creation_flags flags = 0,
         void* userData = nullptr);
 
+    // Thread safe, and unlike everything else here it completes immediately: the memory is ready to write
+    // to once this returns.
+    [[nodiscard]] gpu_staging_reservation_t ReserveStaging(size_t size);
+    // For reservations that end up not being uploaded after all
+    void ReleaseStaging(gpu_staging_reservation_t& staging);
+
+    // Same as CreateBuffer()/CreateImage() with initial data, except each region's Data points into
+    // staging (already written) instead of being copied: the upload is recorded straight from the
+    // reservation, which is consumed and freed once the transfer completes. Meant to be called from
+    // ResourceLoader factories, so decoded assets go from the loader worker to the GPU directly.
+    // Every region must lie entirely within staging: if one doesn't, or staging was already used or
+    // released, the reply fails straight away and the reservation is released.
+    [[nodiscard]] std::shared_ptr<GraphicsResourceReply> CreateBufferFromStaging(
+        const VkBufferCreateInfo& createInfo,
+        const VkBufferViewCreateInfo* viewCreateInfo,
+        gpu_staging_reservation_t&& staging,
+        const gpu_resource_data_t* regions,
+        size_t numRegions,
+        resource_usage resourceUsage = resource_usage::GPUOnly,
+        resource_creation_flags flags = 0,
+        void* userData = nullptr);
+
+    [[nodiscard]] std::shared_ptr<GraphicsResourceReply> CreateImageFromStaging(
+        const VkImageCreateInfo& createInfo,
+        const VkImageViewCreateInfo* viewCreateInfo,
+        gpu_staging_reservation_t&& staging,
+        const gpu_image_resource_data_t* regions,
+        size_t numRegions,
+        resource_usage resourceUsage = resource_usage::GPUOnly,
+        resource_creation_flags flags = 0,
+        void* userData = nullptr);
+
     [[nodiscard]] std::shared_ptr<GraphicsResourceReply> CreateSampler(
         const VkSamplerCreateInfo& createInfo,
         void* userData = nullptr);
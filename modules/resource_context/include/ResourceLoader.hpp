@@ -1,22 +1,40 @@
 #pragma once
 #ifndef VPSK_RESOURCE_LOADER_HPP
 #define VPSK_RESOURCE_LOADER_HPP
-#include <array>
+#include <atomic>
+#include <cstddef>
 #include <memory>
 #include <thread>
 #include <condition_variable>
 #include <future>
-#include <list>
 #include <mutex>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <functional>
+#include <span>
 #include <vector>
+#include "containers/flat_hash_map.hpp"
+#include "containers/indexedPriorityQueue.hpp"
 
 using FactoryFunctor = void*(*)(const char* fname, void* user_data);
+// data is the whole file, memory-mapped (or read, when batching) by the loader and only valid until the factory returns
+using SpanFactoryFunctor = void*(*)(const char* fname, std::span<const std::byte> data, void* user_data);
 using DeleteFunctor = void(*)(void* obj_instance, void* user_data);
 using SignalFunctor = void(*)(void* state, void* data, void* user_data);
+using LoadRequestID = uint64_t;
+
+class BatchFileReader;
+
+// Shared between the requester and the queued load. Default-constructed tokens can never be cancelled.
+class LoadCancellationToken
+{
+public:
+    static LoadCancellationToken Create();
+    void Cancel() noexcept;
+    bool IsCancelled() const noexcept;
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled;
+};
 
 class ResourceLoader {
     ResourceLoader(const ResourceLoader&) = delete;
@@ -26,14 +44,38 @@ class ResourceLoader {
 public:
 
     void Subscribe(const char* file_type, FactoryFunctor func, DeleteFunctor del_fn);
+    // Prefer this for anything that parses file contents: the loader maps the file once and parsers work straight out of the page cache
+    void Subscribe(const char* file_type, SpanFactoryFunctor func, DeleteFunctor del_fn);
     void Unsubscribe(const char* file_type);
-    void Load(const char* file_type, const char* file_path, void* requester, SignalFunctor signal, void* user_data = nullptr);
-    void Load(const char* file_type, const char* file_name, const char* search_dir, void* requester, SignalFunctor signal, void* user_data = nullptr);
+
+    // Higher priorities are loaded first, equal priorities in request order. Priorities derived from
+    // distance or screen coverage land between PrioritySpeculative and PriorityNormal, so explicit
+    // requests still beat streaming, and PriorityImmediate beats everything.
+    static constexpr float PrioritySpeculative = 0.0f;
+    static constexpr float PriorityNormal = 1.0f;
+    static constexpr float PriorityImmediate = 2.0f;
+    static float PriorityFromDistance(const float distance) noexcept;
+    // coverage is the fraction of the screen the asset's bounds cover, in [0, 1]
+    static float PriorityFromScreenCoverage(const float coverage) noexcept;
+
+    // Returned ID can be passed to Reprioritize(). Resources are identified by file type plus the path or
+    // name as given. Requests for one that is already in flight join that load, so each file is loaded
+    // once however many ask for it: they raise its priority if theirs is higher, get the same data, and
+    // return its ID (or 0 if a worker already has it). Every request that gets signalled holds a
+    // reference, released by Unload(). Cancelled requests are not signalled and hold no reference, and
+    // a load is only skipped once everything waiting on it has been cancelled.
+    LoadRequestID Load(const char* file_type, const char* file_path, void* requester, SignalFunctor signal, void* user_data = nullptr,
+        float priority = PriorityNormal, LoadCancellationToken cancel_token = LoadCancellationToken());
+    LoadRequestID Load(const char* file_type, const char* file_name, const char* search_dir, void* requester, SignalFunctor signal, void* user_data = nullptr,
+        float priority = PriorityNormal, LoadCancellationToken cancel_token = LoadCancellationToken());
+    // Returns false if the request has already been picked up by a worker (or never existed)
+    bool Reprioritize(LoadRequestID request_id, float priority);
+    // Drops one reference: the data is deleted once the last holder unloads it
     void Unload(const char* file_type, const char* path);
 
     void Start();
     void Stop();
-    // Runs a while loop waiting for all loads to succeed, by running a while loop until queue empties
+    // Blocks until the queue is empty and no worker is mid-load (or holding a read-but-unparsed file)
     void WaitForAllLoads();
 
     static ResourceLoader& GetResourceLoader();
@@ -48,17 +90,33 @@ private:
         AlreadyLoaded = 2
     };
 
-    struct ResourceData
+    // The hash (FastHash of the type, chained into the name's) is only a shortcut: equality still compares the strings, so colliding names stay distinct
+    struct resourceKey
     {
-        uint64_t FileNameHash;
-        void* Data;
+        uint64_t Hash{ 0u };
         std::string FileType;
         std::string FileName;
+        bool operator==(const resourceKey& other) const noexcept;
+    };
+
+    struct resourceKeyHash
+    {
+        size_t operator()(const resourceKey& key) const noexcept;
+    };
+
+    static resourceKey makeResourceKey(const char* file_type, const char* file_name);
+
+    struct ResourceData
+    {
+        resourceKey Key;
+        void* Data;
         std::string SearchDir;
         std::string AbsoluteFilePath;
         size_t RefCount{ 0 };
     };
 
+    using resource_map = foundation::flat_hash_map<resourceKey, ResourceData, resourceKeyHash>;
+
     struct loadRequest
     {
         loadRequest(ResourceData dest) : destinationData(dest), requester(nullptr) {}
@@ -67,23 +125,90 @@ private:
         void* requester; // state pointer of requesting object, if given
         void* userData; // may contain additional parameters passed to factory function
         SignalFunctor signal;
+        LoadCancellationToken cancelToken;
+    };
+
+    // Exactly one of these is set, depending on which Subscribe() overload was used
+    struct factoryFunctions
+    {
+        FactoryFunctor pathFactory{ nullptr };
+        SpanFactoryFunctor spanFactory{ nullptr };
+    };
+
+    struct pendingListener
+    {
+        void* requester;
+        SignalFunctor signal;
+        void* userData;
+        LoadCancellationToken cancelToken;
+    };
+
+    // A signal owed to a requester, collected under pendingDataMutex and sent once it's released
+    struct pendingSignal
+    {
+        SignalFunctor signal;
+        void* requester;
+        void* data;
+        void* userData;
+    };
+
+    // A FreshLoad that has been queued but not yet finished, and everyone who joined it since
+    struct pendingLoad
+    {
+        LoadRequestID requestID{ 0u };
+        std::vector<pendingListener> listeners;
+    };
+
+    // A FreshLoad whose file a batch has already read, waiting for a worker to run its factory
+    struct readyLoad
+    {
+        loadRequest request;
+        std::vector<std::byte> fileData;
+        // false if the batched read failed: the factory then goes through the mapped path, which reports the error
+        bool hasFileData;
     };
 
     void workerFunction();
     void waitForPendingRequest(const std::string& absolute_file_path, SignalFunctor signal);
+    // Joins the pending load for the same resource if there is one, otherwise queues request. Deciding
+    // which happens under one lock, so two simultaneous requests for a file can't both queue a FreshLoad.
+    LoadRequestID enqueueRequest(loadRequest&& request, const float priority);
+    // Requires pendingDataMutex. Deletes the resource once nothing references it anymore.
+    void releaseResource(resource_map::iterator iter);
+    // If request and every listener that joined it were cancelled, forgets the pending load and returns true
+    bool dropIfCancelled(const loadRequest& request);
+    // Fills in AbsoluteFilePath, searching for the file if need be. Throws if it can't be found.
+    void resolveFilePath(loadRequest& request);
+    // Reads every file in batch at once, queueing each into readyLoads as soon as it arrives
+    void readBatch(BatchFileReader& reader, std::vector<loadRequest>& batch, const std::vector<float>& priorities);
+    // Call once per request popped from requests, when it's finished with (or dropped)
+    void finishLoad();
+    void processRequest(loadRequest&& request, factoryFunctions factory_fns, const std::vector<std::byte>* file_data = nullptr);
+    void* invokeFactory(const factoryFunctions& factory_fns, const char* path, void* user_data, const std::vector<std::byte>* file_data);
 
-    std::unordered_map<std::string, FactoryFunctor> factories;
+    std::unordered_map<std::string, factoryFunctions> factories;
     std::unordered_map<std::string, DeleteFunctor> deleters;
-    std::unordered_map<uint64_t, ResourceData> resources;
-    std::unordered_set<uint64_t> pendingResources;
-    std::unordered_map<uint64_t, std::vector<std::pair<void*, void*>>> pendingResourceListeners;
-    std::list<loadRequest> requests;
+    // resources and pendingLoads are both guarded by pendingDataMutex. A key is in at most one of them.
+    // Both are flat tables, so no reference to an entry is held across an insertion into the same table
+    resource_map resources;
+    foundation::flat_hash_map<resourceKey, pendingLoad, resourceKeyHash> pendingLoads;
+    indexedPriorityQueue<loadRequest> requests;
+    // Served before requests, so read files don't sit in memory while new reads are started
+    indexedPriorityQueue<readyLoad> readyLoads;
+    // Requests popped from requests and not yet finished, including those sitting in readyLoads
+    size_t activeLoads{ 0u };
     std::recursive_mutex queueMutex;
     std::recursive_mutex pendingDataMutex;
     std::mutex subscribeMutex;
     std::condition_variable_any cVar;
+    std::condition_variable_any idleCVar;
     std::atomic<bool> shutdown{ false };
-    std::array<std::thread, 2> workers;
+    // hardware_concurrency / 2, clamped to [2, 8]: loads are mostly waiting on disk, and the factories share the CPU with the render/transfer threads
+    std::vector<std::thread> workers;
+    // With io_uring, a worker that pops a span-factory FreshLoad keeps taking them from the front of the
+    // queue, up to this many, and reads them all at once instead of one blocking read per worker
+    static constexpr size_t maxBatchSize = 32u;
+    static constexpr uint32_t batchQueueDepth = 64u;
 };
 
 #endif //!VPSK_RESOURCE_LOADER_HPP
@@ -86,6 +86,16 @@ struct gpu_image_resource_data_t
     queue_family_flags DestinationQueueFamily{ 0x0 };
 };
 
+// Host-visible staging memory reserved through ResourceContext::ReserveStaging(). Write the data into it
+// from any thread, then pass it to CreateBufferFromStaging()/CreateImageFromStaging() to upload it without
+// any further host copies. Handle identifies the reservation, Data and Size are where to write it.
+struct gpu_staging_reservation_t
+{
+    void* Data{ nullptr };
+    size_t Size{ 0u };
+    uint64_t Handle{ 0u };
+};
+
 struct GraphicsResource
 {
     GraphicsResource() noexcept;
@@ -5,7 +5,7 @@
 #include "../src/ResourceMessageTypesInternal.hpp"
 #include "ResourceMessageReply.hpp"
 #include "containers/mwsrQueue.hpp"
-#include "threading/ExponentialBackoffSleeper.hpp"
+#include "threading/HybridWaiter.hpp"
 
 #include <chrono>
 #include <memory>
@@ -56,6 +56,12 @@ private:
         TransferCommand(
             const vpr::Device* _device,
             std::shared_ptr<ResourceTransferReply>&& _reply);
+
+        // uploads from a staging reservation the user already filled, instead of allocating our own
+        TransferCommand(
+            const vpr::Device* _device,
+            std::shared_ptr<UploadBuffer>&& _staging,
+            std::shared_ptr<ResourceTransferReply>&& _reply);
         
         ~TransferCommand();
 
@@ -77,7 +83,8 @@ private:
         VmaAllocator allocatorHandle;
         std::shared_ptr<ResourceTransferReply> reply;
         std::unique_ptr<vpr::CommandPool> commandPool;
-        std::unique_ptr<UploadBuffer> uploadBuffer;
+        // shared because staging reservations arrive that way, never actually shared once we have it
+        std::shared_ptr<UploadBuffer> uploadBuffer;
     };
 
     // worker thread job, pops messages from the queue and processes them
@@ -133,6 +140,9 @@ private:
     VmaAllocator allocatorHandle;
     std::thread workerThread;
     std::atomic<bool> shouldExitWorker;
+    // Transfers gate uploads the renderer is waiting on, so keep wake latency in the tens of microseconds
+    foundation::HybridWaiter workWaiter{ foundation::HybridWaiterConfig{
+        std::chrono::microseconds(50), std::chrono::microseconds(50), std::chrono::microseconds(4000), 1.5f } };
     // since we may spawn multiple instances of this system, we need to know which queue to submit
     // since splitting up work across queues is part of the benefit of multiple instances! :)
     uint32_t transferQueueIndex;
@@ -0,0 +1,564 @@
+#include "AssetPathIndex.hpp"
+#include "threading/epoch_reclamation.hpp"
+#include "foundation/Profiler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <execution>
+#include <numeric>
+#ifdef __linux__
+#include <cerrno>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+    namespace stdfs = std::filesystem;
+
+    constexpr std::chrono::seconds minRescanInterval{ 1 };
+
+    struct index_registry_node
+    {
+        AssetPathIndex* index;
+        std::string root;
+        const index_registry_node* next;
+    };
+
+    // Pushed to under registryMutex, read without it. Nodes are never removed.
+    std::atomic<const index_registry_node*> registryHead{ nullptr };
+    std::mutex registryMutex;
+
+    const AssetPathIndex* findRegisteredIndex(const std::string& root) noexcept
+    {
+        for (const index_registry_node* node = registryHead.load(std::memory_order_acquire); node != nullptr; node = node->next)
+        {
+            if (node->root == root)
+            {
+                return node->index;
+            }
+        }
+        return nullptr;
+    }
+
+    bool startsWith(const std::string& str, const std::string& prefix) noexcept
+    {
+        return str.size() >= prefix.size() && std::equal(prefix.cbegin(), prefix.cend(), str.cbegin());
+    }
+
+    std::string directoryPrefix(const stdfs::path& dir)
+    {
+        std::string prefix = dir.string();
+        if (prefix.empty() || prefix.back() != stdfs::path::preferred_separator)
+        {
+            prefix += static_cast<char>(stdfs::path::preferred_separator);
+        }
+        return prefix;
+    }
+
+}
+
+AssetPathIndex& AssetPathIndex::ForRoot(const std::filesystem::path& root)
+{
+    const std::string root_str = root.string();
+    if (const AssetPathIndex* index = findRegisteredIndex(root_str); index != nullptr)
+    {
+        return *const_cast<AssetPathIndex*>(index);
+    }
+
+    std::lock_guard registryGuard(registryMutex);
+    if (const AssetPathIndex* index = findRegisteredIndex(root_str); index != nullptr)
+    {
+        return *const_cast<AssetPathIndex*>(index);
+    }
+
+    AssetPathIndex* new_index = new AssetPathIndex(root);
+    registryHead.store(new index_registry_node{ new_index, root_str, registryHead.load(std::memory_order_relaxed) }, std::memory_order_release);
+    return *new_index;
+}
+
+AssetPathIndex::AssetPathIndex(std::filesystem::path _root) : root(std::move(_root))
+{
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_CLOEXEC);
+    watching.store(inotifyFd != -1, std::memory_order_relaxed);
+#endif
+
+    {
+        std::lock_guard writerGuard(writerMutex);
+        rebuild();
+    }
+
+#ifdef __linux__
+    if (inotifyFd != -1)
+    {
+        // runs until exit, like the index itself
+        watcherThread = std::thread(&AssetPathIndex::watcherLoop, this);
+    }
+#endif
+}
+
+std::string AssetPathIndex::Find(std::string_view file_name, const std::filesystem::path& preferred_dir)
+{
+    const std::string key = makeKey(stdfs::path(file_name).filename().string());
+    const std::string preferred_prefix = directoryPrefix(preferred_dir);
+    std::string result;
+
+    {
+        foundation::epoch_guard guard;
+        if (findIn(*current.load(std::memory_order_acquire), key, preferred_prefix, result))
+        {
+            return result;
+        }
+    }
+
+    const bool is_watching = watching.load(std::memory_order_relaxed);
+    if (is_watching && !hasUnwatchedDirs.load(std::memory_order_relaxed))
+    {
+        // index is being kept current, so a miss really is a miss
+        return result;
+    }
+
+    std::lock_guard writerGuard(writerMutex);
+    if (std::chrono::steady_clock::now() - lastRescan >= minRescanInterval)
+    {
+        if (is_watching)
+        {
+            rescanUnwatchedDirs();
+        }
+        else
+        {
+            rebuild();
+        }
+    }
+
+    foundation::epoch_guard guard;
+    findIn(*current.load(std::memory_order_acquire), key, preferred_prefix, result);
+    return result;
+}
+
+const std::filesystem::path& AssetPathIndex::Root() const noexcept
+{
+    return root;
+}
+
+size_t AssetPathIndex::FileCount() const
+{
+    foundation::epoch_guard guard;
+    return current.load(std::memory_order_acquire)->fileCount;
+}
+
+std::string AssetPathIndex::makeKey(std::string_view file_name)
+{
+    std::string key(file_name);
+    std::transform(key.begin(), key.end(), key.begin(), [](const char c)
+    {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    return key;
+}
+
+void AssetPathIndex::addPath(snapshot& index, const std::string& path)
+{
+    std::vector<std::string>& bucket = index.paths[makeKey(stdfs::path(path).filename().string())];
+    // buckets are kept sorted, so which duplicate wins doesn't depend on scan order
+    auto iter = std::lower_bound(bucket.begin(), bucket.end(), path);
+    if (iter == bucket.end() || *iter != path)
+    {
+        bucket.insert(iter, path);
+        ++index.fileCount;
+    }
+}
+
+void AssetPathIndex::removePath(snapshot& index, const std::string& path)
+{
+    auto bucket_iter = index.paths.find(makeKey(stdfs::path(path).filename().string()));
+    if (bucket_iter == index.paths.end())
+    {
+        return;
+    }
+
+    std::vector<std::string>& bucket = bucket_iter->second;
+    auto iter = std::lower_bound(bucket.begin(), bucket.end(), path);
+    if (iter != bucket.end() && *iter == path)
+    {
+        bucket.erase(iter);
+        --index.fileCount;
+    }
+
+    if (bucket.empty())
+    {
+        index.paths.erase(bucket_iter);
+    }
+}
+
+void AssetPathIndex::removeDirectory(snapshot& index, const std::string& dir_path)
+{
+    const std::string prefix = directoryPrefix(dir_path);
+    std::vector<std::string> emptied_keys;
+    for (auto& [key, bucket] : index.paths)
+    {
+        const size_t previous_size = bucket.size();
+        std::erase_if(bucket, [&prefix](const std::string& path) { return startsWith(path, prefix); });
+        index.fileCount -= previous_size - bucket.size();
+        if (bucket.empty())
+        {
+            emptied_keys.emplace_back(key);
+        }
+    }
+
+    for (const std::string& key : emptied_keys)
+    {
+        index.paths.erase(key);
+    }
+}
+
+bool AssetPathIndex::findIn(const snapshot& index, const std::string& key, const std::string& preferred_prefix, std::string& result) const
+{
+    auto iter = index.paths.find(key);
+    if (iter == index.paths.end() || iter->second.empty())
+    {
+        return false;
+    }
+
+    const std::vector<std::string>& bucket = iter->second;
+    auto preferred = std::find_if(bucket.cbegin(), bucket.cend(), [&preferred_prefix](const std::string& path)
+    {
+        return startsWith(path, preferred_prefix);
+    });
+    result = preferred != bucket.cend() ? *preferred : bucket.front();
+    return true;
+}
+
+void AssetPathIndex::scanDirectory(const std::filesystem::path& dir, snapshot& index, std::vector<std::string>* dirs_out)
+{
+    std::error_code ec;
+    stdfs::recursive_directory_iterator iter(dir, stdfs::directory_options::skip_permission_denied, ec);
+    if (ec)
+    {
+        return;
+    }
+
+    if (dirs_out != nullptr)
+    {
+        dirs_out->emplace_back(dir.string());
+    }
+
+    for (const stdfs::recursive_directory_iterator end; iter != end; iter.increment(ec))
+    {
+        if (ec)
+        {
+            // unreadable entry: skip it, keep going with its siblings
+            ec.clear();
+            continue;
+        }
+
+        const stdfs::directory_entry& entry = *iter;
+        if (entry.is_directory(ec))
+        {
+            if (dirs_out != nullptr)
+            {
+                dirs_out->emplace_back(entry.path().string());
+            }
+        }
+        else if (entry.is_regular_file(ec))
+        {
+            addPath(index, entry.path().string());
+        }
+    }
+}
+
+void AssetPathIndex::rebuild()
+{
+    FOUNDATION_PROFILE_ZONE("AssetPathIndex::Rebuild");
+
+    snapshot* new_index = new snapshot();
+    std::vector<std::string> dirs{ root.string() };
+    std::vector<stdfs::path> top_level_dirs;
+
+    std::error_code ec;
+    for (stdfs::directory_iterator iter(root, stdfs::directory_options::skip_permission_denied, ec), end; !ec && iter != end; iter.increment(ec))
+    {
+        if (iter->is_directory(ec))
+        {
+            top_level_dirs.emplace_back(iter->path());
+        }
+        else if (iter->is_regular_file(ec))
+        {
+            addPath(*new_index, iter->path().string());
+        }
+    }
+
+    // Asset trees are usually a handful of large top-level folders (models, textures, shaders...), which scan independently
+    std::vector<snapshot> partial_indices(top_level_dirs.size());
+    std::vector<std::vector<std::string>> partial_dirs(top_level_dirs.size());
+    std::vector<size_t> scan_order(top_level_dirs.size());
+    std::iota(scan_order.begin(), scan_order.end(), size_t(0));
+    std::for_each(std::execution::par, scan_order.begin(), scan_order.end(), [&](const size_t i)
+    {
+        scanDirectory(top_level_dirs[i], partial_indices[i], &partial_dirs[i]);
+    });
+
+    for (size_t i = 0u; i < partial_indices.size(); ++i)
+    {
+        for (const auto& [key, bucket] : partial_indices[i].paths)
+        {
+            for (const std::string& path : bucket)
+            {
+                addPath(*new_index, path);
+            }
+        }
+        dirs.insert(dirs.end(), std::make_move_iterator(partial_dirs[i].begin()), std::make_move_iterator(partial_dirs[i].end()));
+    }
+
+#ifdef __linux__
+    if (inotifyFd != -1)
+    {
+        // every directory gets another try, so start from a clean slate
+        unwatchedDirs.clear();
+        hasUnwatchedDirs.store(false, std::memory_order_relaxed);
+        // re-adding an existing watch just returns its descriptor again
+        for (const std::string& dir : dirs)
+        {
+            addWatch(dir);
+        }
+    }
+#endif
+
+    lastRescan = std::chrono::steady_clock::now();
+    publish(new_index);
+}
+
+void AssetPathIndex::publish(snapshot* new_index)
+{
+    const snapshot* previous = current.exchange(new_index, std::memory_order_acq_rel);
+    if (previous != nullptr)
+    {
+        foundation::Retire(const_cast<snapshot*>(previous));
+        // snapshots can be large, don't let them pile up waiting for a full retire batch
+        foundation::ReclaimRetired();
+    }
+}
+
+#ifdef __linux__
+
+void AssetPathIndex::addWatch(const std::string& dir)
+{
+    constexpr uint32_t watch_mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+    const int wd = inotify_add_watch(inotifyFd, dir.c_str(), watch_mask);
+    if (wd == -1)
+    {
+        // already gone (or replaced by a file): there's nothing under it to miss
+        if (errno != ENOENT && errno != ENOTDIR && std::find(unwatchedDirs.cbegin(), unwatchedDirs.cend(), dir) == unwatchedDirs.cend())
+        {
+            // most likely out of watches (fs.inotify.max_user_watches): just this directory falls back to rescanning on misses
+            unwatchedDirs.emplace_back(dir);
+            hasUnwatchedDirs.store(true, std::memory_order_relaxed);
+        }
+        return;
+    }
+    watchedDirs[wd] = dir;
+}
+
+void AssetPathIndex::rescanUnwatchedDirs()
+{
+    FOUNDATION_PROFILE_ZONE("AssetPathIndex::RescanUnwatchedDirs");
+
+    std::vector<std::string> dirs = std::move(unwatchedDirs);
+    unwatchedDirs.clear();
+    hasUnwatchedDirs.store(false, std::memory_order_relaxed);
+    // sorted, a directory comes right before anything under it, which its own rescan covers
+    std::sort(dirs.begin(), dirs.end());
+
+    snapshot* updated = new snapshot(*current.load(std::memory_order_acquire));
+    std::string covered_prefix;
+    for (const std::string& dir : dirs)
+    {
+        if (!covered_prefix.empty() && startsWith(dir, covered_prefix))
+        {
+            continue;
+        }
+        covered_prefix = directoryPrefix(dir);
+        // anything could have changed while it wasn't watched, so list it afresh. Failing again puts it back in unwatchedDirs.
+        removeDirectory(*updated, dir);
+        watchNewDirectory(dir, *updated);
+    }
+
+    lastRescan = std::chrono::steady_clock::now();
+    publish(updated);
+}
+
+void AssetPathIndex::watchNewDirectory(const std::string& dir, snapshot& index)
+{
+    // Scanning first would miss anything created in a directory between it being listed and watched. Watching
+    // first can report a file the listing also found, which addPath() ignores.
+    std::vector<std::string> pending_dirs{ dir };
+    while (!pending_dirs.empty())
+    {
+        const std::string next_dir = std::move(pending_dirs.back());
+        pending_dirs.pop_back();
+        addWatch(next_dir);
+
+        std::error_code ec;
+        for (stdfs::directory_iterator iter(next_dir, stdfs::directory_options::skip_permission_denied, ec), end; !ec && iter != end; iter.increment(ec))
+        {
+            if (iter->is_directory(ec))
+            {
+                pending_dirs.emplace_back(iter->path().string());
+            }
+            else if (iter->is_regular_file(ec))
+            {
+                addPath(index, iter->path().string());
+            }
+        }
+    }
+}
+
+void AssetPathIndex::watcherLoop()
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+    // a descriptor that keeps failing won't be fixed by another one
+    constexpr uint32_t maxWatcherRestarts = 3u;
+    uint32_t watcherRestarts = 0u;
+
+    while (true)
+    {
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            if (length == -1 && errno == EINTR)
+            {
+                continue;
+            }
+
+            // Events have been lost, and the descriptor is no use any more: start over with a new one, which
+            // rebuild() re-adds every watch to. Misses rescan the whole root in the meantime.
+            std::lock_guard writerGuard(writerMutex);
+            watching.store(false, std::memory_order_relaxed);
+            close(inotifyFd);
+            watchedDirs.clear();
+            inotifyFd = ++watcherRestarts <= maxWatcherRestarts ? inotify_init1(IN_CLOEXEC) : -1;
+            if (inotifyFd == -1)
+            {
+                return;
+            }
+            rebuild();
+            watching.store(true, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::lock_guard writerGuard(writerMutex);
+        // copy-on-write: readers keep using the current snapshot until the new one is published
+        snapshot* updated = new snapshot(*current.load(std::memory_order_acquire));
+        bool needs_rescan = false;
+
+        while (length > 0)
+        {
+            for (const char* ptr = buffer; ptr < buffer + length; )
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    needs_rescan = true;
+                    continue;
+                }
+
+                auto dir_iter = watchedDirs.find(event->wd);
+                if (dir_iter == watchedDirs.end())
+                {
+                    continue;
+                }
+
+                if (event->mask & IN_IGNORED)
+                {
+                    watchedDirs.erase(dir_iter);
+                    continue;
+                }
+
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                const std::string path = dir_iter->second + '/' + event->name;
+                const bool added = (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0;
+                if (event->mask & IN_ISDIR)
+                {
+                    if (added)
+                    {
+                        watchNewDirectory(path, *updated);
+                    }
+                    else
+                    {
+                        removeDirectory(*updated, path);
+                        // moved-away directories keep their watches, which would now report stale paths
+                        const std::string prefix = directoryPrefix(path);
+                        std::erase_if(unwatchedDirs, [&](const std::string& unwatched)
+                        {
+                            return unwatched == path || startsWith(unwatched, prefix);
+                        });
+                        hasUnwatchedDirs.store(!unwatchedDirs.empty(), std::memory_order_relaxed);
+                        std::erase_if(watchedDirs, [&](const auto& watched)
+                        {
+                            if (watched.second == path || startsWith(watched.second, prefix))
+                            {
+                                inotify_rm_watch(inotifyFd, watched.first);
+                                return true;
+                            }
+                            return false;
+                        });
+                    }
+                }
+                else if (added)
+                {
+                    addPath(*updated, path);
+                }
+                else
+                {
+                    removePath(*updated, path);
+                }
+            }
+
+            // batch whatever else is already queued into this same snapshot
+            int pending_bytes = 0;
+            if (ioctl(inotifyFd, FIONREAD, &pending_bytes) == -1 || pending_bytes <= 0)
+            {
+                break;
+            }
+            length = read(inotifyFd, buffer, sizeof(buffer));
+        }
+
+        if (needs_rescan)
+        {
+            delete updated;
+            rebuild();
+        }
+        else
+        {
+            publish(updated);
+        }
+    }
+}
+
+#else
+
+void AssetPathIndex::addWatch(const std::string&)
+{
+}
+
+void AssetPathIndex::watchNewDirectory(const std::string&, snapshot&)
+{
+}
+
+void AssetPathIndex::rescanUnwatchedDirs()
+{
+}
+
+void AssetPathIndex::watcherLoop()
+{
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+#ifndef RESOURCE_CONTEXT_ASSET_PATH_INDEX_HPP
+#define RESOURCE_CONTEXT_ASSET_PATH_INDEX_HPP
+#include "containers/flat_hash_map.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Maps lower-cased file names to every path under a search root with that name, so resolving a bare
+    file name is one hash lookup instead of a directory walk. Built with a parallel scan (one task per
+    top-level directory) the first time a root is searched.
+
+    Readers never lock: the current index is an immutable snapshot, read inside an epoch_guard. Writers
+    build a modified copy and swap it in, retiring the old one. On Linux an inotify watcher keeps the
+    index current as files come and go, batching whatever events are pending into one new snapshot.
+    Elsewhere (or if inotify can't be set up) a miss rescans the root, at most once a second. Directories
+    that couldn't be watched (usually from running out of watches) are remembered instead: a miss retries
+    watching just those and rescans them, on the same schedule.
+
+    Indices are created on first use per root and live until exit, since loader worker threads may be
+    mid-lookup during static destruction.
+*/
+class AssetPathIndex
+{
+public:
+
+    // Returns the index for root, creating and scanning it if this is the first request for it
+    static AssetPathIndex& ForRoot(const std::filesystem::path& root);
+
+    AssetPathIndex(const AssetPathIndex&) = delete;
+    AssetPathIndex& operator=(const AssetPathIndex&) = delete;
+
+    // Case-insensitive match on file_name's basename. If several files share the name, ones under
+    // preferred_dir win, then the lexicographically first path. Empty if nothing matches.
+    std::string Find(std::string_view file_name, const std::filesystem::path& preferred_dir);
+    const std::filesystem::path& Root() const noexcept;
+    size_t FileCount() const;
+
+private:
+
+    explicit AssetPathIndex(std::filesystem::path root);
+
+    using path_map = foundation::flat_hash_map<std::string, std::vector<std::string>>;
+
+    struct snapshot
+    {
+        path_map paths;
+        size_t fileCount{ 0u };
+    };
+
+    static std::string makeKey(std::string_view file_name);
+    static void addPath(snapshot& index, const std::string& path);
+    static void removePath(snapshot& index, const std::string& path);
+    static void removeDirectory(snapshot& index, const std::string& dir_path);
+
+    bool findIn(const snapshot& index, const std::string& key, const std::string& preferred_prefix, std::string& result) const;
+    // Scans root (or a subdirectory of it) into index. Directories found are appended to dirs_out, for the watcher.
+    static void scanDirectory(const std::filesystem::path& dir, snapshot& index, std::vector<std::string>* dirs_out);
+    // Both require writerMutex to be held
+    void rebuild();
+    void publish(snapshot* new_index);
+
+    void addWatch(const std::string& dir);
+    // Watches dir and everything under it, each directory before it's listed, and adds its files to index
+    void watchNewDirectory(const std::string& dir, snapshot& index);
+    // Retries watching the directories addWatch() failed on, and rescans them. Requires writerMutex.
+    void rescanUnwatchedDirs();
+    void watcherLoop();
+
+    const std::filesystem::path root;
+    std::atomic<const snapshot*> current{ nullptr };
+    // Serializes writers (watcher, rescans) against each other, never taken by Find() on a hit
+    std::mutex writerMutex;
+    std::atomic<bool> watching{ false };
+    // Set while some directories aren't being watched, so misses under them might be stale
+    std::atomic<bool> hasUnwatchedDirs{ false };
+    std::chrono::steady_clock::time_point lastRescan;
+#ifdef __linux__
+    int inotifyFd{ -1 };
+    std::unordered_map<int, std::string> watchedDirs;
+    std::vector<std::string> unwatchedDirs;
+    std::thread watcherThread;
+#endif
+};
+
+#endif //!RESOURCE_CONTEXT_ASSET_PATH_INDEX_HPP
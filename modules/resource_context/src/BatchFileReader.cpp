@@ -0,0 +1,543 @@
+#include "BatchFileReader.hpp"
+#include "foundation/Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <thread>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+
+    // READ takes a 32 bit length: bigger files just take a few reads
+    constexpr size_t maxReadChunk = size_t(1) << 30u;
+
+#ifndef _WIN32
+    int readUntilEnd(const int fd, std::vector<std::byte>& data)
+    {
+        constexpr size_t chunk_size = 64u * 1024u;
+        size_t offset = 0u;
+        for (;;)
+        {
+            data.resize(offset + chunk_size);
+            const ssize_t result = read(fd, data.data() + offset, chunk_size);
+            if (result == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (result <= 0)
+            {
+                data.resize(offset);
+                return result == 0 ? 0 : errno;
+            }
+            offset += static_cast<size_t>(result);
+        }
+    }
+
+    // errno on failure
+    int readWholeFile(const char* path, std::vector<std::byte>& data)
+    {
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            return errno;
+        }
+
+        struct stat file_stat{};
+        if (fstat(fd, &file_stat) == -1)
+        {
+            const int error = errno;
+            close(fd);
+            return error;
+        }
+
+        if (!S_ISREG(file_stat.st_mode) || file_stat.st_size == 0)
+        {
+            // pipes, procfs and friends don't report a size: read until they run dry
+            const int error = readUntilEnd(fd, data);
+            close(fd);
+            return error;
+        }
+
+        data.resize(static_cast<size_t>(file_stat.st_size));
+        size_t offset = 0u;
+        while (offset < data.size())
+        {
+            const ssize_t result = pread(fd, data.data() + offset, std::min(data.size() - offset, maxReadChunk), static_cast<off_t>(offset));
+            if (result == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (result <= 0)
+            {
+                const int error = result == 0 ? 0 : errno;
+                // file shrank underneath us: hand back what's there
+                data.resize(offset);
+                close(fd);
+                return error;
+            }
+            offset += static_cast<size_t>(result);
+        }
+
+        close(fd);
+        return 0;
+    }
+#else
+    int readWholeFile(const char* path, std::vector<std::byte>& data)
+    {
+        std::ifstream input(path, std::ios::binary | std::ios::ate);
+        if (!input)
+        {
+            return ENOENT;
+        }
+        data.resize(static_cast<size_t>(input.tellg()));
+        input.seekg(0);
+        input.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        data.resize(static_cast<size_t>(input.gcount()));
+        return input.bad() ? EIO : 0;
+    }
+#endif
+
+#ifdef __linux__
+    int io_uring_setup(unsigned entries, io_uring_params* params) noexcept
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    int io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) noexcept
+    {
+        return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+    }
+
+    uint32_t loadAcquire(uint32_t* ptr) noexcept
+    {
+        return std::atomic_ref<uint32_t>(*ptr).load(std::memory_order_acquire);
+    }
+
+    void storeRelease(uint32_t* ptr, const uint32_t value) noexcept
+    {
+        std::atomic_ref<uint32_t>(*ptr).store(value, std::memory_order_release);
+    }
+
+    enum class uring_op : uint8_t
+    {
+        Open = 0,
+        Read = 1
+    };
+
+    struct uring_file
+    {
+        int fd{ -1 };
+        size_t offset{ 0u };
+        bool done{ false };
+        batch_read_result result;
+    };
+
+    constexpr uint64_t packUserData(const size_t index, const uring_op op) noexcept
+    {
+        return (static_cast<uint64_t>(index) << 1u) | static_cast<uint64_t>(op);
+    }
+#endif
+
+}
+
+BatchFileReader::BatchFileReader(const uint32_t queue_depth, const bool prefer_io_uring) : queueDepth(std::max(queue_depth, 1u))
+{
+    if (prefer_io_uring && setupIoUring())
+    {
+        backend = file_read_backend::IoUring;
+    }
+}
+
+BatchFileReader::~BatchFileReader()
+{
+    destroyIoUring();
+}
+
+file_read_backend BatchFileReader::Backend() const noexcept
+{
+    return backend;
+}
+
+const char* BatchFileReader::GetBackendName(const file_read_backend backend) noexcept
+{
+    switch (backend)
+    {
+    case file_read_backend::IoUring:
+        return "io_uring";
+    case file_read_backend::PRead:
+        [[fallthrough]];
+    default:
+        return "pread";
+    }
+}
+
+void BatchFileReader::ReadFiles(std::span<const char* const> paths, const std::function<void(batch_read_result&&)>& on_complete)
+{
+    FOUNDATION_PROFILE_ZONE_ARG("BatchFileReader::ReadFiles", static_cast<uint32_t>(paths.size()));
+    if (backend == file_read_backend::IoUring)
+    {
+        readFilesIoUring(paths, on_complete);
+    }
+    else
+    {
+        readFilesPRead(paths, on_complete);
+    }
+}
+
+void BatchFileReader::readFilesPRead(std::span<const char* const> paths, const std::function<void(batch_read_result&&)>& on_complete)
+{
+    for (size_t i = 0u; i < paths.size(); ++i)
+    {
+        batch_read_result result;
+        result.index = i;
+        result.error = readWholeFile(paths[i], result.data);
+        on_complete(std::move(result));
+    }
+}
+
+#ifdef __linux__
+
+bool BatchFileReader::setupIoUring()
+{
+    io_uring_params params{};
+    ringFd = io_uring_setup(queueDepth, &params);
+    if (ringFd < 0)
+    {
+        // ENOSYS on old kernels, EPERM when disabled by sysctl or seccomp
+        ringFd = -1;
+        return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+    {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+
+    sqRingPtr = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRingPtr == MAP_FAILED)
+    {
+        sqRingPtr = nullptr;
+        destroyIoUring();
+        return false;
+    }
+
+    if (single_mmap)
+    {
+        cqRingPtr = sqRingPtr;
+    }
+    else
+    {
+        cqRingPtr = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRingPtr == MAP_FAILED)
+        {
+            cqRingPtr = nullptr;
+            destroyIoUring();
+            return false;
+        }
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqesPtr == MAP_FAILED)
+    {
+        sqesPtr = nullptr;
+        destroyIoUring();
+        return false;
+    }
+
+    std::byte* sq_ring = reinterpret_cast<std::byte*>(sqRingPtr);
+    sqHead = reinterpret_cast<uint32_t*>(sq_ring + params.sq_off.head);
+    sqTail = reinterpret_cast<uint32_t*>(sq_ring + params.sq_off.tail);
+    sqMask = *reinterpret_cast<uint32_t*>(sq_ring + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    sqArray = reinterpret_cast<uint32_t*>(sq_ring + params.sq_off.array);
+
+    std::byte* cq_ring = reinterpret_cast<std::byte*>(cqRingPtr);
+    cqHead = reinterpret_cast<uint32_t*>(cq_ring + params.cq_off.head);
+    cqTail = reinterpret_cast<uint32_t*>(cq_ring + params.cq_off.tail);
+    cqMask = *reinterpret_cast<uint32_t*>(cq_ring + params.cq_off.ring_mask);
+    cqes = cq_ring + params.cq_off.cqes;
+
+    // OPENAT and READ only arrived in 5.6: older rings exist but can't do what we need
+    constexpr unsigned probe_ops = 256u;
+    std::vector<std::byte> probe_storage(sizeof(io_uring_probe) + probe_ops * sizeof(io_uring_probe_op));
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probe_storage.data());
+    if (io_uring_register(ringFd, IORING_REGISTER_PROBE, probe, probe_ops) < 0)
+    {
+        destroyIoUring();
+        return false;
+    }
+
+    auto op_supported = [probe](const unsigned op)
+    {
+        return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+
+    if (!op_supported(IORING_OP_OPENAT) || !op_supported(IORING_OP_READ))
+    {
+        destroyIoUring();
+        return false;
+    }
+
+    queueDepth = std::min(queueDepth, sqEntries);
+    return true;
+}
+
+void BatchFileReader::destroyIoUring() noexcept
+{
+    if (sqesPtr != nullptr)
+    {
+        munmap(sqesPtr, sqesSize);
+        sqesPtr = nullptr;
+    }
+    if (cqRingPtr != nullptr && cqRingPtr != sqRingPtr)
+    {
+        munmap(cqRingPtr, cqRingSize);
+    }
+    cqRingPtr = nullptr;
+    if (sqRingPtr != nullptr)
+    {
+        munmap(sqRingPtr, sqRingSize);
+        sqRingPtr = nullptr;
+    }
+    if (ringFd != -1)
+    {
+        close(ringFd);
+        ringFd = -1;
+    }
+}
+
+void BatchFileReader::readFilesIoUring(std::span<const char* const> paths, const std::function<void(batch_read_result&&)>& on_complete)
+{
+    std::vector<uring_file> files(paths.size());
+    // Files that are open and need (more) reading. Served before opening more files, so buffers don't pile up.
+    std::deque<size_t> pending_reads;
+    size_t next_to_open = 0u;
+    size_t completed = 0u;
+    // Queued in the SQ, including entries the kernel hasn't consumed yet
+    uint32_t in_flight = 0u;
+    // In the SQ but not yet taken by io_uring_enter(): a call can consume fewer than it's passed, or none when interrupted
+    uint32_t unsubmitted = 0u;
+
+    auto finish = [&](const size_t index, const int error)
+    {
+        uring_file& file = files[index];
+        if (file.fd != -1)
+        {
+            close(file.fd);
+            file.fd = -1;
+        }
+        file.done = true;
+        file.result.index = index;
+        file.result.error = error;
+        if (error != 0)
+        {
+            file.result.data.clear();
+        }
+        ++completed;
+        on_complete(std::move(file.result));
+    };
+
+    auto reap = [&](auto&& on_cqe)
+    {
+        uint32_t head = *cqHead;
+        const uint32_t cq_tail = loadAcquire(cqTail);
+        while (head != cq_tail)
+        {
+            const io_uring_cqe* cqe = reinterpret_cast<const io_uring_cqe*>(cqes) + (head & cqMask);
+            const size_t index = static_cast<size_t>(cqe->user_data >> 1u);
+            const uring_op op = static_cast<uring_op>(cqe->user_data & 1u);
+            const int res = cqe->res;
+            ++head;
+            --in_flight;
+            on_cqe(index, op, res);
+        }
+        storeRelease(cqHead, head);
+    };
+
+    while (completed < files.size())
+    {
+        // Fill the submission queue up to the depth limit
+        uint32_t tail = *sqTail;
+        while (in_flight < queueDepth && (!pending_reads.empty() || next_to_open < files.size()))
+        {
+            const uint32_t index_in_ring = tail & sqMask;
+            io_uring_sqe* sqe = reinterpret_cast<io_uring_sqe*>(sqesPtr) + index_in_ring;
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+
+            if (!pending_reads.empty())
+            {
+                const size_t index = pending_reads.front();
+                pending_reads.pop_front();
+                uring_file& file = files[index];
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = file.fd;
+                sqe->addr = reinterpret_cast<uint64_t>(file.result.data.data() + file.offset);
+                sqe->len = static_cast<uint32_t>(std::min(file.result.data.size() - file.offset, maxReadChunk));
+                sqe->off = file.offset;
+                sqe->user_data = packUserData(index, uring_op::Read);
+            }
+            else
+            {
+                const size_t index = next_to_open++;
+                sqe->opcode = IORING_OP_OPENAT;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = reinterpret_cast<uint64_t>(paths[index]);
+                sqe->open_flags = O_RDONLY | O_CLOEXEC;
+                sqe->user_data = packUserData(index, uring_op::Open);
+            }
+
+            sqArray[index_in_ring] = index_in_ring;
+            ++tail;
+            ++unsubmitted;
+            ++in_flight;
+        }
+        storeRelease(sqTail, tail);
+
+        // in_flight never exceeds the SQ size and the CQ is twice that, so the CQ can't overflow (EBUSY)
+        int entered = io_uring_enter(ringFd, unsubmitted, 1u, IORING_ENTER_GETEVENTS);
+        while (entered < 0 && (errno == EINTR || errno == EAGAIN))
+        {
+            entered = io_uring_enter(ringFd, unsubmitted, 1u, IORING_ENTER_GETEVENTS);
+        }
+        if (entered < 0)
+        {
+            // Ring is unusable, but what it already took still belongs to the kernel: READs land in
+            // result.data and OPENATs hand back fds. Closing the ring doesn't wait for them, so wait here
+            // (completions are still posted to the mapped CQ, enter or no enter) before touching either.
+            uint32_t submitted = in_flight - unsubmitted;
+            while (submitted != 0u)
+            {
+                if (io_uring_enter(ringFd, 0u, 1u, IORING_ENTER_GETEVENTS) < 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+                reap([&](const size_t index, const uring_op op, const int res)
+                {
+                    --submitted;
+                    if (op == uring_op::Open && res >= 0)
+                    {
+                        // closed by finish() below
+                        files[index].fd = res;
+                    }
+                });
+            }
+
+            // Then the rest of this batch (and every later one) goes through pread
+            destroyIoUring();
+            backend = file_read_backend::PRead;
+            for (size_t i = 0u; i < files.size(); ++i)
+            {
+                if (!files[i].done)
+                {
+                    files[i].result.data.clear();
+                    finish(i, readWholeFile(paths[i], files[i].result.data));
+                }
+            }
+            return;
+        }
+        unsubmitted -= static_cast<uint32_t>(entered);
+
+        // Reap everything that's done
+        reap([&](const size_t index, const uring_op op, const int res)
+        {
+            uring_file& file = files[index];
+            if (op == uring_op::Open)
+            {
+                if (res < 0)
+                {
+                    finish(index, -res);
+                    return;
+                }
+
+                file.fd = res;
+                struct stat file_stat{};
+                if (fstat(file.fd, &file_stat) == -1)
+                {
+                    finish(index, errno);
+                    return;
+                }
+
+                if (!S_ISREG(file_stat.st_mode) || file_stat.st_size == 0)
+                {
+                    // no size to size a read with: rare enough to just do synchronously
+                    finish(index, readUntilEnd(file.fd, file.result.data));
+                    return;
+                }
+
+                file.result.data.resize(static_cast<size_t>(file_stat.st_size));
+                pending_reads.emplace_back(index);
+            }
+            else
+            {
+                if (res == -EINTR || res == -EAGAIN)
+                {
+                    pending_reads.emplace_back(index);
+                }
+                else if (res < 0)
+                {
+                    finish(index, -res);
+                }
+                else if (res == 0)
+                {
+                    // file shrank underneath us: hand back what's there
+                    file.result.data.resize(file.offset);
+                    finish(index, 0);
+                }
+                else
+                {
+                    file.offset += static_cast<size_t>(res);
+                    if (file.offset < file.result.data.size())
+                    {
+                        pending_reads.emplace_back(index);
+                    }
+                    else
+                    {
+                        finish(index, 0);
+                    }
+                }
+            }
+        });
+    }
+}
+
+#else
+
+bool BatchFileReader::setupIoUring()
+{
+    return false;
+}
+
+void BatchFileReader::destroyIoUring() noexcept
+{
+}
+
+void BatchFileReader::readFilesIoUring(std::span<const char* const> paths, const std::function<void(batch_read_result&&)>& on_complete)
+{
+    readFilesPRead(paths, on_complete);
+}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef RESOURCE_CONTEXT_BATCH_FILE_READER_HPP
+#define RESOURCE_CONTEXT_BATCH_FILE_READER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+/*
+    Reads whole files into memory, many at a time. On Linux with a new enough kernel (io_uring with
+    openat/read support, 5.6+) a batch keeps up to queueDepth opens and reads in flight at once, which
+    is what matters for cold-cache loads of lots of small files: they're bound by per-request latency,
+    not bandwidth. Everywhere else it falls back to a plain open/pread loop, one file at a time.
+
+    One reader per thread: the ring isn't shared, so nothing in here locks.
+*/
+
+enum class file_read_backend : uint8_t
+{
+    PRead = 0,
+    IoUring = 1
+};
+
+struct batch_read_result
+{
+    // Index into the paths passed to ReadFiles()
+    size_t index{ 0u };
+    std::vector<std::byte> data;
+    // 0 on success, otherwise an errno value
+    int error{ 0 };
+};
+
+class BatchFileReader
+{
+public:
+
+    explicit BatchFileReader(const uint32_t queue_depth = 64u, const bool prefer_io_uring = true);
+    ~BatchFileReader();
+
+    BatchFileReader(const BatchFileReader&) = delete;
+    BatchFileReader& operator=(const BatchFileReader&) = delete;
+
+    file_read_backend Backend() const noexcept;
+    static const char* GetBackendName(const file_read_backend backend) noexcept;
+
+    // on_complete is called on the calling thread once per path, in completion order
+    void ReadFiles(std::span<const char* const> paths, const std::function<void(batch_read_result&&)>& on_complete);
+
+private:
+
+    void readFilesPRead(std::span<const char* const> paths, const std::function<void(batch_read_result&&)>& on_complete);
+    void readFilesIoUring(std::span<const char* const> paths, const std::function<void(batch_read_result&&)>& on_complete);
+    bool setupIoUring();
+    void destroyIoUring() noexcept;
+
+    file_read_backend backend{ file_read_backend::PRead };
+    uint32_t queueDepth{ 0u };
+
+    // io_uring state: the rings are mapped shared with the kernel
+    int ringFd{ -1 };
+    void* sqRingPtr{ nullptr };
+    size_t sqRingSize{ 0u };
+    void* cqRingPtr{ nullptr };
+    size_t cqRingSize{ 0u };
+    void* sqesPtr{ nullptr };
+    size_t sqesSize{ 0u };
+    uint32_t* sqHead{ nullptr };
+    uint32_t* sqTail{ nullptr };
+    uint32_t sqMask{ 0u };
+    uint32_t sqEntries{ 0u };
+    uint32_t* sqArray{ nullptr };
+    uint32_t* cqHead{ nullptr };
+    uint32_t* cqTail{ nullptr };
+    uint32_t cqMask{ 0u };
+    void* cqes{ nullptr };
+};
+
+#endif //!RESOURCE_CONTEXT_BATCH_FILE_READER_HPP
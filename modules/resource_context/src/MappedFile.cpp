@@ -0,0 +1,191 @@
+#include "MappedFile.hpp"
+#include <fstream>
+#include <utility>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const char* path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        return;
+    }
+
+    if (file_size.QuadPart == 0)
+    {
+        // can't map zero bytes, but an empty file is still a file
+        CloseHandle(file);
+        valid = true;
+        return;
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // the mapping keeps the file alive on its own
+    CloseHandle(file);
+    if (mappingHandle != nullptr)
+    {
+        mappedData = reinterpret_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (mappedData != nullptr)
+        {
+            mappedSize = static_cast<size_t>(file_size.QuadPart);
+            valid = true;
+            return;
+        }
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+#else
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return;
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) == -1)
+    {
+        close(fd);
+        return;
+    }
+
+    if (!S_ISREG(file_stat.st_mode))
+    {
+        close(fd);
+        valid = readFallback(path);
+        return;
+    }
+
+    if (file_stat.st_size == 0)
+    {
+        // either actually empty, or something like procfs that reports no size: reading costs nothing either way
+        close(fd);
+        valid = readFallback(path);
+        return;
+    }
+
+    const size_t file_size = static_cast<size_t>(file_stat.st_size);
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping holds its own reference to the file
+    close(fd);
+    if (mapping != MAP_FAILED)
+    {
+        // advice is only a hint: nothing to do if the kernel ignores it
+        madvise(mapping, file_size, MADV_SEQUENTIAL);
+        madvise(mapping, file_size, MADV_WILLNEED);
+        mappedData = reinterpret_cast<const std::byte*>(mapping);
+        mappedSize = file_size;
+        valid = true;
+        return;
+    }
+#endif
+
+    valid = readFallback(path);
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    mappedData{ std::exchange(other.mappedData, nullptr) },
+    mappedSize{ std::exchange(other.mappedSize, 0u) },
+#ifdef _WIN32
+    mappingHandle{ std::exchange(other.mappingHandle, nullptr) },
+#endif
+    fallbackData{ std::move(other.fallbackData) },
+    valid{ std::exchange(other.valid, false) }
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        mappedData = std::exchange(other.mappedData, nullptr);
+        mappedSize = std::exchange(other.mappedSize, 0u);
+#ifdef _WIN32
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+        fallbackData = std::move(other.fallbackData);
+        valid = std::exchange(other.valid, false);
+    }
+    return *this;
+}
+
+std::span<const std::byte> MappedFile::Data() const noexcept
+{
+    if (mappedData != nullptr)
+    {
+        return std::span<const std::byte>(mappedData, mappedSize);
+    }
+    return std::span<const std::byte>(fallbackData.data(), fallbackData.size());
+}
+
+bool MappedFile::Valid() const noexcept
+{
+    return valid;
+}
+
+void MappedFile::unmap() noexcept
+{
+#ifdef _WIN32
+    if (mappedData != nullptr)
+    {
+        UnmapViewOfFile(mappedData);
+    }
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+#else
+    if (mappedData != nullptr)
+    {
+        munmap(const_cast<std::byte*>(mappedData), mappedSize);
+    }
+#endif
+    mappedData = nullptr;
+    mappedSize = 0u;
+    fallbackData.clear();
+    valid = false;
+}
+
+bool MappedFile::readFallback(const char* path)
+{
+    std::ifstream input(path, std::ios::binary);
+    if (!input)
+    {
+        return false;
+    }
+
+    char buffer[64 * 1024];
+    while (input.read(buffer, sizeof(buffer)) || input.gcount() > 0)
+    {
+        const std::byte* chunk = reinterpret_cast<const std::byte*>(buffer);
+        fallbackData.insert(fallbackData.end(), chunk, chunk + input.gcount());
+    }
+
+    return !input.bad();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef RESOURCE_CONTEXT_MAPPED_FILE_HPP
+#define RESOURCE_CONTEXT_MAPPED_FILE_HPP
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/*
+    Read-only view of a whole file, used by ResourceLoader to hand span factories the file contents
+    straight out of the page cache. The mapping is hinted as sequential/will-need, since factories
+    almost always parse front to back. If the file can't be mapped (pipes, some network filesystems)
+    it's read into a heap buffer instead, so callers only ever see a span either way.
+
+    Unmapped on destruction: the span must not outlive the MappedFile.
+*/
+class MappedFile
+{
+public:
+
+    MappedFile() noexcept = default;
+    explicit MappedFile(const char* path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    std::span<const std::byte> Data() const noexcept;
+    // False if the file couldn't be opened or read at all. Empty files are valid.
+    bool Valid() const noexcept;
+
+private:
+
+    void unmap() noexcept;
+    bool readFallback(const char* path);
+
+    const std::byte* mappedData{ nullptr };
+    size_t mappedSize{ 0u };
+#ifdef _WIN32
+    void* mappingHandle{ nullptr };
+#endif
+    std::vector<std::byte> fallbackData;
+    bool valid{ false };
+};
+
+#endif //!RESOURCE_CONTEXT_MAPPED_FILE_HPP
@@ -1,6 +1,7 @@
 #include "ResourceContext.hpp"
 #include "ResourceContextImpl.hpp"
 #include "ResourceMessageTypesInternal.hpp"
+#include "foundation/SlabPool.hpp"
 
 ResourceContext::ResourceContext()
 {
@@ -37,7 +38,7 @@ std::shared_ptr<GraphicsResourceReply> ResourceContext::CreateBuffer(
     message.resourceUsage = resourceUsage;
     message.flags = flags;
     message.userData = userData;
-    message.reply = std::make_shared<GraphicsResourceReply>(resource_type::Buffer);
+    message.reply = std::allocate_shared<GraphicsResourceReply>(foundation::slab_allocator<GraphicsResourceReply>(), resource_type::Buffer);
     std::shared_ptr<GraphicsResourceReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -65,7 +66,7 @@ std::shared_ptr<GraphicsResourceReply> ResourceContext::CreateImage(
     message.resourceUsage = resourceUsage;
     message.flags = flags;
     message.userData = userData;
-    message.reply = std::make_shared<GraphicsResourceReply>(resource_type::Image);
+    message.reply = std::allocate_shared<GraphicsResourceReply>(foundation::slab_allocator<GraphicsResourceReply>(), resource_type::Image);
     std::shared_ptr<GraphicsResourceReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -73,6 +74,106 @@ std::shared_ptr<GraphicsResourceReply> ResourceContext::CreateImage(
     return reply;
 }
 
+gpu_staging_reservation_t ResourceContext::ReserveStaging(size_t size)
+{
+    return impl->reserveStaging(size);
+}
+
+void ResourceContext::ReleaseStaging(gpu_staging_reservation_t& staging)
+{
+    impl->releaseStaging(staging);
+}
+
+std::shared_ptr<GraphicsResourceReply> ResourceContext::CreateBufferFromStaging(
+    const VkBufferCreateInfo& createInfo,
+    const VkBufferViewCreateInfo* viewCreateInfo,
+    gpu_staging_reservation_t&& staging,
+    const gpu_resource_data_t* regions,
+    size_t numRegions,
+    resource_usage resourceUsage,
+    resource_creation_flags flags,
+    void* userData)
+{
+    // offsets are worked out against the reservation as it was handed in, since taking it resets staging
+    const gpu_staging_reservation_t reservation = staging;
+    std::shared_ptr<UploadBuffer> upload_buffer = impl->takeStaging(staging);
+
+    CreateBufferMessage message;
+    message.reply = std::allocate_shared<GraphicsResourceReply>(foundation::slab_allocator<GraphicsResourceReply>(), resource_type::Buffer);
+    std::shared_ptr<GraphicsResourceReply> reply = message.reply;
+
+    if (!upload_buffer)
+    {
+        // already used or released
+        reply->SetStatus(MessageReply::Status::Failed);
+        return reply;
+    }
+
+    if (!InternalResourceDataContainer::InStaging(numRegions, regions, reservation))
+    {
+        // upload_buffer frees the reservation as it goes out of scope
+        reply->SetStatus(MessageReply::Status::Failed);
+        return reply;
+    }
+
+    message.bufferInfo = createInfo;
+    message.viewInfo = viewCreateInfo ? std::optional<VkBufferViewCreateInfo>(*viewCreateInfo) : std::nullopt;
+    message.initialData = InternalResourceDataContainer(numRegions, regions, reservation);
+    message.initialData->Staging = std::move(upload_buffer);
+    message.resourceUsage = resourceUsage;
+    message.flags = flags;
+    message.userData = userData;
+
+    impl->pushMessage(std::move(message));
+
+    return reply;
+}
+
+std::shared_ptr<GraphicsResourceReply> ResourceContext::CreateImageFromStaging(
+    const VkImageCreateInfo& createInfo,
+    const VkImageViewCreateInfo* viewCreateInfo,
+    gpu_staging_reservation_t&& staging,
+    const gpu_image_resource_data_t* regions,
+    size_t numRegions,
+    resource_usage resourceUsage,
+    resource_creation_flags flags,
+    void* userData)
+{
+    // offsets are worked out against the reservation as it was handed in, since taking it resets staging
+    const gpu_staging_reservation_t reservation = staging;
+    std::shared_ptr<UploadBuffer> upload_buffer = impl->takeStaging(staging);
+
+    CreateImageMessage message;
+    message.reply = std::allocate_shared<GraphicsResourceReply>(foundation::slab_allocator<GraphicsResourceReply>(), resource_type::Image);
+    std::shared_ptr<GraphicsResourceReply> reply = message.reply;
+
+    if (!upload_buffer)
+    {
+        // already used or released
+        reply->SetStatus(MessageReply::Status::Failed);
+        return reply;
+    }
+
+    if (!InternalResourceDataContainer::InStaging(numRegions, regions, reservation))
+    {
+        // upload_buffer frees the reservation as it goes out of scope
+        reply->SetStatus(MessageReply::Status::Failed);
+        return reply;
+    }
+
+    message.imageInfo = createInfo;
+    message.viewInfo = viewCreateInfo ? std::optional<VkImageViewCreateInfo>(*viewCreateInfo) : std::nullopt;
+    message.initialData = InternalResourceDataContainer(numRegions, regions, reservation);
+    message.initialData->Staging = std::move(upload_buffer);
+    message.resourceUsage = resourceUsage;
+    message.flags = flags;
+    message.userData = userData;
+
+    impl->pushMessage(std::move(message));
+
+    return reply;
+}
+
 std::shared_ptr<GraphicsResourceReply> ResourceContext::CreateSampler(
     const VkSamplerCreateInfo& createInfo,
     void* userData)
@@ -80,7 +181,7 @@ std::shared_ptr<GraphicsResourceReply> ResourceContext::CreateSampler(
     CreateSamplerMessage message;
     message.samplerInfo = createInfo;
     message.userData = userData;
-    message.reply = std::make_shared<GraphicsResourceReply>(resource_type::Sampler);
+    message.reply = std::allocate_shared<GraphicsResourceReply>(foundation::slab_allocator<GraphicsResourceReply>(), resource_type::Sampler);
     std::shared_ptr<GraphicsResourceReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -94,7 +195,7 @@ std::shared_ptr<ResourceTransferReply> ResourceContext::SetBufferData(
     size_t numData)
 {
     SetBufferDataMessage message(buffer, numData, data);
-    message.reply = std::make_shared<ResourceTransferReply>();
+    message.reply = std::allocate_shared<ResourceTransferReply>(foundation::slab_allocator<ResourceTransferReply>());
     std::shared_ptr<ResourceTransferReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -108,7 +209,7 @@ std::shared_ptr<ResourceTransferReply> ResourceContext::SetImageData(
     size_t numData)
 {   
     SetImageDataMessage message(image, numData, data);
-    message.reply = std::make_shared<ResourceTransferReply>();
+    message.reply = std::allocate_shared<ResourceTransferReply>(foundation::slab_allocator<ResourceTransferReply>());
     std::shared_ptr<ResourceTransferReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -127,7 +228,7 @@ std::shared_ptr<ResourceTransferReply> ResourceContext::FillBuffer(
     message.value = value;
     message.offset = offset;
     message.size = size;
-    message.reply = std::make_shared<ResourceTransferReply>();
+    message.reply = std::allocate_shared<ResourceTransferReply>(foundation::slab_allocator<ResourceTransferReply>());
     std::shared_ptr<ResourceTransferReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -144,7 +245,7 @@ std::shared_ptr<PointerMessageReply> ResourceContext::MapBuffer(
     message.resource = buffer;
     message.size = size;
     message.offset = offset;
-    message.reply = std::make_shared<PointerMessageReply>();
+    message.reply = std::allocate_shared<PointerMessageReply>(foundation::slab_allocator<PointerMessageReply>());
     std::shared_ptr<PointerMessageReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -161,7 +262,7 @@ std::shared_ptr<MessageReply> ResourceContext::UnmapBuffer(
     message.resource = buffer;
     message.size = size;
     message.offset = offset;
-    message.reply = std::make_shared<MessageReply>();
+    message.reply = std::allocate_shared<MessageReply>(foundation::slab_allocator<MessageReply>());
     std::shared_ptr<MessageReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -176,7 +277,7 @@ std::shared_ptr<GraphicsResourceReply> ResourceContext::CopyBuffer(
     CopyResourceMessage message;
     message.sourceResource = src;
     message.copyContents = copyContents;
-    message.reply = std::make_shared<GraphicsResourceReply>(resource_type::Buffer);
+    message.reply = std::allocate_shared<GraphicsResourceReply>(foundation::slab_allocator<GraphicsResourceReply>(), resource_type::Buffer);
     std::shared_ptr<GraphicsResourceReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -191,7 +292,7 @@ std::shared_ptr<ResourceTransferReply> ResourceContext::CopyBufferContents(
     CopyResourceContentsMessage message;
     message.sourceResource = src;
     message.destinationResource = dst;
-    message.reply = std::make_shared<ResourceTransferReply>();
+    message.reply = std::allocate_shared<ResourceTransferReply>(foundation::slab_allocator<ResourceTransferReply>());
     std::shared_ptr<ResourceTransferReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
@@ -204,7 +305,7 @@ std::shared_ptr<MessageReply> ResourceContext::DestroyResource(
 {
     DestroyResourceMessage message;
     message.resource = resource;
-    message.reply = std::make_shared<MessageReply>();
+    message.reply = std::allocate_shared<MessageReply>(foundation::slab_allocator<MessageReply>());
     std::shared_ptr<MessageReply> reply = message.reply;
 
     impl->pushMessage(std::move(message));
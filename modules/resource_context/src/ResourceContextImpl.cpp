@@ -3,6 +3,7 @@
 #include "ResourceContext.hpp"
 #include "../../rendering_context/include/RenderingContext.hpp"
 #include "Instance.hpp"
+#include "foundation/Profiler.hpp"
 
 #include <fstream>
 #include <format>
@@ -18,6 +19,8 @@ namespace
     VkFormatFeatureFlags GetFormatFeatureFlagsFromUsage(const VkImageUsageFlags flags) noexcept;
     VmaAllocationCreateFlags GetAllocationCreateFlags(const resource_creation_flags flags) noexcept;
     VmaMemoryUsage GetVmaMemoryUsage(const resource_usage _resource_usage) noexcept;
+    TransferSystemReqBufferInfo GetReqBufferInfo(const BufferResourceData& buffer_data) noexcept;
+    TransferSystemReqImageInfo GetReqImageInfo(const ImageResourceData& image_data) noexcept;
 }
 
 void ResourceContextImpl::construct(const ResourceContextCreateInfo& createInfo)
@@ -54,6 +57,11 @@ void ResourceContextImpl::construct(const ResourceContextCreateInfo& createInfo)
     VkResult result = vmaCreateAllocator(&create_info, &allocatorHandle);
     VkAssert(result);
 
+    VmaAllocatorCreateInfo staging_create_info = create_info;
+    staging_create_info.flags &= ~VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT;
+    result = vmaCreateAllocator(&staging_create_info, &stagingAllocatorHandle);
+    VkAssert(result);
+
     transferSystem.Initialize(device);
 
     startWorker();
@@ -73,7 +81,17 @@ void ResourceContextImpl::destroy()
     // destroy transfer system, which may have pending resources and transfers
     transferSystem.destroy();
 
+    // whatever staging was never uploaded goes too: transfers holding the rest are complete by now
+    {
+        std::lock_guard stagingGuard(stagingMutex);
+        stagingReservations.clear();
+    }
+    vmaDestroyAllocator(stagingAllocatorHandle);
+
     // last step, destroy the allocator and the registry. allocator last
+    bufferHandles.Clear();
+    imageHandles.Clear();
+    samplerHandles.Clear();
     resourceRegistry.clear();
     vmaDestroyAllocator(allocatorHandle);
 }
@@ -86,11 +104,47 @@ void ResourceContextImpl::update()
 void ResourceContextImpl::pushMessage(ResourceMessagePayloadType message)
 {
     messageQueue.push(std::move(message));
+    messageWaiter.notify();
+}
+
+gpu_staging_reservation_t ResourceContextImpl::reserveStaging(size_t size)
+{
+    FOUNDATION_PROFILE_ZONE("ResourceContext::ReserveStaging");
+    auto staging_buffer = std::make_shared<UploadBuffer>(device, stagingAllocatorHandle);
+    staging_buffer->Reserve(static_cast<VkDeviceSize>(size));
+
+    gpu_staging_reservation_t result{ staging_buffer->mappedPtr, size, 0u };
+    std::lock_guard stagingGuard(stagingMutex);
+    result.Handle = nextStagingHandle++;
+    stagingReservations.emplace(result.Handle, std::move(staging_buffer));
+    return result;
+}
+
+void ResourceContextImpl::releaseStaging(gpu_staging_reservation_t& staging)
+{
+    // freed as this goes out of scope, after we've let go of the lock
+    std::shared_ptr<UploadBuffer> released = takeStaging(staging);
+}
+
+std::shared_ptr<UploadBuffer> ResourceContextImpl::takeStaging(gpu_staging_reservation_t& staging)
+{
+    std::shared_ptr<UploadBuffer> result;
+    {
+        std::lock_guard stagingGuard(stagingMutex);
+        if (auto iter = stagingReservations.find(staging.Handle); iter != stagingReservations.end())
+        {
+            result = std::move(iter->second);
+            stagingReservations.erase(iter);
+        }
+    }
+    staging = gpu_staging_reservation_t{};
+    return result;
 }
 
 void ResourceContextImpl::setExitWorker()
 {
     shouldExitWorker.store(true);
+    messageWaiter.notify();
     workerThread.join();
 }
 
@@ -102,8 +156,6 @@ void ResourceContextImpl::startWorker()
 
 void ResourceContextImpl::processMessages()
 {
-    // Create a backoff sleeper with default parameters
-    foundation::ExponentialBackoffSleeper sleeper;
     // surely there has to be a better way than this. why is std::visit like this
     auto MessageVisitor =
         [this](auto&& arg)
@@ -159,64 +211,71 @@ void ResourceContextImpl::processMessages()
             }
         };
 
+    FOUNDATION_PROFILE_THREAD_NAME("ResourceContext Worker");
+
     while (!shouldExitWorker.load())
     {
+        // Taken before checking the queue, so a push landing after the check still wakes us
+        const uint32_t waitToken = messageWaiter.prepareWait();
         bool didProcessMessage = false;
         
         // Process all available messages
         while (!messageQueue.empty())
         {
             ResourceMessagePayloadType message = messageQueue.pop();
+            FOUNDATION_PROFILE_ZONE_ARG("ResourceContext::ProcessMessage", static_cast<uint32_t>(message.index()));
             std::visit(MessageVisitor, message);
             didProcessMessage = true;
         }
         
-        // Adjust sleep behavior based on whether we processed any messages
         if (didProcessMessage)
         {
-            // Reset sleep duration to minimum if we processed messages
-            sleeper.reset();
+            // Reset wait timeout to minimum, and go straight back to checking the queue
+            messageWaiter.reset();
         }
         else
         {
-            // Back off if no messages were processed
-            sleeper.backoff();
+            // pushMessage() wakes us early, so the timeout only matters for noticing shouldExitWorker
+            messageWaiter.wait(waitToken);
+            messageWaiter.backoff();
         }
-        
-        // Sleep for the calculated duration
-        sleeper.sleep();
     }
 }
 
 void ResourceContextImpl::processCreateBufferMessage(CreateBufferMessage&& message)
 {
-    const entt::entity new_entity = resourceRegistry.create();
-
     message.reply->SetStatus(MessageReply::Status::Pending);
-    
-    VkBuffer buffer_handle = createBuffer(
-        new_entity,
-        std::move(message.bufferInfo),
-        message.flags,
-        message.resourceUsage,
-        message.userData,
-        message.initialData.has_value());
 
-    if (buffer_handle == VK_NULL_HANDLE)
+    if (bufferHandles.Full())
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
     }
 
-    resourceRegistry.emplace<VkBuffer>(new_entity, buffer_handle);
+    BufferResourceData buffer_data;
+    buffer_data.entity = resourceRegistry.create();
+    buffer_data.createInfo = std::move(message.bufferInfo);
+    buffer_data.flags = message.flags;
+    buffer_data.resourceUsage = message.resourceUsage;
+
+    VkBuffer buffer_handle = createBuffer(buffer_data, message.userData, message.initialData.has_value());
+
+    if (buffer_handle == VK_NULL_HANDLE)
+    {
+        message.reply->SetStatus(MessageReply::Status::Failed);
+        resourceRegistry.destroy(buffer_data.entity);
+        return;
+    }
 
-    VkBufferView buffer_view = VK_NULL_HANDLE;
     if (message.viewInfo)
     {
-        buffer_view = createBufferView(new_entity, std::move(message.viewInfo.value()), message.flags, message.userData);
-        resourceRegistry.emplace<VkBufferView>(new_entity, buffer_view);
+        buffer_data.view = createBufferView(buffer_data.entity, std::move(message.viewInfo.value()), message.flags, message.userData);
     }
 
+    const VkBufferView buffer_view = buffer_data.view;
+    const VkBufferCreateInfo buffer_info = buffer_data.createInfo;
+    const uint32_t resource_handle = bufferHandles.Insert(std::move(buffer_data));
+
     if (message.initialData)
     {
         // pass responsiblity on to transfer system now, transferring ownership of data with a move
@@ -224,7 +283,7 @@ void ResourceContextImpl::processCreateBufferMessage(CreateBufferMessage&& messa
         GraphicsResource createdResource
         {
             resource_type::Buffer,
-            static_cast<uint32_t>(new_entity),
+            resource_handle,
             reinterpret_cast<uint64_t>(buffer_handle),
             reinterpret_cast<uint64_t>(buffer_view),
             0u
@@ -236,7 +295,7 @@ void ResourceContextImpl::processCreateBufferMessage(CreateBufferMessage&& messa
             TransferSystemReqBufferInfo
             {
                 buffer_handle,
-                message.bufferInfo,
+                buffer_info,
                 message.resourceUsage,
                 message.flags
             },
@@ -250,7 +309,7 @@ void ResourceContextImpl::processCreateBufferMessage(CreateBufferMessage&& messa
     {
         message.reply->SetGraphicsResource(
             resource_type::Buffer,
-            static_cast<uint32_t>(new_entity),
+            resource_handle,
             reinterpret_cast<uint64_t>(buffer_handle),
             reinterpret_cast<uint64_t>(buffer_view),
             0u);
@@ -260,75 +319,76 @@ void ResourceContextImpl::processCreateBufferMessage(CreateBufferMessage&& messa
 
 void ResourceContextImpl::processCreateImageMessage(CreateImageMessage&& message)
 {
-    const entt::entity new_entity = resourceRegistry.create();
-    VkImage image_handle = createImage(
-        new_entity,
-        std::move(message.imageInfo),
-        message.flags,
-        message.resourceUsage,
-        message.userData,
-        message.initialData.has_value());
-
-    if (image_handle != VK_NULL_HANDLE)
+    if (imageHandles.Full())
     {
-        resourceRegistry.emplace<VkImage>(new_entity, image_handle);
+        message.reply->SetStatus(MessageReply::Status::Failed);
+        return;
     }
-    else
+
+    ImageResourceData image_data;
+    image_data.entity = resourceRegistry.create();
+    image_data.createInfo = std::move(message.imageInfo);
+    image_data.flags = message.flags;
+    image_data.resourceUsage = message.resourceUsage;
+
+    VkImage image_handle = createImage(image_data, message.userData, message.initialData.has_value());
+
+    if (image_handle == VK_NULL_HANDLE)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
-        resourceRegistry.destroy(new_entity);
+        resourceRegistry.destroy(image_data.entity);
         return;
     }
 
-    VkImageView image_view = VK_NULL_HANDLE;
     if (message.viewInfo.has_value())
     {
-        image_view = createImageView(new_entity, message.viewInfo.value(), message.flags);
-        if (image_view != VK_NULL_HANDLE)
-        {
-            resourceRegistry.emplace<VkImageView>(new_entity, image_view);
-        }
-        else
+        image_data.view = createImageView(image_data.entity, image_handle, message.viewInfo.value(), message.flags);
+        if (image_data.view == VK_NULL_HANDLE)
         {
             message.reply->SetStatus(MessageReply::Status::Failed);
-            resourceRegistry.destroy(new_entity);
+            vmaDestroyImage(allocatorHandle, image_handle, image_data.allocation);
+            resourceRegistry.destroy(image_data.entity);
             return;
         }
     }
 
+    const VkImageView image_view = image_data.view;
+    const VkImageCreateInfo image_info = image_data.createInfo;
+    const uint32_t resource_handle = imageHandles.Insert(std::move(image_data));
+
     if (message.initialData.has_value())
     {
         message.reply->SetStatus(MessageReply::Status::Transferring);
         GraphicsResource createdResource
         {
             resource_type::Image,
-            static_cast<uint32_t>(new_entity),
+            resource_handle,
             reinterpret_cast<uint64_t>(image_handle),
             reinterpret_cast<uint64_t>(image_view),
             0u
         };
         message.reply->SetGraphicsResourceRelaxed(createdResource);
-        
+
         TransferSystemSetImageDataMessage set_image_data_message
         {
             TransferSystemReqImageInfo
             {
                 image_handle,
-                resourceRegistry.get<VkImageCreateInfo>(new_entity),
+                image_info,
                 message.resourceUsage,
                 message.flags
             },
             std::move(message.initialData.value()),
             std::move(message.reply)
         };
-        
+
         transferSystem.EnqueueTransfer(std::move(set_image_data_message));
     }
     else
     {
         message.reply->SetGraphicsResource(
             resource_type::Image,
-            static_cast<uint32_t>(new_entity),
+            resource_handle,
             reinterpret_cast<uint64_t>(image_handle),
             reinterpret_cast<uint64_t>(image_view),
             0u);
@@ -337,57 +397,58 @@ void ResourceContextImpl::processCreateImageMessage(CreateImageMessage&& message
 
 void ResourceContextImpl::processCreateCombinedImageSamplerMessage(CreateCombinedImageSamplerMessage&& message)
 {
-    const entt::entity new_entity = resourceRegistry.create();
-    VkImage image_handle = createImage(
-        new_entity,
-        std::move(message.imageInfo),
-        message.flags,
-        message.resourceUsage,
-        message.userData,
-        message.initialData.has_value());
-
-    if (image_handle != VK_NULL_HANDLE)
-    {
-        resourceRegistry.emplace<VkImage>(new_entity, image_handle);
-    }
-    else
+    if (imageHandles.Full())
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
-        resourceRegistry.destroy(new_entity);
         return;
     }
 
-    VkImageView image_view = createImageView(new_entity, message.viewInfo, message.flags);
-    if (image_view != VK_NULL_HANDLE)
-    {
-        resourceRegistry.emplace<VkImageView>(new_entity, image_view);
-    }
-    else
+    ImageResourceData image_data;
+    image_data.entity = resourceRegistry.create();
+    image_data.createInfo = std::move(message.imageInfo);
+    image_data.flags = message.flags;
+    image_data.resourceUsage = message.resourceUsage;
+
+    VkImage image_handle = createImage(image_data, message.userData, message.initialData.has_value());
+
+    if (image_handle == VK_NULL_HANDLE)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
-        resourceRegistry.destroy(new_entity);
+        resourceRegistry.destroy(image_data.entity);
         return;
     }
 
-    VkSampler sampler = createSampler(new_entity, message.samplerInfo, message.flags, message.userData);
-    if (sampler != VK_NULL_HANDLE)
+    image_data.view = createImageView(image_data.entity, image_handle, message.viewInfo, message.flags);
+    if (image_data.view == VK_NULL_HANDLE)
     {
-        resourceRegistry.emplace<VkSampler>(new_entity, sampler);
+        message.reply->SetStatus(MessageReply::Status::Failed);
+        vmaDestroyImage(allocatorHandle, image_handle, image_data.allocation);
+        resourceRegistry.destroy(image_data.entity);
+        return;
     }
-    else
+
+    image_data.sampler = createSampler(image_data.entity, message.samplerInfo, message.flags, message.userData);
+    if (image_data.sampler == VK_NULL_HANDLE)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
-        resourceRegistry.destroy(new_entity);
+        vkDestroyImageView(device->vkHandle(), image_data.view, nullptr);
+        vmaDestroyImage(allocatorHandle, image_handle, image_data.allocation);
+        resourceRegistry.destroy(image_data.entity);
         return;
     }
 
+    const VkImageView image_view = image_data.view;
+    const VkSampler sampler = image_data.sampler;
+    const VkImageCreateInfo image_info = image_data.createInfo;
+    const uint32_t resource_handle = imageHandles.Insert(std::move(image_data));
+
     if (message.initialData.has_value())
     {
         message.reply->SetStatus(MessageReply::Status::Transferring);
         GraphicsResource createdResource
         {
             resource_type::CombinedImageSampler,
-            static_cast<uint32_t>(new_entity),
+            resource_handle,
             reinterpret_cast<uint64_t>(image_handle),
             reinterpret_cast<uint64_t>(image_view),
             reinterpret_cast<uint64_t>(sampler)
@@ -399,21 +460,21 @@ void ResourceContextImpl::processCreateCombinedImageSamplerMessage(CreateCombine
             TransferSystemReqImageInfo
             {
                 image_handle,
-                resourceRegistry.get<VkImageCreateInfo>(new_entity),
+                image_info,
                 message.resourceUsage,
                 message.flags
             },
             std::move(message.initialData.value()),
             std::move(message.reply)
         };
-        
+
         transferSystem.EnqueueTransfer(std::move(set_image_data_message));
     }
     else
     {
         message.reply->SetGraphicsResource(
             resource_type::CombinedImageSampler,
-            static_cast<uint32_t>(new_entity),
+            resource_handle,
             reinterpret_cast<uint64_t>(image_handle),
             reinterpret_cast<uint64_t>(image_view),
             reinterpret_cast<uint64_t>(sampler));
@@ -422,38 +483,37 @@ void ResourceContextImpl::processCreateCombinedImageSamplerMessage(CreateCombine
 
 void ResourceContextImpl::processCreateSamplerMessage(CreateSamplerMessage&& message)
 {
-    const entt::entity new_entity = resourceRegistry.create();
-    VkSampler sampler = createSampler(new_entity, message.samplerInfo, message.flags, message.userData);
-    if (sampler != VK_NULL_HANDLE)
+    if (samplerHandles.Full())
     {
-        resourceRegistry.emplace<VkSampler>(new_entity, sampler);
+        message.reply->SetStatus(MessageReply::Status::Failed);
+        return;
     }
-    else
+
+    SamplerResourceData sampler_data;
+    sampler_data.entity = resourceRegistry.create();
+    sampler_data.flags = message.flags;
+    sampler_data.sampler = createSampler(sampler_data.entity, message.samplerInfo, message.flags, message.userData);
+    if (sampler_data.sampler == VK_NULL_HANDLE)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
-        resourceRegistry.destroy(new_entity);
+        resourceRegistry.destroy(sampler_data.entity);
         return;
     }
 
+    const VkSampler sampler = sampler_data.sampler;
+    const uint32_t resource_handle = samplerHandles.Insert(std::move(sampler_data));
+
     message.reply->SetGraphicsResource(
         resource_type::Sampler,
-        static_cast<uint32_t>(new_entity),
+        resource_handle,
         0u, 0u, reinterpret_cast<uint64_t>(sampler));
 
 }
 
 void ResourceContextImpl::processSetBufferDataMessage(SetBufferDataMessage&& message)
 {
-    const GraphicsResource& buffer = message.destBuffer;
-    const entt::entity entity = entt::entity(buffer.EntityHandle);
-    if (!resourceRegistry.valid(entity))
-    {
-        message.reply->SetStatus(MessageReply::Status::Failed);
-        return;
-    }
-
-    auto[buffer_handle, buffer_info, buffer_flags] = resourceRegistry.try_get<VkBuffer, VkBufferCreateInfo, ResourceFlags>(entity);
-    if (!buffer_handle || !buffer_info || !buffer_flags)
+    const BufferResourceData* buffer_data = bufferHandles.TryGet(message.destBuffer.EntityHandle);
+    if (!buffer_data)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
@@ -463,13 +523,7 @@ void ResourceContextImpl::processSetBufferDataMessage(SetBufferDataMessage&& mes
 
     TransferSystemSetBufferDataMessage set_buffer_data_message
     {
-        TransferSystemReqBufferInfo
-        {
-            *buffer_handle,
-            *buffer_info,
-            buffer_flags->resourceUsage,
-            buffer_flags->flags
-        },
+        GetReqBufferInfo(*buffer_data),
         std::move(message.data),
         std::move(message.reply)
     };
@@ -479,16 +533,8 @@ void ResourceContextImpl::processSetBufferDataMessage(SetBufferDataMessage&& mes
 
 void ResourceContextImpl::processSetImageDataMessage(SetImageDataMessage&& message)
 {
-    const GraphicsResource& image = message.destImage;
-    const entt::entity entity = entt::entity(image.EntityHandle);
-    if (!resourceRegistry.valid(entity))
-    {
-        message.reply->SetStatus(MessageReply::Status::Failed);
-        return;
-    }
-
-    auto [image_handle, image_info, image_flags] = resourceRegistry.try_get<VkImage, VkImageCreateInfo, ResourceFlags>(entity);
-    if (!image_handle || !image_info || !image_flags)
+    const ImageResourceData* image_data = imageHandles.TryGet(message.destImage.EntityHandle);
+    if (!image_data)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
@@ -498,13 +544,7 @@ void ResourceContextImpl::processSetImageDataMessage(SetImageDataMessage&& messa
 
     TransferSystemSetImageDataMessage set_image_data_message
     {
-        TransferSystemReqImageInfo
-        {
-            *image_handle,
-            *image_info,
-            image_flags->resourceUsage,
-            image_flags->flags
-        },
+        GetReqImageInfo(*image_data),
         std::move(message.data),
         std::move(message.reply)
     };
@@ -514,16 +554,8 @@ void ResourceContextImpl::processSetImageDataMessage(SetImageDataMessage&& messa
 
 void ResourceContextImpl::processFillResourceMessage(FillResourceMessage&& message)
 {
-    const GraphicsResource& buffer = message.resource;
-    const entt::entity entity = entt::entity(buffer.EntityHandle);
-    if (!resourceRegistry.valid(entity))
-    {
-        message.reply->SetStatus(MessageReply::Status::Failed);
-        return;
-    }
-
-    auto[ buffer_handle, buffer_info, buffer_flags ] = resourceRegistry.try_get<VkBuffer, VkBufferCreateInfo, ResourceFlags>(entity);
-    if (!buffer_handle || !buffer_info || !buffer_flags)
+    const BufferResourceData* buffer_data = bufferHandles.TryGet(message.resource.EntityHandle);
+    if (!buffer_data)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
@@ -533,13 +565,7 @@ void ResourceContextImpl::processFillResourceMessage(FillResourceMessage&& messa
 
     TransferSystemFillBufferMessage fill_buffer_message
     {
-        TransferSystemReqBufferInfo
-        {
-            *buffer_handle,
-            *buffer_info,
-            buffer_flags->resourceUsage,
-            buffer_flags->flags
-        },
+        GetReqBufferInfo(*buffer_data),
         message.value,
         message.offset,
         message.size,
@@ -552,39 +578,31 @@ void ResourceContextImpl::processFillResourceMessage(FillResourceMessage&& messa
 
 void ResourceContextImpl::processMapResourceMessage(MapResourceMessage&& message)
 {
-    const entt::entity entity = entt::entity(message.resource.EntityHandle);
-    if (!resourceRegistry.valid(entity))
-    {
-        message.reply->SetStatus(MessageReply::Status::Failed);
-        return;
-    }
-
-    auto[ buffer_handle, allocation_info, allocation_handle, buffer_flags ] =
-        resourceRegistry.try_get<VkBuffer, VmaAllocationInfo, VmaAllocation, ResourceFlags>(entity);
-    if (!buffer_handle || !allocation_info || !allocation_handle || !buffer_flags)
+    const BufferResourceData* buffer_data = bufferHandles.TryGet(message.resource.EntityHandle);
+    if (!buffer_data)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
     }
 
-    // sanity check - is the VkBuffer in the resource the same as the one in the registry?
+    // sanity check - is the VkBuffer in the resource the same as the one in the table?
     const GraphicsResource& buffer = message.resource;
-    if (buffer.VkHandle != reinterpret_cast<uint64_t>(*buffer_handle))
+    if (buffer.VkHandle != reinterpret_cast<uint64_t>(buffer_data->buffer))
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
     }
-    
+
     // now check for some easy stuff - is this persistently mapped or created mapped? if so, yay we can just use that pointer!
     // (so lang as it's set, if not then oops things are broken, go home etc)
-    if (((buffer_flags->flags & resource_creation_flag_bits::PersistentlyMapped) ||
-         (buffer_flags->flags & resource_creation_flag_bits::CreateMapped)) &&
-         allocation_info->pMappedData)
+    if (((buffer_data->flags & resource_creation_flag_bits::PersistentlyMapped) ||
+         (buffer_data->flags & resource_creation_flag_bits::CreateMapped)) &&
+         buffer_data->mappedData)
     {
-        message.reply->SetPointer(allocation_info->pMappedData);
+        message.reply->SetPointer(buffer_data->mappedData);
         return;
     }
-    else if ((buffer_flags->flags & resource_creation_flag_bits::PersistentlyMapped) && !allocation_info->pMappedData)
+    else if ((buffer_data->flags & resource_creation_flag_bits::PersistentlyMapped) && !buffer_data->mappedData)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
@@ -592,50 +610,41 @@ void ResourceContextImpl::processMapResourceMessage(MapResourceMessage&& message
 
     // otherwise, we need to get a pointer to the buffer
     void* mapped_pointer = nullptr;
-    VkResult result = vmaMapMemory(allocatorHandle, *allocation_handle, &mapped_pointer);
+    VkResult result = vmaMapMemory(allocatorHandle, buffer_data->allocation, &mapped_pointer);
     VkAssert(result);
-    
+
     message.reply->SetPointer(mapped_pointer);
 }
 
 void ResourceContextImpl::processUnmapResourceMessage(UnmapResourceMessage&& message)
 {
-    const entt::entity entity = entt::entity(message.resource.EntityHandle);
-    if (!resourceRegistry.valid(entity))
+    const BufferResourceData* buffer_data = bufferHandles.TryGet(message.resource.EntityHandle);
+    if (!buffer_data)
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
     }
 
-    auto[ buffer_handle, allocation_info, allocation_handle, buffer_flags ] =
-        resourceRegistry.try_get<VkBuffer, VmaAllocationInfo, VmaAllocation, ResourceFlags>(entity);
-    if (!buffer_handle || !allocation_info || !allocation_handle || !buffer_flags)
-    {
-        message.reply->SetStatus(MessageReply::Status::Failed);
-        return;
-    }
-
-    if (message.resource.VkHandle != reinterpret_cast<uint64_t>(*buffer_handle))
+    if (message.resource.VkHandle != reinterpret_cast<uint64_t>(buffer_data->buffer))
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
     }
 
     // don't want to unmap something that's persistently mapped!
-    if (buffer_flags->flags & resource_creation_flag_bits::PersistentlyMapped)
+    if (buffer_data->flags & resource_creation_flag_bits::PersistentlyMapped)
     {
         message.reply->SetStatus(MessageReply::Status::Completed);
         return;
     }
 
-    vmaUnmapMemory(allocatorHandle, *allocation_handle);
+    vmaUnmapMemory(allocatorHandle, buffer_data->allocation);
 
 }
 
 void ResourceContextImpl::processCopyResourceMessage(CopyResourceMessage&& message)
 {
-    const entt::entity src_entity = entt::entity(message.sourceResource.EntityHandle);
-    if (!resourceRegistry.valid(src_entity))
+    if (!isLiveResource(message.sourceResource))
     {
         message.reply->SetStatus(MessageReply::Status::Failed);
         return;
@@ -663,31 +672,16 @@ void ResourceContextImpl::processCopyResourceMessage(CopyResourceMessage&& messa
 
 void ResourceContextImpl::processCopyResourceContentsMessage(CopyResourceContentsMessage&& message)
 {
-    // Verify both entities are valid
-    const entt::entity src_entity = entt::entity(message.sourceResource.EntityHandle);
-    const entt::entity dst_entity = entt::entity(message.destinationResource.EntityHandle);
-    if (!resourceRegistry.valid(src_entity) || !resourceRegistry.valid(dst_entity))
-    {
-        message.reply->SetStatus(MessageReply::Status::Failed);
-        return;
-    }
+    // Handle kinds are checked by the lookups themselves: an image handle never resolves in the buffer table
+    const uint32_t src_handle = message.sourceResource.EntityHandle;
+    const uint32_t dst_handle = message.destinationResource.EntityHandle;
 
     // Switch message type based on resource types involved
     if (message.sourceResource.Type == resource_type::Buffer && message.destinationResource.Type == resource_type::Buffer)
     {
-        auto[src_buffer_handle, src_buffer_info, src_buffer_flags] =
-            resourceRegistry.try_get<VkBuffer, VkBufferCreateInfo, ResourceFlags>(src_entity);
-
-        if (!src_buffer_handle || !src_buffer_info || !src_buffer_flags)
-        {
-            message.reply->SetStatus(MessageReply::Status::Failed);
-            return;
-        }
-
-        auto[dst_buffer_handle, dst_buffer_info, dst_buffer_flags] =
-            resourceRegistry.try_get<VkBuffer, VkBufferCreateInfo, ResourceFlags>(dst_entity);
-
-        if (!dst_buffer_handle || !dst_buffer_info || !dst_buffer_flags)
+        const BufferResourceData* src_buffer = bufferHandles.TryGet(src_handle);
+        const BufferResourceData* dst_buffer = bufferHandles.TryGet(dst_handle);
+        if (!src_buffer || !dst_buffer)
         {
             message.reply->SetStatus(MessageReply::Status::Failed);
             return;
@@ -695,20 +689,8 @@ void ResourceContextImpl::processCopyResourceContentsMessage(CopyResourceContent
 
         TransferSystemCopyBufferToBufferMessage copy_buffer_to_buffer_message
         {
-            TransferSystemReqBufferInfo
-            {
-                *src_buffer_handle,
-                *src_buffer_info,
-                src_buffer_flags->resourceUsage,
-                src_buffer_flags->flags
-            },
-            TransferSystemReqBufferInfo
-            {
-                *dst_buffer_handle,
-                *dst_buffer_info,
-                dst_buffer_flags->resourceUsage,
-                dst_buffer_flags->flags
-            },
+            GetReqBufferInfo(*src_buffer),
+            GetReqBufferInfo(*dst_buffer),
             std::move(message.reply)
         };
 
@@ -718,40 +700,18 @@ void ResourceContextImpl::processCopyResourceContentsMessage(CopyResourceContent
     }
     else if (message.sourceResource.Type == resource_type::Image && message.destinationResource.Type == resource_type::Image)
     {
-        auto[src_image_handle, src_image_info, src_image_flags] =
-            resourceRegistry.try_get<VkImage, VkImageCreateInfo, ResourceFlags>(src_entity);
-
-        if (!src_image_handle || !src_image_info || !src_image_flags)
+        const ImageResourceData* src_image = imageHandles.TryGet(src_handle);
+        const ImageResourceData* dst_image = imageHandles.TryGet(dst_handle);
+        if (!src_image || !dst_image)
         {
             message.reply->SetStatus(MessageReply::Status::Failed);
             return;
         }
 
-        auto[dst_image_handle, dst_image_info, dst_image_flags] =
-            resourceRegistry.try_get<VkImage, VkImageCreateInfo, ResourceFlags>(dst_entity);
-            
-        if (!dst_image_handle || !dst_image_info || !dst_image_flags)
-        {
-            message.reply->SetStatus(MessageReply::Status::Failed);
-            return;
-        }
-        
         TransferSystemCopyImageToImageMessage copy_image_to_image_message
         {
-            TransferSystemReqImageInfo
-            {
-                *src_image_handle,
-                *src_image_info,
-                src_image_flags->resourceUsage,
-                src_image_flags->flags
-            },
-            TransferSystemReqImageInfo
-            {
-                *dst_image_handle,  
-                *dst_image_info,
-                dst_image_flags->resourceUsage,
-                dst_image_flags->flags
-            },
+            GetReqImageInfo(*src_image),
+            GetReqImageInfo(*dst_image),
             std::move(message.reply)
         };
 
@@ -761,83 +721,39 @@ void ResourceContextImpl::processCopyResourceContentsMessage(CopyResourceContent
     }
     else if (message.sourceResource.Type == resource_type::Buffer && message.destinationResource.Type == resource_type::Image)
     {
-        auto[src_buffer_handle, src_buffer_info, src_buffer_flags] =
-            resourceRegistry.try_get<VkBuffer, VkBufferCreateInfo, ResourceFlags>(src_entity);
-
-        if (!src_buffer_handle || !src_buffer_info || !src_buffer_flags)
+        const BufferResourceData* src_buffer = bufferHandles.TryGet(src_handle);
+        const ImageResourceData* dst_image = imageHandles.TryGet(dst_handle);
+        if (!src_buffer || !dst_image)
         {
             message.reply->SetStatus(MessageReply::Status::Failed);
             return;
         }
 
-        auto[dst_image_handle, dst_image_info, dst_image_flags] =
-            resourceRegistry.try_get<VkImage, VkImageCreateInfo, ResourceFlags>(dst_entity);
-
-        if (!dst_image_handle || !dst_image_info || !dst_image_flags)
-        {
-            message.reply->SetStatus(MessageReply::Status::Failed);
-            return;
-        }
-        
         TransferSystemCopyBufferToImageMessage copy_buffer_to_image_message
         {
-            TransferSystemReqBufferInfo
-            {
-                *src_buffer_handle,
-                *src_buffer_info,
-                src_buffer_flags->resourceUsage,
-                src_buffer_flags->flags
-            },
-            TransferSystemReqImageInfo
-            {
-                *dst_image_handle,
-                *dst_image_info,
-                dst_image_flags->resourceUsage,
-                dst_image_flags->flags
-            },
+            GetReqBufferInfo(*src_buffer),
+            GetReqImageInfo(*dst_image),
             std::move(message.reply)
         };
-        
+
         copy_buffer_to_image_message.reply->SetStatus(MessageReply::Status::Transferring);
         transferSystem.EnqueueTransfer(std::move(copy_buffer_to_image_message));
         return;
     }
     else if (message.sourceResource.Type == resource_type::Image && message.destinationResource.Type == resource_type::Buffer)
     {
-        auto[src_image_handle, src_image_info, src_image_flags] =
-            resourceRegistry.try_get<VkImage, VkImageCreateInfo, ResourceFlags>(src_entity);
-
-        if (!src_image_handle || !src_image_info || !src_image_flags)
+        const ImageResourceData* src_image = imageHandles.TryGet(src_handle);
+        const BufferResourceData* dst_buffer = bufferHandles.TryGet(dst_handle);
+        if (!src_image || !dst_buffer)
         {
             message.reply->SetStatus(MessageReply::Status::Failed);
             return;
         }
 
-        auto[dst_buffer_handle, dst_buffer_info, dst_buffer_flags] =
-            resourceRegistry.try_get<VkBuffer, VkBufferCreateInfo, ResourceFlags>(dst_entity);
-
-        if (!dst_buffer_handle || !dst_buffer_info || !dst_buffer_flags)
-        {
-            message.reply->SetStatus(MessageReply::Status::Failed);
-            return;
-        }
-        
         TransferSystemCopyImageToBufferMessage copy_image_to_buffer_message
         {
-            TransferSystemReqImageInfo
-            {
-                *src_image_handle,
-                *src_image_info,
-                src_image_flags->resourceUsage,
-                src_image_flags->flags
-            },
-            TransferSystemReqBufferInfo
-            {
-                *dst_buffer_handle,
-                *dst_buffer_info,
-                dst_buffer_flags->resourceUsage,
-                dst_buffer_flags->flags
-            },
+            GetReqImageInfo(*src_image),
+            GetReqBufferInfo(*dst_buffer),
             std::move(message.reply)
         };
 
@@ -852,83 +768,142 @@ void ResourceContextImpl::processCopyResourceContentsMessage(CopyResourceContent
 
 void ResourceContextImpl::processDestroyResourceMessage(DestroyResourceMessage&& message)
 {
-    const entt::entity entity = entt::entity(message.resource.EntityHandle);
-    if (!resourceRegistry.valid(entity))
-    {
-        message.reply->SetStatus(MessageReply::Status::Failed);
-        return;
-    }
-    
+    const GraphicsResource& resource = message.resource;
     MessageReply::Status destroy_vk_handle_status = MessageReply::Status::Completed;
-    switch (message.resource.Type)
+    entt::entity entity = entt::null;
+
+    switch (resource.Type)
     {
     case resource_type::Buffer:
-        destroy_vk_handle_status = destroyBuffer(entity, message.resource);
-        if ((VkBufferView)message.resource.VkViewHandle != VK_NULL_HANDLE)
+        [[fallthrough]];
+    case resource_type::BufferView:
+    {
+        BufferResourceData* buffer_data = bufferHandles.TryGet(resource.EntityHandle);
+        if (!buffer_data)
         {
-            destroy_vk_handle_status = destroyBufferView(entity, message.resource);
+            message.reply->SetStatus(MessageReply::Status::Failed);
+            return;
         }
-        break;
-    case resource_type::BufferView:
-        destroy_vk_handle_status = destroyBufferView(entity, message.resource);
-        break;
-    case resource_type::Image:
-        destroy_vk_handle_status = destroyImage(entity, message.resource);
-        if ((VkImageView)message.resource.VkViewHandle != VK_NULL_HANDLE)
+
+        if ((VkBufferView)resource.VkViewHandle != VK_NULL_HANDLE)
+        {
+            destroy_vk_handle_status = destroyBufferView(*buffer_data, resource);
+        }
+
+        // Destroying just the view leaves the buffer it was made from alive
+        if (resource.Type == resource_type::BufferView)
+        {
+            message.reply->SetStatus(destroy_vk_handle_status);
+            return;
+        }
+
+        if (destroyBuffer(*buffer_data, resource) != MessageReply::Status::Completed)
         {
-            destroy_vk_handle_status = destroyImageView(entity, message.resource);
+            destroy_vk_handle_status = MessageReply::Status::Failed;
         }
+        entity = buffer_data->entity;
+        bufferHandles.Erase(resource.EntityHandle);
         break;
+    }
+    case resource_type::Image:
+        [[fallthrough]];
     case resource_type::ImageView:
-        destroy_vk_handle_status = destroyImageView(entity, message.resource);
+        [[fallthrough]];
+    case resource_type::CombinedImageSampler:
+    {
+        ImageResourceData* image_data = imageHandles.TryGet(resource.EntityHandle);
+        if (!image_data)
+        {
+            message.reply->SetStatus(MessageReply::Status::Failed);
+            return;
+        }
+
+        if ((VkImageView)resource.VkViewHandle != VK_NULL_HANDLE)
+        {
+            destroy_vk_handle_status = destroyImageView(*image_data, resource);
+        }
+
+        if (resource.Type == resource_type::ImageView)
+        {
+            message.reply->SetStatus(destroy_vk_handle_status);
+            return;
+        }
+
+        if (resource.Type == resource_type::CombinedImageSampler && destroySampler(image_data->sampler, resource) != MessageReply::Status::Completed)
+        {
+            destroy_vk_handle_status = MessageReply::Status::Failed;
+        }
+
+        if (destroyImage(*image_data, resource) != MessageReply::Status::Completed)
+        {
+            destroy_vk_handle_status = MessageReply::Status::Failed;
+        }
+        entity = image_data->entity;
+        imageHandles.Erase(resource.EntityHandle);
         break;
+    }
     case resource_type::Sampler:
-        destroy_vk_handle_status = destroySampler(entity, message.resource);
-        break;
-    case resource_type::CombinedImageSampler:
-        destroy_vk_handle_status = destroyCombinedImageSampler(entity, message.resource);
+    {
+        SamplerResourceData* sampler_data = samplerHandles.TryGet(resource.EntityHandle);
+        if (!sampler_data)
+        {
+            message.reply->SetStatus(MessageReply::Status::Failed);
+            return;
+        }
+
+        destroy_vk_handle_status = destroySampler(sampler_data->sampler, resource);
+        entity = sampler_data->entity;
+        samplerHandles.Erase(resource.EntityHandle);
         break;
+    }
     default:
         message.reply->SetStatus(MessageReply::Status::Failed);
-        resourceRegistry.destroy(entity); 
         return;
     }
 
     message.reply->SetStatus(destroy_vk_handle_status);
-    // even if things failed, we still want to destroy the entity
-    resourceRegistry.destroy(entity);
+    // even if things failed, the handle is gone now: drop the cold data too
+    if (resourceRegistry.valid(entity))
+    {
+        resourceRegistry.destroy(entity);
+    }
 }
 
-VkBuffer ResourceContextImpl::createBuffer(
-    entt::entity new_entity,
-    VkBufferCreateInfo&& buffer_info,
-    const resource_creation_flags _flags,
-    const resource_usage _resource_usage,
-    void* user_data_ptr,
-    bool has_initial_data)
+bool ResourceContextImpl::isLiveResource(const GraphicsResource& resource) const noexcept
 {
-    VkBufferCreateInfo& buffer_create_info = resourceRegistry.emplace<VkBufferCreateInfo>(new_entity, std::move(buffer_info)); 
-    const ResourceFlags& flags = resourceRegistry.emplace<ResourceFlags>(new_entity, resource_type::Buffer, _flags, _resource_usage);
+    switch (GetResourceHandleKind(resource.EntityHandle))
+    {
+    case resource_handle_kind::Buffer:
+        return bufferHandles.TryGet(resource.EntityHandle) != nullptr;
+    case resource_handle_kind::Image:
+        return imageHandles.TryGet(resource.EntityHandle) != nullptr;
+    case resource_handle_kind::Sampler:
+        return samplerHandles.TryGet(resource.EntityHandle) != nullptr;
+    default:
+        return false;
+    }
+}
+
+VkBuffer ResourceContextImpl::createBuffer(BufferResourceData& buffer_data, void* user_data_ptr, bool has_initial_data)
+{
+    VkBufferCreateInfo& buffer_create_info = buffer_data.createInfo;
     std::string debug_name;
-    if (flags.flags & resource_creation_flag_bits::UserDataAsString)
+    if (buffer_data.flags & resource_creation_flag_bits::UserDataAsString)
     {
         // working with value instead of ref fine because we're just gonna read it for the debug name setting in a sec
         // don't use macro yet because that contains timestamp info!
-        debug_name = resourceRegistry.emplace<std::string>(new_entity, std::string(reinterpret_cast<const char*>(user_data_ptr)));
+        debug_name = resourceRegistry.emplace<std::string>(buffer_data.entity, std::string(reinterpret_cast<const char*>(user_data_ptr)));
     }
 
-    VmaAllocationInfo& alloc_info = resourceRegistry.emplace<VmaAllocationInfo>(new_entity);
-    VmaAllocation& alloc = resourceRegistry.emplace<VmaAllocation>(new_entity);
-
-    if ((flags.resourceUsage == resource_usage::CPUToGPU || flags.resourceUsage == resource_usage::GPUToCPU || flags.resourceUsage == resource_usage::GPUOnly) && has_initial_data)
+    if ((buffer_data.resourceUsage == resource_usage::CPUToGPU || buffer_data.resourceUsage == resource_usage::GPUToCPU || buffer_data.resourceUsage == resource_usage::GPUOnly) && has_initial_data)
     {
         buffer_create_info.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
     }
 
     VmaAllocationCreateInfo alloc_create_info
     {
-        GetAllocationCreateFlags(flags.flags),
-        GetVmaMemoryUsage(flags.resourceUsage),
+        GetAllocationCreateFlags(buffer_data.flags),
+        GetVmaMemoryUsage(buffer_data.resourceUsage),
         0u,
         0u,
         UINT32_MAX,
@@ -936,19 +911,22 @@ VkBuffer ResourceContextImpl::createBuffer(
         user_data_ptr
     };
 
+    VmaAllocationInfo alloc_info{};
     VkBuffer buffer_handle = VK_NULL_HANDLE;
-    VkResult result = vmaCreateBuffer(allocatorHandle, &buffer_create_info, &alloc_create_info, &buffer_handle, &alloc, &alloc_info);
+    VkResult result = vmaCreateBuffer(allocatorHandle, &buffer_create_info, &alloc_create_info, &buffer_handle, &buffer_data.allocation, &alloc_info);
     VkAssert(result);
-    
+    buffer_data.buffer = buffer_handle;
+    buffer_data.mappedData = alloc_info.pMappedData;
+
     if constexpr (RENDERING_CONTEXT_USE_DEBUG_INFO && RENDERING_CONTEXT_VALIDATION_ENABLED)
     {
-        if (flags.flags & resource_creation_flag_bits::UserDataAsString)
+        if (buffer_data.flags & resource_creation_flag_bits::UserDataAsString)
         {
             const char* debugName = RENDERING_CONTEXT_DEBUG_OBJECT_NAME(debug_name.c_str());
             std::string debugAllocName = std::format("{}_allocation", debugName);
             result = RenderingContext::SetObjectName(VK_OBJECT_TYPE_BUFFER, reinterpret_cast<uint64_t>(buffer_handle), RENDERING_CONTEXT_DEBUG_OBJECT_NAME(debug_name.c_str()));
             VkAssert(result);
-            vmaSetAllocationName(allocatorHandle, alloc, debugAllocName.c_str());
+            vmaSetAllocationName(allocatorHandle, buffer_data.allocation, debugAllocName.c_str());
         }
     }
 
@@ -966,8 +944,6 @@ VkBufferView ResourceContextImpl::createBufferView(
     VkResult result = vkCreateBufferView(device->vkHandle(), &local_view_info, nullptr, &buffer_view);
     VkAssert(result);
 
-    resourceRegistry.emplace<VkBufferView>(new_entity, buffer_view);
-
     if constexpr (RENDERING_CONTEXT_USE_DEBUG_INFO && RENDERING_CONTEXT_VALIDATION_ENABLED)
     {
         if (_flags & resource_creation_flag_bits::UserDataAsString)
@@ -981,24 +957,21 @@ VkBufferView ResourceContextImpl::createBufferView(
     return buffer_view;
 }
 
-void ResourceContextImpl::setBufferDataHostOnly(entt::entity new_entity, InternalResourceDataContainer& dataContainer)
+void ResourceContextImpl::setBufferDataHostOnly(const BufferResourceData& buffer_data, InternalResourceDataContainer& dataContainer)
 {
-    const VmaAllocationInfo& alloc_info = resourceRegistry.get<VmaAllocationInfo>(new_entity);
-    const VmaAllocation& alloc = resourceRegistry.get<VmaAllocation>(new_entity);
-
     void* mapped_address = nullptr;
-    if (alloc_info.pMappedData)
+    if (buffer_data.mappedData)
     {
-        mapped_address = alloc_info.pMappedData;
+        mapped_address = buffer_data.mappedData;
     }
     else
     {
-        VkResult result = vmaMapMemory(allocatorHandle, alloc, &mapped_address);
+        VkResult result = vmaMapMemory(allocatorHandle, buffer_data.allocation, &mapped_address);
         VkAssert(result);
     }
 
     InternalResourceDataContainer::BufferDataVector& dataVector = std::get<InternalResourceDataContainer::BufferDataVector>(dataContainer.DataVector);
-    
+
     size_t offset = 0u;
     for (size_t i = 0u; i < dataVector.size(); ++i)
     {
@@ -1007,40 +980,30 @@ void ResourceContextImpl::setBufferDataHostOnly(entt::entity new_entity, Interna
         offset += dataVector[i].size;
     }
 
-    vmaUnmapMemory(allocatorHandle, alloc);
-    vmaFlushAllocation(allocatorHandle, alloc, VK_WHOLE_SIZE, 0);
+    vmaUnmapMemory(allocatorHandle, buffer_data.allocation);
+    vmaFlushAllocation(allocatorHandle, buffer_data.allocation, VK_WHOLE_SIZE, 0);
     // free copied memory, finally
     dataVector.clear();
 }
 
-VkImage ResourceContextImpl::createImage(
-    entt::entity new_entity,
-    VkImageCreateInfo&& image_info,
-    const resource_creation_flags _flags,
-    const resource_usage _resource_usage,
-    void* user_data_ptr,
-    bool has_initial_data)
+VkImage ResourceContextImpl::createImage(ImageResourceData& image_data, void* user_data_ptr, bool has_initial_data)
 {
-    VkImageCreateInfo& image_create_info = resourceRegistry.emplace<VkImageCreateInfo>(new_entity, std::move(image_info));
-    const ResourceFlags& flags = resourceRegistry.emplace<ResourceFlags>(new_entity, resource_type::Image, _flags, _resource_usage);
+    VkImageCreateInfo& image_create_info = image_data.createInfo;
     std::string debug_name;
-    if (flags.flags & resource_creation_flag_bits::UserDataAsString)
+    if (image_data.flags & resource_creation_flag_bits::UserDataAsString)
     {
-        debug_name = resourceRegistry.emplace<std::string>(new_entity, reinterpret_cast<const char*>(user_data_ptr));
+        debug_name = resourceRegistry.emplace<std::string>(image_data.entity, reinterpret_cast<const char*>(user_data_ptr));
     }
 
-    VmaAllocationInfo& alloc_info = resourceRegistry.emplace<VmaAllocationInfo>(new_entity);
-    VmaAllocation& alloc = resourceRegistry.emplace<VmaAllocation>(new_entity);
-
-    if (!(image_create_info.usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) || (flags.resourceUsage != resource_usage::GPUOnly))
+    if (!(image_create_info.usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) || (image_data.resourceUsage != resource_usage::GPUOnly))
     {
         image_create_info.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
     }
 
     VmaAllocationCreateInfo alloc_create_info
     {
-        GetAllocationCreateFlags(flags.flags),
-        GetVmaMemoryUsage(flags.resourceUsage),
+        GetAllocationCreateFlags(image_data.flags),
+        GetVmaMemoryUsage(image_data.resourceUsage),
         0u,
         0u,
         UINT32_MAX,
@@ -1049,19 +1012,19 @@ VkImage ResourceContextImpl::createImage(
     };
 
     VkImage image_handle = VK_NULL_HANDLE;
-    VkResult result = vmaCreateImage(allocatorHandle, &image_create_info, &alloc_create_info, &image_handle, &alloc, &alloc_info);
-    resourceRegistry.emplace<VkImage>(new_entity, image_handle);
+    VkResult result = vmaCreateImage(allocatorHandle, &image_create_info, &alloc_create_info, &image_handle, &image_data.allocation, nullptr);
     VkAssert(result);
+    image_data.image = image_handle;
 
     if constexpr (RENDERING_CONTEXT_USE_DEBUG_INFO && RENDERING_CONTEXT_VALIDATION_ENABLED)
     {
-        if (flags.flags & resource_creation_flag_bits::UserDataAsString)
+        if (image_data.flags & resource_creation_flag_bits::UserDataAsString)
         {
             const char* debugName = RENDERING_CONTEXT_DEBUG_OBJECT_NAME(debug_name.c_str());
             std::string debugAllocationName = std::format("{}_allocation", debugName);
             result = RenderingContext::SetObjectName(VK_OBJECT_TYPE_IMAGE, reinterpret_cast<uint64_t>(image_handle), RENDERING_CONTEXT_DEBUG_OBJECT_NAME(debug_name.c_str()));
             VkAssert(result);
-            vmaSetAllocationName(allocatorHandle, alloc, debugAllocationName.c_str());
+            vmaSetAllocationName(allocatorHandle, image_data.allocation, debugAllocationName.c_str());
         }
     }
 
@@ -1070,11 +1033,11 @@ VkImage ResourceContextImpl::createImage(
 
 VkImageView ResourceContextImpl::createImageView(
     entt::entity new_entity,
+    VkImage image_handle,
     const VkImageViewCreateInfo& view_info,
     const resource_creation_flags resource_flags)
 {
     // need a valid parent image to attach to
-    VkImage image_handle = resourceRegistry.get<VkImage>(new_entity);
     if (!image_handle)
     {
         return VK_NULL_HANDLE;
@@ -1130,109 +1093,98 @@ VkSampler ResourceContextImpl::createSampler(
     return sampler;
 }
 
-MessageReply::Status ResourceContextImpl::destroyBuffer(entt::entity entity, GraphicsResource resource)
+MessageReply::Status ResourceContextImpl::destroyBuffer(BufferResourceData& buffer_data, const GraphicsResource& resource)
 {
-    VkBuffer local_buffer_handle = resourceRegistry.get<VkBuffer>(entity);
-    if (!local_buffer_handle)
+    if (!buffer_data.buffer)
     {
         return MessageReply::Status::Failed;
     }
 
-    if (local_buffer_handle != (VkBuffer)resource.VkHandle)
+    if (buffer_data.buffer != (VkBuffer)resource.VkHandle)
     {
         return MessageReply::Status::Failed;
     }
 
-    vkDestroyBuffer(device->vkHandle(), local_buffer_handle, nullptr);
-    resourceRegistry.replace<VkBuffer>(entity, VK_NULL_HANDLE);
+    vmaDestroyBuffer(allocatorHandle, buffer_data.buffer, buffer_data.allocation);
+    buffer_data.buffer = VK_NULL_HANDLE;
+    buffer_data.allocation = VK_NULL_HANDLE;
 
     return MessageReply::Status::Completed;
 }
 
-MessageReply::Status ResourceContextImpl::destroyImage(entt::entity entity, GraphicsResource resource)
+MessageReply::Status ResourceContextImpl::destroyImage(ImageResourceData& image_data, const GraphicsResource& resource)
 {
-    VkImage local_image_handle = resourceRegistry.get<VkImage>(entity);
-    if (!local_image_handle)
+    if (!image_data.image)
     {
         return MessageReply::Status::Failed;
     }
 
-    if (local_image_handle != (VkImage)resource.VkHandle)
+    if (image_data.image != (VkImage)resource.VkHandle)
     {
         return MessageReply::Status::Failed;
     }
 
-    vkDestroyImage(device->vkHandle(), local_image_handle, nullptr);
-    resourceRegistry.replace<VkImage>(entity, VK_NULL_HANDLE);
+    vmaDestroyImage(allocatorHandle, image_data.image, image_data.allocation);
+    image_data.image = VK_NULL_HANDLE;
+    image_data.allocation = VK_NULL_HANDLE;
 
     return MessageReply::Status::Completed;
 }
 
-MessageReply::Status ResourceContextImpl::destroySampler(entt::entity entity, GraphicsResource resource)
+MessageReply::Status ResourceContextImpl::destroySampler(VkSampler& sampler, const GraphicsResource& resource)
 {
-    VkSampler local_sampler_handle = resourceRegistry.get<VkSampler>(entity);
-    if (!local_sampler_handle)
+    if (!sampler)
     {
         return MessageReply::Status::Failed;
     }
 
-    if (local_sampler_handle != (VkSampler)resource.VkHandle)
+    if (sampler != (VkSampler)resource.VkSamplerHandle)
     {
         return MessageReply::Status::Failed;
     }
 
-    vkDestroySampler(device->vkHandle(), local_sampler_handle, nullptr);
-    resourceRegistry.replace<VkSampler>(entity, VK_NULL_HANDLE);
+    vkDestroySampler(device->vkHandle(), sampler, nullptr);
+    sampler = VK_NULL_HANDLE;
 
     return MessageReply::Status::Completed;
 }
 
-MessageReply::Status ResourceContextImpl::destroyBufferView(entt::entity entity, GraphicsResource resource)
+MessageReply::Status ResourceContextImpl::destroyBufferView(BufferResourceData& buffer_data, const GraphicsResource& resource)
 {
-    VkBufferView local_buffer_view_handle = resourceRegistry.get<VkBufferView>(entity);
-    if (!local_buffer_view_handle)
+    if (!buffer_data.view)
     {
         return MessageReply::Status::Failed;
     }
 
-    if ((VkBufferView)resource.VkViewHandle != local_buffer_view_handle)
+    if ((VkBufferView)resource.VkViewHandle != buffer_data.view)
     {
         return MessageReply::Status::Failed;
     }
 
-    vkDestroyBufferView(device->vkHandle(), local_buffer_view_handle, nullptr);
-    resourceRegistry.replace<VkBufferView>(entity, VK_NULL_HANDLE);
+    vkDestroyBufferView(device->vkHandle(), buffer_data.view, nullptr);
+    buffer_data.view = VK_NULL_HANDLE;
 
     return MessageReply::Status::Completed;
 }
 
-MessageReply::Status ResourceContextImpl::destroyImageView(entt::entity entity, GraphicsResource resource)
+MessageReply::Status ResourceContextImpl::destroyImageView(ImageResourceData& image_data, const GraphicsResource& resource)
 {
-    VkImageView local_image_view_handle = resourceRegistry.get<VkImageView>(entity);
-    if (!local_image_view_handle)
+    if (!image_data.view)
     {
         return MessageReply::Status::Failed;
     }
 
-    if ((VkImageView)resource.VkViewHandle != local_image_view_handle)
+    if ((VkImageView)resource.VkViewHandle != image_data.view)
     {
         return MessageReply::Status::Failed;
     }
 
-    vkDestroyImageView(device->vkHandle(), local_image_view_handle, nullptr);
-    resourceRegistry.replace<VkImageView>(entity, VK_NULL_HANDLE);
+    vkDestroyImageView(device->vkHandle(), image_data.view, nullptr);
+    image_data.view = VK_NULL_HANDLE;
 
     return MessageReply::Status::Completed;
 }
 
-MessageReply::Status ResourceContextImpl::destroyCombinedImageSampler(entt::entity entity, GraphicsResource resource)
-{
-    destroyImage(entity, resource);
-    destroyImageView(entity, resource);
-    destroySampler(entity, resource);
-    return MessageReply::Status::Completed;
-}
-
 void ResourceContextImpl::writeStatsJsonFile(const char* output_file)
 {
     char* output;
@@ -1334,4 +1286,14 @@ namespace
         }
     }
 
+    TransferSystemReqBufferInfo GetReqBufferInfo(const BufferResourceData& buffer_data) noexcept
+    {
+        return TransferSystemReqBufferInfo{ buffer_data.buffer, buffer_data.createInfo, buffer_data.resourceUsage, buffer_data.flags };
+    }
+
+    TransferSystemReqImageInfo GetReqImageInfo(const ImageResourceData& image_data) noexcept
+    {
+        return TransferSystemReqImageInfo{ image_data.image, image_data.createInfo, image_data.resourceUsage, image_data.flags };
+    }
+
 }
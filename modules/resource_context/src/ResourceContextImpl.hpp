@@ -4,6 +4,7 @@
 #include "ResourceTypes.hpp"
 #include "ResourceMessageReply.hpp"
 #include "ResourceMessageTypesInternal.hpp"
+#include "ResourceHandleTable.hpp"
 #include "TransferSystem.hpp"
 #include "ResourceLoader.hpp"
 #include "LogicalDevice.hpp"
@@ -15,6 +16,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <unordered_set>
@@ -24,7 +26,7 @@
 #include <vulkan/vulkan_core.h>
 #include <vk_mem_alloc.h>
 #include <entt/entity/registry.hpp>
-#include "threading/ExponentialBackoffSleeper.hpp"
+#include "threading/HybridWaiter.hpp"
 
 struct ResourceContextCreateInfo;
 
@@ -38,18 +40,17 @@ public:
     void update();
 
     void pushMessage(ResourceMessagePayloadType message);
+
+    // Called on user/loader threads directly, not through the message queue
+    gpu_staging_reservation_t reserveStaging(size_t size);
+    void releaseStaging(gpu_staging_reservation_t& staging);
+    // Removes the reservation from the table, handing it to whatever is going to upload from it. Null if unknown.
+    std::shared_ptr<UploadBuffer> takeStaging(gpu_staging_reservation_t& staging);
     void setExitWorker();
     void startWorker();
 
 private:
 
-    struct ResourceFlags
-    {
-        resource_type type;
-        resource_creation_flags flags;
-        resource_usage resourceUsage;
-    };
-
     void processMessages();
 
     // I don't want to blow up the header implementing the above functions, so they're redeclared here explicitly to be implemented in the .cpp. Sorry :(
@@ -66,13 +67,11 @@ private:
     void processCopyResourceContentsMessage(CopyResourceContentsMessage&& message);
     void processDestroyResourceMessage(DestroyResourceMessage&& message);
 
-    VkBuffer createBuffer(
-        entt::entity new_entity,
-        VkBufferCreateInfo&& buffer_info,
-        const resource_creation_flags _flags,
-        const resource_usage _resource_usage,
-        void* user_data_ptr,
-        bool has_initial_data);
+    // Returns true if resource's handle still resolves in the table matching its kind
+    bool isLiveResource(const GraphicsResource& resource) const noexcept;
+
+    // create info, flags and usage are read from (and the resulting handles written to) the passed-in data
+    VkBuffer createBuffer(BufferResourceData& buffer_data, void* user_data_ptr, bool has_initial_data);
 
     VkBufferView createBufferView(
         entt::entity new_entity,
@@ -81,18 +80,13 @@ private:
         void* user_data_ptr);
 
     // in case of CPU-only buffers (e.g. UBOs and such) we just handle it in the resource context instead of the transfer system
-    void setBufferDataHostOnly(entt::entity new_entity, InternalResourceDataContainer& dataContainer);
+    void setBufferDataHostOnly(const BufferResourceData& buffer_data, InternalResourceDataContainer& dataContainer);
 
-    VkImage createImage(
-        entt::entity new_entity,
-        VkImageCreateInfo&& image_info,
-        const resource_creation_flags _flags,
-        const resource_usage _resource_usage,
-        void* user_data_ptr,
-        bool has_initial_data);
+    VkImage createImage(ImageResourceData& image_data, void* user_data_ptr, bool has_initial_data);
  
     VkImageView createImageView(
         entt::entity new_entity,
+        VkImage image_handle,
         const VkImageViewCreateInfo& view_info,
         const resource_creation_flags _flags);
 
@@ -102,23 +96,35 @@ private:
         const resource_creation_flags _flags,
         void* user_data_ptr);
 
-    MessageReply::Status destroyBuffer(entt::entity entity, GraphicsResource resource);
-    MessageReply::Status destroyImage(entt::entity entity, GraphicsResource resource);
-    MessageReply::Status destroySampler(entt::entity entity, GraphicsResource resource);
-    MessageReply::Status destroyBufferView(entt::entity entity, GraphicsResource resource);
-    MessageReply::Status destroyImageView(entt::entity entity, GraphicsResource resource);
-    MessageReply::Status destroyCombinedImageSampler(entt::entity entity, GraphicsResource resource);
+    MessageReply::Status destroyBuffer(BufferResourceData& buffer_data, const GraphicsResource& resource);
+    MessageReply::Status destroyImage(ImageResourceData& image_data, const GraphicsResource& resource);
+    MessageReply::Status destroySampler(VkSampler& sampler, const GraphicsResource& resource);
+    MessageReply::Status destroyBufferView(BufferResourceData& buffer_data, const GraphicsResource& resource);
+    MessageReply::Status destroyImageView(ImageResourceData& image_data, const GraphicsResource& resource);
 
     void writeStatsJsonFile(const char* output_file);
 
     mwsrQueue<ResourceMessagePayloadType> messageQueue;
     std::thread workerThread;
     std::atomic<bool> shouldExitWorker{ false };
+    // Messages are usually replied to by a waiting caller, so stay responsive: short spin, sub-ms first sleep
+    foundation::HybridWaiter messageWaiter{ foundation::HybridWaiterConfig{
+        std::chrono::microseconds(20), std::chrono::microseconds(100), std::chrono::microseconds(10000), 2.0f } };
 
     vpr::VkDebugUtilsFunctions vkDebugFns;
     VmaAllocator allocatorHandle{ VK_NULL_HANDLE };
-
-    // Primarily used to contain our info structures and allocation structures
+    // Separate from allocatorHandle (which only the worker touches, so skips VMA's locking) because
+    // staging is reserved from loader threads. Reservations are freed by the transfer system once uploaded.
+    VmaAllocator stagingAllocatorHandle{ VK_NULL_HANDLE };
+    std::mutex stagingMutex;
+    std::unordered_map<uint64_t, std::shared_ptr<UploadBuffer>> stagingReservations;
+    uint64_t nextStagingHandle{ 1u };
+
+    // Hot per-resource data, indexed by GraphicsResource::EntityHandle
+    BufferHandleTable bufferHandles;
+    ImageHandleTable imageHandles;
+    SamplerHandleTable samplerHandles;
+    // Cold data only: debug names and view/sampler create infos, keyed by the entity stored in each table slot
     entt::registry resourceRegistry;
     ResourceTransferSystem transferSystem;
 
@@ -0,0 +1,214 @@
+#pragma once
+#ifndef RESOURCE_CONTEXT_RESOURCE_HANDLE_TABLE_HPP
+#define RESOURCE_CONTEXT_RESOURCE_HANDLE_TABLE_HPP
+#include "ResourceTypes.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include <vk_mem_alloc.h>
+#include <entt/entity/entity.hpp>
+
+/*
+    Dense, generation-checked storage for the data every resource message needs (Vulkan handles,
+    allocation, create info, flags). GraphicsResource::EntityHandle holds a handle into one of these
+    tables, laid out as:
+
+        [ kind : 2 ][ generation : 10 ][ slot index : 20 ]
+
+    A lookup is then one indexed load plus a compare of the whole 32 bits against the handle stored in
+    the slot, which checks the kind (so an image handle can't be used as a buffer), the generation
+    (so a handle to a destroyed resource can't hit whatever reused its slot) and liveness at once.
+    The slot also records the resource's entt entity, where the cold data (debug names, view create
+    infos) still lives. A slot whose generation would wrap back to 0 is retired instead of reused, so
+    a stale handle can never match a live one, however long it's held on to.
+
+    Only touched from the resource context's worker thread, like the registry, so there's no locking.
+*/
+
+enum class resource_handle_kind : uint32_t
+{
+    Invalid = 0,
+    Buffer = 1,
+    Image = 2,
+    Sampler = 3
+};
+
+constexpr uint32_t ResourceHandleIndexBits = 20u;
+constexpr uint32_t ResourceHandleGenerationBits = 10u;
+constexpr uint32_t ResourceHandleIndexMask = (1u << ResourceHandleIndexBits) - 1u;
+constexpr uint32_t ResourceHandleGenerationMask = (1u << ResourceHandleGenerationBits) - 1u;
+// Highest index is never handed out, so no handle can ever equal entt::null (all ones)
+constexpr uint32_t MaxResourceHandleSlots = ResourceHandleIndexMask;
+
+[[nodiscard]] constexpr resource_handle_kind GetResourceHandleKind(const uint32_t handle) noexcept
+{
+    return static_cast<resource_handle_kind>(handle >> (ResourceHandleIndexBits + ResourceHandleGenerationBits));
+}
+
+struct BufferResourceData
+{
+    VkBuffer buffer{ VK_NULL_HANDLE };
+    VkBufferView view{ VK_NULL_HANDLE };
+    VmaAllocation allocation{ VK_NULL_HANDLE };
+    void* mappedData{ nullptr };
+    VkBufferCreateInfo createInfo{};
+    resource_creation_flags flags{ 0u };
+    resource_usage resourceUsage{ resource_usage::InvalidResourceUsage };
+    entt::entity entity{ entt::null };
+};
+
+// Images, and the image half of combined image samplers
+struct ImageResourceData
+{
+    VkImage image{ VK_NULL_HANDLE };
+    VkImageView view{ VK_NULL_HANDLE };
+    VkSampler sampler{ VK_NULL_HANDLE };
+    VmaAllocation allocation{ VK_NULL_HANDLE };
+    VkImageCreateInfo createInfo{};
+    resource_creation_flags flags{ 0u };
+    resource_usage resourceUsage{ resource_usage::InvalidResourceUsage };
+    entt::entity entity{ entt::null };
+};
+
+struct SamplerResourceData
+{
+    VkSampler sampler{ VK_NULL_HANDLE };
+    resource_creation_flags flags{ 0u };
+    entt::entity entity{ entt::null };
+};
+
+template<typename DataType, resource_handle_kind Kind>
+class ResourceHandleTable
+{
+    static_assert(Kind != resource_handle_kind::Invalid, "ResourceHandleTable needs a valid kind!");
+    static constexpr uint32_t kindBits = static_cast<uint32_t>(Kind) << (ResourceHandleIndexBits + ResourceHandleGenerationBits);
+    static constexpr uint32_t noFreeSlot = ~0u;
+public:
+
+    // Returns 0 if the table is full (no valid handle is ever 0, since the kind bits are non-zero)
+    [[nodiscard]] uint32_t Insert(DataType&& data)
+    {
+        uint32_t index = freeHead;
+        if (index != noFreeSlot)
+        {
+            freeHead = slots[index].nextFree;
+        }
+        else if (slots.size() < MaxResourceHandleSlots)
+        {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        else
+        {
+            return 0u;
+        }
+
+        slot_t& slot = slots[index];
+        slot.data = std::move(data);
+        slot.handle = kindBits | (slot.generation << ResourceHandleIndexBits) | index;
+        slot.nextFree = noFreeSlot;
+        ++liveCount;
+        return slot.handle;
+    }
+
+    [[nodiscard]] DataType* TryGet(const uint32_t handle) noexcept
+    {
+        const uint32_t index = handle & ResourceHandleIndexMask;
+        if (index < slots.size() && slots[index].handle == handle)
+        {
+            return &slots[index].data;
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] const DataType* TryGet(const uint32_t handle) const noexcept
+    {
+        return const_cast<ResourceHandleTable*>(this)->TryGet(handle);
+    }
+
+    // Invalidates every outstanding copy of handle. Returns false if it was already stale.
+    bool Erase(const uint32_t handle) noexcept
+    {
+        DataType* data = TryGet(handle);
+        if (data == nullptr)
+        {
+            return false;
+        }
+
+        const uint32_t index = handle & ResourceHandleIndexMask;
+        slot_t& slot = slots[index];
+        slot.data = DataType{};
+        slot.handle = 0u;
+        --liveCount;
+        if (slot.generation == ResourceHandleGenerationMask)
+        {
+            // Every generation has been handed out: left off the free list for good, costing one slot per 1024 reuses
+            ++retiredCount;
+            return true;
+        }
+        ++slot.generation;
+        slot.nextFree = freeHead;
+        freeHead = index;
+        return true;
+    }
+
+    template<typename Fn>
+    void ForEach(Fn&& fn)
+    {
+        for (slot_t& slot : slots)
+        {
+            if (slot.handle != 0u)
+            {
+                fn(slot.handle, slot.data);
+            }
+        }
+    }
+
+    void Clear() noexcept
+    {
+        slots.clear();
+        freeHead = noFreeSlot;
+        liveCount = 0u;
+        retiredCount = 0u;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept
+    {
+        return liveCount;
+    }
+
+    // Slots that have used up their generations and won't be handed out again
+    [[nodiscard]] size_t RetiredCount() const noexcept
+    {
+        return retiredCount;
+    }
+
+    [[nodiscard]] bool Full() const noexcept
+    {
+        return freeHead == noFreeSlot && slots.size() >= MaxResourceHandleSlots;
+    }
+
+private:
+
+    struct slot_t
+    {
+        DataType data{};
+        // Full handle while live, 0 while free
+        uint32_t handle{ 0u };
+        uint32_t generation{ 0u };
+        uint32_t nextFree{ noFreeSlot };
+    };
+
+    std::vector<slot_t> slots;
+    uint32_t freeHead{ noFreeSlot };
+    size_t liveCount{ 0u };
+    size_t retiredCount{ 0u };
+};
+
+using BufferHandleTable = ResourceHandleTable<BufferResourceData, resource_handle_kind::Buffer>;
+using ImageHandleTable = ResourceHandleTable<ImageResourceData, resource_handle_kind::Image>;
+using SamplerHandleTable = ResourceHandleTable<SamplerResourceData, resource_handle_kind::Sampler>;
+
+#endif //!RESOURCE_CONTEXT_RESOURCE_HANDLE_TABLE_HPP
@@ -1,8 +1,10 @@
 #include "ResourceLoader.hpp"
+#include "AssetPathIndex.hpp"
+#include "BatchFileReader.hpp"
+#include "MappedFile.hpp"
+#include "foundation/Profiler.hpp"
 #include <filesystem>
 #include <algorithm>
-#include <locale>
-#include <execution>
 #include <iostream>
 
 static std::mutex logMutex;
@@ -24,7 +26,18 @@ void ResourceLoader::Subscribe(const char* file_type, FactoryFunctor func, Delet
     {
         return;
     }
-    factories[file_type] = func;
+    factories[file_type] = factoryFunctions{ func, nullptr };
+    deleters[file_type] = del_fn;
+}
+
+void ResourceLoader::Subscribe(const char* file_type, SpanFactoryFunctor func, DeleteFunctor del_fn)
+{
+    std::lock_guard subscribeGuard(subscribeMutex);
+    if (factories.count(file_type) != 0 && deleters.count(file_type) != 0)
+    {
+        return;
+    }
+    factories[file_type] = factoryFunctions{ nullptr, func };
     deleters[file_type] = del_fn;
 }
 
@@ -33,23 +46,57 @@ void ResourceLoader::Unsubscribe(const char* file_type)
 
 }
 
-void ResourceLoader::Load(const char* file_type, const char* file_path, void* _requester, SignalFunctor signal, void* user_data)
+LoadCancellationToken LoadCancellationToken::Create()
 {
-    namespace fs = std::filesystem;
-    const std::string file_name{ file_path };
-    const uint64_t fileNameHash{ std::hash<std::string>()(file_name) };
+    LoadCancellationToken token;
+    token.cancelled = std::make_shared<std::atomic<bool>>(false);
+    return token;
+}
 
+void LoadCancellationToken::Cancel() noexcept
+{
+    if (cancelled)
     {
-        // Check to see if resource is already loaded
-        std::lock_guard pendingDataGuard(pendingDataMutex);
-        if (pendingResources.count(fileNameHash) != 0)
-        {
-            auto& listeners_vec = pendingResourceListeners[fileNameHash];
-            listeners_vec.emplace_back(_requester, user_data);
-            return;
-        }
+        cancelled->store(true, std::memory_order_release);
     }
+}
+
+bool LoadCancellationToken::IsCancelled() const noexcept
+{
+    return cancelled && cancelled->load(std::memory_order_acquire);
+}
+
+float ResourceLoader::PriorityFromDistance(const float distance) noexcept
+{
+    return 1.0f / (1.0f + std::max(distance, 0.0f));
+}
+
+float ResourceLoader::PriorityFromScreenCoverage(const float coverage) noexcept
+{
+    return std::clamp(coverage, 0.0f, 1.0f);
+}
+
+bool ResourceLoader::resourceKey::operator==(const resourceKey& other) const noexcept
+{
+    return Hash == other.Hash && FileName == other.FileName && FileType == other.FileType;
+}
+
+size_t ResourceLoader::resourceKeyHash::operator()(const resourceKey& key) const noexcept
+{
+    return static_cast<size_t>(key.Hash);
+}
+
+ResourceLoader::resourceKey ResourceLoader::makeResourceKey(const char* file_type, const char* file_name)
+{
+    resourceKey key{ 0u, file_type, file_name };
+    // the type's hash seeds the name's, so "a"/"b" and "b"/"a" don't collide
+    const uint64_t type_hash = foundation::FastHash(key.FileType.data(), key.FileType.size());
+    key.Hash = foundation::FastHash(key.FileName.data(), key.FileName.size(), type_hash);
+    return key;
+}
 
+LoadRequestID ResourceLoader::Load(const char* file_type, const char* file_path, void* _requester, SignalFunctor signal, void* user_data, float priority, LoadCancellationToken cancel_token)
+{
     if (factories.count(file_type) == 0)
     {
         throw std::domain_error("Tried to load resource type for which there is no factory!");
@@ -61,56 +108,19 @@ void ResourceLoader::Load(const char* file_type, const char* file_path, void* _r
     }
 
     ResourceData data;
-    data.FileType = file_type;
-    data.RefCount = 1;
-    data.FileName = file_name;
-    data.FileNameHash = fileNameHash;
-
-    if (fs::exists(file_name))
-    {
-        data.AbsoluteFilePath = fs::canonical(file_name).string();
-    }
+    data.Key = makeResourceKey(file_type, file_path);
 
     loadRequest req(data);
     req.requester = _requester;
     req.signal = signal;
     req.userData = user_data;
+    req.cancelToken = std::move(cancel_token);
 
-    if (resources.count(fileNameHash) != 0)
-    {
-        req.type = load_req_type::AlreadyLoaded;
-    }
-    else
-    {
-        std::lock_guard pendingResourcesGuard(pendingDataMutex);
-        req.type = load_req_type::FreshLoad;
-        pendingResources.emplace(fileNameHash);
-    }
-
-    {
-        std::unique_lock<std::recursive_mutex> guard(queueMutex);
-        requests.push_back(req);
-        guard.unlock();
-    }
-    cVar.notify_one();
+    return enqueueRequest(std::move(req), priority);
 }
 
-void ResourceLoader::Load(const char* file_type, const char* _file_name, const char* search_dir, void* _requester, SignalFunctor signal, void* user_data)
+LoadRequestID ResourceLoader::Load(const char* file_type, const char* _file_name, const char* search_dir, void* _requester, SignalFunctor signal, void* user_data, float priority, LoadCancellationToken cancel_token)
 {
-    namespace fs = std::filesystem;
-    const std::string file_name{ _file_name };
-    const uint64_t fileNameHash{ std::hash<std::string>()(file_name) };
-
-    {
-        // Check to see if resource is already queued for load
-        std::lock_guard pendingDataGuard(pendingDataMutex);
-        if (pendingResources.count(fileNameHash) != 0) {
-            auto& listeners_vec = pendingResourceListeners[fileNameHash];
-            listeners_vec.emplace_back(_requester, user_data);
-            return;
-        }
-    }
-
     if (factories.count(file_type) == 0)
     {
         throw std::domain_error("Tried to load resource type for which there is no factory!");
@@ -122,50 +132,45 @@ void ResourceLoader::Load(const char* file_type, const char* _file_name, const c
     }
 
     ResourceData data;
-    data.FileType = file_type;
-    data.RefCount = 1;
-    data.FileName = file_name;
-    data.FileNameHash = std::hash<std::string>()(data.FileName);
+    data.Key = makeResourceKey(file_type, _file_name);
     data.SearchDir = std::string(search_dir);
 
     loadRequest req(data);
     req.requester = _requester;
     req.signal = signal;
     req.userData = user_data;
+    req.cancelToken = std::move(cancel_token);
 
-    if (resources.count(fileNameHash) != 0)
-    {
-        req.type = load_req_type::AlreadyLoaded;
-    }
-    else
-    {
-        std::lock_guard pendingResourcesGuard(pendingDataMutex);
-        req.type = load_req_type::FreshLoad;
-        pendingResources.emplace(fileNameHash);
-    }
+    return enqueueRequest(std::move(req), priority);
+}
 
-    {
-        std::unique_lock<std::recursive_mutex> guard(queueMutex);
-        requests.push_back(req);
-        guard.unlock();
-    }
-    cVar.notify_one();
+bool ResourceLoader::Reprioritize(LoadRequestID request_id, float priority)
+{
+    std::lock_guard<std::recursive_mutex> guard(queueMutex);
+    return requests.update(request_id, priority);
 }
 
 void ResourceLoader::Unload(const char* file_type, const char* _path)
 {
-    namespace fs = std::filesystem;
+    const resourceKey key = makeResourceKey(file_type, _path);
 
-    uint64_t pathHash = std::hash<std::string>()(_path);
+    std::lock_guard<std::recursive_mutex> guard(pendingDataMutex);
+    if (auto iter = resources.find(key); iter != std::end(resources))
+    {
+        releaseResource(iter);
+    }
+}
 
-    std::lock_guard<std::recursive_mutex> guard(queueMutex);
-    if (auto iter = resources.find(pathHash); iter != std::end(resources))
+void ResourceLoader::releaseResource(resource_map::iterator iter)
+{
+    if (iter->second.RefCount != 0u)
     {
         --iter->second.RefCount;
-        if (iter->second.RefCount == 0)
-        {
-            deleters.at(iter->second.FileType)(iter->second.Data, nullptr);
-        }
+    }
+
+    if (iter->second.RefCount == 0u)
+    {
+        deleters.at(iter->second.Key.FileType)(iter->second.Data, nullptr);
         resources.erase(iter);
     }
 }
@@ -179,17 +184,6 @@ ResourceLoader& ResourceLoader::GetResourceLoader()
 std::string ResourceLoader::FindFile(const std::string& fname, const std::string& init_dir, const size_t depth)
 {
     namespace stdfs = std::filesystem;
-    static std::unordered_map<std::string, stdfs::path> foundPathsCache;
-    static std::mutex cacheMutex;
-
-    auto case_insensitive_comparison = [](const std::string & fname, const std::string & curr_entry)->bool
-    {
-
-        return std::equal(std::execution::par_unseq, fname.cbegin(), fname.cend(), curr_entry.cbegin(), curr_entry.cend(), [](const char a, const char b)
-            {
-                return std::tolower(a) == std::tolower(b);
-            });
-    };
 
     stdfs::path starting_path(stdfs::canonical(init_dir));
 
@@ -201,55 +195,28 @@ std::string ResourceLoader::FindFile(const std::string& fname, const std::string
         return file_name_path.string();
     }
 
-    {
-        std::lock_guard cacheGuard(cacheMutex);
-        auto iter = foundPathsCache.find(fname);
-        if (iter != foundPathsCache.end())
-        {
-            return iter->second.string();
-        }
-    }
-
-    stdfs::path file_path = starting_path;
+    stdfs::path search_root = starting_path;
 
     for (size_t i = 0; i < depth; ++i)
     {
-        file_path = file_path.parent_path();
-    }
-
-    for (auto& dir_entry : stdfs::recursive_directory_iterator(file_path))
-    {
-        if (dir_entry == starting_path)
-        {
-            continue;
-        }
-
-        if (!stdfs::is_regular_file(dir_entry) || stdfs::is_directory(dir_entry))
-        {
-            continue;
-        }
-
-        const stdfs::path entry_path(dir_entry);
-        const std::string curr_entry_str = entry_path.filename().string();
-
-        if (case_insensitive_comparison(fname, curr_entry_str))
-        {
-            std::lock_guard cacheGuard(cacheMutex);
-            auto iter = foundPathsCache.emplace(fname, entry_path);
-            return iter.first->second.string();
-        }
+        search_root = search_root.parent_path();
     }
 
-    return std::string();
+    // scanned once per root, after that it's a hash lookup: matches under init_dir itself are preferred
+    return AssetPathIndex::ForRoot(search_root).Find(file_name_path.string(), starting_path);
 }
 
 void ResourceLoader::Start()
 {
     shutdown = false;
 
-    for (auto& thr : workers)
+    if (workers.empty())
     {
-        thr = std::thread(&ResourceLoader::workerFunction, this);
+        const size_t worker_count = std::clamp<size_t>(std::thread::hardware_concurrency() / 2u, 2u, 8u);
+        for (size_t i = 0u; i < worker_count; ++i)
+        {
+            workers.emplace_back(&ResourceLoader::workerFunction, this);
+        }
     }
 
     cVar.notify_all();
@@ -264,97 +231,343 @@ void ResourceLoader::Stop()
     {
         thr.join();
     }
+    workers.clear();
 
 }
 
 void ResourceLoader::WaitForAllLoads()
 {
-    size_t counter = 0;
-    while (!requests.empty())
+    std::unique_lock<std::recursive_mutex> lock{ queueMutex };
+    idleCVar.wait(lock, [this]()->bool { return requests.empty() && readyLoads.empty() && activeLoads == 0u; });
+}
+
+LoadRequestID ResourceLoader::enqueueRequest(loadRequest&& request, const float priority)
+{
+    // lock order is always pendingDataMutex -> queueMutex
+    std::lock_guard pendingDataGuard(pendingDataMutex);
+    if (auto loaded = resources.find(request.destinationData.Key); loaded != resources.end())
+    {
+        // take the reference now, so an Unload() before a worker gets to this can't delete it
+        request.type = load_req_type::AlreadyLoaded;
+        ++loaded->second.RefCount;
+    }
+    else if (auto pending = pendingLoads.find(request.destinationData.Key); pending != pendingLoads.end())
     {
-        // every 100 loops, sleep for a millisecond so we don't just burn this core
-        if (counter % 100 == 0)
+        pending->second.listeners.emplace_back(pendingListener{ request.requester, request.signal, request.userData, std::move(request.cancelToken) });
+
+        // Whoever needs it soonest sets the priority for everyone waiting on it
+        std::lock_guard<std::recursive_mutex> queueGuard(queueMutex);
+        const LoadRequestID pending_id = pending->second.requestID;
+        if (const auto queued_priority = requests.priority(pending_id); queued_priority.has_value())
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (*queued_priority < priority)
+            {
+                requests.update(pending_id, priority);
+            }
+            return pending_id;
         }
+        // a worker already has it
+        return 0u;
+    }
+    else
+    {
+        request.type = load_req_type::FreshLoad;
+    }
+
+    const load_req_type type = request.type;
+    const resourceKey& key = request.destinationData.Key;
+    auto pending = type == load_req_type::FreshLoad ? pendingLoads.emplace(key, pendingLoad{}).first : pendingLoads.end();
+
+    LoadRequestID request_id = 0u;
+    {
+        std::unique_lock<std::recursive_mutex> guard(queueMutex);
+        request_id = requests.push(std::move(request), priority);
+        guard.unlock();
+    }
+
+    if (type == load_req_type::FreshLoad)
+    {
+        pending->second.requestID = request_id;
+    }
+    cVar.notify_one();
+
+    return request_id;
+}
+
+bool ResourceLoader::dropIfCancelled(const loadRequest& request)
+{
+    if (!request.cancelToken.IsCancelled())
+    {
+        return false;
+    }
 
-        ++counter;
+    std::lock_guard pendingDataGuard(pendingDataMutex);
+    if (auto iter = pendingLoads.find(request.destinationData.Key); iter != pendingLoads.end())
+    {
+        for (const auto& listener : iter->second.listeners)
+        {
+            if (!listener.cancelToken.IsCancelled())
+            {
+                return false;
+            }
+        }
+        // Nobody wants it anymore: forget about it, so a later Load() queues it afresh
+        pendingLoads.erase(iter);
     }
 
-    counter = 0;
+    return true;
 }
 
 void ResourceLoader::workerFunction()
 {
-    namespace fs = std::filesystem;
+    FOUNDATION_PROFILE_THREAD_NAME("ResourceLoader Worker");
+
+    // rings aren't shared, so each worker gets its own
+    BatchFileReader reader(batchQueueDepth);
+    const bool batch_reads = reader.Backend() == file_read_backend::IoUring;
 
     while (!shutdown)
     {
         std::unique_lock<std::recursive_mutex> lock{queueMutex};
-        cVar.wait(lock, [this]()->bool { return shutdown || !requests.empty(); });
+        cVar.wait(lock, [this]()->bool { return shutdown || !requests.empty() || !readyLoads.empty(); });
 
-        if (requests.empty())
+        if (requests.empty() && readyLoads.empty())
         {
             // get here when shutdown set true: we still want to finish out queued loads though
             return;
         }
 
-        loadRequest request = requests.front();
-        requests.pop_front();
-        FactoryFunctor factory_fn = factories.at(request.destinationData.FileType);
-        lock.unlock();
+        if (!readyLoads.empty())
+        {
+            readyLoad ready = std::move(readyLoads.pop().value());
+            factoryFunctions factory_fns = factories.at(ready.request.destinationData.Key.FileType);
+            lock.unlock();
+
+            processRequest(std::move(ready.request), factory_fns, ready.hasFileData ? &ready.fileData : nullptr);
+            finishLoad();
+            continue;
+        }
+
+        const float priority = requests.top_priority().value();
+        loadRequest request = std::move(requests.pop().value());
+        factoryFunctions factory_fns = factories.at(request.destinationData.Key.FileType);
 
-        if (!fs::exists(request.destinationData.FileName))
+        if (batch_reads && request.type == load_req_type::FreshLoad && factory_fns.spanFactory != nullptr)
         {
-            // Gotta find file path.
-            std::string found_path = FindFile(request.destinationData.FileName, request.destinationData.SearchDir, 2);
-            if (found_path.empty())
+            std::vector<loadRequest> batch;
+            std::vector<float> priorities;
+            batch.emplace_back(std::move(request));
+            priorities.emplace_back(priority);
+
+            // only what's at the front: anything further back is for a later batch (or another worker)
+            while (batch.size() < maxBatchSize && !requests.empty())
             {
-                std::lock_guard failMutex{ logMutex };
-                std::cerr << "Failed to load resource! File name was " << request.destinationData.FileName;
-                throw std::runtime_error("Failed to load resource!"); // how could we handle this without throwing?
+                const loadRequest* next = requests.top();
+                if (next->type != load_req_type::FreshLoad || factories.at(next->destinationData.Key.FileType).spanFactory == nullptr)
+                {
+                    break;
+                }
+                priorities.emplace_back(requests.top_priority().value());
+                batch.emplace_back(std::move(requests.pop().value()));
             }
-            request.destinationData.AbsoluteFilePath = std::move(found_path);
-            request.destinationData.SearchDir.clear();
-            request.destinationData.SearchDir.shrink_to_fit();
 
+            activeLoads += batch.size();
+            lock.unlock();
+
+            readBatch(reader, batch, priorities);
+            continue;
+        }
+
+        ++activeLoads;
+        lock.unlock();
+
+        processRequest(std::move(request), factory_fns);
+        finishLoad();
+    }
+}
+
+void ResourceLoader::readBatch(BatchFileReader& reader, std::vector<loadRequest>& batch, const std::vector<float>& priorities)
+{
+    FOUNDATION_PROFILE_ZONE_ARG("ResourceLoader::ReadBatch", static_cast<uint32_t>(batch.size()));
+
+    // indices into batch of the requests actually being read, in the order their paths were handed to the reader
+    std::vector<size_t> read_indices;
+    std::vector<const char*> paths;
+    read_indices.reserve(batch.size());
+    paths.reserve(batch.size());
+
+    for (size_t i = 0u; i < batch.size(); ++i)
+    {
+        if (dropIfCancelled(batch[i]))
+        {
+            finishLoad();
+            continue;
+        }
+
+        resolveFilePath(batch[i]);
+        read_indices.emplace_back(i);
+        paths.emplace_back(batch[i].destinationData.AbsoluteFilePath.c_str());
+    }
+
+    reader.ReadFiles(paths, [&](batch_read_result&& result)
+    {
+        const size_t index = read_indices[result.index];
+        readyLoad ready{ std::move(batch[index]), std::move(result.data), result.error == 0 };
+        {
+            std::lock_guard<std::recursive_mutex> guard(queueMutex);
+            readyLoads.push(std::move(ready), priorities[index]);
+        }
+        // an idle worker can start parsing this while the rest of the batch is still in flight
+        cVar.notify_one();
+    });
+}
+
+void ResourceLoader::finishLoad()
+{
+    std::lock_guard<std::recursive_mutex> guard(queueMutex);
+    --activeLoads;
+    if (requests.empty() && readyLoads.empty() && activeLoads == 0u)
+    {
+        idleCVar.notify_all();
+    }
+}
+
+void ResourceLoader::resolveFilePath(loadRequest& request)
+{
+    namespace fs = std::filesystem;
+
+    if (!request.destinationData.AbsoluteFilePath.empty())
+    {
+        return;
+    }
+
+    if (fs::exists(request.destinationData.Key.FileName))
+    {
+        request.destinationData.AbsoluteFilePath = fs::canonical(request.destinationData.Key.FileName).string();
+        return;
+    }
+
+    // Gotta find file path.
+    std::string found_path = FindFile(request.destinationData.Key.FileName, request.destinationData.SearchDir, 2);
+    if (found_path.empty())
+    {
+        std::lock_guard failMutex{ logMutex };
+        std::cerr << "Failed to load resource! File name was " << request.destinationData.Key.FileName;
+        throw std::runtime_error("Failed to load resource!"); // how could we handle this without throwing?
+    }
+    request.destinationData.AbsoluteFilePath = std::move(found_path);
+    request.destinationData.SearchDir.clear();
+    request.destinationData.SearchDir.shrink_to_fit();
+}
+
+void ResourceLoader::processRequest(loadRequest&& request, factoryFunctions factory_fns, const std::vector<std::byte>* file_data)
+{
+    if (request.type == load_req_type::AlreadyLoaded)
+    {
+        // just dispatch a signal: the reference was taken when this was queued, so the data outlives the lock
+        void* data = nullptr;
+        {
+            std::lock_guard pendingDataGuard(pendingDataMutex);
+            auto iter = resources.find(request.destinationData.Key);
+            if (request.cancelToken.IsCancelled())
+            {
+                releaseResource(iter);
+                return;
+            }
+            data = iter->second.Data;
         }
+        request.signal(request.requester, data, request.userData);
+        return;
+    }
+
+    if (request.type != load_req_type::FreshLoad || dropIfCancelled(request))
+    {
+        return;
+    }
 
-        if (request.type == load_req_type::FreshLoad)
+    FOUNDATION_PROFILE_ZONE("ResourceLoader::Load");
+
+    resolveFilePath(request);
+    request.destinationData.Data = invokeFactory(factory_fns, request.destinationData.AbsoluteFilePath.c_str(), request.userData, file_data);
+
+    // References are all taken under the lock, but signals run after it's released: they're user code, and
+    // may well call back into Load()/Unload() or block on something another worker is doing
+    std::vector<pendingSignal> signals;
+    void* abandoned_data = nullptr;
+    DeleteFunctor abandoned_deleter = nullptr;
+    {
+        // resources is shared between all the workers now, so it's guarded by the same lock as the pending data
+        std::lock_guard pendingDataGuard(pendingDataMutex);
+        auto pending = pendingLoads.find(request.destinationData.Key);
+        std::vector<pendingListener> listeners = std::move(pending->second.listeners);
+        pendingLoads.erase(pending);
+
+        auto iter = resources.emplace(request.destinationData.Key, std::move(request.destinationData)).first;
+        ResourceData& resource = iter->second;
+        resource.RefCount = 0u;
+        signals.reserve(listeners.size() + 1u);
+
+        // first requester first, then everyone who joined in the order they asked. Each one signalled holds a reference.
+        if (!request.cancelToken.IsCancelled())
         {
+            signals.emplace_back(pendingSignal{ request.signal, request.requester, resource.Data, request.userData });
+            ++resource.RefCount;
+        }
 
-            request.destinationData.Data = factory_fn(request.destinationData.AbsoluteFilePath.c_str(), request.userData);
-            auto iter = resources.emplace(request.destinationData.FileNameHash, std::move(request.destinationData));
-            void* data = iter.first->second.Data;
-            // signal first requester first
-            request.signal(request.requester, data, request.userData);
-            if (pendingResourceListeners.count(iter.first->first) != 0)
+        for (auto& listener : listeners)
+        {
+            if (!listener.cancelToken.IsCancelled())
             {
-                // we can use the same signal function on resources with same type string
-                std::unique_lock<std::recursive_mutex> pendingDataLock(pendingDataMutex);
-                auto& listeners_vec = pendingResourceListeners.at(iter.first->first);
-                while (!listeners_vec.empty())
-                {
-                    request.signal(listeners_vec.back().first, data, listeners_vec.back().second);
-                    // we couldn't increment this earlier because it didn't exist, so let's do so now
-                    ++iter.first->second.RefCount;
-                    listeners_vec.pop_back();
-                }
-                pendingResourceListeners.erase(iter.first->first);
-                // safe to unlock, signal function won't mutate object variables unsafely
-                pendingDataLock.unlock();
+                signals.emplace_back(pendingSignal{ listener.signal, listener.requester, resource.Data, listener.userData });
+                ++resource.RefCount;
             }
-            // call other dependent items
-            pendingResources.erase(iter.first->first);
         }
-        else if (request.type == load_req_type::AlreadyLoaded)
+
+        if (resource.RefCount == 0u)
         {
-            // just dispatch a signal
-            auto& data = resources.at(request.destinationData.FileNameHash);
-            request.signal(request.requester, data.Data, request.userData);
-            data.RefCount += 1;
+            // everyone gave up while it was loading
+            abandoned_data = resource.Data;
+            abandoned_deleter = deleters.at(resource.Key.FileType);
+            resources.erase(iter);
         }
     }
+
+    if (abandoned_deleter != nullptr)
+    {
+        abandoned_deleter(abandoned_data, nullptr);
+    }
+
+    for (const pendingSignal& pending_signal : signals)
+    {
+        pending_signal.signal(pending_signal.requester, pending_signal.data, pending_signal.userData);
+    }
+}
+
+void* ResourceLoader::invokeFactory(const factoryFunctions& factory_fns, const char* path, void* user_data, const std::vector<std::byte>* file_data)
+{
+    if (factory_fns.pathFactory)
+    {
+        return factory_fns.pathFactory(path, user_data);
+    }
+
+    if (file_data != nullptr)
+    {
+        // already read by a batch
+        FOUNDATION_PROFILE_ZONE_ARG("ResourceLoader::BatchedFactory", static_cast<uint32_t>(file_data->size()));
+        return factory_fns.spanFactory(path, std::span<const std::byte>(file_data->data(), file_data->size()), user_data);
+    }
+
+    // unmapped as soon as the factory returns: factories copy out whatever they keep
+    const MappedFile mapped_file(path);
+    if (!mapped_file.Valid())
+    {
+        std::lock_guard failMutex{ logMutex };
+        std::cerr << "Failed to map resource file " << path;
+        throw std::runtime_error("Failed to map resource file!");
+    }
+
+    FOUNDATION_PROFILE_ZONE_ARG("ResourceLoader::MappedFactory", static_cast<uint32_t>(mapped_file.Data().size()));
+    return factory_fns.spanFactory(path, mapped_file.Data(), user_data);
 }
 
 void ResourceLoader::waitForPendingRequest(const std::string & absolute_file_path, SignalFunctor signal) {
@@ -1,4 +1,45 @@
 #include "ResourceMessageTypesInternal.hpp"
+#include <cassert>
+
+namespace
+{
+    bool RegionInStaging(const void* data, const size_t data_size, const gpu_staging_reservation_t& staging) noexcept
+    {
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(staging.Data);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(data);
+        return address >= begin && address - begin <= staging.Size && data_size <= staging.Size - (address - begin);
+    }
+
+    template<typename RegionType>
+    bool RegionsInStaging(const size_t numData, const RegionType* data, const gpu_staging_reservation_t& staging) noexcept
+    {
+        for (size_t i = 0; i < numData; ++i)
+        {
+            if (!RegionInStaging(data[i].Data, data[i].DataSize, staging))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t GetStagingOffset(const void* data, const size_t data_size, const gpu_staging_reservation_t& staging) noexcept
+    {
+        // callers check RegionsInStaging() first
+        assert(RegionInStaging(data, data_size, staging));
+        return static_cast<size_t>(reinterpret_cast<uintptr_t>(data) - reinterpret_cast<uintptr_t>(staging.Data));
+    }
+}
+
+bool InternalResourceDataContainer::InStaging(size_t numData, const gpu_resource_data_t* data, const gpu_staging_reservation_t& staging) noexcept
+{
+    return RegionsInStaging(numData, data, staging);
+}
+
+bool InternalResourceDataContainer::InStaging(size_t numData, const gpu_image_resource_data_t* data, const gpu_staging_reservation_t& staging) noexcept
+{
+    return RegionsInStaging(numData, data, staging);
+}
 
 
 InternalResourceDataContainer::BufferData::BufferData(const gpu_resource_data_t& _data) :
@@ -12,7 +53,8 @@ InternalResourceDataContainer::BufferData::BufferData(const gpu_resource_data_t&
 InternalResourceDataContainer::BufferData::BufferData(BufferData&& other) noexcept :
     data{ std::move(other.data) },
     size{ other.size },
-    alignment{ other.alignment }
+    alignment{ other.alignment },
+    stagingOffset{ other.stagingOffset }
 {}
 
 InternalResourceDataContainer::BufferData::BufferData() noexcept : data{ nullptr }, size{ 0 }, alignment{ 0 }
@@ -27,6 +69,7 @@ InternalResourceDataContainer::InternalResourceDataContainer::BufferData& Intern
     data = std::move(other.data);
     size = other.size;
     alignment = other.alignment;
+    stagingOffset = other.stagingOffset;
     return *this;
 }
 
@@ -47,7 +90,8 @@ InternalResourceDataContainer::ImageData::ImageData(ImageData&& other) noexcept
     width{ other.width },
     height{ other.height },
     arrayLayer{ other.arrayLayer },
-    mipLevel{ other.mipLevel }
+    mipLevel{ other.mipLevel },
+    stagingOffset{ other.stagingOffset }
 {}
 
 InternalResourceDataContainer::ImageData::ImageData() noexcept :
@@ -71,6 +115,7 @@ InternalResourceDataContainer::InternalResourceDataContainer::ImageData& Interna
     height = other.height;
     arrayLayer = other.arrayLayer;
     mipLevel = other.mipLevel;
+    stagingOffset = other.stagingOffset;
     return *this;
 }
 
@@ -100,6 +145,35 @@ InternalResourceDataContainer::InternalResourceDataContainer(size_t numData, con
     DataVector = std::move(buffer_data);
 }
 
+InternalResourceDataContainer::InternalResourceDataContainer(size_t numData, const gpu_resource_data_t* data, const gpu_staging_reservation_t& staging) :
+    NumLayers{ std::nullopt }
+{
+    BufferDataVector buffer_data(numData);
+    for (size_t i = 0; i < numData; ++i)
+    {
+        buffer_data[i].size = data[i].DataSize;
+        buffer_data[i].alignment = data[i].DataAlignment;
+        buffer_data[i].stagingOffset = GetStagingOffset(data[i].Data, data[i].DataSize, staging);
+    }
+    DataVector = std::move(buffer_data);
+}
+
+InternalResourceDataContainer::InternalResourceDataContainer(size_t numData, const gpu_image_resource_data_t* data, const gpu_staging_reservation_t& staging)
+{
+    NumLayers = data[0].NumLayers;
+    ImageDataVector image_data(numData);
+    for (size_t i = 0; i < numData; ++i)
+    {
+        image_data[i].size = data[i].DataSize;
+        image_data[i].width = data[i].Width;
+        image_data[i].height = data[i].Height;
+        image_data[i].arrayLayer = data[i].ArrayLayer;
+        image_data[i].mipLevel = data[i].MipLevel;
+        image_data[i].stagingOffset = GetStagingOffset(data[i].Data, data[i].DataSize, staging);
+    }
+    DataVector = std::move(image_data);
+}
+
 SetBufferDataMessage::SetBufferDataMessage(GraphicsResource _destBuffer, InternalResourceDataContainer&& _data, std::shared_ptr<ResourceTransferReply>&& reply) noexcept :
     destBuffer{ _destBuffer },
     data{ std::move(_data) },
@@ -113,7 +187,8 @@ SetBufferDataMessage::SetBufferDataMessage(GraphicsResource _destBuffer, size_t
 
 SetBufferDataMessage::SetBufferDataMessage(SetBufferDataMessage&& other) noexcept :
     destBuffer{ other.destBuffer },
-    data{ std::move(other.data) }
+    data{ std::move(other.data) },
+    reply{ std::move(other.reply) }
 {}
 
 SetBufferDataMessage& SetBufferDataMessage::operator=(SetBufferDataMessage&& other) noexcept
@@ -122,13 +197,15 @@ SetBufferDataMessage& SetBufferDataMessage::operator=(SetBufferDataMessage&& oth
     {
         destBuffer = other.destBuffer;
         data = std::move(other.data);
+        reply = std::move(other.reply);
     }
     return *this;
 }
 
 SetImageDataMessage::SetImageDataMessage(SetImageDataMessage&& other) noexcept :
     destImage{ other.destImage },
-    data{ std::move(other.data) }
+    data{ std::move(other.data) },
+    reply{ std::move(other.reply) }
 {}
 
 SetImageDataMessage::SetImageDataMessage(GraphicsResource _destImage, size_t numData, const gpu_image_resource_data_t* data) noexcept :
@@ -148,6 +225,7 @@ SetImageDataMessage& SetImageDataMessage::operator=(SetImageDataMessage&& other)
     {
         destImage = other.destImage;
         data = std::move(other.data);
+        reply = std::move(other.reply);
     }
     return *this;
 }
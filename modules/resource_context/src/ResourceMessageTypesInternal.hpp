@@ -16,6 +16,10 @@
 // Because users just provide pointers to raw data, we need to take a copy of the data so that exiting 
 // the function once they finish enqueuing the message doesn't invalidate the data right before we use it.
 // We'll free this as soon as it's uploaded to the GPU or a staging buffer
+// The exception is data the user already wrote into a staging reservation: then we just record where in
+// the reservation each region lives, and take ownership of the reservation itself
+struct UploadBuffer;
+
 struct InternalResourceDataContainer
 {
 
@@ -34,6 +38,8 @@ struct InternalResourceDataContainer
         std::unique_ptr<std::byte[]> data;
         size_t size;
         size_t alignment;
+        // only meaningful when the container has Staging, in which case data is null
+        size_t stagingOffset{ 0u };
     };
     using BufferDataVector = std::vector<BufferData>;
     // Images have a bit more metadata, so we need this struct for them
@@ -56,17 +62,29 @@ struct InternalResourceDataContainer
         uint32_t height;
         uint32_t arrayLayer;
         uint32_t mipLevel;
+        size_t stagingOffset{ 0u };
     };
     using ImageDataVector = std::vector<ImageData>;
     
     std::variant<BufferDataVector, ImageDataVector> DataVector;
     std::optional<uint32_t> NumLayers;
+    // shared_ptr so this header doesn't need UploadBuffer complete
+    std::shared_ptr<UploadBuffer> Staging;
 
     InternalResourceDataContainer(size_t numData, const gpu_resource_data_t* data);
 
     InternalResourceDataContainer(size_t numData, const gpu_image_resource_data_t* data);
 
+    // Regions' Data must point inside staging, as only their offsets are stored: check with InStaging() first
+    InternalResourceDataContainer(size_t numData, const gpu_resource_data_t* data, const gpu_staging_reservation_t& staging);
+
+    InternalResourceDataContainer(size_t numData, const gpu_image_resource_data_t* data, const gpu_staging_reservation_t& staging);
+
     InternalResourceDataContainer() noexcept;
+
+    // Whether every region lies entirely within staging
+    static bool InStaging(size_t numData, const gpu_resource_data_t* data, const gpu_staging_reservation_t& staging) noexcept;
+    static bool InStaging(size_t numData, const gpu_image_resource_data_t* data, const gpu_staging_reservation_t& staging) noexcept;
 };
 
 struct CreateBufferMessage
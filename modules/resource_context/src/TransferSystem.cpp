@@ -9,6 +9,7 @@
 #include "UploadBuffer.hpp"
 #include "../../rendering_context/include/RenderingContext.hpp"
 #include "VkDebugUtils.hpp"
+#include "foundation/Profiler.hpp"
 
 #include <array>
 #include <mutex>
@@ -89,7 +90,19 @@ ResourceTransferSystem::TransferCommand::TransferCommand(
     allocatorHandle(_allocator)
 {
     createCommandPool();
-    uploadBuffer = std::make_unique<UploadBuffer>(device, allocatorHandle);
+    uploadBuffer = std::make_shared<UploadBuffer>(device, allocatorHandle);
+}
+
+ResourceTransferSystem::TransferCommand::TransferCommand(
+    const vpr::Device* _device,
+    std::shared_ptr<UploadBuffer>&& _staging,
+    std::shared_ptr<ResourceTransferReply>&& _reply) :
+    device(_device),
+    reply(std::move(_reply)),
+    allocatorHandle(_staging->Allocator),
+    uploadBuffer(std::move(_staging))
+{
+    createCommandPool();
 }
 
 ResourceTransferSystem::TransferCommand::TransferCommand(
@@ -248,6 +261,7 @@ void ResourceTransferSystem::Initialize(const vpr::Device* dvc)
 void ResourceTransferSystem::SetExitWorker(bool value)
 {
     shouldExitWorker.store(value, std::memory_order_seq_cst);
+    workWaiter.notify();
 }
 
 void ResourceTransferSystem::StartWorker()
@@ -259,6 +273,7 @@ void ResourceTransferSystem::StartWorker()
 void ResourceTransferSystem::StopWorker()
 {
     shouldExitWorker.store(true);
+    workWaiter.notify();
     workerThread.join();
     ForceCompleteTransfers();
 }
@@ -309,6 +324,7 @@ void ResourceTransferSystem::ForceCompleteTransfers()
 void ResourceTransferSystem::EnqueueTransfer(TransferPayloadType&& payload)
 {
     messageQueue.push(std::move(payload));
+    workWaiter.notify();
 }
 
 void ResourceTransferSystem::workerThreadJob()
@@ -319,18 +335,13 @@ void ResourceTransferSystem::workerThreadJob()
     // 1ms chosen to give us less time than the message processing, but still enough for GPU to do work
     // PCI bus goes WHIRRRRRRRRRRRRRRRRR
     static constexpr std::chrono::milliseconds command_submission_timeout = std::chrono::milliseconds(1);
-    
-    // Create a backoff sleeper with custom parameters for transfer system
-    // Use a smaller min sleep time (1ms) since transfers are often time-sensitive
-    foundation::ExponentialBackoffSleeper sleeper(
-        std::chrono::milliseconds(1),  // min sleep
-        std::chrono::milliseconds(30), // max sleep
-        0.2f,                          // less jitter (20%)
-        1.5f                           // gentler backoff multiplier
-    );
 
+    FOUNDATION_PROFILE_THREAD_NAME("Transfer Worker");
+    
     while (!shouldExitWorker.load())
     {
+        // Taken before checking for work, so an EnqueueTransfer() landing after the checks still wakes us
+        const uint32_t waitToken = workWaiter.prepareWait();
         bool didWork = false;
         
         // Process messages with timeout
@@ -354,23 +365,21 @@ void ResourceTransferSystem::workerThreadJob()
             didWork = true;
         }
         
-        // Adjust sleep behavior based on whether we did any work
         if (didWork)
         {
-            sleeper.reset();
+            workWaiter.reset();
         }
         else
         {
-            sleeper.backoff();
+            workWaiter.wait(waitToken);
+            workWaiter.backoff();
         }
-        
-        // Sleep for the calculated duration
-        sleeper.sleep();
     }
 }
 
 void ResourceTransferSystem::processMessages(std::chrono::milliseconds timeout)
 {
+    FOUNDATION_PROFILE_ZONE("TransferSystem::ProcessMessages");
     using clock = std::chrono::high_resolution_clock;
     const clock::time_point start = clock::now();
     
@@ -393,6 +402,7 @@ void ResourceTransferSystem::processMessages(std::chrono::milliseconds timeout)
 
 void ResourceTransferSystem::submitTransferCommands()
 {
+    FOUNDATION_PROFILE_ZONE_ARG("TransferSystem::SubmitTransferCommands", static_cast<uint32_t>(commands.size()));
     std::vector<VkCommandBuffer> cmd_buffers;
     std::vector<VkSemaphore> signal_semaphores;
     const std::vector<uint64_t> signal_values(commands.size(), k_TransferCompleteSemaphoreValue);
@@ -426,6 +436,7 @@ void ResourceTransferSystem::submitTransferCommands()
 
 void ResourceTransferSystem::waitForCommandsToComplete(std::chrono::milliseconds timeout)
 {
+    FOUNDATION_PROFILE_ZONE("TransferSystem::WaitForCommandsToComplete");
     using clock = std::chrono::high_resolution_clock;
     const clock::time_point wait_start = clock::now();
     const clock::time_point wait_end = wait_start + timeout;
@@ -484,13 +495,17 @@ void ResourceTransferSystem::processSetBufferDataMessage(TransferSystemSetBuffer
     const VkBufferCreateInfo& buffer_create_info = message.bufferInfo.createInfo;
     const VkBuffer buffer_handle = message.bufferInfo.bufferHandle;
 
-    TransferCommand transfer_command(device, allocatorHandle, std::move(message.reply));
+    const bool pre_staged = message.data.Staging != nullptr;
+    TransferCommand transfer_command = pre_staged ?
+        TransferCommand(device, std::move(message.data.Staging), std::move(message.reply)) :
+        TransferCommand(device, allocatorHandle, std::move(message.reply));
 
     // note that this is copying to an API managed staging buffer, not just another raw data buffer like our data container. will only be briefly duplicated
+    // (unless it was written into a staging reservation to begin with, in which case there's nothing left to copy)
     InternalResourceDataContainer::BufferDataVector& dataVector = std::get<InternalResourceDataContainer::BufferDataVector>(message.data.DataVector);
     
     UploadBuffer* upload_buffer = transfer_command.GetUploadBuffer();
-    std::vector<VkBufferCopy> buffer_copies = upload_buffer->SetData(dataVector);
+    std::vector<VkBufferCopy> buffer_copies = pre_staged ? upload_buffer->GetStagedCopies(dataVector) : upload_buffer->SetData(dataVector);
 
     VkCommandBuffer cmd = transfer_command.CmdBuffer();
     vkCmdCopyBuffer(cmd, upload_buffer->Buffer, buffer_handle, static_cast<uint32_t>(buffer_copies.size()), buffer_copies.data());
@@ -564,11 +579,16 @@ void ResourceTransferSystem::processSetImageDataMessage(TransferSystemSetImageDa
         VkImageSubresourceRange { VK_IMAGE_ASPECT_COLOR_BIT, 0u, image_info.mipLevels, 0u, image_info.arrayLayers }
     };
 
-    TransferCommand transfer_command(device, allocatorHandle, std::move(message.reply));
+    const bool pre_staged = message.data.Staging != nullptr;
+    TransferCommand transfer_command = pre_staged ?
+        TransferCommand(device, std::move(message.data.Staging), std::move(message.reply)) :
+        TransferCommand(device, allocatorHandle, std::move(message.reply));
     InternalResourceDataContainer::ImageDataVector& imageDataVector = std::get<InternalResourceDataContainer::ImageDataVector>(message.data.DataVector);
     
     UploadBuffer* upload_buffer = transfer_command.GetUploadBuffer();
-    std::vector<VkBufferImageCopy> buffer_image_copies = upload_buffer->SetData(imageDataVector, image_info.arrayLayers);
+    std::vector<VkBufferImageCopy> buffer_image_copies = pre_staged ?
+        upload_buffer->GetStagedCopies(imageDataVector, image_info.arrayLayers) :
+        upload_buffer->SetData(imageDataVector, image_info.arrayLayers);
 
     VkCommandBuffer cmd = transfer_command.CmdBuffer();
    
@@ -108,37 +108,66 @@ std::vector<VkBufferImageCopy> UploadBuffer::SetData(
     for (size_t i = 0; i < imageDataVector.size(); ++i)
     {
         setDataAtOffset(imageDataVector[i].data.get(), imageDataVector[i].size, offset);
-        VkBufferImageCopy& copy = buffer_image_copies[i];
-        copy.bufferOffset = offset;
-        copy.bufferRowLength = 0u;
-        copy.bufferImageHeight = 0u;
-        copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copy.imageSubresource.baseArrayLayer = imageDataVector[i].arrayLayer;
-        copy.imageSubresource.layerCount = numLayers;
-        copy.imageSubresource.mipLevel = imageDataVector[i].mipLevel;
-        copy.imageOffset = VkOffset3D{ 0, 0, 0 };
-        copy.imageExtent = VkExtent3D{ imageDataVector[i].width, imageDataVector[i].height, 1u };
-        buffer_image_copies.emplace_back(std::move(copy));
+        buffer_image_copies[i] = makeImageCopy(imageDataVector[i], numLayers, offset);
         offset += static_cast<VkDeviceSize>(imageDataVector[i].size);
     }
 
     return buffer_image_copies;
 }
 
+void UploadBuffer::Reserve(VkDeviceSize size)
+{
+    createAndAllocateBuffer(size);
+}
+
+std::vector<VkBufferCopy> UploadBuffer::GetStagedCopies(const InternalResourceDataContainer::BufferDataVector& dataVector) const
+{
+    // regions still land back to back in the destination, same as SetData()
+    std::vector<VkBufferCopy> buffer_copies(dataVector.size());
+    VkDeviceSize dst_offset = 0;
+    for (size_t i = 0; i < dataVector.size(); ++i)
+    {
+        assert((dataVector[i].stagingOffset + dataVector[i].size) <= Size);
+        buffer_copies[i].size = dataVector[i].size;
+        buffer_copies[i].srcOffset = dataVector[i].stagingOffset;
+        buffer_copies[i].dstOffset = dst_offset;
+        dst_offset += dataVector[i].size;
+    }
+
+    return buffer_copies;
+}
+
+std::vector<VkBufferImageCopy> UploadBuffer::GetStagedCopies(
+    const InternalResourceDataContainer::ImageDataVector& imageDataVector,
+    const uint32_t numLayers) const
+{
+    std::vector<VkBufferImageCopy> buffer_image_copies(imageDataVector.size());
+    for (size_t i = 0; i < imageDataVector.size(); ++i)
+    {
+        assert((imageDataVector[i].stagingOffset + imageDataVector[i].size) <= Size);
+        buffer_image_copies[i] = makeImageCopy(imageDataVector[i], numLayers, imageDataVector[i].stagingOffset);
+    }
+
+    return buffer_image_copies;
+}
+
 void UploadBuffer::createAndAllocateBuffer(VkDeviceSize size)
 {
     VkBufferCreateInfo create_info = k_defaultStagingBufferCreateInfo;
     create_info.size = size;
     VmaAllocationCreateInfo alloc_create_info = k_defaultAllocationCreateInfo;
+    VmaAllocationInfo allocation_info{};
     VkResult result = vmaCreateBuffer(
         Allocator,
         &create_info,
         &alloc_create_info,
         &Buffer,
         &Allocation,
-        nullptr
+        &allocation_info
     );
     VkAssert(result);
+    // created with VMA_ALLOCATION_CREATE_MAPPED_BIT, so this stays valid for the buffer's whole lifetime
+    mappedPtr = allocation_info.pMappedData;
     Size = size;
 }
 
@@ -148,3 +177,18 @@ void UploadBuffer::setDataAtOffset(const void* data, size_t data_size, size_t of
     auto destAddress = reinterpret_cast<std::byte*>(mappedPtr) + offset;
     std::memcpy(destAddress, data, data_size);
 }
+
+VkBufferImageCopy UploadBuffer::makeImageCopy(const InternalResourceDataContainer::ImageData& image_data, const uint32_t numLayers, const VkDeviceSize offset) noexcept
+{
+    VkBufferImageCopy copy{};
+    copy.bufferOffset = offset;
+    copy.bufferRowLength = 0u;
+    copy.bufferImageHeight = 0u;
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.baseArrayLayer = image_data.arrayLayer;
+    copy.imageSubresource.layerCount = numLayers;
+    copy.imageSubresource.mipLevel = image_data.mipLevel;
+    copy.imageOffset = VkOffset3D{ 0, 0, 0 };
+    copy.imageExtent = VkExtent3D{ image_data.width, image_data.height, 1u };
+    return copy;
+}
@@ -20,6 +20,13 @@ struct UploadBuffer
     std::vector<VkBufferImageCopy> SetData(
         const InternalResourceDataContainer::ImageDataVector& imageDataVector,
         const uint32_t numLayers);
+    // For staging reservations: allocates up front, and the caller writes the data through mappedPtr
+    void Reserve(VkDeviceSize size);
+    // Copy regions for data that was written into this buffer already, at each entry's stagingOffset
+    std::vector<VkBufferCopy> GetStagedCopies(const InternalResourceDataContainer::BufferDataVector& dataVector) const;
+    std::vector<VkBufferImageCopy> GetStagedCopies(
+        const InternalResourceDataContainer::ImageDataVector& imageDataVector,
+        const uint32_t numLayers) const;
     VkBuffer Buffer{ VK_NULL_HANDLE };
     VmaAllocation Allocation{ VK_NULL_HANDLE };
     VmaAllocator Allocator{ VK_NULL_HANDLE };
@@ -29,6 +36,7 @@ struct UploadBuffer
 private:
     void createAndAllocateBuffer(VkDeviceSize size);
     void setDataAtOffset(const void* data, size_t data_size, size_t offset);
+    static VkBufferImageCopy makeImageCopy(const InternalResourceDataContainer::ImageData& image_data, const uint32_t numLayers, const VkDeviceSize offset) noexcept;
 };
 
 #endif //!RESOURCE_CONTEXT_UPLOAD_BUFFER_HPP
@@ -0,0 +1,143 @@
+#include "BenchmarkCommon.hpp"
+#include "BatchFileReader.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+    Loads a directory of a few thousand small files (sizes spread like meshes, materials and small
+    textures) with both BatchFileReader backends, the way ResourceLoader::readBatch() hands them over.
+    Warm runs read from the page cache. Cold runs first ask the kernel to drop each file's cached pages
+    (posix_fadvise DONTNEED, no root needed), which is where io_uring's queue depth should pay off.
+
+    Pass a directory to use instead of the system temp directory, e.g. one on the drive assets live on.
+*/
+
+namespace
+{
+
+    constexpr size_t numRepetitions = 5u;
+    constexpr size_t numFiles = 4096u;
+    constexpr size_t filesPerBatch = 32u;
+
+    std::vector<std::string> createFiles(const std::filesystem::path& dir)
+    {
+        std::filesystem::create_directories(dir);
+        std::mt19937 rng(99u);
+        // Mostly a few kB, with a long tail up to 1MB
+        std::lognormal_distribution<double> size_dist(9.0, 1.5);
+        std::vector<char> contents;
+        std::vector<std::string> paths;
+        paths.reserve(numFiles);
+
+        for (size_t i = 0u; i < numFiles; ++i)
+        {
+            const size_t size = std::clamp(static_cast<size_t>(size_dist(rng)), size_t(16), size_t(1) << 20u);
+            contents.resize(size);
+            for (size_t j = 0u; j < size; ++j)
+            {
+                contents[j] = static_cast<char>((i * 31u + j) & 0xffu);
+            }
+            paths.emplace_back((dir / ("asset_" + std::to_string(i) + ".bin")).string());
+            std::ofstream output(paths.back(), std::ios::binary);
+            output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }
+        return paths;
+    }
+
+    void dropFromPageCache(const std::vector<std::string>& paths)
+    {
+#ifdef __linux__
+        for (const std::string& path : paths)
+        {
+            const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd != -1)
+            {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    // Checksum covers every byte read plus the failures, so both backends have to agree on the contents
+    uint64_t readAll(BatchFileReader& reader, const std::vector<const char*>& paths)
+    {
+        uint64_t checksum = 0u;
+        for (size_t first = 0u; first < paths.size(); first += filesPerBatch)
+        {
+            const size_t count = std::min(filesPerBatch, paths.size() - first);
+            reader.ReadFiles(std::span<const char* const>(paths.data() + first, count), [&](batch_read_result&& result)
+            {
+                uint64_t sum = static_cast<uint64_t>(result.error) << 32u;
+                for (const std::byte value : result.data)
+                {
+                    sum += static_cast<uint64_t>(value);
+                }
+                checksum += sum * (first + result.index + 1u);
+            });
+        }
+        return checksum;
+    }
+
+    void benchmarkBackend(const bool prefer_io_uring, const bool cold, const std::vector<std::string>& paths)
+    {
+        std::vector<const char*> path_ptrs;
+        for (const std::string& path : paths)
+        {
+            path_ptrs.emplace_back(path.c_str());
+        }
+
+        BatchFileReader reader(64u, prefer_io_uring);
+        if (prefer_io_uring && reader.Backend() != file_read_backend::IoUring)
+        {
+            std::printf("io_uring unavailable, skipping its %s run\n", cold ? "cold" : "warm");
+            return;
+        }
+
+        uint64_t checksum = 0u;
+        double bestNs = 1e300;
+        for (size_t repetition = 0u; repetition <= numRepetitions; ++repetition)
+        {
+            if (cold)
+            {
+                dropFromPageCache(paths);
+            }
+            const auto start = benchmark::clock::now();
+            checksum = readAll(reader, path_ptrs);
+            const double ns = std::chrono::duration<double, std::nano>(benchmark::clock::now() - start).count();
+            // First pass is the warm-up
+            if (repetition != 0u)
+            {
+                bestNs = std::min(bestNs, ns);
+            }
+        }
+
+        const std::string name = std::string(BatchFileReader::GetBackendName(reader.Backend())) + (cold ? ", cold cache" : ", warm cache");
+        benchmark::Report(name.c_str(), bestNs, paths.size(), checksum);
+    }
+
+}
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path base = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::temp_directory_path();
+    const std::filesystem::path dir = base / "BatchFileReaderBenchmark";
+    const std::vector<std::string> paths = createFiles(dir);
+
+    for (const bool cold : { false, true })
+    {
+        benchmarkBackend(false, cold, paths);
+        benchmarkBackend(true, cold, paths);
+    }
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
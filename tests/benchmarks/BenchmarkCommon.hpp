@@ -0,0 +1,42 @@
+#pragma once
+#ifndef DIAMOND_DOGS_BENCHMARK_COMMON_HPP
+#define DIAMOND_DOGS_BENCHMARK_COMMON_HPP
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/*
+    Shared helpers for the benchmark executables. Each benchmark prints one line per case: the name,
+    the time per operation, and a checksum derived from the work done, which is also what keeps
+    the optimizer from throwing the measured loop away.
+*/
+namespace benchmark
+{
+
+    using clock = std::chrono::steady_clock;
+
+    // Runs fn once to warm up, then repetitions more times, and returns the fastest run in nanoseconds
+    template<typename Fn>
+    double MeasureBestOf(const size_t repetitions, Fn&& fn)
+    {
+        fn();
+        double best = 1e300;
+        for (size_t i = 0u; i < repetitions; ++i)
+        {
+            const auto start = clock::now();
+            fn();
+            const double elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            best = elapsed < best ? elapsed : best;
+        }
+        return best;
+    }
+
+    inline void Report(const char* name, const double total_ns, const size_t operations, const uint64_t checksum)
+    {
+        std::printf("%-56s %12.2f ns/op  (checksum %llu)\n", name, total_ns / static_cast<double>(operations),
+            static_cast<unsigned long long>(checksum));
+    }
+
+}
+
+#endif //!DIAMOND_DOGS_BENCHMARK_COMMON_HPP
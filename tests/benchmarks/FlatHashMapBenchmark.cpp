@@ -0,0 +1,153 @@
+#include "BenchmarkCommon.hpp"
+#include "containers/flat_hash_map.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+    flat_hash_map against std::unordered_map on the key distributions the engine's tables hold:
+    - asset paths and resource names (ResourceLoader, vtfFrameData::rsrcMap), looked up by string_view
+      where the caller only has a view, which unordered_map has to turn into a std::string first
+    - 64-bit content hashes (LoadedDataCache's ccDataHandle)
+    - small, dense 32-bit IDs (entity-style handles)
+    Each case times inserting every key, finding every key, and finding keys that aren't present.
+*/
+
+namespace
+{
+
+    constexpr size_t numRepetitions = 5u;
+
+    std::vector<std::string> makeAssetPaths(const size_t count, const uint32_t seed)
+    {
+        static const char* directories[] = { "assets/models/", "assets/textures/", "ResourceContextTestAssets/", "shaders/cache/" };
+        static const char* extensions[] = { ".obj", ".png", ".dds", ".mtl", ".spv" };
+        std::mt19937 rng(seed);
+        std::vector<std::string> result;
+        result.reserve(count);
+        for (size_t i = 0u; i < count; ++i)
+        {
+            result.emplace_back(std::string(directories[rng() % 4u]) + "asset_" + std::to_string(rng()) + extensions[rng() % 5u]);
+        }
+        return result;
+    }
+
+    std::vector<uint64_t> makeContentHashes(const size_t count, const uint64_t seed)
+    {
+        std::mt19937_64 rng(seed);
+        std::vector<uint64_t> result(count);
+        for (uint64_t& hash : result)
+        {
+            hash = rng();
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> makeDenseIDs(const size_t count, const uint32_t first)
+    {
+        std::vector<uint32_t> result(count);
+        for (size_t i = 0u; i < count; ++i)
+        {
+            result[i] = first + static_cast<uint32_t>(i);
+        }
+        std::shuffle(result.begin(), result.end(), std::mt19937(first));
+        return result;
+    }
+
+    template<typename MapType, typename KeyType, typename LookupFn>
+    void benchmarkMap(const char* label, const std::vector<KeyType>& keys, const std::vector<KeyType>& missing, LookupFn&& lookup)
+    {
+        std::string name;
+        uint64_t checksum = 0u;
+
+        const double insertNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            MapType map;
+            for (size_t i = 0u; i < keys.size(); ++i)
+            {
+                map.emplace(keys[i], i);
+            }
+            checksum = map.size();
+        });
+        name = std::string(label) + ": insert";
+        benchmark::Report(name.c_str(), insertNs, keys.size(), checksum);
+
+        MapType map;
+        for (size_t i = 0u; i < keys.size(); ++i)
+        {
+            map.emplace(keys[i], i);
+        }
+
+        const double hitNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = 0u;
+            for (const KeyType& key : keys)
+            {
+                checksum += lookup(map, key);
+            }
+        });
+        name = std::string(label) + ": find (present)";
+        benchmark::Report(name.c_str(), hitNs, keys.size(), checksum);
+
+        const double missNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = 0u;
+            for (const KeyType& key : missing)
+            {
+                checksum += lookup(map, key);
+            }
+        });
+        name = std::string(label) + ": find (absent)";
+        benchmark::Report(name.c_str(), missNs, missing.size(), checksum);
+    }
+
+    template<typename MapType, typename KeyType>
+    uint64_t findValue(const MapType& map, const KeyType& key)
+    {
+        auto iter = map.find(key);
+        return iter != map.end() ? iter->second + 1u : 0u;
+    }
+
+}
+
+int main()
+{
+    {
+        const std::vector<std::string> paths = makeAssetPaths(10000u, 1u);
+        const std::vector<std::string> missing = makeAssetPaths(10000u, 2u);
+        benchmarkMap<foundation::flat_hash_map<std::string, size_t>>("asset paths, 10k, flat_hash_map (string_view)", paths, missing,
+            [](const auto& map, const std::string& key) { return findValue(map, std::string_view(key)); });
+        benchmarkMap<std::unordered_map<std::string, size_t>>("asset paths, 10k, unordered_map (string_view)", paths, missing,
+            [](const auto& map, const std::string& key)
+            {
+                // What callers holding a string_view have to do today
+                const std::string_view view(key);
+                return findValue(map, std::string(view));
+            });
+        benchmarkMap<std::unordered_map<std::string, size_t>>("asset paths, 10k, unordered_map (std::string)", paths, missing,
+            [](const auto& map, const std::string& key) { return findValue(map, key); });
+    }
+
+    {
+        const std::vector<uint64_t> hashes = makeContentHashes(100000u, 1u);
+        const std::vector<uint64_t> missing = makeContentHashes(100000u, 2u);
+        benchmarkMap<foundation::flat_hash_map<uint64_t, size_t>>("content hashes, 100k, flat_hash_map", hashes, missing,
+            [](const auto& map, const uint64_t key) { return findValue(map, key); });
+        benchmarkMap<std::unordered_map<uint64_t, size_t>>("content hashes, 100k, unordered_map", hashes, missing,
+            [](const auto& map, const uint64_t key) { return findValue(map, key); });
+    }
+
+    {
+        const std::vector<uint32_t> ids = makeDenseIDs(100000u, 0u);
+        const std::vector<uint32_t> missing = makeDenseIDs(100000u, 100000u);
+        benchmarkMap<foundation::flat_hash_map<uint32_t, size_t>>("dense IDs, 100k, flat_hash_map", ids, missing,
+            [](const auto& map, const uint32_t key) { return findValue(map, key); });
+        benchmarkMap<std::unordered_map<uint32_t, size_t>>("dense IDs, 100k, unordered_map", ids, missing,
+            [](const auto& map, const uint32_t key) { return findValue(map, key); });
+    }
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include "BenchmarkCommon.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "threading/critical_section.hpp"
+#include "threading/srw_lock.hpp"
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    Read-heavy contention, shaped like descriptor pool and resource registry lookups: a few thousand
+    entries in a hash map, threads mostly looking them up, with one operation in writeInterval
+    updating an entry instead. srw_lock is measured against std::shared_mutex, and critical_section
+    (which takes every operation exclusively) against std::mutex, at increasing thread counts.
+*/
+
+namespace
+{
+
+    constexpr size_t numEntries = 4096u;
+    constexpr size_t opsPerThread = 200000u;
+    constexpr size_t writeInterval = 32u;
+    constexpr size_t numRepetitions = 3u;
+
+    using table_t = foundation::flat_hash_map<uint64_t, uint64_t>;
+
+    struct srw_lock_adapter
+    {
+        srw_lock lock;
+
+        template<typename Fn>
+        void read(Fn&& fn)
+        {
+            srw_lock::scoped_read_lock guard(lock);
+            fn();
+        }
+
+        template<typename Fn>
+        void write(Fn&& fn)
+        {
+            srw_lock::scoped_write_lock guard(lock);
+            fn();
+        }
+    };
+
+    struct shared_mutex_adapter
+    {
+        std::shared_mutex mutex;
+
+        template<typename Fn>
+        void read(Fn&& fn)
+        {
+            std::shared_lock<std::shared_mutex> guard(mutex);
+            fn();
+        }
+
+        template<typename Fn>
+        void write(Fn&& fn)
+        {
+            std::unique_lock<std::shared_mutex> guard(mutex);
+            fn();
+        }
+    };
+
+    struct critical_section_adapter
+    {
+        critical_section section;
+
+        template<typename Fn>
+        void read(Fn&& fn)
+        {
+            critical_section::raii_scoped_lock guard(section);
+            fn();
+        }
+
+        template<typename Fn>
+        void write(Fn&& fn)
+        {
+            read(fn);
+        }
+    };
+
+    struct mutex_adapter
+    {
+        std::mutex mutex;
+
+        template<typename Fn>
+        void read(Fn&& fn)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            fn();
+        }
+
+        template<typename Fn>
+        void write(Fn&& fn)
+        {
+            read(fn);
+        }
+    };
+
+    template<typename LockAdapter>
+    void benchmarkLock(const char* label, const size_t numThreads)
+    {
+        table_t table;
+        for (uint64_t i = 0u; i < numEntries; ++i)
+        {
+            table.emplace(i * 0x9e3779b97f4a7c15u, i);
+        }
+
+        LockAdapter lock;
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            std::vector<uint64_t> sums(numThreads, 0u);
+            std::vector<std::thread> threads;
+            for (size_t t = 0u; t < numThreads; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    uint64_t state = t + 1u;
+                    uint64_t sum = 0u;
+                    for (size_t i = 0u; i < opsPerThread; ++i)
+                    {
+                        state = state * 6364136223846793005u + 1442695040888963407u;
+                        const uint64_t key = ((state >> 33u) % numEntries) * 0x9e3779b97f4a7c15u;
+                        if (i % writeInterval == 0u)
+                        {
+                            lock.write([&]() { table[key] += 1u; });
+                        }
+                        else
+                        {
+                            lock.read([&]() { sum += table.find(key)->second; });
+                        }
+                    }
+                    sums[t] = sum;
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            checksum = 0u;
+            for (const uint64_t sum : sums)
+            {
+                checksum += sum;
+            }
+        });
+
+        const std::string name = std::string(label) + ", " + std::to_string(numThreads) + " thread(s)";
+        benchmark::Report(name.c_str(), ns, numThreads * opsPerThread, checksum);
+    }
+
+}
+
+// Reported time is wall clock per operation across all threads, so lower is better and perfect scaling halves it per doubling
+int main()
+{
+    const size_t maxThreads = std::clamp(std::thread::hardware_concurrency(), 4u, 16u);
+    for (size_t numThreads = 1u; numThreads <= maxThreads; numThreads *= 2u)
+    {
+        benchmarkLock<srw_lock_adapter>("srw_lock", numThreads);
+        benchmarkLock<shared_mutex_adapter>("std::shared_mutex", numThreads);
+        benchmarkLock<critical_section_adapter>("critical_section", numThreads);
+        benchmarkLock<mutex_adapter>("std::mutex", numThreads);
+    }
+    return 0;
+}
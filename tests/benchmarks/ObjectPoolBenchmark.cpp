@@ -0,0 +1,172 @@
+#include "BenchmarkCommon.hpp"
+#include "foundation/ObjectPool.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+/*
+    object_pool against the std::unique_ptr-per-object storage it replaces: iterating every live
+    object, churning (destroying and recreating random objects), and dereferencing handles after
+    compaction. The heap-allocated objects are churned before they're iterated, so they're scattered
+    the way long-lived allocations end up in practice, not laid out in allocation order.
+*/
+
+namespace
+{
+
+    struct particle_t
+    {
+        float position[3];
+        float velocity[3];
+        uint32_t flags;
+    };
+
+    constexpr size_t numObjects = 100000u;
+    constexpr size_t numChurnOps = 200000u;
+    constexpr size_t numRepetitions = 5u;
+
+    particle_t makeParticle(const uint32_t i)
+    {
+        const float f = static_cast<float>(i);
+        return particle_t{ { f, f + 1.0f, f + 2.0f }, { 1.0f, 0.5f, 0.25f }, i };
+    }
+
+    void integrate(particle_t& p)
+    {
+        p.position[0] += p.velocity[0];
+        p.position[1] += p.velocity[1];
+        p.position[2] += p.velocity[2];
+    }
+
+    uint64_t checksumOf(const particle_t& p)
+    {
+        return static_cast<uint64_t>(p.position[0]) + p.flags;
+    }
+
+    std::vector<uint32_t> makeChurnSequence()
+    {
+        std::mt19937 rng(0xdd);
+        std::uniform_int_distribution<uint32_t> dist(0u, static_cast<uint32_t>(numObjects - 1u));
+        std::vector<uint32_t> result(numChurnOps);
+        for (uint32_t& idx : result)
+        {
+            idx = dist(rng);
+        }
+        return result;
+    }
+
+    void benchmarkUniquePtr(const std::vector<uint32_t>& churn)
+    {
+        std::vector<std::unique_ptr<particle_t>> objects;
+        objects.reserve(numObjects);
+        for (uint32_t i = 0u; i < numObjects; ++i)
+        {
+            objects.emplace_back(std::make_unique<particle_t>(makeParticle(i)));
+        }
+
+        uint64_t checksum = 0u;
+        const double churnNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            for (const uint32_t idx : churn)
+            {
+                checksum += objects[idx]->flags;
+                objects[idx] = std::make_unique<particle_t>(makeParticle(idx));
+            }
+        });
+        benchmark::Report("churn: unique_ptr", churnNs, churn.size(), checksum);
+
+        checksum = 0u;
+        const double iterateNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            for (auto& object : objects)
+            {
+                integrate(*object);
+                checksum += checksumOf(*object);
+            }
+        });
+        benchmark::Report("iterate: unique_ptr", iterateNs, objects.size(), checksum);
+    }
+
+    template<foundation::memory_mode Mode>
+    void benchmarkPool(const char* churnName, const char* iterateName, const char* derefName, const std::vector<uint32_t>& churn)
+    {
+        using pool_type = foundation::object_pool<particle_t, Mode>;
+        auto pool = std::make_unique<pool_type>(numObjects);
+        std::vector<typename pool_type::handle_type> handles;
+        handles.reserve(numObjects);
+        for (uint32_t i = 0u; i < numObjects; ++i)
+        {
+            handles.emplace_back(pool->create(makeParticle(i)));
+        }
+
+        uint64_t checksum = 0u;
+        const double churnNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            for (const uint32_t idx : churn)
+            {
+                checksum += handles[idx].get()->flags;
+                pool->destroy(handles[idx]);
+                handles[idx] = pool->create(makeParticle(idx));
+            }
+        });
+        benchmark::Report(churnName, churnNs, churn.size(), checksum);
+
+        if constexpr (Mode == foundation::memory_mode::full_safety)
+        {
+            // Churn in this pool refills holes immediately, so punch some first to give Compact() work to do
+            for (size_t i = 0u; i < numObjects; i += 4u)
+            {
+                pool->destroy(handles[i]);
+            }
+            const auto start = benchmark::clock::now();
+            pool->Compact();
+            const double compactNs = std::chrono::duration<double, std::nano>(benchmark::clock::now() - start).count();
+            benchmark::Report("compact: object_pool<full_safety>, 25% holes", compactNs, pool->size(), pool->hole_count());
+        }
+
+        checksum = 0u;
+        const double iterateNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            pool->for_each([&](particle_t& p)
+            {
+                integrate(p);
+                checksum += checksumOf(p);
+            });
+        });
+        benchmark::Report(iterateName, iterateNs, pool->size(), checksum);
+
+        checksum = 0u;
+        size_t numDerefs = 0u;
+        const double derefNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            numDerefs = 0u;
+            for (size_t i = 0u; i < handles.size(); ++i)
+            {
+                if constexpr (Mode == foundation::memory_mode::full_safety)
+                {
+                    if ((i % 4u) == 0u)
+                    {
+                        continue;
+                    }
+                }
+                checksum += handles[i].get()->flags;
+                ++numDerefs;
+            }
+        });
+        benchmark::Report(derefName, derefNs, numDerefs, checksum);
+    }
+
+}
+
+int main()
+{
+    const std::vector<uint32_t> churn = makeChurnSequence();
+    benchmarkUniquePtr(churn);
+    benchmarkPool<foundation::memory_mode::fast>(
+        "churn: object_pool<fast>", "iterate: object_pool<fast>", "deref: object_pool<fast>", churn);
+    benchmarkPool<foundation::memory_mode::minimal_safety>(
+        "churn: object_pool<minimal_safety>", "iterate: object_pool<minimal_safety>", "deref: object_pool<minimal_safety>", churn);
+    benchmarkPool<foundation::memory_mode::full_safety>(
+        "churn: object_pool<full_safety>", "iterate: object_pool<full_safety>", "deref: object_pool<full_safety> (after compact)", churn);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "BenchmarkCommon.hpp"
+#include "foundation/Profiler.hpp"
+#include <algorithm>
+
+/*
+    Per-zone overhead of the profiler. Zones are recorded in bursts that fit a thread's ring, with a
+    collection between bursts the way RenderingContext::Update() collects once a frame. The recording
+    case times only the zones, the amortized case includes the collections too.
+    Uses foundation::profiler_zone directly, so it measures the same thing whether or not the
+    FOUNDATION_PROFILE_* macros are compiled in.
+*/
+
+namespace
+{
+
+    constexpr size_t numRepetitions = 5u;
+    constexpr size_t zonesPerBurst = foundation::ProfilerThreadRingCapacity / 2u;
+    constexpr size_t numBursts = 64u;
+    constexpr size_t numZones = zonesPerBurst * numBursts;
+
+    // Keeps the zone bodies from being optimized away, without being work worth measuring
+    volatile uint32_t sink = 0u;
+
+    void recordBurst()
+    {
+        for (uint32_t i = 0u; i < zonesPerBurst; ++i)
+        {
+            foundation::profiler_zone zone("benchmark_zone", i);
+            sink = i;
+        }
+    }
+
+    void benchmarkRecordingOnly()
+    {
+        double bestNs = 1e300;
+        for (size_t repetition = 0u; repetition <= numRepetitions; ++repetition)
+        {
+            double totalNs = 0.0;
+            for (size_t burst = 0u; burst < numBursts; ++burst)
+            {
+                const auto start = benchmark::clock::now();
+                recordBurst();
+                totalNs += std::chrono::duration<double, std::nano>(benchmark::clock::now() - start).count();
+                foundation::CollectProfilerEvents();
+                foundation::ClearProfilerEvents();
+            }
+            // First pass is the warm-up
+            if (repetition != 0u)
+            {
+                bestNs = std::min(bestNs, totalNs);
+            }
+        }
+        benchmark::Report("profiler_zone: recording", bestNs, numZones, foundation::GetProfilerDroppedEventCount());
+    }
+
+    void benchmarkAmortizedCollection()
+    {
+        const double ns = benchmark::MeasureBestOf(numRepetitions, []()
+        {
+            for (size_t burst = 0u; burst < numBursts; ++burst)
+            {
+                recordBurst();
+                foundation::CollectProfilerEvents();
+                foundation::ClearProfilerEvents();
+            }
+        });
+        benchmark::Report("profiler_zone: recording + collection", ns, numZones, foundation::GetProfilerDroppedEventCount());
+    }
+
+    void benchmarkDisabled()
+    {
+        foundation::SetProfilerEnabled(false);
+        const double ns = benchmark::MeasureBestOf(numRepetitions, []()
+        {
+            for (size_t burst = 0u; burst < numBursts; ++burst)
+            {
+                recordBurst();
+            }
+        });
+        foundation::SetProfilerEnabled(true);
+        benchmark::Report("profiler_zone: disabled at runtime", ns, numZones, 0u);
+    }
+
+    // A zone is two clock reads plus a ring push: on machines without a fast clock source the reads dominate
+    void benchmarkClockReads()
+    {
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            for (size_t i = 0u; i < numZones; ++i)
+            {
+                const uint64_t start = foundation::detail::profiler_now_ns();
+                checksum += foundation::detail::profiler_now_ns() - start;
+            }
+        });
+        benchmark::Report("two clock reads (zone lower bound)", ns, numZones, checksum != 0u);
+    }
+
+    void benchmarkBaseline()
+    {
+        const double ns = benchmark::MeasureBestOf(numRepetitions, []()
+        {
+            for (size_t burst = 0u; burst < numBursts; ++burst)
+            {
+                for (uint32_t i = 0u; i < zonesPerBurst; ++i)
+                {
+                    sink = i;
+                }
+            }
+        });
+        benchmark::Report("no zone (loop overhead)", ns, numZones, 0u);
+    }
+
+}
+
+// Checksum is the number of dropped events, which should stay 0
+int main()
+{
+    foundation::RegisterProfilerThread();
+    benchmarkBaseline();
+    benchmarkClockReads();
+    benchmarkDisabled();
+    benchmarkRecordingOnly();
+    benchmarkAmortizedCollection();
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include "BenchmarkCommon.hpp"
+#include "ResourceHandleTable.hpp"
+#include "ResourceTypes.hpp"
+#include <entt/entity/registry.hpp>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+    Resource lookups on the ResourceContextImpl worker thread, before and after the handle tables.
+    The registry side does what the worker used to: every buffer is an entity carrying the components
+    createBuffer() emplaced, and a message looks one up with valid() and then try_get<> over the
+    components it needs (set/fill/copy read the create info, map/unmap the allocation). The table side
+    is BufferHandleTable::TryGet(), which is what those paths do now.
+
+    No Vulkan objects are created: the handles are just distinct non-null values, since only the
+    lookups are measured.
+*/
+
+namespace
+{
+
+    constexpr size_t numRepetitions = 5u;
+    constexpr size_t numResources = 100000u;
+    constexpr size_t numLookups = 4000000u;
+    // One in this many lookups uses a handle whose resource has since been destroyed
+    constexpr size_t staleEvery = 8u;
+
+    // What ResourceContextImpl kept per entity alongside the Vulkan components
+    struct resource_flags_t
+    {
+        resource_type type;
+        resource_creation_flags flags;
+        resource_usage resourceUsage;
+    };
+
+    template<typename HandleType>
+    HandleType fakeHandle(const size_t i)
+    {
+        return reinterpret_cast<HandleType>(static_cast<uintptr_t>(i + 1u) << 4u);
+    }
+
+    VkBufferCreateInfo makeCreateInfo(const size_t i)
+    {
+        VkBufferCreateInfo create_info{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        create_info.size = static_cast<VkDeviceSize>(256u + (i & 1023u));
+        create_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+        create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        return create_info;
+    }
+
+    struct registry_path_t
+    {
+        entt::registry registry;
+
+        entt::entity create(const size_t i)
+        {
+            const entt::entity entity = registry.create();
+            registry.emplace<VkBufferCreateInfo>(entity, makeCreateInfo(i));
+            registry.emplace<resource_flags_t>(entity, resource_type::Buffer, resource_creation_flags(0u), resource_usage::CPUToGPU);
+            // Debug names were only there for some resources
+            if ((i & 3u) == 0u)
+            {
+                registry.emplace<std::string>(entity, "buffer_" + std::to_string(i));
+            }
+            VmaAllocationInfo& alloc_info = registry.emplace<VmaAllocationInfo>(entity);
+            alloc_info.pMappedData = fakeHandle<void*>(i);
+            alloc_info.size = makeCreateInfo(i).size;
+            registry.emplace<VmaAllocation>(entity, fakeHandle<VmaAllocation>(i));
+            registry.emplace<VkBuffer>(entity, fakeHandle<VkBuffer>(i));
+            return entity;
+        }
+
+        void destroy(const entt::entity entity)
+        {
+            registry.destroy(entity);
+        }
+
+        // processSetBufferMessage/processFillBufferMessage/processCopyResourceMessage
+        uint64_t lookupCreateInfo(const entt::entity entity)
+        {
+            if (!registry.valid(entity))
+            {
+                return 1u;
+            }
+            auto [buffer_handle, buffer_info, buffer_flags] = registry.try_get<VkBuffer, VkBufferCreateInfo, resource_flags_t>(entity);
+            if (buffer_handle == nullptr || buffer_info == nullptr || buffer_flags == nullptr)
+            {
+                return 1u;
+            }
+            return static_cast<uint64_t>(buffer_info->size) + static_cast<uint64_t>(buffer_flags->resourceUsage);
+        }
+
+        // processMapBufferMessage/processUnmapBufferMessage
+        uint64_t lookupAllocation(const entt::entity entity)
+        {
+            if (!registry.valid(entity))
+            {
+                return 1u;
+            }
+            auto [buffer_handle, alloc_info, alloc, buffer_flags] = registry.try_get<VkBuffer, VmaAllocationInfo, VmaAllocation, resource_flags_t>(entity);
+            if (buffer_handle == nullptr || alloc_info == nullptr || alloc == nullptr || buffer_flags == nullptr)
+            {
+                return 1u;
+            }
+            return reinterpret_cast<uintptr_t>(alloc_info->pMappedData) + reinterpret_cast<uintptr_t>(*alloc);
+        }
+    };
+
+    struct table_path_t
+    {
+        // Cold data still lives in a registry, keyed by the entity stored in each slot
+        entt::registry registry;
+        BufferHandleTable table;
+
+        uint32_t create(const size_t i)
+        {
+            BufferResourceData data;
+            data.buffer = fakeHandle<VkBuffer>(i);
+            data.allocation = fakeHandle<VmaAllocation>(i);
+            data.mappedData = fakeHandle<void*>(i);
+            data.createInfo = makeCreateInfo(i);
+            data.resourceUsage = resource_usage::CPUToGPU;
+            data.entity = registry.create();
+            if ((i & 3u) == 0u)
+            {
+                registry.emplace<std::string>(data.entity, "buffer_" + std::to_string(i));
+            }
+            return table.Insert(std::move(data));
+        }
+
+        void destroy(const uint32_t handle)
+        {
+            if (const BufferResourceData* data = table.TryGet(handle))
+            {
+                registry.destroy(data->entity);
+            }
+            table.Erase(handle);
+        }
+
+        uint64_t lookupCreateInfo(const uint32_t handle)
+        {
+            const BufferResourceData* data = table.TryGet(handle);
+            if (data == nullptr)
+            {
+                return 1u;
+            }
+            return static_cast<uint64_t>(data->createInfo.size) + static_cast<uint64_t>(data->resourceUsage);
+        }
+
+        uint64_t lookupAllocation(const uint32_t handle)
+        {
+            const BufferResourceData* data = table.TryGet(handle);
+            if (data == nullptr)
+            {
+                return 1u;
+            }
+            return reinterpret_cast<uintptr_t>(data->mappedData) + reinterpret_cast<uintptr_t>(data->allocation);
+        }
+    };
+
+    /*
+        Fills the path with numResources live buffers, after some churn so that slots and entity
+        versions have been reused the way they would be mid-session, then builds a shuffled lookup
+        order over the live handles with some stale ones mixed in.
+    */
+    template<typename PathType, typename HandleType>
+    std::vector<HandleType> populate(PathType& path)
+    {
+        std::mt19937_64 rng(42u);
+        std::vector<HandleType> live;
+        live.reserve(numResources);
+        for (size_t i = 0u; i < numResources; ++i)
+        {
+            live.emplace_back(path.create(i));
+        }
+
+        std::vector<HandleType> stale;
+        for (size_t i = 0u; i < numResources / 4u; ++i)
+        {
+            const size_t victim = static_cast<size_t>(rng() % live.size());
+            stale.emplace_back(live[victim]);
+            path.destroy(live[victim]);
+            live[victim] = path.create(numResources + i);
+        }
+
+        std::vector<HandleType> lookups;
+        lookups.reserve(numLookups);
+        for (size_t i = 0u; i < numLookups; ++i)
+        {
+            if (i % staleEvery == 0u)
+            {
+                lookups.emplace_back(stale[static_cast<size_t>(rng() % stale.size())]);
+            }
+            else
+            {
+                lookups.emplace_back(live[static_cast<size_t>(rng() % live.size())]);
+            }
+        }
+        return lookups;
+    }
+
+    template<typename PathType, typename HandleType, typename LookupFn>
+    void benchmarkLookups(const char* name, PathType& path, const std::vector<HandleType>& lookups, LookupFn&& lookup)
+    {
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = 0u;
+            for (const HandleType handle : lookups)
+            {
+                checksum += lookup(path, handle);
+            }
+        });
+        benchmark::Report(name, ns, lookups.size(), checksum);
+    }
+
+}
+
+// Both paths hold the same resources and see the same lookup pattern, so matching checksums show they found the same data
+int main()
+{
+    registry_path_t registryPath;
+    const std::vector<entt::entity> registryLookups = populate<registry_path_t, entt::entity>(registryPath);
+    table_path_t tablePath;
+    const std::vector<uint32_t> tableLookups = populate<table_path_t, uint32_t>(tablePath);
+
+    benchmarkLookups("registry valid + try_get, create info", registryPath, registryLookups,
+        [](registry_path_t& path, const entt::entity entity) { return path.lookupCreateInfo(entity); });
+    benchmarkLookups("BufferHandleTable::TryGet, create info", tablePath, tableLookups,
+        [](table_path_t& path, const uint32_t handle) { return path.lookupCreateInfo(handle); });
+    benchmarkLookups("registry valid + try_get, allocation", registryPath, registryLookups,
+        [](registry_path_t& path, const entt::entity entity) { return path.lookupAllocation(entity); });
+    benchmarkLookups("BufferHandleTable::TryGet, allocation", tablePath, tableLookups,
+        [](table_path_t& path, const uint32_t handle) { return path.lookupAllocation(handle); });
+    return 0;
+}
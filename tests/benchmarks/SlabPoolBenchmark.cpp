@@ -0,0 +1,226 @@
+#include "BenchmarkCommon.hpp"
+#include "containers/spscRing.hpp"
+#include "foundation/SlabPool.hpp"
+#include <mimalloc.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    slab_pool against mimalloc, for the ResourceContext call pattern: every call allocate_shared's a
+    reply, hands one reference to the worker thread with the message, and the caller drops its own
+    reference a few calls later once it has seen the result. So replies are freed on either thread,
+    whichever lets go last. foundation replaces global operator new with mimalloc, so the make_shared
+    cases measure mimalloc too (plus the control block layout both share).
+
+    reply_t stands in for GraphicsResourceReply, which needs Vulkan headers: same shape, a vtable, an
+    atomic status, semaphore and device fields, and the 32 byte resource.
+*/
+
+namespace
+{
+
+    constexpr size_t numRepetitions = 5u;
+    constexpr size_t callsPerThread = 500000u;
+    // How many calls a caller keeps its own reply references around for
+    constexpr size_t callerWindow = 16u;
+
+    struct reply_base_t
+    {
+        virtual ~reply_base_t() = default;
+        std::atomic<uint8_t> status{ 0u };
+    };
+
+    struct reply_t final : reply_base_t
+    {
+        explicit reply_t(uint32_t _type) noexcept : type(_type) {}
+        uint64_t semaphoreHandle{ 0u };
+        const void* device{ nullptr };
+        alignas(16) uint64_t resource[4]{};
+        uint32_t type;
+    };
+
+    using reply_ptr = std::shared_ptr<reply_t>;
+
+    reply_ptr makeSlabReply(uint32_t type)
+    {
+        return std::allocate_shared<reply_t>(foundation::slab_allocator<reply_t>(), type);
+    }
+
+    reply_ptr makeDefaultReply(uint32_t type)
+    {
+        return std::make_shared<reply_t>(type);
+    }
+
+    // Burst of calls whose replies are all released on the calling thread
+    template<typename MakeFn>
+    void benchmarkSingleThread(const char* name, MakeFn&& make_reply)
+    {
+        constexpr size_t burstSize = 64u;
+        std::vector<reply_ptr> replies(burstSize);
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = 0u;
+            for (size_t i = 0u; i < callsPerThread; i += burstSize)
+            {
+                for (size_t j = 0u; j < burstSize; ++j)
+                {
+                    replies[j] = make_reply(static_cast<uint32_t>(j));
+                    checksum += replies[j]->type;
+                }
+                for (reply_ptr& reply : replies)
+                {
+                    reply.reset();
+                }
+            }
+        });
+        benchmark::Report(name, ns, callsPerThread, checksum);
+    }
+
+    // Callers push a reference to a worker per call, like pushMessage(), and drop their own later
+    template<typename MakeFn>
+    void benchmarkCallers(const char* name, const size_t num_callers, MakeFn&& make_reply)
+    {
+        using ring_t = spscRing<reply_ptr, 1024>;
+        std::vector<std::unique_ptr<ring_t>> rings;
+        for (size_t i = 0u; i < num_callers; ++i)
+        {
+            rings.emplace_back(std::make_unique<ring_t>());
+        }
+
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            std::atomic<size_t> callersDone{ 0u };
+            std::thread worker([&]()
+            {
+                reply_ptr message;
+                for (;;)
+                {
+                    bool anyPopped = false;
+                    for (std::unique_ptr<ring_t>& ring : rings)
+                    {
+                        while (ring->try_pop(message))
+                        {
+                            message->status.store(3u, std::memory_order_release);
+                            message.reset();
+                            anyPopped = true;
+                        }
+                    }
+                    if (!anyPopped)
+                    {
+                        if (callersDone.load(std::memory_order_acquire) == num_callers)
+                        {
+                            bool allEmpty = true;
+                            for (std::unique_ptr<ring_t>& ring : rings)
+                            {
+                                allEmpty &= ring->empty();
+                            }
+                            if (allEmpty)
+                            {
+                                return;
+                            }
+                        }
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            std::vector<uint64_t> sums(num_callers, 0u);
+            std::vector<std::thread> callers;
+            for (size_t c = 0u; c < num_callers; ++c)
+            {
+                callers.emplace_back([&, c]()
+                {
+                    std::array<reply_ptr, callerWindow> held;
+                    uint64_t sum = 0u;
+                    for (size_t i = 0u; i < callsPerThread; ++i)
+                    {
+                        reply_ptr reply = make_reply(static_cast<uint32_t>(i));
+                        while (!rings[c]->try_push(reply))
+                        {
+                            std::this_thread::yield();
+                        }
+                        sum += reply->type;
+                        held[i % callerWindow] = std::move(reply);
+                    }
+                    sums[c] = sum;
+                    callersDone.fetch_add(1u, std::memory_order_release);
+                });
+            }
+
+            for (std::thread& caller : callers)
+            {
+                caller.join();
+            }
+            worker.join();
+            checksum = 0u;
+            for (const uint64_t sum : sums)
+            {
+                checksum += sum;
+            }
+        });
+        benchmark::Report(name, ns, callsPerThread * num_callers, checksum);
+    }
+
+    // Raw fixed-size blocks, without shared_ptr's reference counting on top
+    void benchmarkRawBlocks()
+    {
+        constexpr size_t blockSize = 96u;
+        constexpr size_t burstSize = 64u;
+        std::vector<void*> blocks(burstSize);
+        foundation::slab_pool pool(blockSize);
+
+        const double slabNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            for (size_t i = 0u; i < callsPerThread; i += burstSize)
+            {
+                for (void*& block : blocks)
+                {
+                    block = pool.allocate();
+                }
+                for (void* block : blocks)
+                {
+                    pool.deallocate(block);
+                }
+            }
+        });
+        benchmark::Report("slab_pool: allocate/deallocate 96B", slabNs, callsPerThread, pool.stats().slabCount);
+
+        const double miNs = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            for (size_t i = 0u; i < callsPerThread; i += burstSize)
+            {
+                for (void*& block : blocks)
+                {
+                    block = mi_malloc(blockSize);
+                }
+                for (void* block : blocks)
+                {
+                    mi_free(block);
+                }
+            }
+        });
+        benchmark::Report("mi_malloc/mi_free 96B", miNs, callsPerThread, 0u);
+    }
+
+}
+
+int main()
+{
+    benchmarkRawBlocks();
+    benchmarkSingleThread("allocate_shared, slab_allocator", makeSlabReply);
+    benchmarkSingleThread("make_shared, mimalloc", makeDefaultReply);
+    for (size_t numCallers = 1u; numCallers <= 3u; ++numCallers)
+    {
+        const std::string slabName = "slab_allocator, " + std::to_string(numCallers) + " caller(s) + worker";
+        const std::string defaultName = "mimalloc, " + std::to_string(numCallers) + " caller(s) + worker";
+        benchmarkCallers(slabName.c_str(), numCallers, makeSlabReply);
+        benchmarkCallers(defaultName.c_str(), numCallers, makeDefaultReply);
+    }
+    return 0;
+}
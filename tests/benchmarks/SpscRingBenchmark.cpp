@@ -0,0 +1,194 @@
+#include "BenchmarkCommon.hpp"
+#include "containers/spscRing.hpp"
+#ifdef _MSC_VER
+#include "containers/mwsrQueue.hpp"
+#endif
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Single-producer throughput: one thread pushes numItems sequence numbers, another pops and sums them.
+    mwsrQueue needs atomic128, which only has an implementation for MSVC so far, so elsewhere a
+    mutex-guarded std::deque stands in as the baseline.
+*/
+
+namespace
+{
+
+    constexpr uint64_t numItems = 4000000u;
+    constexpr size_t numRepetitions = 3u;
+    constexpr uint64_t expectedSum = numItems * (numItems - 1u) / 2u;
+
+    template<typename PushFn, typename ConsumeFn>
+    uint64_t runTransfer(PushFn&& push_all, ConsumeFn&& consume_all)
+    {
+        std::thread producer(push_all);
+        const uint64_t sum = consume_all();
+        producer.join();
+        return sum;
+    }
+
+    void benchmarkSpscSingle()
+    {
+        static spscRing<uint64_t, 1024> ring;
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = runTransfer([]()
+            {
+                for (uint64_t i = 0u; i < numItems; ++i)
+                {
+                    while (!ring.try_push(i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }, []()
+            {
+                uint64_t sum = 0u;
+                uint64_t value = 0u;
+                for (uint64_t received = 0u; received < numItems;)
+                {
+                    if (ring.try_pop(value))
+                    {
+                        sum += value;
+                        ++received;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                return sum;
+            });
+        });
+        benchmark::Report("spscRing<1024>: try_push/try_pop", ns, numItems, checksum == expectedSum);
+    }
+
+    void benchmarkSpscBulk()
+    {
+        static spscRing<uint64_t, 1024> ring;
+        constexpr size_t batchSize = 64u;
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = runTransfer([]()
+            {
+                std::vector<uint64_t> batch(batchSize);
+                for (uint64_t next = 0u; next < numItems; next += batchSize)
+                {
+                    for (size_t i = 0u; i < batchSize; ++i)
+                    {
+                        batch[i] = next + i;
+                    }
+                    for (size_t pushed = 0u; pushed < batchSize;)
+                    {
+                        const size_t count = ring.push_n(std::span<const uint64_t>(batch.data() + pushed, batchSize - pushed));
+                        pushed += count;
+                        if (count == 0u)
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                }
+            }, []()
+            {
+                std::vector<uint64_t> batch(batchSize);
+                uint64_t sum = 0u;
+                for (uint64_t received = 0u; received < numItems;)
+                {
+                    const size_t count = ring.pop_n(batch);
+                    for (size_t i = 0u; i < count; ++i)
+                    {
+                        sum += batch[i];
+                    }
+                    received += count;
+                    if (count == 0u)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                return sum;
+            });
+        });
+        benchmark::Report("spscRing<1024>: push_n/pop_n, batches of 64", ns, numItems, checksum == expectedSum);
+    }
+
+#ifdef _MSC_VER
+    void benchmarkMwsrQueue()
+    {
+        static mwsrQueue<uint64_t> queue;
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = runTransfer([]()
+            {
+                for (uint64_t i = 0u; i < numItems; ++i)
+                {
+                    queue.push(uint64_t(i));
+                }
+            }, []()
+            {
+                uint64_t sum = 0u;
+                for (uint64_t received = 0u; received < numItems; ++received)
+                {
+                    sum += queue.pop();
+                }
+                return sum;
+            });
+        });
+        benchmark::Report("mwsrQueue: push/pop, one writer", ns, numItems, checksum == expectedSum);
+    }
+#endif
+
+    void benchmarkMutexDeque()
+    {
+        std::mutex mutex;
+        std::deque<uint64_t> queue;
+        uint64_t checksum = 0u;
+        const double ns = benchmark::MeasureBestOf(numRepetitions, [&]()
+        {
+            checksum = runTransfer([&]()
+            {
+                for (uint64_t i = 0u; i < numItems; ++i)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    queue.push_back(i);
+                }
+            }, [&]()
+            {
+                uint64_t sum = 0u;
+                for (uint64_t received = 0u; received < numItems;)
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (queue.empty())
+                    {
+                        lock.unlock();
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    sum += queue.front();
+                    queue.pop_front();
+                    ++received;
+                }
+                return sum;
+            });
+        });
+        benchmark::Report("std::mutex + std::deque: push/pop", ns, numItems, checksum == expectedSum);
+    }
+
+}
+
+// Checksum is 1 when every item arrived
+int main()
+{
+    benchmarkSpscSingle();
+    benchmarkSpscBulk();
+#ifdef _MSC_VER
+    benchmarkMwsrQueue();
+#endif
+    benchmarkMutexDeque();
+    return 0;
+}
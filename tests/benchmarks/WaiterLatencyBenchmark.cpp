@@ -0,0 +1,130 @@
+#include "BenchmarkCommon.hpp"
+#include "threading/ExponentialBackoffSleeper.hpp"
+#include "threading/HybridWaiter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+/*
+    Wake latency of an idle worker loop, the way ResourceContextImpl and ResourceTransferSystem wait
+    for uploads: a producer posts one item at a time after a random idle gap, and the worker notes
+    how long after posting it picked the item up. HybridWaiter is woken by notify(), while
+    ExponentialBackoffSleeper only finds the work once its current sleep runs out.
+*/
+
+namespace
+{
+
+    constexpr size_t numItems = 400u;
+
+    uint64_t now_ns()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            benchmark::clock::now().time_since_epoch()).count());
+    }
+
+    // Posted timestamp of the pending item, or 0 when the worker has taken it
+    std::atomic<uint64_t> pendingPostNs{ 0u };
+
+    template<typename NotifyFn>
+    void produce(NotifyFn&& notify)
+    {
+        std::mt19937 rng(7u);
+        // Mix of back-to-back work and gaps long enough for the waiters to back off into sleeping
+        std::uniform_int_distribution<int> gapUs(0, 3000);
+        for (size_t i = 0u; i < numItems; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(gapUs(rng)));
+            pendingPostNs.store(now_ns(), std::memory_order_release);
+            notify();
+            while (pendingPostNs.load(std::memory_order_acquire) != 0u)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool takeItem(std::vector<uint64_t>& latencies)
+    {
+        const uint64_t posted = pendingPostNs.load(std::memory_order_acquire);
+        if (posted == 0u)
+        {
+            return false;
+        }
+        latencies.emplace_back(now_ns() - posted);
+        pendingPostNs.store(0u, std::memory_order_release);
+        return true;
+    }
+
+    void reportDistribution(const char* name, std::vector<uint64_t>& latencies)
+    {
+        std::sort(latencies.begin(), latencies.end());
+        auto percentileUs = [&](double p)
+        {
+            const size_t idx = std::min(latencies.size() - 1u, static_cast<size_t>(p * static_cast<double>(latencies.size())));
+            return static_cast<double>(latencies[idx]) * 1.0e-3;
+        };
+        std::printf("%-32s p50 %9.1f us  p90 %9.1f us  p99 %9.1f us  max %9.1f us\n", name, percentileUs(0.5),
+            percentileUs(0.9), percentileUs(0.99), static_cast<double>(latencies.back()) * 1.0e-3);
+    }
+
+    void benchmarkHybridWaiter()
+    {
+        // Tuned the way an upload worker would be: spin briefly, never sleep past 2ms without re-checking
+        foundation::HybridWaiterConfig config;
+        config.maxSpinDuration = std::chrono::microseconds(50);
+        config.minSleepDuration = std::chrono::microseconds(100);
+        config.maxSleepDuration = std::chrono::microseconds(2000);
+        foundation::HybridWaiter waiter(config);
+        std::vector<uint64_t> latencies;
+        latencies.reserve(numItems);
+
+        std::thread producer([&]() { produce([&]() { waiter.notify(); }); });
+        while (latencies.size() < numItems)
+        {
+            const uint32_t token = waiter.prepareWait();
+            if (takeItem(latencies))
+            {
+                waiter.reset();
+            }
+            else if (!waiter.wait(token))
+            {
+                waiter.backoff();
+            }
+        }
+        producer.join();
+        reportDistribution("HybridWaiter", latencies);
+    }
+
+    void benchmarkBackoffSleeper()
+    {
+        foundation::ExponentialBackoffSleeper sleeper;
+        std::vector<uint64_t> latencies;
+        latencies.reserve(numItems);
+
+        std::thread producer([&]() { produce([]() {}); });
+        while (latencies.size() < numItems)
+        {
+            if (takeItem(latencies))
+            {
+                sleeper.reset();
+            }
+            else
+            {
+                sleeper.sleepAndBackoff();
+            }
+        }
+        producer.join();
+        reportDistribution("ExponentialBackoffSleeper", latencies);
+    }
+
+}
+
+int main()
+{
+    benchmarkHybridWaiter();
+    benchmarkBackoffSleeper();
+    return 0;
+}
@@ -241,7 +241,7 @@ void ContentCompilerScene::renderObject(VkCommandBuffer cmd)
     const VkBuffer vbo[1]{ (VkBuffer)meshVBO->Handle };
     constexpr static VkDeviceSize offsets[1]{ 0u };
     vkCmdBindVertexBuffers(cmd, 0u, 1u, vbo, offsets);
-    vkCmdBindIndexBuffer(cmd, (VkBuffer)meshEBO->Handle, 0u, VK_INDEX_TYPE_UINT32);
+    vkCmdBindIndexBuffer(cmd, (VkBuffer)meshEBO->Handle, 0u, (VkIndexType)modelData.indexType);
     vkCmdDrawIndexedIndirect(cmd, (VkBuffer)indirectDrawBuffer->Handle, 0u, static_cast<uint32_t>(indirectDraws.size()), sizeof(VkDrawIndexedIndirectCommand));
 }
 
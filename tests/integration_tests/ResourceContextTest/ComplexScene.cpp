@@ -93,12 +93,12 @@ struct skybox_mesh_data_t
 struct stb_image_data_t
 {
 
-    stb_image_data_t(const char* fname)
+    stb_image_data_t(std::span<const std::byte> file_data)
     {
-        pixels = stbi_load(fname, &width, &height, &channels, 4);
+        pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file_data.data()), static_cast<int>(file_data.size()), &width, &height, &channels, 4);
         if (!pixels)
         {
-            throw std::runtime_error("Invalid file path for stb_load");
+            throw std::runtime_error("Invalid image data for stbi_load_from_memory");
         }
     }
 
@@ -124,7 +124,17 @@ struct vertex_hash
     }
 };
 
-LoadedObjModel::LoadedObjModel(const char* fname)
+// Lets tinyobj's istream interface read the mapped file in place
+struct span_streambuf : std::streambuf
+{
+    span_streambuf(std::span<const std::byte> data)
+    {
+        char* begin = const_cast<char*>(reinterpret_cast<const char*>(data.data()));
+        setg(begin, begin, begin + data.size());
+    }
+};
+
+LoadedObjModel::LoadedObjModel(std::span<const std::byte> file_data)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
@@ -133,7 +143,10 @@ LoadedObjModel::LoadedObjModel(const char* fname)
     std::string warnings;
     
     {
-        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warnings, &err, fname))
+        span_streambuf file_buffer(file_data);
+        std::istream file_stream(&file_buffer);
+        tinyobj::MaterialFileReader material_reader("");
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warnings, &err, &file_stream, &material_reader))
         {
             std::cerr << "Internal error in tinyobj_opt, couldn't load model data! Error: " << err;
             throw std::runtime_error(err);
@@ -302,42 +315,34 @@ void VulkanComplexScene::Destroy()
     skyboxEboReply.reset();
 }
 
-void* VulkanComplexScene::LoadObjFile(const char* fname, void* user_data)
-{
-    return new LoadedObjModel(fname);
-}
-
-void VulkanComplexScene::DestroyObjFileData(void* obj_file, void* user_data)
-{
-    LoadedObjModel* model = reinterpret_cast<LoadedObjModel*>(obj_file);
-    delete model;
-}
-
-void* VulkanComplexScene::LoadPngImage(const char* fname, void* user_data)
+// The decoded data in these only lives until it's been copied into staging memory
+void* VulkanComplexScene::LoadObjFile(const char* fname, std::span<const std::byte> file_data, void* user_data)
 {
-    return new stb_image_data_t(fname);
+    const LoadedObjModel model(file_data);
+    return reinterpret_cast<VulkanComplexScene*>(user_data)->CreateHouseMesh(&model);
 }
 
-void VulkanComplexScene::DestroyPngFileData(void * jpeg_file, void* user_data)
+void* VulkanComplexScene::LoadPngImage(const char* fname, std::span<const std::byte> file_data, void* user_data)
 {
-    stb_image_data_t* image = reinterpret_cast<stb_image_data_t*>(jpeg_file);
-    delete image;
+    const stb_image_data_t image(file_data);
+    return reinterpret_cast<VulkanComplexScene*>(user_data)->CreateHouseTexture(&image);
 }
 
-void* VulkanComplexScene::LoadCompressedTexture(const char* fname, void* user_data)
+void* VulkanComplexScene::LoadCompressedTexture(const char* fname, std::span<const std::byte> file_data, void* user_data)
 {
-    return new gli::texture_cube(gli::load(fname));
+    const gli::texture_cube texture(gli::load(reinterpret_cast<const char*>(file_data.data()), file_data.size()));
+    return reinterpret_cast<VulkanComplexScene*>(user_data)->CreateSkyboxTexture(&texture);
 }
 
-void VulkanComplexScene::DestroyCompressedTextureData(void* compressed_texture, void* user_data)
+void VulkanComplexScene::DestroyStagedAsset(void* staged_asset, void* user_data)
 {
-    gli::texture_cube* texture = reinterpret_cast<gli::texture_cube*>(compressed_texture);
-    delete texture;
+    StagedAsset* asset = reinterpret_cast<StagedAsset*>(staged_asset);
+    delete asset;
 }
 
-void VulkanComplexScene::CreateHouseMesh(void * obj_data)
+StagedAsset* VulkanComplexScene::CreateHouseMesh(const void* obj_data)
 {
-    LoadedObjModel* obj_model = reinterpret_cast<LoadedObjModel*>(obj_data);
+    const LoadedObjModel* obj_model = reinterpret_cast<const LoadedObjModel*>(obj_data);
     const auto device = vprObjects.device;
 
     const uint32_t queueFamilyIndices[2]
@@ -358,12 +363,13 @@ void VulkanComplexScene::CreateHouseMesh(void * obj_data)
         queueFamilyIndices
     };
 
-    // Test multi-copy functionality of resource context, by merging these two 
-    // separate data buffers into a single VkBuffer
+    gpu_staging_reservation_t vbo_staging = resourceContext->ReserveStaging(static_cast<size_t>(vbo_info.size));
+    std::memcpy(vbo_staging.Data, obj_model->vertices.data(), vbo_staging.Size);
+
     const gpu_resource_data_t vbo_data
     {
-        obj_model->vertices.data(),
-        sizeof(LoadedObjModel::vertex_t) * obj_model->vertices.size(),
+        vbo_staging.Data,
+        vbo_staging.Size,
         0,
         0
     };
@@ -380,10 +386,13 @@ void VulkanComplexScene::CreateHouseMesh(void * obj_data)
         queueFamilyIndices
     };
 
+    gpu_staging_reservation_t ebo_staging = resourceContext->ReserveStaging(static_cast<size_t>(ebo_info.size));
+    std::memcpy(ebo_staging.Data, obj_model->indices.data(), ebo_staging.Size);
+
     const gpu_resource_data_t ebo_data
     {
-        obj_model->indices.data(),
-        static_cast<size_t>(ebo_info.size),
+        ebo_staging.Data,
+        ebo_staging.Size,
         0,
         0
     };
@@ -395,18 +404,20 @@ void VulkanComplexScene::CreateHouseMesh(void * obj_data)
     VkBufferCreateInfo vbo_info_val = vbo_info;
     VkBufferCreateInfo ebo_info_val = ebo_info;
     
-    houseVboReply = resourceContext->CreateBuffer(
+    houseVboReply = resourceContext->CreateBufferFromStaging(
         vbo_info_val, 
         nullptr, 
+        std::move(vbo_staging), 
         &vbo_data, 
         1, 
         resource_usage::GPUOnly, 
         creationFlags, 
         (void*)houseVBO_Str);
     
-    houseEboReply = resourceContext->CreateBuffer(
+    houseEboReply = resourceContext->CreateBufferFromStaging(
         ebo_info_val, 
         nullptr, 
+        std::move(ebo_staging), 
         &ebo_data, 
         1, 
         resource_usage::GPUOnly, 
@@ -415,11 +426,12 @@ void VulkanComplexScene::CreateHouseMesh(void * obj_data)
 
     houseIndexCount = static_cast<uint32_t>(obj_model->indices.size());
 
+    return new StagedAsset{ { houseVboReply, houseEboReply } };
 }
 
-void VulkanComplexScene::CreateHouseTexture(void * texture_data)
+StagedAsset* VulkanComplexScene::CreateHouseTexture(const void* texture_data)
 {
-    stb_image_data_t* image_data = reinterpret_cast<stb_image_data_t*>(texture_data);
+    const stb_image_data_t* image_data = reinterpret_cast<const stb_image_data_t*>(texture_data);
 
     const uint32_t queueFamilyIndices[2]
     {
@@ -458,12 +470,16 @@ void VulkanComplexScene::CreateHouseTexture(void * texture_data)
         VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
     };
 
+    // stbi was asked for 4 channels, whatever the file has
+    gpu_staging_reservation_t staging = resourceContext->ReserveStaging(sizeof(stbi_uc) * image_data->width * image_data->height * 4u);
+    std::memcpy(staging.Data, image_data->pixels, staging.Size);
+
     const gpu_image_resource_data_t initial_texture_data[1]
     {
         gpu_image_resource_data_t
         {
-            image_data->pixels,
-            sizeof(stbi_uc) * image_data->width * image_data->height * image_data->channels,
+            staging.Data,
+            staging.Size,
             static_cast<uint32_t>(image_data->width), 
             static_cast<uint32_t>(image_data->height),
         }
@@ -475,23 +491,25 @@ void VulkanComplexScene::CreateHouseTexture(void * texture_data)
     VkImageCreateInfo image_info_val = image_info;
     VkImageViewCreateInfo view_info_val = view_info;
     
-    houseTextureReply = resourceContext->CreateImage(
+    houseTextureReply = resourceContext->CreateImageFromStaging(
         image_info_val, 
         &view_info_val, 
+        std::move(staging), 
         initial_texture_data, 
         1, 
         resource_usage::GPUOnly, 
         creationFlags, 
         (void*)houseTextureStr);
 
+    return new StagedAsset{ { houseTextureReply } };
 }
 
-void VulkanComplexScene::CreateSkyboxTexture(void * texture_data)
+StagedAsset* VulkanComplexScene::CreateSkyboxTexture(const void* texture_data)
 {
 
     std::cout << "Creating backing resources for loaded compressed skybox texture...\n";
 
-    gli::texture_cube* texture = reinterpret_cast<gli::texture_cube*>(texture_data);
+    const gli::texture_cube* texture = reinterpret_cast<const gli::texture_cube*>(texture_data);
     const uint32_t width = static_cast<uint32_t>(texture->extent().x);
     const uint32_t height = static_cast<uint32_t>(texture->extent().y);
     const uint32_t mipLevels = static_cast<uint32_t>(texture->levels());
@@ -535,6 +553,12 @@ void VulkanComplexScene::CreateSkyboxTexture(void * texture_data)
 
     const size_t total_size = texture->size();
 
+    // Faces and mips are contiguous in gli's storage, so one copy stages them all at the same offsets
+    gpu_staging_reservation_t staging = resourceContext->ReserveStaging(total_size);
+    std::memcpy(staging.Data, texture->data(), total_size);
+    const std::byte* texture_base = reinterpret_cast<const std::byte*>(texture->data());
+    std::byte* staging_base = reinterpret_cast<std::byte*>(staging.Data);
+
     std::cout << "Creating image copy data, making sure layers and mips are correctly transferred...\n";
     std::vector<gpu_image_resource_data_t> image_copies;
     for (size_t i = 0; i < 6; ++i)
@@ -544,7 +568,7 @@ void VulkanComplexScene::CreateSkyboxTexture(void * texture_data)
             auto& ref = *texture;
             image_copies.emplace_back(gpu_image_resource_data_t
             {
-                ref[i][j].data(),
+                staging_base + (reinterpret_cast<const std::byte*>(ref[i][j].data()) - texture_base),
                 ref[i][j].size(),
                 static_cast<uint32_t>(ref[i][j].extent().x),
                 static_cast<uint32_t>(ref[i][j].extent().y),
@@ -562,15 +586,17 @@ void VulkanComplexScene::CreateSkyboxTexture(void * texture_data)
     VkImageCreateInfo image_info_val = image_info;
     VkImageViewCreateInfo view_info_val = view_info;
     
-    skyboxTextureReply = resourceContext->CreateImage(
+    skyboxTextureReply = resourceContext->CreateImageFromStaging(
         image_info_val, 
         &view_info_val, 
+        std::move(staging), 
         image_copies.data(), 
         image_copies.size(), 
         resource_usage::GPUOnly, 
         creationFlags, 
         (void*)skyboxTextureStr);
-    
+
+    return new StagedAsset{ { skyboxTextureReply } };
 }
 
 bool VulkanComplexScene::AllAssetsLoaded()
@@ -605,8 +631,8 @@ void VulkanComplexScene::update()
 
 void VulkanComplexScene::recordCommands()
 {
-
-    if (!skyboxTexture && skyboxTextureReply->IsCompleted())
+    // Replies are set by the loader factories, so until those have run (at startup, or after a resize) some are still null
+    if (!skyboxTexture && skyboxTextureReply && skyboxTextureReply->IsCompleted())
     {
         skyboxTexture = skyboxTextureReply->GetResource();
         updateSkyboxDescriptorSet();
@@ -614,32 +640,32 @@ void VulkanComplexScene::recordCommands()
         skyboxTextureReply.reset();
     }
 
-    if (!houseTexture && houseTextureReply->IsCompleted())
+    if (!houseTexture && houseTextureReply && houseTextureReply->IsCompleted())
     {
         houseTexture = houseTextureReply->GetResource();
         updateHouseDescriptorSet();
         houseTextureReply.reset();
     }
 
-    if (!skyboxVBO && skyboxVboReply->IsCompleted())
+    if (!skyboxVBO && skyboxVboReply && skyboxVboReply->IsCompleted())
     {
         skyboxVBO = skyboxVboReply->GetResource();
         skyboxVboReply.reset();
     }
 
-    if (!skyboxEBO && skyboxEboReply->IsCompleted())
+    if (!skyboxEBO && skyboxEboReply && skyboxEboReply->IsCompleted())
     {
         skyboxEBO = skyboxEboReply->GetResource();
         skyboxEboReply.reset();
     }
 
-    if (!houseVBO && houseVboReply->IsCompleted())
+    if (!houseVBO && houseVboReply && houseVboReply->IsCompleted())
     {
         houseVBO = houseVboReply->GetResource();
         houseVboReply.reset();
     }
 
-    if (!houseEBO && houseEboReply->IsCompleted())
+    if (!houseEBO && houseEboReply && houseEboReply->IsCompleted())
     {
         houseEBO = houseEboReply->GetResource();
         houseEboReply.reset();
@@ -6,6 +6,8 @@
 #include "CommonCreationFunctions.hpp"
 #include "ResourceTypes.hpp"
 #include "ResourceMessageReply.hpp"
+#include <cstddef>
+#include <span>
 #include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -13,7 +15,7 @@
 
 struct LoadedObjModel
 {
-    LoadedObjModel(const char* fname);
+    LoadedObjModel(std::span<const std::byte> file_data);
     struct vertex_t
     {
         bool operator==(const vertex_t& other) const noexcept
@@ -27,6 +29,12 @@ struct LoadedObjModel
     std::vector<uint32_t> indices;
 };
 
+// What the loader holds on to for an asset once its decoded data has been handed to the ResourceContext
+struct StagedAsset
+{
+    std::vector<std::shared_ptr<GraphicsResourceReply>> Replies;
+};
+
 class ResourceContext;
 
 class VulkanComplexScene : public VulkanScene
@@ -40,16 +48,16 @@ public:
     void Construct(RequiredVprObjects objects, void* user_data) final;
     void Destroy() final;
 
-    static void* LoadObjFile(const char* fname, void* user_data = nullptr);
-    static void DestroyObjFileData(void* obj_file, void* user_data);
-    static void* LoadPngImage(const char* fname, void* user_data = nullptr);
-    static void DestroyPngFileData(void* jpeg_file, void* user_data);
-    static void* LoadCompressedTexture(const char* fname, void* user_data = nullptr);
-    static void DestroyCompressedTextureData(void* compressed_texture, void* user_data);
+    // user_data is the scene: these decode, copy straight into staging memory and queue the uploads, all on the
+    // loader thread, and return a StagedAsset
+    static void* LoadObjFile(const char* fname, std::span<const std::byte> file_data, void* user_data);
+    static void* LoadPngImage(const char* fname, std::span<const std::byte> file_data, void* user_data);
+    static void* LoadCompressedTexture(const char* fname, std::span<const std::byte> file_data, void* user_data);
+    static void DestroyStagedAsset(void* staged_asset, void* user_data);
 
-    void CreateHouseMesh(void* obj_data);
-    void CreateHouseTexture(void* texture_data);
-    void CreateSkyboxTexture(void* texture_data);
+    StagedAsset* CreateHouseMesh(const void* obj_data);
+    StagedAsset* CreateHouseTexture(const void* texture_data);
+    StagedAsset* CreateSkyboxTexture(const void* texture_data);
 
     bool AllAssetsLoaded();
     void WaitForAllLoaded();
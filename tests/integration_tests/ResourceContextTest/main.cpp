@@ -19,26 +19,24 @@ static const std::string SkyboxDdsFile = SkyboxTexturePath.string();
 static bool dataLoadedToRAM = false;
 static std::unique_ptr<ResourceContext> resourceContext{ nullptr };
 
-static void objFileLoadedCallback(void* scene_ptr, void* data_ptr, void* user_data)
+// The factories already queued the uploads from the loader thread, so there's nothing left to do here
+static void assetStagedCallback(void* scene_ptr, void* staged_asset, void* user_data)
 {
-    reinterpret_cast<VulkanComplexScene*>(scene_ptr)->CreateHouseMesh(data_ptr);
-}
-
-static void jpegLoadedCallback(void* scene_ptr, void* data_ptr, void* user_data)
-{
-    reinterpret_cast<VulkanComplexScene*>(scene_ptr)->CreateHouseTexture(data_ptr);
-}
-
-static void skyboxLoadedCallback(void* scene_ptr, void* data, void* user_data)
-{
-    reinterpret_cast<VulkanComplexScene*>(scene_ptr)->CreateSkyboxTexture(data);
 }
 
 static void BeginResizeCallback(VkSwapchainKHR handle, uint32_t width, uint32_t height, void* userData)
 {
     auto& loader = ResourceLoader::GetResourceLoader();
     loader.Stop(); // get threads to finish pending work
-    
+
+    // The staged assets hold replies from the context we're about to destroy. If they stayed loaded, the
+    // Load() calls in CompleteResizeCallback would come back AlreadyLoaded and the factories wouldn't run
+    // again for the new context. (An Unload() in the main loop is a no-op if the load hadn't finished yet.)
+    loader.Unload("OBJ", HouseObjFile.c_str());
+    loader.Unload("PNG", HousePngFile.c_str());
+    loader.Unload("DDS", SkyboxDdsFile.c_str());
+    dataLoadedToRAM = false;
+
     auto& scene = VulkanComplexScene::GetScene();
     scene.Destroy();
     resourceContext.reset();
@@ -62,9 +60,9 @@ static void CompleteResizeCallback(VkSwapchainKHR handle, uint32_t width, uint32
     loader.Start(); // restart threads
 
     auto& rsrc_loader = ResourceLoader::GetResourceLoader();
-    rsrc_loader.Load("OBJ", HouseObjFile.c_str(), &scene, objFileLoadedCallback, nullptr);
-    rsrc_loader.Load("PNG", HousePngFile.c_str(), &scene, jpegLoadedCallback, nullptr);
-    rsrc_loader.Load("DDS", SkyboxDdsFile.c_str(), &scene, skyboxLoadedCallback, nullptr);
+    rsrc_loader.Load("OBJ", HouseObjFile.c_str(), &scene, assetStagedCallback, &scene);
+    rsrc_loader.Load("PNG", HousePngFile.c_str(), &scene, assetStagedCallback, &scene);
+    rsrc_loader.Load("DDS", SkyboxDdsFile.c_str(), &scene, assetStagedCallback, &scene);
     dataLoadedToRAM = true;
 }
 
@@ -103,16 +101,16 @@ int main(int argc, char* argv[])
     };
     resourceContext->Initialize(create_info);
     auto& rsrc_loader = ResourceLoader::GetResourceLoader();
-    rsrc_loader.Subscribe("OBJ", &VulkanComplexScene::LoadObjFile, &VulkanComplexScene::DestroyObjFileData);
-    rsrc_loader.Subscribe("PNG", &VulkanComplexScene::LoadPngImage, &VulkanComplexScene::DestroyPngFileData);
-    rsrc_loader.Subscribe("DDS", &VulkanComplexScene::LoadCompressedTexture, &VulkanComplexScene::DestroyCompressedTextureData);
+    rsrc_loader.Subscribe("OBJ", &VulkanComplexScene::LoadObjFile, &VulkanComplexScene::DestroyStagedAsset);
+    rsrc_loader.Subscribe("PNG", &VulkanComplexScene::LoadPngImage, &VulkanComplexScene::DestroyStagedAsset);
+    rsrc_loader.Subscribe("DDS", &VulkanComplexScene::LoadCompressedTexture, &VulkanComplexScene::DestroyStagedAsset);
 
     auto& scene = VulkanComplexScene::GetScene();
     scene.Construct(RequiredVprObjects{ context.Device(), context.PhysicalDevice(), context.Instance(), context.Swapchain() }, resourceContext.get());
 
-    rsrc_loader.Load("OBJ", HouseObjFile.c_str(), &scene, objFileLoadedCallback, nullptr);
-    rsrc_loader.Load("PNG", HousePngFile.c_str(), &scene, jpegLoadedCallback, nullptr);
-    rsrc_loader.Load("DDS", SkyboxDdsFile.c_str(), &scene, skyboxLoadedCallback, nullptr);
+    rsrc_loader.Load("OBJ", HouseObjFile.c_str(), &scene, assetStagedCallback, &scene);
+    rsrc_loader.Load("PNG", HousePngFile.c_str(), &scene, assetStagedCallback, &scene);
+    rsrc_loader.Load("DDS", SkyboxDdsFile.c_str(), &scene, assetStagedCallback, &scene);
     dataLoadedToRAM = true;
 
     SwapchainCallbacks callbacks;
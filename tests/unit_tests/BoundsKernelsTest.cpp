@@ -0,0 +1,241 @@
+#include "UnitTest.hpp"
+#include "math/BoundsKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+    Every SIMD level has to give bit-identical results to the scalar reference, for any count: the vector
+    loops hand their tails to the scalar code, so sizes around each multiple of the lane width matter most.
+    Inputs include NaNs and degenerate boxes (flat, and inside out), so any level that orders the operands
+    of a min, max or comparison differently from the scalar code shows up.
+*/
+
+namespace
+{
+
+    using namespace foundation;
+
+    constexpr size_t maxCount = 200u;
+
+    struct soa_boxes
+    {
+        std::vector<float> components[6];
+
+        explicit soa_boxes(const size_t count)
+        {
+            for (std::vector<float>& component : components)
+            {
+                component.resize(count);
+            }
+        }
+
+        aabb_soa_view view(const size_t count) const noexcept
+        {
+            return aabb_soa_view{ components[0].data(), components[1].data(), components[2].data(),
+                components[3].data(), components[4].data(), components[5].data(), count };
+        }
+
+        aabb_soa_output output() noexcept
+        {
+            return aabb_soa_output{ components[0].data(), components[1].data(), components[2].data(),
+                components[3].data(), components[4].data(), components[5].data() };
+        }
+
+        bool operator==(const soa_boxes& other) const noexcept
+        {
+            for (size_t i = 0u; i < 6u; ++i)
+            {
+                if (components[i].size() != other.components[i].size() ||
+                    std::memcmp(components[i].data(), other.components[i].data(), components[i].size() * sizeof(float)) != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    bool sameBits(const std::vector<float>& lhs, const std::vector<float>& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(float)) == 0;
+    }
+
+    bool sameBits(const aabb_bounds& lhs, const aabb_bounds& rhs) noexcept
+    {
+        return std::memcmp(lhs.min, rhs.min, sizeof(lhs.min)) == 0 && std::memcmp(lhs.max, rhs.max, sizeof(lhs.max)) == 0;
+    }
+
+    struct test_inputs
+    {
+        test_inputs() : boxes(maxCount), otherBoxes(maxCount), points{ std::vector<float>(maxCount), std::vector<float>(maxCount), std::vector<float>(maxCount) }, radii(maxCount)
+        {
+            std::mt19937 rng(0xb0b5u);
+            std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+            std::uniform_real_distribution<float> extent(0.0f, 20.0f);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_int_distribution<int> special(0, 19);
+            const float nan = std::numeric_limits<float>::quiet_NaN();
+
+            auto fillBoxes = [&](soa_boxes& target)
+            {
+                for (size_t i = 0u; i < maxCount; ++i)
+                {
+                    for (size_t axis = 0u; axis < 3u; ++axis)
+                    {
+                        float& min = target.components[axis][i];
+                        float& max = target.components[axis + 3u][i];
+                        min = position(rng);
+                        max = min + extent(rng);
+                        switch (special(rng))
+                        {
+                        case 0:
+                            // Flat
+                            max = min;
+                            break;
+                        case 1:
+                            // Inside out
+                            std::swap(min, max);
+                            min += 1.0f;
+                            break;
+                        case 2:
+                            min = nan;
+                            break;
+                        case 3:
+                            max = nan;
+                            break;
+                        default:
+                            break;
+                        }
+                    }
+                }
+            };
+            fillBoxes(boxes);
+            fillBoxes(otherBoxes);
+
+            for (size_t i = 0u; i < maxCount; ++i)
+            {
+                for (std::vector<float>& component : points)
+                {
+                    component[i] = special(rng) == 0 ? nan : position(rng);
+                }
+                const int kind = special(rng);
+                radii[i] = kind == 0 ? 0.0f : kind == 1 ? nan : extent(rng);
+            }
+
+            for (size_t p = 0u; p < 6u; ++p)
+            {
+                const float nx = unit(rng);
+                const float ny = unit(rng);
+                const float nz = unit(rng);
+                const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+                planes.nx[p] = nx / length;
+                planes.ny[p] = ny / length;
+                planes.nz[p] = nz / length;
+                planes.d[p] = position(rng) * 0.5f;
+            }
+
+            for (size_t i = 0u; i < 16u; ++i)
+            {
+                matrix[i] = unit(rng) * 2.0f;
+            }
+            matrix[3] = 0.0f;
+            matrix[7] = 0.0f;
+            matrix[11] = 0.0f;
+            matrix[15] = 1.0f;
+            matrix[12] = position(rng);
+        }
+
+        soa_boxes boxes;
+        soa_boxes otherBoxes;
+        std::vector<float> points[3];
+        std::vector<float> radii;
+        frustum_planes planes;
+        float matrix[16];
+    };
+
+    void compareWithScalar(const simd_level level, const test_inputs& inputs)
+    {
+        const bounds_kernel_table& scalar = GetBoundsKernelTable(simd_level::Scalar);
+        const bounds_kernel_table& kernels = GetBoundsKernelTable(level);
+        UT_CHECK(kernels.level == level);
+        UT_CHECK(scalar.level == simd_level::Scalar);
+
+        for (size_t count = 0u; count <= maxCount; ++count)
+        {
+            const aabb_soa_view boxes = inputs.boxes.view(count);
+            const aabb_soa_view otherBoxes = inputs.otherBoxes.view(count);
+            const sphere_soa_view spheres{ inputs.points[0].data(), inputs.points[1].data(), inputs.points[2].data(), inputs.radii.data(), count };
+            const point_soa_view points{ inputs.points[0].data(), inputs.points[1].data(), inputs.points[2].data(), count };
+
+            {
+                // One past the count, to check nothing writes beyond it
+                std::vector<uint8_t> expected(count + 1u, 0xcdu);
+                std::vector<uint8_t> result(count + 1u, 0xcdu);
+                UT_CHECK(scalar.cullAABBs(inputs.planes, boxes, expected.data()) == kernels.cullAABBs(inputs.planes, boxes, result.data()));
+                UT_CHECK(expected == result);
+                UT_CHECK(scalar.cullSpheres(inputs.planes, spheres, expected.data()) == kernels.cullSpheres(inputs.planes, spheres, result.data()));
+                UT_CHECK(expected == result);
+            }
+
+            {
+                std::vector<float> expected[3]{ std::vector<float>(count + 1u, -1.0f), std::vector<float>(count + 1u, -1.0f), std::vector<float>(count + 1u, -1.0f) };
+                std::vector<float> result[3]{ std::vector<float>(count + 1u, -1.0f), std::vector<float>(count + 1u, -1.0f), std::vector<float>(count + 1u, -1.0f) };
+                scalar.transformPoints(inputs.matrix, points, point_soa_output{ expected[0].data(), expected[1].data(), expected[2].data() });
+                kernels.transformPoints(inputs.matrix, points, point_soa_output{ result[0].data(), result[1].data(), result[2].data() });
+                UT_CHECK(sameBits(expected[0], result[0]) && sameBits(expected[1], result[1]) && sameBits(expected[2], result[2]));
+            }
+
+            {
+                soa_boxes expected(count + 1u);
+                soa_boxes result(count + 1u);
+                scalar.transformAABBs(inputs.matrix, boxes, expected.output());
+                kernels.transformAABBs(inputs.matrix, boxes, result.output());
+                UT_CHECK(expected == result);
+
+                scalar.mergeAABBs(boxes, otherBoxes, expected.output());
+                kernels.mergeAABBs(boxes, otherBoxes, result.output());
+                UT_CHECK(expected == result);
+
+                // In place, as the output is allowed to alias an input
+                soa_boxes inPlace = inputs.boxes;
+                kernels.mergeAABBs(inPlace.view(count), otherBoxes, inPlace.output());
+                UT_CHECK(std::equal(expected.components, expected.components + 6, inPlace.components, [count](const std::vector<float>& lhs, const std::vector<float>& rhs)
+                {
+                    return std::memcmp(lhs.data(), rhs.data(), count * sizeof(float)) == 0;
+                }));
+            }
+
+            UT_CHECK(sameBits(scalar.reduceAABBs(boxes), kernels.reduceAABBs(boxes)));
+            UT_CHECK(sameBits(scalar.reduceAABBs(otherBoxes), kernels.reduceAABBs(otherBoxes)));
+        }
+    }
+
+    // Levels the CPU can't run just fall back, so those are skipped rather than tested twice
+    void testLevel(const simd_level level, const test_inputs& inputs)
+    {
+        if (GetBoundsKernelTable(level).level != level)
+        {
+            std::printf("SKIPPED: %s bounds kernels, not supported here\n", GetSimdLevelName(level));
+            return;
+        }
+        const std::string name = std::string(GetSimdLevelName(level)) + " bounds kernels match scalar";
+        unit_test::Run(name.c_str(), [&]() { compareWithScalar(level, inputs); });
+    }
+
+}
+
+int main()
+{
+    const test_inputs inputs;
+    testLevel(simd_level::SSE, inputs);
+    testLevel(simd_level::AVX2, inputs);
+    testLevel(simd_level::NEON, inputs);
+    return unit_test::Result();
+}
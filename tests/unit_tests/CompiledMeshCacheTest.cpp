@@ -0,0 +1,226 @@
+#include "UnitTest.hpp"
+#include "CompiledMeshCache.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+    constexpr uint64_t sourceHash = 0x1234567890abcdefull;
+    constexpr uint64_t recipeHash = 0xfedcba0987654321ull;
+
+    // Two triangles, positions and uvs, two materials in one group
+    ObjectModelDataImpl makeModel()
+    {
+        ObjectModelDataImpl model;
+        model.vertexStride = 5u * sizeof(float);
+        model.vertexData = {
+            0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+            1.0f, 1.0f, 0.5f, 1.0f, 0.0f,
+            0.0f, 1.0f, -0.5f, 0.0f, 0.0f
+        };
+        model.vertexMetadata = { VertexMetadataEntry{ 0u, 106u, 0u }, VertexMetadataEntry{ 1u, 103u, 3u * sizeof(float) } };
+        model.indices = { 0u, 1u, 2u, 0u, 2u, 3u };
+        model.materialRanges = { MaterialRange{ "red", 0u, 3u }, MaterialRange{ "blue", 3u, 3u } };
+        PrimitiveGroup group{ "quad", 0u, 2u };
+        const float groupMin[3]{ 0.0f, 0.0f, -0.5f };
+        const float groupMax[3]{ 1.0f, 1.0f, 0.5f };
+        std::copy(groupMin, groupMin + 3, group.min);
+        std::copy(groupMax, groupMax + 3, group.max);
+        model.primitiveGroups = { group };
+        std::copy(group.min, group.min + 3, model.min);
+        std::copy(group.max, group.max + 3, model.max);
+        return model;
+    }
+
+    std::vector<std::byte> writeAndLoad(const ObjectModelDataImpl& model)
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "CompiledMeshCacheTest.cmsh";
+        std::vector<std::byte> bytes;
+        UT_CHECK(WriteCompiledMesh(path, model, sourceHash, recipeHash));
+        std::ifstream input(path, std::ios::binary);
+        const std::vector<char> contents{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+        bytes.resize(contents.size());
+        std::memcpy(bytes.data(), contents.data(), contents.size());
+        input.close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return bytes;
+    }
+
+    compiled_mesh_header_t readHeader(const std::vector<std::byte>& bytes)
+    {
+        compiled_mesh_header_t header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        return header;
+    }
+
+    template<typename T>
+    void patch(std::vector<std::byte>& bytes, const size_t offset, const T& value)
+    {
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    // A failed read has to leave the destination alone
+    bool rejected(const std::vector<std::byte>& bytes, const uint64_t source = sourceHash, const uint64_t recipe = recipeHash)
+    {
+        ObjectModelDataImpl result;
+        result.vertexStride = 7u;
+        const bool read = ReadCompiledMesh(bytes, source, recipe, result);
+        return !read && result.vertexStride == 7u && result.vertexData.empty() && result.indices.empty();
+    }
+
+    void roundTrip()
+    {
+        const ObjectModelDataImpl model = makeModel();
+        const std::vector<std::byte> bytes = writeAndLoad(model);
+        UT_CHECK(readHeader(bytes).fileSize == bytes.size());
+
+        ObjectModelDataImpl result;
+        UT_CHECK(ReadCompiledMesh(bytes, sourceHash, recipeHash, result));
+        UT_CHECK(result.vertexStride == model.vertexStride);
+        UT_CHECK(result.vertexData == model.vertexData);
+        UT_CHECK(result.indices == model.indices);
+        UT_CHECK(result.vertexMetadata.size() == model.vertexMetadata.size());
+        for (size_t i = 0u; i < result.vertexMetadata.size() && i < model.vertexMetadata.size(); ++i)
+        {
+            UT_CHECK(result.vertexMetadata[i].location == model.vertexMetadata[i].location);
+            UT_CHECK(result.vertexMetadata[i].vkFormat == model.vertexMetadata[i].vkFormat);
+            UT_CHECK(result.vertexMetadata[i].offset == model.vertexMetadata[i].offset);
+        }
+        UT_CHECK(result.materialRanges.size() == 2u);
+        for (size_t i = 0u; i < result.materialRanges.size() && i < model.materialRanges.size(); ++i)
+        {
+            UT_CHECK(result.materialRanges[i].MaterialName == model.materialRanges[i].MaterialName);
+            UT_CHECK(result.materialRanges[i].startIndex == model.materialRanges[i].startIndex);
+            UT_CHECK(result.materialRanges[i].indexCount == model.materialRanges[i].indexCount);
+        }
+        UT_CHECK(result.primitiveGroups.size() == 1u);
+        if (!result.primitiveGroups.empty())
+        {
+            const PrimitiveGroup& group = result.primitiveGroups[0];
+            UT_CHECK(group.primitiveName == "quad" && group.startMaterial == 0u && group.materialCount == 2u);
+            UT_CHECK(std::equal(group.min, group.min + 3, model.primitiveGroups[0].min));
+            UT_CHECK(std::equal(group.max, group.max + 3, model.primitiveGroups[0].max));
+        }
+        UT_CHECK(std::equal(result.min, result.min + 3, model.min));
+        UT_CHECK(std::equal(result.max, result.max + 3, model.max));
+    }
+
+    void rejectsOtherHashesAndVersions()
+    {
+        std::vector<std::byte> bytes = writeAndLoad(makeModel());
+        UT_CHECK(rejected(bytes, sourceHash + 1u, recipeHash));
+        UT_CHECK(rejected(bytes, sourceHash, recipeHash + 1u));
+        patch(bytes, offsetof(compiled_mesh_header_t, version), compiledMeshVersion + 1u);
+        UT_CHECK(rejected(bytes));
+        patch(bytes, offsetof(compiled_mesh_header_t, version), compiledMeshVersion);
+        patch(bytes, offsetof(compiled_mesh_header_t, magic), uint32_t(0u));
+        UT_CHECK(rejected(bytes));
+    }
+
+    void rejectsTruncatedFiles()
+    {
+        const std::vector<std::byte> bytes = writeAndLoad(makeModel());
+        for (const size_t size : { size_t(0u), sizeof(compiled_mesh_header_t) - 1u, sizeof(compiled_mesh_header_t), bytes.size() - 1u })
+        {
+            UT_CHECK(rejected(std::vector<std::byte>(bytes.begin(), bytes.begin() + size)));
+        }
+        // Even with the recorded size patched to match, the blobs no longer fit
+        std::vector<std::byte> truncated(bytes.begin(), bytes.end() - 1);
+        patch(truncated, offsetof(compiled_mesh_header_t, fileSize), uint64_t(truncated.size()));
+        UT_CHECK(rejected(truncated));
+    }
+
+    void rejectsCorruptedContents()
+    {
+        const std::vector<std::byte> bytes = writeAndLoad(makeModel());
+        const compiled_mesh_header_t header = readHeader(bytes);
+
+        {
+            // Blob running past the end of the file
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, offsetof(compiled_mesh_header_t, indices) + offsetof(compiled_mesh_blob_t, size), uint64_t(bytes.size()));
+            UT_CHECK(rejected(corrupted));
+        }
+        {
+            // Blob no longer aligned
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, offsetof(compiled_mesh_header_t, indices) + offsetof(compiled_mesh_blob_t, offset), header.indices.offset + 4u);
+            UT_CHECK(rejected(corrupted));
+        }
+        {
+            // Blob size not a whole number of vertices
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, offsetof(compiled_mesh_header_t, vertexData) + offsetof(compiled_mesh_blob_t, size), header.vertexData.size - sizeof(float));
+            UT_CHECK(rejected(corrupted));
+        }
+        {
+            // Index past the last vertex
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, header.indices.offset + 2u * sizeof(uint32_t), uint32_t(4u));
+            UT_CHECK(rejected(corrupted));
+        }
+        {
+            // Material range past the end of the indices
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, header.materialRanges.offset + sizeof(compiled_mesh_range_t) + offsetof(compiled_mesh_range_t, indexCount), uint32_t(4u));
+            UT_CHECK(rejected(corrupted));
+        }
+        {
+            // Material range name past the end of the names
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, header.materialRanges.offset + offsetof(compiled_mesh_range_t, nameLength), uint32_t(header.names.size + 1u));
+            UT_CHECK(rejected(corrupted));
+        }
+        {
+            // Group using more materials than there are
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, header.primitiveGroups.offset + offsetof(compiled_mesh_group_t, materialCount), uint32_t(3u));
+            UT_CHECK(rejected(corrupted));
+            patch(corrupted, header.primitiveGroups.offset + offsetof(compiled_mesh_group_t, materialCount), uint32_t(1u));
+            patch(corrupted, header.primitiveGroups.offset + offsetof(compiled_mesh_group_t, startMaterial), uint32_t(2u));
+            UT_CHECK(rejected(corrupted));
+            patch(corrupted, header.primitiveGroups.offset + offsetof(compiled_mesh_group_t, startMaterial), uint32_t(0xffffffffu));
+            UT_CHECK(rejected(corrupted));
+        }
+        {
+            // Attribute starting outside the vertex
+            std::vector<std::byte> corrupted = bytes;
+            patch(corrupted, header.vertexMetadata.offset + sizeof(VertexMetadataEntry) + offsetof(VertexMetadataEntry, offset), uint32_t(header.vertexStride));
+            UT_CHECK(rejected(corrupted));
+        }
+    }
+
+    void writesBoundsOfUnsetModels()
+    {
+        // Bounds nobody set are the empty box, not whatever was on the stack
+        ObjectModelDataImpl model = makeModel();
+        ObjectModelDataImpl unset;
+        std::copy(unset.min, unset.min + 3, model.min);
+        std::copy(unset.max, unset.max + 3, model.max);
+        const compiled_mesh_header_t header = readHeader(writeAndLoad(model));
+        for (size_t i = 0u; i < 3u; ++i)
+        {
+            UT_CHECK(header.min[i] == 3e38f && header.max[i] == -3e38f);
+        }
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("Compiled meshes round trip", roundTrip);
+    unit_test::Run("Compiled meshes with other hashes or versions are rejected", rejectsOtherHashesAndVersions);
+    unit_test::Run("Truncated compiled meshes are rejected", rejectsTruncatedFiles);
+    unit_test::Run("Corrupted compiled meshes are rejected", rejectsCorruptedContents);
+    unit_test::Run("Compiled meshes write default bounds", writesBoundsOfUnsetModels);
+    return unit_test::Result();
+}
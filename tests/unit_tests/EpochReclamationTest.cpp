@@ -0,0 +1,213 @@
+#include "UnitTest.hpp"
+#include "threading/epoch_reclamation.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/*
+    Readers check a canary in every node they can reach, and nodes clear it when destroyed, so a node
+    freed while still readable shows up as a failed check (and as a use-after-free under ASan).
+*/
+
+namespace
+{
+
+    constexpr uint64_t liveCanary = 0x600df00d600df00du;
+
+    std::atomic<int64_t> nodesAlive{ 0 };
+
+    struct node_t
+    {
+        explicit node_t(uint64_t _value) noexcept : value(_value)
+        {
+            nodesAlive.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ~node_t()
+        {
+            canary.store(0u, std::memory_order_relaxed);
+            nodesAlive.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        std::atomic<uint64_t> canary{ liveCanary };
+        uint64_t value;
+    };
+
+    void yieldSometimes(size_t i)
+    {
+        if ((i & 15u) == 0u)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void guardedReadersNeverSeeFreedNodes()
+    {
+        constexpr size_t numReaders = 3u;
+        constexpr size_t numWriters = 2u;
+        constexpr size_t swapsPerWriter = 20000u;
+
+        std::atomic<node_t*> shared{ new node_t(0u) };
+        std::atomic<size_t> writersDone{ 0u };
+        std::atomic<bool> sawFreedNode{ false };
+        std::atomic<uint64_t> reads{ 0u };
+
+        std::vector<std::thread> threads;
+        for (size_t r = 0u; r < numReaders; ++r)
+        {
+            threads.emplace_back([&]()
+            {
+                uint64_t localReads = 0u;
+                while (writersDone.load(std::memory_order_relaxed) != numWriters)
+                {
+                    foundation::epoch_guard guard;
+                    node_t* node = shared.load(std::memory_order_acquire);
+                    // Yield while holding the node, so writers get the chance to retire it out from under us
+                    for (int check = 0; check < 2; ++check)
+                    {
+                        if (node->canary.load(std::memory_order_relaxed) != liveCanary)
+                        {
+                            sawFreedNode = true;
+                        }
+                        std::this_thread::yield();
+                    }
+                    ++localReads;
+                }
+                reads += localReads;
+            });
+        }
+
+        for (size_t w = 0u; w < numWriters; ++w)
+        {
+            threads.emplace_back([&, w]()
+            {
+                for (size_t i = 0u; i < swapsPerWriter; ++i)
+                {
+                    node_t* old = shared.exchange(new node_t(w * swapsPerWriter + i), std::memory_order_acq_rel);
+                    foundation::Retire(old);
+                    yieldSometimes(i);
+                }
+                // Exiting hands whatever is still pending over as orphans
+                ++writersDone;
+            });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        UT_CHECK(!sawFreedNode.load());
+        UT_CHECK(reads.load() > 0u);
+
+        // Everything the writers left behind gets adopted and freed, leaving just the current node
+        foundation::DrainRetired();
+        UT_CHECK(nodesAlive.load() == 1);
+        delete shared.load();
+        UT_CHECK(nodesAlive.load() == 0);
+    }
+
+    void hazardPointersProtectWithoutStallingEpoch()
+    {
+        constexpr size_t numReaders = 2u;
+        constexpr size_t swaps = 20000u;
+
+        std::atomic<node_t*> shared{ new node_t(0u) };
+        std::atomic<bool> done{ false };
+        std::atomic<bool> sawFreedNode{ false };
+
+        std::vector<std::thread> readers;
+        for (size_t r = 0u; r < numReaders; ++r)
+        {
+            readers.emplace_back([&]()
+            {
+                foundation::hazard_pointer<node_t> hazard;
+                for (size_t i = 0u; !done.load(std::memory_order_relaxed); ++i)
+                {
+                    node_t* node = hazard.protect(shared);
+                    // Held across sleeps, far longer than an epoch_guard should be, while many batches get reclaimed
+                    for (int check = 0; check < 3; ++check)
+                    {
+                        if (node->canary.load(std::memory_order_relaxed) != liveCanary)
+                        {
+                            sawFreedNode = true;
+                        }
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }
+                    hazard.reset();
+                }
+            });
+        }
+
+        const uint64_t epochBefore = foundation::GetGlobalEpoch();
+        for (size_t i = 0u; i < swaps; ++i)
+        {
+            foundation::Retire(shared.exchange(new node_t(i + 1u), std::memory_order_acq_rel));
+            yieldSometimes(i);
+        }
+        // Hazard holders never hold up the epoch, so reclamation kept going the whole time
+        UT_CHECK(foundation::GetGlobalEpoch() > epochBefore + 2u);
+        UT_CHECK(foundation::GetPendingRetiredCount() < swaps / 2u);
+
+        done = true;
+        for (std::thread& reader : readers)
+        {
+            reader.join();
+        }
+
+        UT_CHECK(!sawFreedNode.load());
+        foundation::DrainRetired();
+        UT_CHECK(nodesAlive.load() == 1);
+        delete shared.load();
+    }
+
+    void drainWaitsForActiveReaders()
+    {
+        std::atomic<bool> guardHeld{ false };
+        std::atomic<bool> releaseGuard{ false };
+        std::thread reader([&]()
+        {
+            foundation::epoch_guard guard;
+            guardHeld = true;
+            while (!releaseGuard.load())
+            {
+                std::this_thread::yield();
+            }
+        });
+        while (!guardHeld.load())
+        {
+            std::this_thread::yield();
+        }
+
+        foundation::Retire(new node_t(1u));
+        for (int i = 0; i < 8; ++i)
+        {
+            foundation::ReclaimRetired();
+        }
+        // The reader might still hold a reference from the epoch the node was retired in
+        UT_CHECK(nodesAlive.load() == 1);
+        UT_CHECK(foundation::GetPendingRetiredCount() == 1u);
+
+        std::thread releaser([&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            releaseGuard = true;
+        });
+        foundation::DrainRetired();
+        UT_CHECK(nodesAlive.load() == 0);
+        UT_CHECK(foundation::GetPendingRetiredCount() == 0u);
+
+        releaser.join();
+        reader.join();
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("epoch reclamation: guarded readers never see freed nodes", guardedReadersNeverSeeFreedNodes);
+    unit_test::Run("epoch reclamation: hazard pointers protect without stalling the epoch", hazardPointersProtectWithoutStallingEpoch);
+    unit_test::Run("epoch reclamation: DrainRetired waits for active readers", drainWaitsForActiveReaders);
+    return unit_test::Result();
+}
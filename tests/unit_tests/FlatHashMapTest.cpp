@@ -0,0 +1,269 @@
+#include "UnitTest.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "containers/flat_hash_set.hpp"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+
+    // Tracks how many are alive, and throws from its copy constructor once copiesUntilThrow runs out
+    struct tracked_t
+    {
+        static inline int alive = 0;
+        static inline int copiesUntilThrow = -1;
+
+        explicit tracked_t(int v) : value(v)
+        {
+            ++alive;
+        }
+
+        tracked_t(const tracked_t& other) : value(other.value)
+        {
+            if (copiesUntilThrow == 0)
+            {
+                throw std::runtime_error("copy failed");
+            }
+            --copiesUntilThrow;
+            ++alive;
+        }
+
+        tracked_t(tracked_t&& other) noexcept : value(other.value)
+        {
+            ++alive;
+        }
+
+        ~tracked_t()
+        {
+            --alive;
+        }
+
+        int value;
+    };
+
+    // Counts copies and moves of keys, to check rehashing moves them
+    struct counted_key_t
+    {
+        static inline int copies = 0;
+        static inline int moves = 0;
+
+        explicit counted_key_t(int v) : value(v) {}
+
+        counted_key_t(const counted_key_t& other) : value(other.value)
+        {
+            ++copies;
+        }
+
+        counted_key_t(counted_key_t&& other) noexcept : value(other.value)
+        {
+            ++moves;
+        }
+
+        bool operator==(const counted_key_t& other) const noexcept
+        {
+            return value == other.value;
+        }
+
+        int value;
+    };
+
+    struct counted_key_hash
+    {
+        size_t operator()(const counted_key_t& key) const noexcept
+        {
+            return foundation::FastHash(&key.value, sizeof(key.value));
+        }
+    };
+
+    // Like tracked_t, but its move might throw, so a rehash has to copy it instead
+    struct throwing_move_t
+    {
+        static inline int alive = 0;
+        static inline int copiesUntilThrow = -1;
+
+        explicit throwing_move_t(int v) : value(v)
+        {
+            ++alive;
+        }
+
+        throwing_move_t(const throwing_move_t& other) : value(other.value)
+        {
+            if (copiesUntilThrow == 0)
+            {
+                throw std::runtime_error("copy failed");
+            }
+            --copiesUntilThrow;
+            ++alive;
+        }
+
+        throwing_move_t(throwing_move_t&& other) noexcept(false) : value(other.value)
+        {
+            ++alive;
+        }
+
+        ~throwing_move_t()
+        {
+            --alive;
+        }
+
+        int value;
+    };
+
+    void matchesUnorderedMap()
+    {
+        foundation::flat_hash_map<uint64_t, uint64_t> map;
+        std::unordered_map<uint64_t, uint64_t> reference;
+        uint64_t state = 0x9e3779b97f4a7c15u;
+        for (int i = 0; i < 20000; ++i)
+        {
+            state = state * 6364136223846793005u + 1442695040888963407u;
+            const uint64_t key = (state >> 33u) % 4096u;
+            if ((state & 3u) == 0u)
+            {
+                UT_CHECK(map.erase(key) == reference.erase(key));
+            }
+            else
+            {
+                map[key] = state;
+                reference[key] = state;
+            }
+        }
+
+        UT_CHECK(map.size() == reference.size());
+        for (const auto& [key, value] : reference)
+        {
+            auto iter = map.find(key);
+            UT_CHECK(iter != map.end() && iter->second == value);
+        }
+    }
+
+    void heterogeneousStringLookup()
+    {
+        foundation::flat_hash_map<std::string, int> map;
+        map.emplace("House.obj", 1);
+        map.emplace("Starbox.dds", 2);
+        const std::string_view key("House.obj");
+        UT_CHECK(map.find(key) != map.end() && map.find(key)->second == 1);
+        UT_CHECK(map.contains(std::string_view("Starbox.dds")));
+        UT_CHECK(!map.contains(std::string_view("House.png")));
+
+        foundation::flat_hash_set<std::string> set;
+        set.emplace("a");
+        UT_CHECK(set.contains(std::string_view("a")));
+    }
+
+    void copyConstructorCleansUpWhenCopyThrows()
+    {
+        {
+            foundation::flat_hash_map<int, tracked_t> source;
+            for (int i = 0; i < 100; ++i)
+            {
+                source.emplace(i, tracked_t(i));
+            }
+            const int aliveBefore = tracked_t::alive;
+
+            tracked_t::copiesUntilThrow = 50;
+            bool threw = false;
+            try
+            {
+                foundation::flat_hash_map<int, tracked_t> copy(source);
+            }
+            catch (const std::runtime_error&)
+            {
+                threw = true;
+            }
+            tracked_t::copiesUntilThrow = -1;
+
+            UT_CHECK(threw);
+            // Every copy made before the throw was destroyed again (and run under ASan, the storage was freed)
+            UT_CHECK(tracked_t::alive == aliveBefore);
+
+            foundation::flat_hash_map<int, tracked_t> copy(source);
+            UT_CHECK(copy.size() == source.size());
+            UT_CHECK(copy.at(42).value == 42);
+        }
+        UT_CHECK(tracked_t::alive == 0);
+    }
+
+    void rehashMovesKeys()
+    {
+        foundation::flat_hash_map<counted_key_t, int, counted_key_hash> map;
+        foundation::flat_hash_set<counted_key_t, counted_key_hash> set;
+        counted_key_t::copies = 0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            map.try_emplace(counted_key_t(i), i);
+            set.insert(counted_key_t(i));
+        }
+        UT_CHECK(map.capacity() > 1000u && set.capacity() > 1000u);
+        UT_CHECK(counted_key_t::copies == 0);
+
+        bool allFound = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto iter = map.find(counted_key_t(i));
+            allFound &= iter != map.end() && iter->first.value == i && iter->second == i && set.contains(counted_key_t(i));
+        }
+        UT_CHECK(allFound);
+    }
+
+    void rehashKeepsContentsWhenCopyThrows()
+    {
+        {
+            foundation::flat_hash_map<int, throwing_move_t> map;
+            int count = 0;
+            // Fill right up to the point where the next insert has to grow the table
+            while (map.size() + 1u <= map.capacity() - map.capacity() / 8u || map.capacity() == 0u)
+            {
+                map.try_emplace(count, count);
+                ++count;
+            }
+            const size_t capacityBefore = map.capacity();
+            const int aliveBefore = throwing_move_t::alive;
+
+            throwing_move_t::copiesUntilThrow = count / 2;
+            bool threw = false;
+            try
+            {
+                map.try_emplace(count, count);
+            }
+            catch (const std::runtime_error&)
+            {
+                threw = true;
+            }
+            throwing_move_t::copiesUntilThrow = -1;
+
+            UT_CHECK(threw);
+            UT_CHECK(map.capacity() == capacityBefore);
+            UT_CHECK(map.size() == static_cast<size_t>(count));
+            UT_CHECK(throwing_move_t::alive == aliveBefore);
+            bool allFound = true;
+            for (int i = 0; i < count; ++i)
+            {
+                auto iter = map.find(i);
+                allFound &= iter != map.end() && iter->second.value == i;
+            }
+            UT_CHECK(allFound);
+
+            // And still grows fine once copies stop throwing
+            map.try_emplace(count, count);
+            UT_CHECK(map.size() == static_cast<size_t>(count + 1));
+            UT_CHECK(map.capacity() > capacityBefore);
+            UT_CHECK(map.at(count).value == count && map.at(0).value == 0);
+        }
+        UT_CHECK(throwing_move_t::alive == 0);
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("flat_hash_map matches std::unordered_map", matchesUnorderedMap);
+    unit_test::Run("flat_hash_map heterogeneous string lookup", heterogeneousStringLookup);
+    unit_test::Run("flat_hash_map copy constructor cleans up when a copy throws", copyConstructorCleansUpWhenCopyThrows);
+    unit_test::Run("flat_hash_map rehash moves keys instead of copying them", rehashMovesKeys);
+    unit_test::Run("flat_hash_map rehash keeps its contents when a copy throws", rehashKeepsContentsWhenCopyThrows);
+    return unit_test::Result();
+}
@@ -0,0 +1,75 @@
+#include "UnitTest.hpp"
+#include "threading/HybridWaiter.hpp"
+#include <atomic>
+#include <thread>
+
+namespace
+{
+
+    using namespace std::chrono_literals;
+
+    void notifyBeforeWaitReturnsImmediately()
+    {
+        foundation::HybridWaiter waiter;
+        const uint32_t token = waiter.prepareWait();
+        waiter.notify();
+        UT_CHECK(waiter.wait(token));
+    }
+
+    void timeoutsDontSkewAverage()
+    {
+        foundation::HybridWaiterConfig config;
+        config.maxSpinDuration = 50us;
+        config.minSleepDuration = 2ms;
+        config.maxSleepDuration = 2ms;
+        foundation::HybridWaiter waiter(config);
+        const auto averageBefore = waiter.getAverageWaitDuration();
+
+        for (int i = 0; i < 16; ++i)
+        {
+            UT_CHECK(!waiter.wait(waiter.prepareWait()));
+        }
+        // Nothing was ever notified, so there is nothing to learn from
+        UT_CHECK(waiter.getAverageWaitDuration() == averageBefore);
+    }
+
+    void notifyWakesBlockedWaiter()
+    {
+        foundation::HybridWaiterConfig config;
+        config.maxSpinDuration = 1us;
+        config.minSleepDuration = 5s;
+        config.maxSleepDuration = 5s;
+        foundation::HybridWaiter waiter(config);
+
+        std::atomic<bool> waiting{ false };
+        bool notified = false;
+        const auto start = std::chrono::steady_clock::now();
+        std::thread consumer([&]()
+        {
+            const uint32_t token = waiter.prepareWait();
+            waiting = true;
+            notified = waiter.wait(token);
+        });
+        while (!waiting)
+        {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(10ms);
+        waiter.notify();
+        consumer.join();
+
+        UT_CHECK(notified);
+        UT_CHECK(std::chrono::steady_clock::now() - start < 1s);
+        // That wait was notified, so it's what the average learns from
+        UT_CHECK(waiter.getAverageWaitDuration() > 25us);
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("HybridWaiter notify before wait returns immediately", notifyBeforeWaitReturnsImmediately);
+    unit_test::Run("HybridWaiter timeouts don't skew the average wait", timeoutsDontSkewAverage);
+    unit_test::Run("HybridWaiter notify wakes a blocked waiter", notifyWakesBlockedWaiter);
+    return unit_test::Result();
+}
@@ -0,0 +1,149 @@
+#include "UnitTest.hpp"
+#include "containers/indexedPriorityQueue.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+    using queue_t = indexedPriorityQueue<std::unique_ptr<int>>;
+
+    void popsByPriorityThenPushOrder()
+    {
+        queue_t queue;
+        queue.push(std::make_unique<int>(0), 1.0f);
+        queue.push(std::make_unique<int>(1), 3.0f);
+        queue.push(std::make_unique<int>(2), 1.0f);
+        queue.push(std::make_unique<int>(3), 3.0f);
+        queue.push(std::make_unique<int>(4), 2.0f);
+
+        const int expected[] = { 1, 3, 4, 0, 2 };
+        for (const int value : expected)
+        {
+            std::optional<std::unique_ptr<int>> item = queue.pop();
+            UT_CHECK(item.has_value() && **item == value);
+        }
+        UT_CHECK(queue.empty());
+        UT_CHECK(!queue.pop().has_value());
+    }
+
+    void updateAndEraseWhileQueued()
+    {
+        queue_t queue;
+        const queue_t::handle_type low = queue.push(std::make_unique<int>(0), 1.0f);
+        const queue_t::handle_type mid = queue.push(std::make_unique<int>(1), 2.0f);
+        const queue_t::handle_type high = queue.push(std::make_unique<int>(2), 3.0f);
+
+        UT_CHECK(queue.update(low, 4.0f));
+        UT_CHECK(queue.priority(low) == 4.0f);
+        UT_CHECK(**queue.top() == 0);
+        UT_CHECK(queue.erase(high));
+        UT_CHECK(!queue.contains(high));
+        UT_CHECK(!queue.erase(high));
+        UT_CHECK(queue.find(mid) != nullptr && **queue.find(mid) == 1);
+
+        UT_CHECK(**queue.pop() == 0);
+        UT_CHECK(**queue.pop() == 1);
+        UT_CHECK(queue.empty());
+    }
+
+    void staleHandlesStayInvalidAfterSlotReuse()
+    {
+        queue_t queue;
+        const queue_t::handle_type first = queue.push(std::make_unique<int>(0), 1.0f);
+        UT_CHECK(first != 0u);
+        queue.pop();
+
+        const queue_t::handle_type second = queue.push(std::make_unique<int>(1), 1.0f);
+        UT_CHECK(second != first);
+        UT_CHECK(!queue.contains(first));
+        UT_CHECK(!queue.update(first, 5.0f));
+        UT_CHECK(!queue.erase(first));
+        UT_CHECK(queue.find(first) == nullptr);
+        UT_CHECK(queue.contains(second));
+
+        queue.clear();
+        UT_CHECK(!queue.contains(second));
+        UT_CHECK(queue.push(std::make_unique<int>(2), 1.0f) != second);
+    }
+
+    // Random pushes, updates, erases and pops checked against a (priority, push order) -> value map
+    void matchesReferenceUnderChurn()
+    {
+        std::mt19937 rng(1234u);
+        std::uniform_int_distribution<int> op(0, 9);
+        std::uniform_int_distribution<int> prio(0, 15);
+
+        queue_t queue;
+        std::map<std::pair<float, uint64_t>, int, std::greater<>> reference;
+        struct live_item { queue_t::handle_type handle; uint64_t order; float priority; int value; };
+        std::vector<live_item> live;
+        uint64_t pushes = 0u;
+        bool matched = true;
+
+        auto referenceKey = [](const live_item& item)
+        {
+            // Ties go to the earlier push, so order is flipped to sort highest-first with std::greater
+            return std::make_pair(item.priority, ~item.order);
+        };
+
+        for (int step = 0; step < 20000; ++step)
+        {
+            const int choice = op(rng);
+            if (choice < 4 || live.empty())
+            {
+                const float priority = static_cast<float>(prio(rng));
+                const int value = static_cast<int>(pushes);
+                live.emplace_back(live_item{ queue.push(std::make_unique<int>(value), priority), pushes, priority, value });
+                reference.emplace(referenceKey(live.back()), value);
+                ++pushes;
+            }
+            else if (choice < 6)
+            {
+                live_item& item = live[rng() % live.size()];
+                reference.erase(referenceKey(item));
+                item.priority = static_cast<float>(prio(rng));
+                reference.emplace(referenceKey(item), item.value);
+                matched &= queue.update(item.handle, item.priority);
+            }
+            else if (choice < 7)
+            {
+                const size_t index = rng() % live.size();
+                reference.erase(referenceKey(live[index]));
+                matched &= queue.erase(live[index].handle);
+                matched &= !queue.contains(live[index].handle);
+                live.erase(live.begin() + static_cast<ptrdiff_t>(index));
+            }
+            else
+            {
+                const int expected = reference.begin()->second;
+                reference.erase(reference.begin());
+                std::optional<std::unique_ptr<int>> item = queue.pop();
+                matched &= item.has_value() && **item == expected;
+                live.erase(std::find_if(live.begin(), live.end(), [&](const live_item& entry) { return entry.value == expected; }));
+            }
+            matched &= queue.size() == reference.size();
+        }
+
+        UT_CHECK(matched);
+        while (!reference.empty())
+        {
+            UT_CHECK(**queue.pop() == reference.begin()->second);
+            reference.erase(reference.begin());
+        }
+        UT_CHECK(queue.empty());
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("indexedPriorityQueue pops by priority, then push order", popsByPriorityThenPushOrder);
+    unit_test::Run("indexedPriorityQueue update and erase while queued", updateAndEraseWhileQueued);
+    unit_test::Run("indexedPriorityQueue stale handles stay invalid after slot reuse", staleHandlesStayInvalidAfterSlotReuse);
+    unit_test::Run("indexedPriorityQueue matches a reference under churn", matchesReferenceUnderChurn);
+    return unit_test::Result();
+}
@@ -0,0 +1,194 @@
+#include "UnitTest.hpp"
+#include "MeshProcessing.hpp"
+#include "LoadedDataCache.hpp"
+#include "easylogging++.h"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+INITIALIZE_EASYLOGGINGPP
+
+namespace
+{
+
+    constexpr uint32_t gridSize = 16u;
+    constexpr size_t floatsPerVert = 5u;
+    using triangle_list_t = std::vector<std::vector<float>>;
+
+    /*
+        A gridSize * gridSize grid of quads, positions and uvs, with its left and right halves in separate
+        material ranges. It's bent into a bowl so clusters face different ways for OptimizeOverdraw to sort. Triangles are shuffled within each range, so there's plenty for the passes to fix,
+        and there's one vertex nothing uses at the end.
+    */
+    ObjectModelDataImpl makeShuffledGrid()
+    {
+        ObjectModelDataImpl data;
+        data.vertexStride = floatsPerVert * sizeof(float);
+        data.vertexMetadata = { VertexMetadataEntry{ 0u, 106u, 0u }, VertexMetadataEntry{ 1u, 103u, 3u * sizeof(float) } };
+        for (uint32_t y = 0u; y <= gridSize; ++y)
+        {
+            for (uint32_t x = 0u; x <= gridSize; ++x)
+            {
+                const float u = float(x) / float(gridSize);
+                const float v = float(y) / float(gridSize);
+                const float z = (u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f);
+                data.vertexData.insert(data.vertexData.end(), { float(x), float(y), z * float(gridSize), u, v });
+            }
+        }
+        data.vertexData.insert(data.vertexData.end(), { -1.0f, -1.0f, -1.0f, 0.0f, 0.0f });
+
+        std::mt19937 rng(4242u);
+        for (uint32_t half = 0u; half < 2u; ++half)
+        {
+            std::vector<std::array<uint32_t, 3>> triangles;
+            for (uint32_t y = 0u; y < gridSize; ++y)
+            {
+                for (uint32_t x = half * gridSize / 2u; x < (half + 1u) * gridSize / 2u; ++x)
+                {
+                    const uint32_t v0 = y * (gridSize + 1u) + x;
+                    const uint32_t v1 = v0 + 1u;
+                    const uint32_t v2 = v0 + gridSize + 1u;
+                    const uint32_t v3 = v2 + 1u;
+                    triangles.push_back({ v0, v1, v3 });
+                    triangles.push_back({ v0, v3, v2 });
+                }
+            }
+            std::shuffle(triangles.begin(), triangles.end(), rng);
+
+            const uint32_t startIndex = static_cast<uint32_t>(data.indices.size());
+            for (const auto& triangle : triangles)
+            {
+                data.indices.insert(data.indices.end(), triangle.begin(), triangle.end());
+            }
+            data.materialRanges.emplace_back(MaterialRange{ half == 0u ? "left" : "right", startIndex, static_cast<uint32_t>(data.indices.size()) - startIndex });
+        }
+        return data;
+    }
+
+    // Triangles of each material range by the vertices they're made of, so vertex reordering doesn't matter
+    std::vector<triangle_list_t> getRangeTriangles(const ObjectModelDataImpl& data)
+    {
+        std::vector<triangle_list_t> result;
+        for (const MaterialRange& range : data.materialRanges)
+        {
+            triangle_list_t& triangles = result.emplace_back();
+            for (uint32_t i = range.startIndex; i + 3u <= range.startIndex + range.indexCount; i += 3u)
+            {
+                std::vector<float>& triangle = triangles.emplace_back();
+                for (uint32_t j = 0u; j < 3u; ++j)
+                {
+                    const float* vertex = &data.vertexData[data.indices[i + j] * floatsPerVert];
+                    triangle.insert(triangle.end(), vertex, vertex + floatsPerVert);
+                }
+            }
+            std::sort(triangles.begin(), triangles.end());
+        }
+        return result;
+    }
+
+    // The 16-bit copy is made when the data is added, and every pass changing the indices refreshes it
+    bool narrowedInStep(const ObjectModelDataImpl& data)
+    {
+        return std::equal(data.indices.begin(), data.indices.end(), data.indices16.begin(), data.indices16.end());
+    }
+
+    void passesKeepTrianglesAndImproveCache()
+    {
+        constexpr ccDataHandle handle = 1u;
+        AddObjectModelData(handle, makeShuffledGrid());
+        ObjectModelDataImpl* data = TryAndGetModelData(handle);
+        UT_CHECK(data != nullptr);
+        if (!data)
+        {
+            return;
+        }
+
+        UT_CHECK(narrowedInStep(*data));
+        const std::vector<triangle_list_t> expected = getRangeTriangles(*data);
+        const std::vector<uint32_t> shuffledIndices = data->indices;
+        const float shuffledAcmr = AnalyzeVertexCache(handle).acmr;
+
+        OptimizeVertexCache(handle);
+        UT_CHECK(data->indices != shuffledIndices);
+        UT_CHECK(getRangeTriangles(*data) == expected);
+        UT_CHECK(narrowedInStep(*data));
+        const float cacheOptimizedAcmr = AnalyzeVertexCache(handle).acmr;
+        UT_CHECK(cacheOptimizedAcmr < shuffledAcmr);
+        // Anything like a proper cache optimiser gets a regular grid well under one vertex per triangle
+        UT_CHECK(cacheOptimizedAcmr < 1.0f);
+
+        const std::vector<uint32_t> cacheOptimizedIndices = data->indices;
+        OptimizeOverdraw(handle);
+        UT_CHECK(data->indices != cacheOptimizedIndices);
+        UT_CHECK(getRangeTriangles(*data) == expected);
+        UT_CHECK(narrowedInStep(*data));
+        const float overdrawOptimizedAcmr = AnalyzeVertexCache(handle).acmr;
+        // The threshold only bounds each cluster, and moving clusters around costs a few misses where they meet
+        UT_CHECK(overdrawOptimizedAcmr <= shuffledAcmr);
+        UT_CHECK(overdrawOptimizedAcmr < 1.0f);
+
+        OptimizeVertexFetch(handle);
+        UT_CHECK(getRangeTriangles(*data) == expected);
+        UT_CHECK(narrowedInStep(*data));
+        UT_CHECK(AnalyzeVertexCache(handle).acmr == overdrawOptimizedAcmr);
+        // The unused vertex is gone, and the rest are in the order they're first used
+        UT_CHECK(data->vertexData.size() == (gridSize + 1u) * (gridSize + 1u) * floatsPerVert);
+        uint32_t nextVertex = 0u;
+        bool inFirstUseOrder = true;
+        for (const uint32_t index : data->indices)
+        {
+            inFirstUseOrder = inFirstUseOrder && index <= nextVertex;
+            nextVertex = std::max(nextVertex, index + 1u);
+        }
+        UT_CHECK(inFirstUseOrder);
+    }
+
+    void rangesWithoutTrianglesAreLeftAlone()
+    {
+        // Every range is too small to hold a triangle, so there's nothing to reorder: not the whole buffer
+        constexpr ccDataHandle handle = 2u;
+        ObjectModelDataImpl grid = makeShuffledGrid();
+        grid.materialRanges = { MaterialRange{ "empty", 0u, 0u }, MaterialRange{ "line", 0u, 2u } };
+        AddObjectModelData(handle, std::move(grid));
+        ObjectModelDataImpl* data = TryAndGetModelData(handle);
+        UT_CHECK(data != nullptr);
+        if (!data)
+        {
+            return;
+        }
+
+        const std::vector<uint32_t> indices = data->indices;
+        OptimizeVertexCache(handle);
+        UT_CHECK(data->indices == indices);
+        OptimizeOverdraw(handle);
+        UT_CHECK(data->indices == indices);
+    }
+
+    void meshesWithoutRangesAreOneRange()
+    {
+        constexpr ccDataHandle handle = 3u;
+        ObjectModelDataImpl grid = makeShuffledGrid();
+        grid.materialRanges.clear();
+        AddObjectModelData(handle, std::move(grid));
+        ObjectModelDataImpl* data = TryAndGetModelData(handle);
+        UT_CHECK(data != nullptr);
+        if (!data)
+        {
+            return;
+        }
+
+        const float shuffledAcmr = AnalyzeVertexCache(handle).acmr;
+        OptimizeVertexCache(handle);
+        UT_CHECK(AnalyzeVertexCache(handle).acmr < shuffledAcmr);
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("Mesh passes keep each range's triangles and don't hurt the cache", passesKeepTrianglesAndImproveCache);
+    unit_test::Run("Mesh passes leave ranges without triangles alone", rangesWithoutTrianglesAreLeftAlone);
+    unit_test::Run("Mesh passes treat meshes without ranges as one range", meshesWithoutRangesAreOneRange);
+    return unit_test::Result();
+}
@@ -0,0 +1,183 @@
+#include "UnitTest.hpp"
+#include "utility/multicast_delegate.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+// Counts heap allocations, so the inline storage test can check none happen
+static std::atomic<size_t> allocationCount{ 0u };
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1u, std::memory_order_relaxed);
+    if (void* result = std::malloc(size != 0u ? size : 1u))
+    {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+
+    struct subscriber_t
+    {
+        std::atomic<int> calls{ 0 };
+        int value{ 0 };
+
+        void onEvent(int amount)
+        {
+            calls.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        int offset(int amount)
+        {
+            return value + amount;
+        }
+    };
+
+    void broadcastAndUnsubscribe()
+    {
+        multicast_delegate_t<void(int)> event;
+        subscriber_t a;
+        subscriber_t b;
+        const auto delegateA = delegate_t<void(int)>::create<subscriber_t, &subscriber_t::onEvent>(&a);
+        const auto delegateB = delegate_t<void(int)>::create<subscriber_t, &subscriber_t::onEvent>(&b);
+        event += delegateA;
+        event += delegateB;
+        event(2);
+        UT_CHECK(a.calls == 2 && b.calls == 2);
+
+        event -= delegateA;
+        event(3);
+        UT_CHECK(a.calls == 2 && b.calls == 5);
+        UT_CHECK(event.size() == 1u);
+
+        event -= delegateB;
+        UT_CHECK(event.empty());
+    }
+
+    void resultHandlerSeesEveryResult()
+    {
+        multicast_delegate_t<int(int)> event;
+        subscriber_t a;
+        subscriber_t b;
+        a.value = 10;
+        b.value = 20;
+        event += delegate_t<int(int)>::create<subscriber_t, &subscriber_t::offset>(&a);
+        event += delegate_t<int(int)>::create<subscriber_t, &subscriber_t::offset>(&b);
+
+        struct collector_t
+        {
+            int results[2]{ 0, 0 };
+            void collect(size_t idx, int* result)
+            {
+                results[idx] = *result;
+            }
+        } collector;
+        event(1, delegate_t<void(size_t, int*)>::create<collector_t, &collector_t::collect>(&collector));
+        UT_CHECK(collector.results[0] == 11 && collector.results[1] == 21);
+    }
+
+    void smallSubscriberCountsStayInline()
+    {
+        multicast_delegate_t<void(int)> event;
+        subscriber_t subscribers[multicast_delegate_t<void(int)>::inlineSnapshotCapacity + 1u];
+        std::vector<delegate_t<void(int)>> delegates;
+        for (subscriber_t& subscriber : subscribers)
+        {
+            delegates.emplace_back(delegate_t<void(int)>::create<subscriber_t, &subscriber_t::onEvent>(&subscriber));
+        }
+
+        const size_t allocationsBefore = allocationCount.load();
+        for (size_t i = 0u; i < multicast_delegate_t<void(int)>::inlineSnapshotCapacity; ++i)
+        {
+            event += delegates[i];
+        }
+        event(1);
+        event -= delegates[0];
+        UT_CHECK(allocationCount.load() == allocationsBefore);
+
+        // One past the inline capacity has to go to the heap, and coming back down returns to inline storage
+        event += delegates[0];
+        event += delegates.back();
+        UT_CHECK(allocationCount.load() == allocationsBefore + 1u);
+        event -= delegates.back();
+        event(1);
+        UT_CHECK(allocationCount.load() == allocationsBefore + 1u);
+        UT_CHECK(subscribers[1].calls == 2);
+    }
+
+    // Writers racing each other used to copy snapshots another writer had already freed: run under ASan
+    void concurrentWritersAndBroadcasts()
+    {
+        constexpr size_t numWriters = 3u;
+        constexpr size_t numIterations = 20000u;
+        multicast_delegate_t<void(int)> event;
+        subscriber_t subscribers[numWriters][2];
+        std::atomic<bool> stop{ false };
+
+        std::thread broadcaster([&]()
+        {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                event(1);
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::thread> writers;
+        for (size_t w = 0u; w < numWriters; ++w)
+        {
+            writers.emplace_back([&, w]()
+            {
+                const auto kept = delegate_t<void(int)>::create<subscriber_t, &subscriber_t::onEvent>(&subscribers[w][0]);
+                const auto churned = delegate_t<void(int)>::create<subscriber_t, &subscriber_t::onEvent>(&subscribers[w][1]);
+                event += kept;
+                for (size_t i = 0u; i < numIterations; ++i)
+                {
+                    event += churned;
+                    event -= churned;
+                }
+            });
+        }
+
+        for (std::thread& writer : writers)
+        {
+            writer.join();
+        }
+        stop.store(true);
+        broadcaster.join();
+
+        // Only each writer's kept subscription survives
+        UT_CHECK(event.size() == numWriters);
+        for (size_t w = 0u; w < numWriters; ++w)
+        {
+            const int before = subscribers[w][0].calls.load();
+            event(1);
+            UT_CHECK(subscribers[w][0].calls.load() == before + 1);
+        }
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("multicast_delegate broadcast and unsubscribe", broadcastAndUnsubscribe);
+    unit_test::Run("multicast_delegate result handler", resultHandlerSeesEveryResult);
+    unit_test::Run("multicast_delegate small subscriber counts stay inline", smallSubscriberCountsStayInline);
+    unit_test::Run("multicast_delegate concurrent writers and broadcasts", concurrentWritersAndBroadcasts);
+    return unit_test::Result();
+}
@@ -0,0 +1,287 @@
+#include "UnitTest.hpp"
+#include "ObjParsing.hpp"
+#include "svUtil.hpp"
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    The chunked parser has to produce exactly what the serial parser it replaced did, quirks included (faces
+    only keep their first three vertices, empty index tokens are skipped so "1//2" reads 2 as a uv index).
+    That parser is kept below as the reference, and the same text is parsed with chunks from a single line up
+    to the whole file. The text keeps negative indices, usemtl and g lines close together so plenty of them
+    land just after a chunk boundary.
+*/
+
+namespace
+{
+
+    using namespace ObjLoader;
+
+    // Anything at least as long as the text is parsed as one chunk
+    constexpr size_t singleChunk = ~size_t(0u);
+    constexpr size_t chunkSizes[] = { singleChunk, 1u, 7u, 32u, 100u, 1000u };
+
+    template<size_t numVecElements>
+    std::array<float, numVecElements> baselineExtractVector(std::vector<std::string_view>& tokens)
+    {
+        std::array<float, numVecElements> result{};
+        for (size_t i = 0; i < numVecElements; ++i)
+        {
+            std::string_view& currToken = tokens[i + 1];
+            std::from_chars(currToken.data(), currToken.data() + currToken.size(), result[i]);
+        }
+        if constexpr (numVecElements == 2)
+        {
+            if (result[1] > 1.0f)
+            {
+                result[1] -= 1.0f;
+            }
+            if (result[0] > 1.0f)
+            {
+                result[0] -= 1.0f;
+            }
+            result[1] = 1.0f - result[1];
+        }
+        return result;
+    }
+
+    // ObjFileData::parseFile() as it was before parsing was split into chunks. Only handles LF or CRLF text
+    // that ends in a newline: it never terminated without one, and mixed line endings confused it.
+    OBJparsedData baselineParse(std::string_view modelMemoryView, bool loadNormals)
+    {
+        using namespace svutil;
+        OBJparsedData data;
+        std::vector<vec3>& positions = data.positions;
+        std::vector<vec3>& normals = data.normals;
+        std::vector<vec2>& uvs = data.uvs;
+        std::vector<OBJgroup>& groups = data.groups;
+        std::vector<OBJvertex>& OBJverts = data.OBJverts;
+        std::vector<OBJface>& OBJfaces = data.OBJfaces;
+        std::vector<OBJMtlRange>& OBJMtlRanges = data.OBJMtlRanges;
+        groups.emplace_back(OBJgroup{ std::string(""), 0u, 0u, 0u, 0u });
+        OBJMtlRanges.emplace_back(OBJMtlRange{ std::string(""), 0u, 0u });
+
+        while (!modelMemoryView.empty())
+        {
+            std::string_view line = get_line(modelMemoryView);
+            std::vector<std::string_view> tokens = separate_tokens_in_view(line, ' ');
+            if (tokens.empty())
+            {
+                continue;
+            }
+
+            if (tokens[0] == "f")
+            {
+                OBJface face{};
+                face.startVertexIdx = static_cast<uint32_t>(OBJverts.size());
+
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    OBJvertex vertex;
+                    std::vector<std::string_view> indexTokens = separate_tokens_in_view(tokens[i + 1], '/');
+                    std::from_chars(indexTokens[0].data(), indexTokens[0].data() + indexTokens[0].size(), vertex.posIdx);
+                    if (indexTokens.size() > 1)
+                    {
+                        std::from_chars(indexTokens[1].data(), indexTokens[1].data() + indexTokens[1].size(), vertex.uvIdx);
+                    }
+                    if (indexTokens.size() > 2 && loadNormals)
+                    {
+                        std::from_chars(indexTokens[2].data(), indexTokens[2].data() + indexTokens[2].size(), vertex.normalIdx);
+                    }
+
+                    if (vertex.posIdx < 0)
+                    {
+                        vertex.posIdx += static_cast<int32_t>(positions.size()) + 1;
+                    }
+                    if (vertex.uvIdx < 0)
+                    {
+                        vertex.uvIdx += static_cast<int32_t>(uvs.size()) + 1;
+                    }
+                    if (vertex.normalIdx < 0)
+                    {
+                        vertex.normalIdx += static_cast<int32_t>(normals.size()) + 1;
+                    }
+
+                    OBJverts.emplace_back(vertex);
+                }
+
+                face.endVertexIdx = static_cast<uint32_t>(OBJverts.size());
+                OBJfaces.emplace_back(face);
+            }
+            else if (tokens[0] == "v")
+            {
+                positions.emplace_back(baselineExtractVector<3>(tokens));
+            }
+            else if (tokens[0] == "vt")
+            {
+                uvs.emplace_back(baselineExtractVector<2>(tokens));
+            }
+            else if (tokens[0] == "vn" && loadNormals)
+            {
+                normals.emplace_back(baselineExtractVector<3>(tokens));
+            }
+            else if (tokens[0] == "usemtl")
+            {
+                OBJMtlRange* currMtlRange = &OBJMtlRanges.back();
+                currMtlRange->endFaceIndex = static_cast<uint32_t>(OBJfaces.size());
+
+                if (currMtlRange->endFaceIndex > currMtlRange->startFaceIndex)
+                {
+                    OBJMtlRanges.push_back(OBJMtlRange());
+                    currMtlRange = &OBJMtlRanges.back();
+                }
+
+                currMtlRange->mtlName = to_lowercase(tokens[1]);
+                currMtlRange->startFaceIndex = static_cast<uint32_t>(OBJfaces.size());
+            }
+            else if (tokens[0] == "g")
+            {
+                OBJgroup* currGroup = &groups.back();
+                currGroup->endFaceIndex = static_cast<uint32_t>(OBJfaces.size());
+                currGroup->endMtlIndex = static_cast<uint32_t>(OBJMtlRanges.size());
+
+                if (currGroup->endFaceIndex > currGroup->startFaceIndex && currGroup->endMtlIndex > currGroup->startMtlIndex)
+                {
+                    groups.push_back(OBJgroup());
+                    currGroup = &groups.back();
+                }
+
+                currGroup->groupName = to_lowercase(tokens[1]);
+                currGroup->startFaceIndex = static_cast<uint32_t>(OBJfaces.size());
+                currGroup->startMtlIndex = static_cast<uint32_t>(OBJMtlRanges.size());
+            }
+        }
+
+        OBJMtlRanges.back().endFaceIndex = static_cast<uint32_t>(OBJfaces.size());
+        return data;
+    }
+
+    std::string makeObjText(const char* lineEnding)
+    {
+        std::string text;
+        auto line = [&](const std::string& contents)
+        {
+            text += contents;
+            text += lineEnding;
+        };
+
+        line("# chunking test");
+        line("mtllib test.mtl");
+        line("o Grid");
+        for (int quad = 0; quad < 64; ++quad)
+        {
+            const std::string x = std::to_string(quad % 8);
+            const std::string y = std::to_string(quad / 8);
+            line("v " + x + " " + y + " 0");
+            line("v " + x + ".5 " + y + " 0.25");
+            line("v " + x + ".5  " + y + ".5 0.5");
+            line("v " + x + " " + y + ".5 0.75");
+            line("vt 0." + std::to_string(quad) + " 0.25");
+            line("vt 1.75 0." + std::to_string(quad));
+            line("vn 0 0 1");
+            line("vn 0 1 0");
+
+            if (quad % 5 == 0)
+            {
+                line("g Group" + std::to_string(quad % 3));
+            }
+            if (quad % 3 == 0)
+            {
+                line("usemtl Material" + std::to_string(quad % 4));
+            }
+            if (quad % 11 == 0)
+            {
+                // Empty group, and a material with nothing in it
+                line("g Empty");
+                line("usemtl Unused");
+                line("usemtl MATERIAL" + std::to_string(quad % 2));
+            }
+
+            // Relative indices, as positions/uvs/normals, as positions//normals, and as positions only
+            line("f -4/-2/-2 -3/-1/-2 -2/-2/-1");
+            line("f -4/-2/-2 -2/-2/-1 -1/-1/-1");
+            line("f -4//-1 -2//-1 -1//-2");
+            line("");
+            line("s off");
+            line("f  -3 -2   -1");
+            // Quads only keep their first three vertices
+            line("f -4/-2 -3/-1 -2/-2 -1/-1");
+            if (quad > 0)
+            {
+                // Absolute indices reaching back into the previous quad, which is often in another chunk
+                const std::string previous = std::to_string(quad * 4);
+                const std::string current = std::to_string(quad * 4 + 1);
+                line("f " + previous + "/" + std::to_string(quad * 2) + "/" + std::to_string(quad * 2) + " " + current + "/1/1 -1/-1/-1");
+            }
+        }
+        return text;
+    }
+
+    bool sameParse(const OBJparsedData& lhs, const OBJparsedData& rhs)
+    {
+        bool same = lhs.positions == rhs.positions && lhs.normals == rhs.normals && lhs.uvs == rhs.uvs && lhs.OBJverts == rhs.OBJverts &&
+            lhs.OBJfaces.size() == rhs.OBJfaces.size() && lhs.OBJMtlRanges.size() == rhs.OBJMtlRanges.size() && lhs.groups.size() == rhs.groups.size();
+        for (size_t i = 0u; same && i < lhs.OBJfaces.size(); ++i)
+        {
+            same = lhs.OBJfaces[i].startVertexIdx == rhs.OBJfaces[i].startVertexIdx && lhs.OBJfaces[i].endVertexIdx == rhs.OBJfaces[i].endVertexIdx;
+        }
+        for (size_t i = 0u; same && i < lhs.OBJMtlRanges.size(); ++i)
+        {
+            same = lhs.OBJMtlRanges[i].mtlName == rhs.OBJMtlRanges[i].mtlName && lhs.OBJMtlRanges[i].startFaceIndex == rhs.OBJMtlRanges[i].startFaceIndex &&
+                lhs.OBJMtlRanges[i].endFaceIndex == rhs.OBJMtlRanges[i].endFaceIndex;
+        }
+        for (size_t i = 0u; same && i < lhs.groups.size(); ++i)
+        {
+            same = lhs.groups[i].groupName == rhs.groups[i].groupName && lhs.groups[i].startFaceIndex == rhs.groups[i].startFaceIndex &&
+                lhs.groups[i].endFaceIndex == rhs.groups[i].endFaceIndex && lhs.groups[i].startMtlIndex == rhs.groups[i].startMtlIndex &&
+                lhs.groups[i].endMtlIndex == rhs.groups[i].endMtlIndex;
+        }
+        return same;
+    }
+
+    void parsesRelativeIndicesAndMaterials()
+    {
+        for (const size_t chunkSize : { singleChunk, size_t(1u) })
+        {
+            ObjFileData fileData;
+            fileData.ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nusemtl Red\nf -4 -3 -2\nf -4 -2 -1\n", false, chunkSize);
+            const ObjectModelDataImpl data = fileData.RetrieveData(false, false);
+            UT_CHECK(data.vertexStride == 3u * sizeof(float));
+            UT_CHECK((data.vertexData == std::vector<float>{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f }));
+            UT_CHECK((data.indices == std::vector<uint32_t>{ 0u, 1u, 2u, 0u, 2u, 3u }));
+            UT_CHECK(data.materialRanges.size() == 1u);
+            UT_CHECK(!data.materialRanges.empty() && data.materialRanges[0].MaterialName == "red" && data.materialRanges[0].indexCount == 6u);
+            UT_CHECK(data.min[0] == 0.0f && data.min[1] == 0.0f && data.min[2] == 0.0f);
+            UT_CHECK(data.max[0] == 1.0f && data.max[1] == 1.0f && data.max[2] == 0.0f);
+        }
+    }
+
+    void matchesBaselineParser(const char* lineEnding)
+    {
+        const std::string text = makeObjText(lineEnding);
+        for (const bool loadNormals : { false, true })
+        {
+            const OBJparsedData expected = baselineParse(text, loadNormals);
+            UT_CHECK(expected.OBJfaces.size() > 300u);
+            UT_CHECK(expected.OBJMtlRanges.size() > 10u);
+            UT_CHECK(expected.groups.size() > 10u);
+            for (const size_t chunkSize : chunkSizes)
+            {
+                ObjFileData fileData;
+                fileData.ParseText(text, loadNormals, chunkSize);
+                UT_CHECK(sameParse(fileData.Parsed(), expected));
+            }
+        }
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("OBJ parser resolves relative indices and materials", parsesRelativeIndicesAndMaterials);
+    unit_test::Run("OBJ parser matches the serial parser, LF", []() { matchesBaselineParser("\n"); });
+    unit_test::Run("OBJ parser matches the serial parser, CRLF", []() { matchesBaselineParser("\r\n"); });
+    return unit_test::Result();
+}
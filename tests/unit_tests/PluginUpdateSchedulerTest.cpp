@@ -0,0 +1,295 @@
+#include "UnitTest.hpp"
+#include "PluginUpdateScheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+    Synthetic plugins: each one's dependencies, and what it does when updated, come from the specs
+    table below. Updates stamp a shared sequence counter on entry and exit, so a dependency A -> B
+    holds exactly when A's exit stamp comes before B's entry stamp.
+*/
+
+namespace
+{
+
+    constexpr uint32_t maxPlugins = 8u;
+
+    struct plugin_spec_t
+    {
+        std::vector<uint32_t> reads;
+        std::vector<uint32_t> writes;
+        bool declaresDependencies{ true };
+        std::chrono::milliseconds updateTime{ 0 };
+    };
+
+    struct plugin_record_t
+    {
+        std::atomic<uint64_t> enterStamp{ 0u };
+        std::atomic<uint64_t> exitStamp{ 0u };
+        std::atomic<uint32_t> updateCount{ 0u };
+        std::atomic<double> lastDt{ 0.0 };
+    };
+
+    plugin_spec_t specs[maxPlugins];
+    plugin_record_t records[maxPlugins];
+    std::atomic<uint64_t> sequence{ 0u };
+    std::atomic<uint32_t> running{ 0u };
+    std::atomic<uint32_t> maxRunning{ 0u };
+
+    void resetRecords()
+    {
+        for (plugin_record_t& record : records)
+        {
+            record.enterStamp = 0u;
+            record.exitStamp = 0u;
+            record.updateCount = 0u;
+            record.lastDt = 0.0;
+        }
+        sequence = 0u;
+        running = 0u;
+        maxRunning = 0u;
+    }
+
+    template<uint32_t Index>
+    struct synthetic_plugin
+    {
+        static const char* Name()
+        {
+            return "synthetic_plugin";
+        }
+
+        // Offset so plugin IDs can't be confused with the engine API IDs plugins depend on
+        static uint32_t ID()
+        {
+            return 1000u + Index;
+        }
+
+        static void Load(GetEngineAPI_Fn)
+        {
+        }
+
+        static void Unload()
+        {
+        }
+
+        static void UpdateDependencies(uint32_t* num_reads, uint32_t* read_api_ids, uint32_t* num_writes, uint32_t* write_api_ids)
+        {
+            const plugin_spec_t& spec = specs[Index];
+            *num_reads = static_cast<uint32_t>(spec.reads.size());
+            *num_writes = static_cast<uint32_t>(spec.writes.size());
+            if (read_api_ids != nullptr)
+            {
+                std::copy(spec.reads.cbegin(), spec.reads.cend(), read_api_ids);
+            }
+            if (write_api_ids != nullptr)
+            {
+                std::copy(spec.writes.cbegin(), spec.writes.cend(), write_api_ids);
+            }
+        }
+
+        static void Update(double dt)
+        {
+            plugin_record_t& record = records[Index];
+            record.enterStamp = ++sequence;
+            const uint32_t nowRunning = ++running;
+            uint32_t observedMax = maxRunning.load();
+            while (nowRunning > observedMax && !maxRunning.compare_exchange_weak(observedMax, nowRunning))
+            {
+            }
+
+            std::this_thread::sleep_for(specs[Index].updateTime);
+
+            --running;
+            record.lastDt = dt;
+            ++record.updateCount;
+            record.exitStamp = ++sequence;
+        }
+
+        static void LogicalUpdate()
+        {
+            Update(0.0);
+        }
+
+        static void TimeDependentUpdate(double dt)
+        {
+            Update(dt);
+        }
+
+        static Plugin_API* API()
+        {
+            // Refreshed on every call, since tests change whether a plugin declares dependencies
+            static Plugin_API api{};
+            api.PluginName = &Name;
+            api.PluginID = &ID;
+            api.Load = &Load;
+            api.Unload = &Unload;
+            api.LogicalUpdate = &LogicalUpdate;
+            api.TimeDependentUpdate = &TimeDependentUpdate;
+            api.UpdateDependencies = specs[Index].declaresDependencies ? &UpdateDependencies : nullptr;
+            return &api;
+        }
+    };
+
+    template<uint32_t... Indices>
+    std::vector<Plugin_API*> makePlugins(std::integer_sequence<uint32_t, Indices...>)
+    {
+        return { synthetic_plugin<Indices>::API()... };
+    }
+
+    bool ranBefore(uint32_t first, uint32_t second)
+    {
+        return records[first].exitStamp.load() < records[second].enterStamp.load();
+    }
+
+    // Engine API IDs the plugins depend on
+    constexpr uint32_t physicsAPI = 1u;
+    constexpr uint32_t audioAPI = 2u;
+    constexpr uint32_t renderAPI = 3u;
+
+    /*
+        0: writes physics
+        1: reads physics           -> after 0
+        2: reads audio             -> independent of 0 and 1
+        3: writes audio            -> after 2
+        4: declares nothing        -> after everything before it, before everything after it
+        5: reads render
+        6: reads render            -> independent of 5, reads never conflict
+        7: reads plugin 5's API    -> after 5, since updates write a plugin's own API
+    */
+    void setupMixedSpecs(std::chrono::milliseconds update_time)
+    {
+        specs[0] = { {}, { physicsAPI } };
+        specs[1] = { { physicsAPI }, {} };
+        specs[2] = { { audioAPI }, {} };
+        specs[3] = { {}, { audioAPI } };
+        specs[4] = { {}, {}, false };
+        specs[5] = { { renderAPI }, {} };
+        specs[6] = { { renderAPI }, {} };
+        specs[7] = { { synthetic_plugin<5>::ID() }, {} };
+        for (plugin_spec_t& spec : specs)
+        {
+            spec.updateTime = update_time;
+        }
+    }
+
+    void checkMixedOrdering()
+    {
+        UT_CHECK(ranBefore(0, 1));
+        UT_CHECK(ranBefore(2, 3));
+        for (uint32_t i = 0u; i < 4u; ++i)
+        {
+            UT_CHECK(ranBefore(i, 4));
+        }
+        for (uint32_t i = 5u; i < maxPlugins; ++i)
+        {
+            UT_CHECK(ranBefore(4, i));
+        }
+        UT_CHECK(ranBefore(5, 7));
+        for (const plugin_record_t& record : records)
+        {
+            UT_CHECK(record.updateCount == 1u);
+        }
+    }
+
+    void criticalPathFollowsConflicts()
+    {
+        setupMixedSpecs(std::chrono::milliseconds(0));
+        PluginUpdateScheduler scheduler;
+        scheduler.SetPlugins(makePlugins(std::make_integer_sequence<uint32_t, maxPlugins>{}));
+        // 0 -> 1 (or 2 -> 3), then 4, then 5 -> 7
+        UT_CHECK(scheduler.CriticalPathLength() == 5u);
+
+        // Only non-conflicting readers: everything could run at once
+        for (plugin_spec_t& spec : specs)
+        {
+            spec = { { renderAPI }, {} };
+        }
+        scheduler.SetPlugins(makePlugins(std::make_integer_sequence<uint32_t, maxPlugins>{}));
+        UT_CHECK(scheduler.CriticalPathLength() == 1u);
+    }
+
+    void serialRunKeepsRegistrationOrder()
+    {
+        setupMixedSpecs(std::chrono::milliseconds(0));
+        resetRecords();
+        PluginUpdateScheduler scheduler;
+        scheduler.SetPlugins(makePlugins(std::make_integer_sequence<uint32_t, maxPlugins>{}));
+        scheduler.SetWorkerCount(0u);
+        scheduler.Run(PluginUpdateScheduler::update_kind::TimeDependent, 0.25);
+
+        for (uint32_t i = 1u; i < maxPlugins; ++i)
+        {
+            UT_CHECK(ranBefore(i - 1u, i));
+        }
+        UT_CHECK(records[3].lastDt == 0.25);
+    }
+
+    void parallelRunRespectsDependencies()
+    {
+        setupMixedSpecs(std::chrono::milliseconds(2));
+        PluginUpdateScheduler scheduler;
+        scheduler.SetPlugins(makePlugins(std::make_integer_sequence<uint32_t, maxPlugins>{}));
+        scheduler.SetWorkerCount(3u);
+
+        uint32_t mostConcurrent = 0u;
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            resetRecords();
+            const auto kind = (frame & 1) != 0 ? PluginUpdateScheduler::update_kind::TimeDependent : PluginUpdateScheduler::update_kind::Logical;
+            scheduler.Run(kind, 0.5);
+            checkMixedOrdering();
+            mostConcurrent = std::max(mostConcurrent, maxRunning.load());
+        }
+        // 0 and 2, or 5 and 6, don't conflict and sleep long enough that they should have overlapped at some point
+        UT_CHECK(mostConcurrent > 1u);
+
+        // Changing the worker count restarts the pool, and runs still complete
+        resetRecords();
+        scheduler.SetWorkerCount(1u);
+        scheduler.Run(PluginUpdateScheduler::update_kind::Logical, 0.0);
+        checkMixedOrdering();
+    }
+
+    void timingsReportEveryPlugin()
+    {
+        setupMixedSpecs(std::chrono::milliseconds(0));
+        specs[6].updateTime = std::chrono::milliseconds(5);
+        resetRecords();
+        PluginUpdateScheduler scheduler;
+        scheduler.SetPlugins(makePlugins(std::make_integer_sequence<uint32_t, maxPlugins>{}));
+        scheduler.SetWorkerCount(2u);
+        scheduler.Run(PluginUpdateScheduler::update_kind::TimeDependent, 1.0 / 60.0);
+
+        uint32_t numTimings = 0u;
+        scheduler.GetTimings(&numTimings, nullptr);
+        UT_CHECK(numTimings == maxPlugins);
+        std::vector<PluginUpdateTiming> timings(numTimings);
+        scheduler.GetTimings(&numTimings, timings.data());
+
+        const auto slowest = std::max_element(timings.cbegin(), timings.cend(), [](const PluginUpdateTiming& a, const PluginUpdateTiming& b)
+        {
+            return a.TimeDependentUpdateMs < b.TimeDependentUpdateMs;
+        });
+        UT_CHECK(slowest->PluginID == synthetic_plugin<6>::ID());
+        UT_CHECK(slowest->TimeDependentUpdateMs >= 4.0);
+        for (uint32_t i = 0u; i < maxPlugins; ++i)
+        {
+            UT_CHECK(timings[i].PluginID == 1000u + i);
+            UT_CHECK(timings[i].LogicalUpdateMs == 0.0);
+        }
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("PluginUpdateScheduler critical path follows conflicts", criticalPathFollowsConflicts);
+    unit_test::Run("PluginUpdateScheduler serial run keeps registration order", serialRunKeepsRegistrationOrder);
+    unit_test::Run("PluginUpdateScheduler parallel run respects dependencies", parallelRunRespectsDependencies);
+    unit_test::Run("PluginUpdateScheduler timings report every plugin", timingsReportEveryPlugin);
+    return unit_test::Result();
+}
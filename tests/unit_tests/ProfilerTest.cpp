@@ -0,0 +1,143 @@
+#include "UnitTest.hpp"
+#include "foundation/Profiler.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+
+// Counts heap allocations, to check the recording path never makes any
+static std::atomic<size_t> allocationCount{ 0u };
+static std::atomic<size_t> allocatedBytes{ 0u };
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1u, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* result = std::malloc(size != 0u ? size : 1u))
+    {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+
+    constexpr const char* traceFile = "ProfilerTest.json";
+
+    size_t countInTrace(const std::string& needle)
+    {
+        UT_CHECK(foundation::WriteProfilerChromeTrace(traceFile));
+        std::ifstream input(traceFile);
+        const std::string contents{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+        size_t count = 0u;
+        for (size_t pos = contents.find(needle); pos != std::string::npos; pos = contents.find(needle, pos + 1u))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    void firstZoneOnThreadDoesNotAllocate()
+    {
+        foundation::ClearProfilerEvents();
+        foundation::ReserveProfilerThreadBuffers(1u);
+
+        size_t allocationsDuringZones = 0u;
+        std::thread worker([&]()
+        {
+            const size_t before = allocationCount.load();
+            for (uint32_t i = 0u; i < 100u; ++i)
+            {
+                foundation::profiler_zone zone("unregistered_zone", i);
+            }
+            allocationsDuringZones = allocationCount.load() - before;
+        });
+        worker.join();
+
+        UT_CHECK(allocationsDuringZones == 0u);
+        UT_CHECK(countInTrace("\"unregistered_zone\"") == 100u);
+    }
+
+    void exitedThreadBuffersAreRecycled()
+    {
+        foundation::ClearProfilerEvents();
+        foundation::ReserveProfilerThreadBuffers(1u);
+        constexpr size_t ringBytes = foundation::ProfilerThreadRingCapacity * sizeof(foundation::profiler_event);
+
+        for (int round = 0; round < 4; ++round)
+        {
+            size_t bytesForRegistration = 0u;
+            std::thread worker([&]()
+            {
+                const size_t before = allocatedBytes.load();
+                foundation::RegisterProfilerThread();
+                bytesForRegistration = allocatedBytes.load() - before;
+                foundation::profiler_zone zone("recycled_zone");
+            });
+            worker.join();
+            // Picked up the spare, which the previous round's collection put back, instead of a fresh ring
+            UT_CHECK(bytesForRegistration < ringBytes);
+            foundation::CollectProfilerEvents();
+        }
+        UT_CHECK(countInTrace("\"recycled_zone\"") == 4u);
+    }
+
+    void threadsWithoutBuffersDropEvents()
+    {
+        foundation::ClearProfilerEvents();
+        foundation::ReserveProfilerThreadBuffers(0u);
+        const uint64_t droppedBefore = foundation::GetProfilerDroppedEventCount();
+
+        std::thread worker([]()
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                foundation::profiler_zone zone("dropped_zone");
+            }
+        });
+        worker.join();
+
+        UT_CHECK(foundation::GetProfilerDroppedEventCount() == droppedBefore + 10u);
+        UT_CHECK(countInTrace("\"dropped_zone\"") == 0u);
+    }
+
+    void exitedThreadNamesSurvive()
+    {
+        foundation::ClearProfilerEvents();
+        std::thread worker([]()
+        {
+            foundation::SetProfilerThreadName("Short Lived Worker");
+            foundation::profiler_zone zone("named_zone");
+        });
+        worker.join();
+        foundation::CollectProfilerEvents();
+        UT_CHECK(countInTrace("\"Short Lived Worker\"") == 1u);
+        UT_CHECK(countInTrace("\"named_zone\"") == 1u);
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("Profiler first zone on a thread doesn't allocate", firstZoneOnThreadDoesNotAllocate);
+    unit_test::Run("Profiler recycles buffers of exited threads", exitedThreadBuffersAreRecycled);
+    unit_test::Run("Profiler threads without buffers drop events", threadsWithoutBuffersDropEvents);
+    unit_test::Run("Profiler names of exited threads survive", exitedThreadNamesSurvive);
+    std::remove(traceFile);
+    return unit_test::Result();
+}
@@ -0,0 +1,82 @@
+#include "UnitTest.hpp"
+#include "ResourceHandleTable.hpp"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+
+    SamplerResourceData makeSampler(const uintptr_t value)
+    {
+        SamplerResourceData data;
+        data.sampler = reinterpret_cast<VkSampler>(value);
+        return data;
+    }
+
+    void staleHandlesMissReusedSlots()
+    {
+        SamplerHandleTable table;
+        const uint32_t first = table.Insert(makeSampler(1u));
+        UT_CHECK(first != 0u);
+        UT_CHECK(GetResourceHandleKind(first) == resource_handle_kind::Sampler);
+        UT_CHECK(table.TryGet(first) != nullptr && table.TryGet(first)->sampler == makeSampler(1u).sampler);
+
+        UT_CHECK(table.Erase(first));
+        UT_CHECK(!table.Erase(first));
+        UT_CHECK(table.TryGet(first) == nullptr);
+
+        // Same slot, next generation
+        const uint32_t second = table.Insert(makeSampler(2u));
+        UT_CHECK((second & ResourceHandleIndexMask) == (first & ResourceHandleIndexMask));
+        UT_CHECK(second != first);
+        UT_CHECK(table.TryGet(first) == nullptr);
+        UT_CHECK(table.TryGet(second) != nullptr);
+        UT_CHECK(table.Size() == 1u);
+
+        // A handle of another kind, with the same slot and generation, isn't a sampler
+        BufferHandleTable buffers;
+        UT_CHECK(table.TryGet(buffers.Insert(BufferResourceData{})) == nullptr);
+    }
+
+    void slotsRetireInsteadOfWrapping()
+    {
+        // Churn a single slot through every generation: no handle may come around again
+        SamplerHandleTable table;
+        std::vector<uint32_t> handles;
+        std::unordered_set<uint32_t> seen;
+        for (uint32_t i = 0u; i <= ResourceHandleGenerationMask; ++i)
+        {
+            const uint32_t handle = table.Insert(makeSampler(i + 1u));
+            UT_CHECK((handle & ResourceHandleIndexMask) == 0u);
+            UT_CHECK(seen.insert(handle).second);
+            handles.emplace_back(handle);
+            UT_CHECK(table.Erase(handle));
+        }
+        UT_CHECK(table.RetiredCount() == 1u);
+
+        const uint32_t next = table.Insert(makeSampler(~uintptr_t(0u)));
+        UT_CHECK((next & ResourceHandleIndexMask) == 1u);
+        UT_CHECK(seen.insert(next).second);
+        for (const uint32_t handle : handles)
+        {
+            UT_CHECK(table.TryGet(handle) == nullptr);
+        }
+
+        size_t visited = 0u;
+        table.ForEach([&](const uint32_t handle, SamplerResourceData&)
+        {
+            UT_CHECK(handle == next);
+            ++visited;
+        });
+        UT_CHECK(visited == 1u && table.Size() == 1u);
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("Stale resource handles miss reused slots", staleHandlesMissReusedSlots);
+    unit_test::Run("Resource handle slots retire instead of wrapping their generation", slotsRetireInsteadOfWrapping);
+    return unit_test::Result();
+}
@@ -0,0 +1,205 @@
+#include "UnitTest.hpp"
+#include "containers/circular_buffer.hpp"
+#include "containers/spscRing.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+    void circularBufferPopReturnsValue()
+    {
+        circular_buffer<std::string, 8> buffer;
+        buffer.push(std::string("first"));
+        buffer.push(std::string("second"));
+        UT_CHECK(buffer.pop() == "first");
+        UT_CHECK(buffer.pop() == "second");
+        UT_CHECK(buffer.empty());
+    }
+
+    void fillAndDrainInOrder()
+    {
+        spscRing<int, 8> ring;
+        for (int i = 0; i < 8; ++i)
+        {
+            UT_CHECK(ring.try_push(i));
+        }
+        UT_CHECK(!ring.try_push(8));
+        UT_CHECK(ring.size_approx() == 8u);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            const std::optional<int> value = ring.try_pop();
+            UT_CHECK(value.has_value() && *value == i);
+        }
+        UT_CHECK(!ring.try_pop().has_value());
+        UT_CHECK(ring.empty());
+    }
+
+    void bulkOpsWrapAround()
+    {
+        spscRing<int, 8> ring;
+        int next = 0;
+        int expected = 0;
+        std::vector<int> source(5);
+        std::vector<int> dest(5);
+        // 5 in, 5 out, repeatedly: the start index walks around the ring so every split point gets hit
+        for (int round = 0; round < 16; ++round)
+        {
+            for (int& value : source)
+            {
+                value = next++;
+            }
+            UT_CHECK(ring.push_n(source) == source.size());
+            UT_CHECK(ring.pop_n(dest) == dest.size());
+            for (const int value : dest)
+            {
+                UT_CHECK(value == expected++);
+            }
+        }
+    }
+
+    void bulkPushRefreshesStaleHead()
+    {
+        spscRing<int, 8> ring;
+        std::vector<int> six{ 0, 1, 2, 3, 4, 5 };
+        std::vector<int> out(6);
+        UT_CHECK(ring.push_n(six) == 6u);
+        UT_CHECK(ring.pop_n(out) == 6u);
+        // Producer's cached head still says only 2 slots are free, though all 8 are
+        UT_CHECK(ring.push_n(six) == 6u);
+    }
+
+    void bulkPopRefreshesStaleTail()
+    {
+        spscRing<int, 8> ring;
+        UT_CHECK(ring.try_push(0));
+        UT_CHECK(ring.try_push(1));
+        UT_CHECK(ring.try_pop().value_or(-1) == 0);
+        std::vector<int> five{ 2, 3, 4, 5, 6 };
+        UT_CHECK(ring.push_n(five) == 5u);
+        // Consumer's cached tail only knows about item 1
+        std::vector<int> out(6);
+        UT_CHECK(ring.pop_n(out) == 6u);
+        for (int i = 0; i < 6; ++i)
+        {
+            UT_CHECK(out[i] == i + 1);
+        }
+    }
+
+    void moveOnlyItems()
+    {
+        spscRing<std::unique_ptr<int>, 4> ring;
+        std::unique_ptr<int> items[6];
+        for (int i = 0; i < 6; ++i)
+        {
+            items[i] = std::make_unique<int>(i);
+        }
+        UT_CHECK(ring.push_n_move(items) == 4u);
+        UT_CHECK(items[0] == nullptr && items[3] == nullptr);
+        // Elements beyond the count pushed are left alone
+        UT_CHECK(items[4] != nullptr && *items[4] == 4);
+
+        std::unique_ptr<int> popped;
+        UT_CHECK(ring.try_pop(popped) && *popped == 0);
+        UT_CHECK(*ring.try_pop().value() == 1);
+    }
+
+    void concurrentTransferKeepsOrder()
+    {
+        constexpr uint64_t numItems = 500000u;
+        static spscRing<uint64_t, 256> ring;
+        std::atomic<bool> done{ false };
+        std::atomic<bool> sizeOutOfRange{ false };
+
+        std::thread producer([&]()
+        {
+            std::vector<uint64_t> batch(37);
+            uint64_t next = 0u;
+            while (next < numItems)
+            {
+                const size_t count = static_cast<size_t>(std::min<uint64_t>(batch.size(), numItems - next));
+                for (size_t i = 0u; i < count; ++i)
+                {
+                    batch[i] = next + i;
+                }
+                size_t pushed = 0u;
+                while (pushed < count)
+                {
+                    const size_t pushedBefore = pushed;
+                    if ((next & 1u) != 0u)
+                    {
+                        pushed += ring.push_n(std::span<const uint64_t>(batch.data() + pushed, count - pushed));
+                    }
+                    else
+                    {
+                        pushed += ring.try_push(batch[pushed]) ? 1u : 0u;
+                    }
+                    if (pushed == pushedBefore)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                next += count;
+            }
+        });
+
+        // Not the producer or consumer, so its reads race both: they must still be in range
+        std::thread observer([&]()
+        {
+            while (!done.load(std::memory_order_relaxed))
+            {
+                if (ring.size_approx() > ring.capacity())
+                {
+                    sizeOutOfRange.store(true);
+                }
+                std::this_thread::yield();
+            }
+        });
+
+        bool inOrder = true;
+        uint64_t expected = 0u;
+        std::vector<uint64_t> batch(50);
+        while (expected < numItems)
+        {
+            const size_t count = ring.pop_n(batch);
+            for (size_t i = 0u; i < count; ++i)
+            {
+                inOrder &= batch[i] == expected++;
+            }
+            uint64_t single = 0u;
+            if (ring.try_pop(single))
+            {
+                inOrder &= single == expected++;
+            }
+            else if (count == 0u)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        producer.join();
+        done.store(true);
+        observer.join();
+
+        UT_CHECK(inOrder);
+        UT_CHECK(!sizeOutOfRange.load());
+        UT_CHECK(ring.empty());
+    }
+
+}
+
+int main()
+{
+    unit_test::Run("circular_buffer::pop returns the value", circularBufferPopReturnsValue);
+    unit_test::Run("spscRing fill and drain in order", fillAndDrainInOrder);
+    unit_test::Run("spscRing bulk ops wrap around", bulkOpsWrapAround);
+    unit_test::Run("spscRing bulk push refreshes stale head", bulkPushRefreshesStaleHead);
+    unit_test::Run("spscRing bulk pop refreshes stale tail", bulkPopRefreshesStaleTail);
+    unit_test::Run("spscRing move-only items", moveOnlyItems);
+    unit_test::Run("spscRing concurrent transfer keeps order", concurrentTransferKeepsOrder);
+    return unit_test::Result();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef DIAMOND_DOGS_UNIT_TEST_HPP
+#define DIAMOND_DOGS_UNIT_TEST_HPP
+#include <cstdio>
+
+/*
+    Just enough to write unit tests as plain executables: checks report file and line and keep going,
+    and main() returns unit_test::Result() so CTest sees any failure.
+*/
+namespace unit_test
+{
+
+    inline int& FailureCount() noexcept
+    {
+        static int count = 0;
+        return count;
+    }
+
+    template<typename Fn>
+    void Run(const char* name, Fn&& fn)
+    {
+        const int failuresBefore = FailureCount();
+        fn();
+        std::printf("%s: %s\n", FailureCount() == failuresBefore ? "PASSED" : "FAILED", name);
+    }
+
+    inline int Result() noexcept
+    {
+        return FailureCount() == 0 ? 0 : 1;
+    }
+
+}
+
+#define UT_CHECK(expr) \
+    do \
+    { \
+        if (!(expr)) \
+        { \
+            std::fprintf(stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #expr); \
+            ++unit_test::FailureCount(); \
+        } \
+    } while (0)
+
+#endif //!DIAMOND_DOGS_UNIT_TEST_HPP